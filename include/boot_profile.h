@@ -0,0 +1,46 @@
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <cstdint>
+
+/**
+ * @brief Tempo de cada fase do boot (sem Arduino)
+ *
+ * begin() com o instante de referência (0 = reset, já que micros() conta do
+ * início da aplicação); mark() fecha a fase corrente com o nome dado. As
+ * durações são a diferença entre marcas consecutivas: a primeira fase
+ * inclui o que rodou antes do setup().
+ */
+class BootProfile {
+public:
+    static constexpr int BOOT_PHASE_MAX = 12;
+
+    void begin(uint32_t originUs) {
+        _originUs = originUs;
+        _lastUs = originUs;
+        _count = 0;
+    }
+
+    void mark(const char* name, uint32_t nowUs) {
+        if (_count < BOOT_PHASE_MAX) {
+            _names[_count] = name;
+            _durationUs[_count] = nowUs - _lastUs;
+            ++_count;
+        }
+        _lastUs = nowUs;
+    }
+
+    int count() const { return _count; }
+    const char* name(int i) const { return _names[i]; }
+    uint32_t durationUs(int i) const { return _durationUs[i]; }
+    uint32_t totalUs() const { return _lastUs - _originUs; }
+
+private:
+    const char* _names[BOOT_PHASE_MAX] = {};
+    uint32_t _durationUs[BOOT_PHASE_MAX] = {};
+    uint32_t _originUs = 0;
+    uint32_t _lastUs = 0;
+    int _count = 0;
+};
+
+#endif // BOOT_PROFILE_H
@@ -0,0 +1,113 @@
+#ifndef COMMAND_PARSER_H
+#define COMMAND_PARSER_H
+
+#include <cstdint>
+
+/**
+ * @brief Comandos remotos via Serial (operação sem encoder, a partir de um PC)
+ *
+ * Protocolo de linhas ASCII: "VERBO [arg1 .. arg4]\n" (verbo sem distinção
+ * de maiúsculas, '\r' ignorado). Respostas de uma linha:
+ *   OK <VERBO> chave=valor ...
+ *   ERR <VERBO> <motivo>
+ * Linhas de log da aplicação começam com '[' e não colidem com o protocolo.
+ */
+enum CommandId : uint8_t {
+    CMD_NONE = 0,      // linha vazia ou inválida (ver Command::error)
+    CMD_UNKNOWN,
+    CMD_HELP,
+    CMD_STATUS,
+    CMD_PROFILES,
+    CMD_START,         // START <perfil>   índice (0..) do perfil de teste
+    CMD_ABORT,
+    CMD_TARE,
+    CMD_CAL,           // CAL <kg>         peso conhecido já sobre a célula
+    CMD_JOG,           // JOG <mm>         movimento relativo (sinal = sentido)
+    CMD_RESULT,
+    CMD_PROBES,        // PROBES [RESET]
+    CMD_TRACE,         // TRACE [CLEAR]
+    CMD_EXPORT,        // EXPORT [offset]  exportação binária (result_export.h)
+    CMD_STORE,         // STORE [CLEAR]    estado do registro de resultados
+    CMD_STEPBENCH,     // STEPBENCH [n]    frequência máx. do laço de passos (driver desabilitado)
+    CMD_HOMESIM,       // HOMESIM [bounce_us] [runs] [ruído/s]  repetibilidade do home simulado
+    CMD_HOME           // HOME             homing + posição de colocação (plataforma livre)
+};
+
+enum CommandError : uint8_t {
+    CMD_ERR_NONE = 0,
+    CMD_ERR_TOO_LONG,      // token maior que CMD_TOKEN_MAX
+    CMD_ERR_TOO_MANY_ARGS,
+    CMD_ERR_BAD_CHAR       // byte de controle/não ASCII na linha
+};
+
+constexpr int CMD_MAX_ARGS  = 4;
+constexpr int CMD_TOKEN_MAX = 15;
+
+struct Command {
+    CommandId    id;
+    CommandError error;
+    uint8_t      argc;
+    char         verb[CMD_TOKEN_MAX + 1];   // em maiúsculas
+    char         args[CMD_MAX_ARGS][CMD_TOKEN_MAX + 1];
+
+    bool argFloat(int i, float* out) const;
+    bool argInt(int i, long* out) const;
+    bool argIs(int i, const char* word) const;   // sem distinção de maiúsculas
+};
+
+/**
+ * @brief Parser de comandos por máquina de estados, alimentado byte a byte
+ *
+ * Sem alocação: o comando é montado em buffers fixos à medida que os bytes
+ * chegam, e feed() retorna true quando uma linha termina. Linhas com erro
+ * (token longo, argumentos demais, bytes inválidos) são descartadas até o
+ * '\n' e entregues como CMD_NONE com o erro preenchido, para que o chamador
+ * responda ERR sem perder o sincronismo. Sem dependência de Arduino.
+ */
+class CommandParser {
+public:
+    CommandParser() { resetLine(); }
+
+    bool feed(uint8_t c);
+    const Command& command() const { return _cmd; }
+
+private:
+    enum State : uint8_t {
+        ST_GAP,       // entre tokens
+        ST_TOKEN,     // dentro de um token
+        ST_DISCARD    // erro: ignora até o fim da linha
+    };
+
+    Command _cmd;
+    State   _state;
+    uint8_t _tokenIndex;   // 0 = verbo, 1.. = argumentos
+    uint8_t _tokenLen;
+    bool    _delivered;    // _cmd entregue; zera no próximo byte
+
+    void resetLine();
+    void fail(CommandError err);
+    void finishToken();
+};
+
+CommandId commandIdFromVerb(const char* verb);
+const char* commandErrorName(CommandError err);
+
+/**
+ * @brief Condição para o START remoto
+ *
+ * A mola é colocada antes do START, então o teste não pode começar pelo
+ * homing (desceria sobre ela). Fluxo remoto: HOME com a plataforma livre,
+ * mola na bancada, START. O eixo precisa ter feito homing e estar na
+ * posição de colocação (SPRING_PLACEMENT_MM); um JOG depois do HOME exige
+ * voltar a ela.
+ */
+enum RemoteStartGate : uint8_t {
+    REMOTE_START_OK = 0,
+    REMOTE_START_NOT_HOMED,
+    REMOTE_START_NOT_PARKED
+};
+
+RemoteStartGate remoteStartGate(bool homed, float positionMm);
+const char* remoteStartGateName(RemoteStartGate gate);   // motivo do ERR
+
+#endif // COMMAND_PARSER_H
@@ -1,6 +1,9 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#include <cstdint>
+#include "rig_profile.h"
+
 // ==== ALOCAÇÃO DE PINOS - ESP32-WROOM COM TFT_eSPI ====
 // ⚠️ CONFLITOS RESOLVIDOS - Evita pinos reservados pelo TFT_eSPI (18, 19, 23, 15, 2, 4)
 // Pinos reservados TFT (SPI): GPIO 18 (SCLK), 19 (MISO), 23 (MOSI), 15 (CS), 2 (DC), 4 (RST)
@@ -11,38 +14,39 @@
 // ⚠️ GPIO 5: Startup timing - evitar se possível
 
 // ==== PINOS DO PROJETO ====
+// Definidos pelo perfil da bancada (rig_profile.h, ActiveRig); valores da rev A
 
 // Célula de carga (HX711) - Pinos de dados simples
-constexpr int LOADCELL_DOUT_PIN = 34;  // GPIO 34 (Input only) - ✅ Apenas leitura
-constexpr int LOADCELL_SCK_PIN  = 16;  // GPIO 16 (Saída digital) - ✅ Pode gerar saída para SCK
+constexpr int LOADCELL_DOUT_PIN = ActiveRig::LOADCELL_DOUT_PIN;  // GPIO 34 (Input only) - ✅ Apenas leitura
+constexpr int LOADCELL_SCK_PIN  = ActiveRig::LOADCELL_SCK_PIN;  // GPIO 16 (Saída digital) - ✅ Pode gerar saída para SCK
 
 // Motor de passo (driver tipo A4988/DRV8825) - Pinos de saída digital
-constexpr int STEP_PIN   = 25;  // GPIO 25 - ✅ Saída digital (livre)
-constexpr int DIR_PIN    = 26;  // GPIO 26 - ✅ Saída digital (livre)
-constexpr int EN_PIN     = 27;  // GPIO 27 - ✅ Saída digital (livre)
+constexpr int STEP_PIN   = ActiveRig::STEP_PIN;  // GPIO 25 - ✅ Saída digital (livre)
+constexpr int DIR_PIN    = ActiveRig::DIR_PIN;  // GPIO 26 - ✅ Saída digital (livre)
+constexpr int EN_PIN     = ActiveRig::EN_PIN;  // GPIO 27 - ✅ Saída digital (livre)
 constexpr uint32_t TMC_R_SENSE = 110; // mOhm - Resistor de sense no TMC2209 (110mΩ típico)
 
 // Endstop de referência do eixo - Pino de entrada digital
-constexpr int ENDSTOP_PIN = 33;  // GPIO 33 - ✅ Entrada digital (livre)
+constexpr int ENDSTOP_PIN = ActiveRig::ENDSTOP_PIN;  // GPIO 33 - ✅ Entrada digital (livre)
 
 // Backlight do display TFT
-constexpr int BL_PIN      = 21;  // GPIO 21 - ✅ Configurado tanto em config.h quanto em User_Setup.h
+constexpr int BL_PIN      = ActiveRig::BL_PIN;  // GPIO 21 - ✅ Configurado tanto em config.h quanto em User_Setup.h
 
 // Encoder KY-040 - Pinos de entrada digital (alternados para evitar SPI e boot conflicts)
-constexpr int ENC_CLK_PIN = 13;  // GPIO 13 - ✅ Entrada digital (mudado de 18, que é SCLK do LCD)
-constexpr int ENC_DT_PIN  = 14;  // GPIO 14 - ✅ Entrada digital (mudado de 19, que é MISO do LCD)
-constexpr int ENC_SW_PIN  = 17;  // GPIO 17 - ✅ Entrada digital (mudado de 12, que tem boot conflict MTDI)
+constexpr int ENC_CLK_PIN = ActiveRig::ENC_CLK_PIN;  // GPIO 13 - ✅ Entrada digital (mudado de 18, que é SCLK do LCD)
+constexpr int ENC_DT_PIN  = ActiveRig::ENC_DT_PIN;  // GPIO 14 - ✅ Entrada digital (mudado de 19, que é MISO do LCD)
+constexpr int ENC_SW_PIN  = ActiveRig::ENC_SW_PIN;  // GPIO 17 - ✅ Entrada digital (mudado de 12, que tem boot conflict MTDI)
 // Número de bordas quadratura necessárias por passo lógico (ajuste conforme encoder)
 // Use 2 para encoders que geram 2 bordas por detente, 4 para 4 bordas por detente.
 constexpr int ENCODER_EDGES_PER_STEP = 2;
 
 // TMC2209 UART e DIAG (pré-configurado, comunicação permanece desabilitada por padrão)
-constexpr int TMC_UART_TX_PIN   = 22;   // GPIO 22 -> TX para TMC2209
-constexpr int TMC_UART_RX_PIN   = 35;   // GPIO 35 <- RX do TMC2209 (input-only)
-constexpr int TMC_DIAG_PIN      = 32;   // GPIO 32 <- DIAG/SG
+constexpr int TMC_UART_TX_PIN   = ActiveRig::TMC_UART_TX_PIN;   // GPIO 22 -> TX para TMC2209
+constexpr int TMC_UART_RX_PIN   = ActiveRig::TMC_UART_RX_PIN;   // GPIO 35 <- RX do TMC2209 (input-only)
+constexpr int TMC_DIAG_PIN      = ActiveRig::TMC_DIAG_PIN;   // GPIO 32 <- DIAG/SG
 constexpr long TMC_UART_BAUD    = 115200;
 constexpr uint8_t TMC_UART_ADDR = 0b00; // endereço UART (CFG1/CFG2 flutuando)
-constexpr uint16_t TMC_DEFAULT_MICROSTEPS = 8; // manter consistente com STEPPER_STEPS_PER_MM
+constexpr uint16_t TMC_DEFAULT_MICROSTEPS = ActiveRig::MICROSTEPS; // unidade de STEPPER_STEPS_PER_MM
 constexpr bool TMC_UART_ENABLED = false; // deixe false para não abrir a UART; mude para true quando quiser ativar
 
 // ==== RESUMO DE ALOCAÇÃO (Total: 14 pinos) - VERSÃO COM TMC2209 StallGuard ====
@@ -75,7 +79,7 @@ constexpr float SCALE_CALIB_WEIGHTS[] = {0.5f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
 constexpr int SCALE_CALIB_WEIGHTS_COUNT = sizeof(SCALE_CALIB_WEIGHTS) / sizeof(SCALE_CALIB_WEIGHTS[0]);
 
 // Limiares de detecção de mola
-constexpr float SPRING_CONTACT_FORCE_KG   = 0.30f;  // força para considerar contato com a mola
+constexpr float SPRING_CONTACT_FORCE_KG   = 0.30f;  // contato com a mola (homing/fadiga; teste de mola usa contact_kg do perfil)
 constexpr float SPRING_TARA_THRESHOLD_KG  = 0.05f;  // força abaixo da qual considera sem contato
 // Limite de alteração de peso durante homing para acionar alarme
 constexpr float HOMING_WEIGHT_DELTA_KG    = 0.05f;  // variação mínima na balança que caracteriza objeto colocado
@@ -86,11 +90,9 @@ constexpr unsigned long HOMING_MONITOR_INTERVAL_MS = 10; // reduz jitter do moto
 constexpr float SPRING_FREE_LENGTH_MM = 20.0f;
 
 // ==== PARÂMETROS DO EIXO / MOTOR DE PASSO ====
-// Motor NEMA11 com TMC2209 em modo standalone (MS pins flutuando tendem a 1/8 microstep em muitos módulos)
-// Sistema: Trilho deslizante com pitch 1mm/volta
-// Cálculo alvo: 200 passos/volta * 8 microsteps / 1 mm = 1600 passos/mm
-// Ajuste aqui conforme o hardware (se os pinos CFG1/CFG2 forem amarrados para 1/16, volte para 3200.0f)
-constexpr float STEPPER_STEPS_PER_MM   = 1600.0f;   // assumir 1/8 microstep por padrão
+// Passos/mm vêm da mecânica do perfil (rig_profile.h): passos/volta x
+// microsteps / passo do fuso. Rev A: 200 x 8 / 1 mm = 1600 passos/mm
+constexpr float STEPPER_STEPS_PER_MM   = (float)ActiveRig::STEPS_PER_MM;
 constexpr float STEPPER_MAX_TRAVEL_MM  = 40.0f;     // curso mecânico útil
 
 // Limite de curso usado na rotina de homing (proteção para não subir até bater no topo)
@@ -102,6 +104,23 @@ constexpr float STEPPER_HOME_BACKOFF_MM = 30.0f;    // recua 30mm após homing
 // Direção do home (para o lado do fim de curso)
 constexpr int STEPPER_HOME_DIR_INT = 0; // 0 = FORWARD, 1 = BACKWARD
 
+// Fim de curso por interrupção (endstop_homing.h): a borda captura a posição
+// e para o homing; o esp_timer confirma o acionamento após o debounce
+constexpr bool     ENDSTOP_LATCH_ENABLED     = true;
+constexpr uint32_t ENDSTOP_DEBOUNCE_US       = 2000;   // sinal estável por esse tempo
+constexpr uint32_t ENDSTOP_SETTLE_TIMEOUT_US = 20000;  // bounce contínuo: decide pelo nível
+
+// Simulador da bancada (rig_sim.h, comando HOMESIM): repetibilidade do home
+// com bounce/ruído do switch, com e sem a captura por interrupção
+constexpr float    RIG_SIM_TRIP_JITTER_UM = 1.0f;   // espalhamento mecânico do switch
+constexpr uint32_t RIG_SIM_BOUNCE_US      = 2000;   // padrão do comando
+constexpr uint32_t RIG_SIM_BOUNCE_EDGE_US = 50;     // intervalo médio entre bordas do bounce
+constexpr uint32_t RIG_SIM_GLITCH_US      = 20;     // largura do pulso de ruído
+constexpr uint16_t RIG_SIM_STEP_DELAY_US  = 133;    // mesmo intervalo do homing dos grafsets
+constexpr float    RIG_SIM_START_MM       = 0.5f;
+constexpr uint16_t RIG_SIM_DEFAULT_RUNS   = 100;
+constexpr uint16_t RIG_SIM_MAX_RUNS       = 1000;
+
 // ==== PARÂMETROS TMC2209 StallGuard ====
 // Corrente RMS do motor (mA) - NEMA11 típico: 600-1000mA
 constexpr uint16_t TMC_CURRENT_RMS = 600;  // 600mA - reduzido para evitar ressonância
@@ -120,20 +139,187 @@ constexpr float TMC_STALL_RETRACT_MM = 10.0f; // Recua 10mm quando detectar trav
 // Velocidade mínima para StallGuard funcionar (precisa ter movimento)
 constexpr uint16_t TMC_STALL_MIN_SPEED_US = 1500; // microsteps delay (mais lento que normal)
 
+// Nível do pino DIAG durante stall (TMC2209: saída push-pull, ativa em HIGH)
+constexpr int TMC_DIAG_STALL_LEVEL = 1;
+
+// ==== MICROSTEP / CORRENTE POR FASE DE MOVIMENTO (requer UART do TMC2209) ====
+// Com a UART ativa a posição passa a ser contada na unidade mais fina
+// (1/TMC_FINE_MICROSTEPS) e cada pulso avança 1/microsteps da fase atual.
+// speedPct escala a velocidade pedida (usDelay é sempre relativo a
+// 1/TMC_DEFAULT_MICROSTEPS), de modo que os tempos existentes continuam valendo.
+struct MotionPhaseConfig {
+    uint16_t microsteps;
+    uint16_t currentMa;
+    bool     stealthChop;   // StallGuard4 só funciona em StealthChop
+    uint8_t  speedPct;
+};
+constexpr uint16_t TMC_FINE_MICROSTEPS = 16;
+static_assert(TMC_FINE_MICROSTEPS % TMC_DEFAULT_MICROSTEPS == 0,
+              "TMC_FINE_MICROSTEPS deve ser múltiplo do microstep do perfil");
+constexpr MotionPhaseConfig MOTION_PHASE_TRAVEL_CFG  = {4,  750, false, 150}; // deslocamentos livres
+constexpr MotionPhaseConfig MOTION_PHASE_HOMING_CFG  = {4,  600, true,  100}; // StallGuard ativo
+constexpr MotionPhaseConfig MOTION_PHASE_MEASURE_CFG = {16, 600, true,  100}; // curso de compressão
+constexpr uint16_t STEP_PULSE_US = 10;  // largura do pulso STEP
+// Comando STEPBENCH: pulsos por medição (padrão e limite)
+constexpr uint32_t STEP_BENCH_DEFAULT_PULSES = 20000;
+constexpr uint32_t STEP_BENCH_MAX_PULSES     = 200000;
+
+// Fila de movimento (look-ahead): aceleração e velocidade de partida/parada
+constexpr float STEPPER_ACCEL_MM_S2   = 200.0f;
+constexpr float STEPPER_START_MM_S    = 2.0f;
+
+// Verificação de passos perdidos via MSCNT (requer UART): intervalo mínimo
+// entre leituras ao fim dos movimentos (uma transação UART cada)
+constexpr uint32_t STEP_VERIFY_INTERVAL_MS = 100;
+
+// ==== HOMING SEM SENSOR (StallGuard) ====
+// Usado somente quando a UART do TMC2209 está ativa; caso contrário o homing
+// continua rastejando até o micro switch. O fim de curso vira verificação.
+constexpr bool     STEPPER_SENSORLESS_HOMING   = true;
+constexpr uint16_t SENSORLESS_HOME_FAST_US     = 60;    // ~10 mm/s a 1600 passos/mm
+constexpr uint16_t SENSORLESS_HOME_SLOW_US     = 250;   // reaproximação lenta
+constexpr float    SENSORLESS_HOME_BACKOFF_MM  = 2.0f;  // recuo entre as aproximações
+constexpr float    SENSORLESS_HOME_BLANK_MM    = 0.25f; // DIAG ignorado no início de cada aproximação
+
+// ==== MONITORAMENTO DE SG_RESULT (canal secundário de carga) ====
+// Leitura em segundo plano (tarefa no core 0) durante movimentos
+constexpr uint32_t SG_POLL_PERIOD_MS    = 10;  // uma transação UART (~1 ms a 115200) a cada 10 ms
+constexpr uint8_t  SG_POLL_MAX_BACKOFF  = 3;   // falhas seguidas: período até 8x
+// Abort da compressão: SG_RESULT <= limiar por N leituras seguidas
+// (DIAG dispara em SG_RESULT <= 2*SGTHRS; usa o mesmo critério)
+constexpr uint16_t SG_ABORT_RESULT      = 2 * TMC_STALLGUARD_THRESHOLD;
+constexpr uint8_t  SG_ABORT_CONSECUTIVE = 3;
+constexpr uint32_t SG_TASK_STACK        = 3072;
+constexpr int      SG_TASK_PRIORITY     = 1;
+constexpr int      SG_TASK_CORE         = 0;
+// A mesma tarefa envia os registradores shadow pendentes do TMC2209; troca de
+// fase de movimento espera no máximo isso pelo envio antes de pulsar
+constexpr uint32_t TMC_FLUSH_TIMEOUT_MS = 50;
+
 // ==== TESTE PADRÃO DE MOLA ====
 
-// Opções de curso de leitura para teste de mola
-constexpr float SPRING_TEST_COURSES[] = {10.0f, 8.0f, 5.0f};
-constexpr int SPRING_TEST_COURSES_COUNT = sizeof(SPRING_TEST_COURSES) / sizeof(SPRING_TEST_COURSES[0]);
+// Cursos, pontos de amostragem, filtro e limites do teste de mola vêm dos
+// perfis em tools/test_profiles.txt (compilados para test_profiles_data.h)
 
 // Compressão padrão usada no teste (pode ajustar depois)
 constexpr float DEFAULT_TEST_COMPRESSION_MM = 10.0f;
 
+// Veredito da peça (limites no perfil): reprovação antecipada de K só com
+// esta margem além da faixa e após N pontos acima de VERDICT_MIN_X_MM
+constexpr float VERDICT_EARLY_K_MARGIN  = 0.25f;
+constexpr int   VERDICT_EARLY_MIN_POINTS = 4;
+constexpr float VERDICT_MIN_X_MM        = 0.5f;
+
+// Posição do motor (mm) com o prato encostado no apoio, sem mola: referência
+// do comprimento livre medido (free_length nos perfis). Calibrar na máquina.
+constexpr float PLATEN_BASE_POSITION_MM = 0.0f;
+
+// Comandos remotos via Serial: JOG anda em fatias de REMOTE_JOG_CHUNK_MM por
+// volta do loop, para o parser continuar atendendo (ABORT, STATUS) no trajeto
+constexpr float    REMOTE_JOG_CHUNK_MM  = 0.25f;
+constexpr uint16_t REMOTE_JOG_US_DELAY  = 133;
+// Posição de colocação da mola (após o homing e ao fim do teste). O START
+// remoto parte dela: a mola já está na bancada, o homing fica com o HOME
+constexpr float SPRING_PLACEMENT_MM      = 30.0f;
+constexpr float REMOTE_START_PARK_TOL_MM = 0.05f;
+
+// Capacidade da arena estática de amostras do teste (decima ao encher)
+constexpr int SPRING_SAMPLE_CAPACITY = 256;
+
+// Acomodação após cada movimento da compressão (settling_detector.h): em vez
+// da espera fixa do perfil (acomod_ms) e da média com intervalo, lê
+// conversões únicas até a força estabilizar. false = espera fixa do perfil
+constexpr bool     SETTLE_ADAPTIVE     = true;
+constexpr uint8_t  SETTLE_WINDOW       = 6;        // mínimo de conversões (ou N do perfil, se maior)
+constexpr uint16_t SETTLE_MIN_SPAN_MS  = 300;      // janela cobre ao menos 300 ms
+constexpr float    SETTLE_MAX_DRIFT_KG = 0.005f;   // variação ao longo da janela
+constexpr float    SETTLE_MAX_STD_KG   = 0.005f;   // oscilação residual
+constexpr float    SETTLE_REL_TOL      = 0.002f;   // ou 0,2% da força, se maior
+constexpr uint16_t SETTLE_TIMEOUT_MS   = 3000;     // usa a última janela e sinaliza
+
+// Registro de resultados no LittleFS (partição spiffs padrão, ~1,4 MB): ao
+// atingir o limite os novos testes não são gravados até "STORE CLEAR"
+constexpr uint32_t RESULT_STORE_MAX_BYTES = 1024UL * 1024UL;
+
+// Buffer de transmissão da Serial: a exportação enche até este limite por
+// volta do loop sem bloquear (o padrão do core é só a FIFO de 128 bytes)
+constexpr uint32_t SERIAL_TX_BUFFER_BYTES = 2048;
+
+// Rastreamento do zero da célula (zero_tracker.h): só observa com a máquina
+// no menu (célula descarregada) e janela estável; compensa deriva por tempo
+// e temperatura até a próxima tara. Limiares em kg (convertidos com o fator)
+constexpr bool     ZERO_TRACK_ENABLED     = true;
+constexpr uint32_t ZERO_TRACK_OBSERVE_MS  = 30000;   // uma observação a cada 30 s
+constexpr float    ZERO_TRACK_STABLE_KG   = 0.005f;  // desvio máximo da janela
+constexpr float    ZERO_TRACK_MAX_JUMP_KG = 0.05f;   // acima disso é carga, não deriva
+constexpr float    ZERO_TRACK_FORGET      = 0.995f;  // ~200 observações (~100 min) de memória
+// Fonte de temperatura: 0 = nenhuma (só tempo), 1 = sensor interno do ESP32
+// (temperatureRead(), perto do HX711 na mesma placa), 2 = sensor externo
+// (readExternalTempC() em scale_manager.cpp, a implementar). Sem temperatura
+// o modelo só extrapola a tendência linear: ciclos térmicos não são previstos
+constexpr int      ZERO_TRACK_TEMP_SOURCE = 1;
+constexpr uint32_t ZERO_TRACK_TEMP_PERIOD_MS = 10000;   // temperatura em cache
+
+// Estimador de K ao final do teste: 0 = mínimos quadrados, 1 = Theil-Sen,
+// 2 = RANSAC, 3 = Huber (ver spring_rate_estimator.h)
+constexpr int SPRING_RATE_METHOD = 1;
+
+// Detecção automática da região linear (substitui a faixa fixa 2..8 mm)
+constexpr float SPRING_LINEAR_REL_TOL   = 0.25f; // inclinação local até 25% da mediana
+constexpr int   SPRING_LINEAR_MIN_POINTS = 4;    // abaixo disso usa todas as amostras
+
 // Número máximo de pontos no gráfico durante o teste
 constexpr int MAX_GRAPH_SAMPLES = 40;
 
-// Estimativa de força máxima em kg para escalar o gráfico (só visual)
-constexpr float GRAPH_MAX_FORCE_KG = 10.0f;
+// Escala do gráfico (só visual): capacidade da célula do perfil
+constexpr float GRAPH_MAX_FORCE_KG = (float)ActiveRig::LOADCELL_CAPACITY_KG;
+
+// ==== TESTE DE FADIGA (CICLAGEM) ====
+
+// Opções de número de ciclos para o teste de fadiga
+constexpr uint32_t FATIGUE_CYCLE_OPTIONS[] = {100, 500, 1000, 5000};
+constexpr int FATIGUE_CYCLE_OPTIONS_COUNT = sizeof(FATIGUE_CYCLE_OPTIONS) / sizeof(FATIGUE_CYCLE_OPTIONS[0]);
+
+// Curso de ciclagem a partir do contato aliviado (mm)
+constexpr float FATIGUE_COURSE_MM = 5.0f;
+
+// Incremento de movimento entre leituras durante a compressão (mm)
+constexpr float FATIGUE_SAMPLE_STEP_MM = 0.25f;
+
+// Velocidade de ciclagem (microseconds entre passos) - mais rápida que o teste padrão
+constexpr uint16_t FATIGUE_STEP_DELAY_US = 60;
+
+// Os pontos da descida não param o carro: cada um só entra com uma conversão
+// nova do HX711. A ~8,9 mm/s a descida leva ~0,6 s: a 10 SPS sobram ~5
+// pontos por ciclo (a 80 SPS quase todos os 21). K sai da regressão desses
+// pontos; para mais pontos a 10 SPS, reduza a velocidade
+constexpr float FATIGUE_HX711_MIN_SPS = 10.0f;
+constexpr float FATIGUE_STROKE_S = FATIGUE_COURSE_MM * STEPPER_STEPS_PER_MM *
+                                   (FATIGUE_STEP_DELAY_US + STEP_PULSE_US) * 1e-6f;
+
+// Ciclo com menos amostras que isto fica fora do resumo; mais de
+// FATIGUE_MAX_REJECTED_CYCLES rejeitados SEGUIDOS (HX711 parado) interrompe
+constexpr int FATIGUE_MIN_CYCLE_SAMPLES = 4;
+constexpr uint32_t FATIGUE_MAX_REJECTED_CYCLES = 10;
+static_assert(FATIGUE_STROKE_S * FATIGUE_HX711_MIN_SPS >= FATIGUE_MIN_CYCLE_SAMPLES + 1,
+              "descida rápida demais para FATIGUE_MIN_CYCLE_SAMPLES a 10 SPS");
+
+// Força máxima permitida durante a ciclagem (aborta acima disso)
+constexpr float FATIGUE_MAX_FORCE_KG = GRAPH_MAX_FORCE_KG;
+
+// Curvas completas guardadas (ciclos 1, 2, 4, ... 2^(N-1)) e pontos por curva
+constexpr int FATIGUE_STORED_CURVES = 14;
+constexpr int FATIGUE_CURVE_POINTS  = 32;
+
+// Intervalo de atualização da tela durante a ciclagem (ms)
+constexpr unsigned long FATIGUE_UI_INTERVAL_MS = 1000;
+
+// ==== BOOT ====
+// Splash fica no mínimo BOOT_SPLASH_MIN_MS (marca visível; também cobre a
+// espera do driver antes de habilitar o motor) e até a tara de boot
+// terminar; BOOT_SPLASH_MAX_MS limita a espera se o HX711 não responde
+constexpr uint32_t BOOT_SPLASH_MIN_MS = 800;
+constexpr uint32_t BOOT_SPLASH_MAX_MS = 6000;
 
 // ==== TIMEOUTS E SEGURANÇA ====
 // Timeout para homing (ms)
@@ -149,6 +335,18 @@ constexpr int STEPPER_HOME_MAX_RETRIES = 1;
 // Timeout para HX711 responder (ms)
 constexpr unsigned long SCALE_READ_TIMEOUT_MS = 5000;
 
+// Tara por parada estatística (tare_estimator.h): lê até o erro padrão da
+// média ficar abaixo do alvo (4 conversões = 0,4 s com a célula quieta);
+// tendência significativa descarta o trecho (plataforma ainda acomodando)
+constexpr float    TARE_TARGET_SE_KG = 0.0005f;   // 0,5 g
+constexpr uint16_t TARE_MIN_SAMPLES  = 4;
+constexpr uint16_t TARE_MAX_SAMPLES  = 30;        // 3 s a 10 SPS
+constexpr float    TARE_TREND_T      = 4.0f;
+// Tara de boot em tarefa no core 0 (ScaleManager::beginAsync)
+constexpr uint32_t TARE_TASK_STACK    = 4096;
+constexpr int      TARE_TASK_PRIORITY = 1;
+constexpr int      TARE_TASK_CORE     = 0;
+
 // ==== CORES DO DISPLAY TFT (TFT_eSPI) ====
 // Cores RGB565 para uso na interface
 #define TFT_BLACK       0x0000
@@ -0,0 +1,30 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief CRC-32 (IEEE 802.3, o mesmo de zlib.crc32) com tabela de 16 entradas
+ *
+ * Tabela de nibble: 64 bytes em vez de 1 KB, rápida o bastante para
+ * quadros de exportação e registros gravados. Encadeável: passe o retorno
+ * anterior em crc (comece com 0).
+ */
+inline uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t len) {
+    static const uint32_t NIBBLE[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+        0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+        0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+    crc = ~crc;
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ NIBBLE[crc & 0x0F];
+        crc = (crc >> 4) ^ NIBBLE[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+#endif // CRC32_H
@@ -0,0 +1,98 @@
+#ifndef CURVE_CODEC_H
+#define CURVE_CODEC_H
+
+#include <cstdint>
+#include <cstddef>
+#include "sample_arena.h"
+
+/**
+ * @brief Calibração e tempos de uma curva: o necessário para voltar a mm/kg
+ */
+struct CurveMeta {
+    float    stepsPerMm;
+    float    calibFactor;
+    int32_t  tareOffset;
+    int32_t  zeroSteps;      // posição (passos) do zero de compressão
+    uint32_t startUs;        // timestampUs da primeira amostra
+    uint32_t endUs;          // timestampUs da última
+};
+
+constexpr uint16_t CURVE_MAGIC   = 0x5643;   // "CV"
+constexpr uint8_t  CURVE_VERSION = 1;
+constexpr int      CURVE_DEFAULT_CHECKPOINT_INTERVAL = 32;
+
+// Cabeçalho do blob (little-endian, copiado com memcpy)
+struct CurveBlobHeader {
+    uint16_t  magic;
+    uint8_t   version;
+    uint8_t   checkpointInterval;   // N: uma âncora a cada N amostras
+    uint16_t  sampleCount;
+    uint16_t  checkpointCount;
+    uint32_t  dataBytes;            // bytes de deltas após a tabela
+    CurveMeta meta;
+};
+
+// Âncora: valores absolutos da amostra k*N e onde começam os deltas seguintes
+struct CurveCheckpoint {
+    uint32_t dataOffset;            // relativo ao início dos deltas
+    int32_t  stepPos;
+    int32_t  rawCount;
+    uint32_t timestampUs;
+};
+
+static_assert(sizeof(CurveBlobHeader) == 36, "CurveBlobHeader deve ter 36 bytes");
+static_assert(sizeof(CurveCheckpoint) == 16, "CurveCheckpoint deve ter 16 bytes");
+
+// Pior caso do blob para n amostras e intervalo N
+constexpr size_t curveMaxBytes(int sampleCount, int interval = CURVE_DEFAULT_CHECKPOINT_INTERVAL) {
+    return sizeof(CurveBlobHeader) +
+           (size_t)((sampleCount + interval - 1) / interval) * sizeof(CurveCheckpoint) +
+           (size_t)sampleCount * 15;
+}
+
+/**
+ * @brief Codifica uma curva: cabeçalho + âncoras + deltas zigzag/varint
+ *
+ * Cada amostra após uma âncora guarda delta de passo e de contagem (zigzag)
+ * e delta de tempo (sem sinal, módulo 2^32). Em movimento contínuo isso dá
+ * ~5 bytes por amostra contra 12 da CurveSample bruta. Retorna o tamanho
+ * do blob (0 se não couber em cap ou n inválido). Sem dependência de Arduino.
+ */
+size_t curveEncode(const CurveMeta& meta, const CurveSample* samples, int count,
+                   uint8_t* out, size_t cap,
+                   int checkpointInterval = CURVE_DEFAULT_CHECKPOINT_INTERVAL);
+
+/**
+ * @brief Leitura de um blob de curva, sequencial ou por índice
+ *
+ * open() valida cabeçalho e limites. sampleAt(i) parte da âncora de i/N e
+ * decodifica no máximo N-1 deltas; next() percorre a curva em ordem.
+ */
+class CurveReader {
+public:
+    bool open(const uint8_t* blob, size_t len);
+
+    int count() const { return _hdr.sampleCount; }
+    const CurveMeta& meta() const { return _hdr.meta; }
+    int checkpointInterval() const { return _hdr.checkpointInterval; }
+
+    bool sampleAt(int index, CurveSample* out) const;
+
+    void rewind();
+    bool next(CurveSample* out);
+
+private:
+    CurveBlobHeader _hdr = {};
+    const uint8_t*  _table = nullptr;
+    const uint8_t*  _data = nullptr;
+
+    // Cursor de next()
+    int         _index = 0;
+    uint32_t    _pos = 0;
+    CurveSample _cur = {};
+
+    void checkpoint(int k, CurveSample* s, uint32_t* pos) const;
+    bool decodeDelta(uint32_t* pos, CurveSample* s) const;
+};
+
+#endif // CURVE_CODEC_H
@@ -0,0 +1,123 @@
+#ifndef CYCLE_STATS_H
+#define CYCLE_STATS_H
+
+#include <cstdint>
+
+/**
+ * @brief Acumulador de estatísticas de UM ciclo de compressão (memória constante)
+ *
+ * Recebe amostras (x em mm de compressão, F em kg) em ordem de chegada e
+ * mantém apenas somatórios: não guarda a curva. Ao final do ciclo fornece
+ * força mín/máx, K por mínimos quadrados e energia (área sob F-x).
+ */
+class CycleAccumulator {
+public:
+    void begin();
+    void addSample(float xMm, float forceKg);
+
+    int   count() const { return _n; }
+    float minForceKg() const { return _minF; }
+    float maxForceKg() const { return _maxF; }
+    float maxCompressionMm() const { return _maxX; }
+
+    // K (kgf/mm) por regressão linear F = a + k*x; 0 se < 2 pontos
+    float springRateKgfMm() const;
+
+    // Energia de compressão (trapézios) em mJ
+    float energyMj() const;
+
+private:
+    int   _n = 0;
+    float _sumX = 0.0f, _sumY = 0.0f, _sumXX = 0.0f, _sumXY = 0.0f;
+    float _minF = 0.0f, _maxF = 0.0f, _maxX = 0.0f;
+    float _lastX = 0.0f, _lastF = 0.0f;
+    float _workKgfMm = 0.0f;
+};
+
+/**
+ * @brief Resumo de N ciclos (Welford para média/desvio de K, O(1) por ciclo)
+ */
+class FatigueSummary {
+public:
+    void begin();
+    void addCycle(const CycleAccumulator& cycle);
+
+    uint32_t cycles() const { return _cycles; }
+    float firstK() const { return _firstK; }
+    float lastK() const { return _lastK; }
+    float minK() const { return _minK; }
+    float maxK() const { return _maxK; }
+    float meanK() const { return _meanK; }
+    float stdDevK() const;
+    float minForceKg() const { return _minF; }
+    float maxForceKg() const { return _maxF; }
+    float meanEnergyMj() const { return _meanEnergy; }
+
+    // Variação percentual de K do primeiro para o último ciclo
+    float driftPercent() const;
+
+private:
+    uint32_t _cycles = 0;
+    float _firstK = 0.0f, _lastK = 0.0f;
+    float _minK = 0.0f, _maxK = 0.0f;
+    float _meanK = 0.0f, _m2K = 0.0f;
+    float _minF = 0.0f, _maxF = 0.0f;
+    float _meanEnergy = 0.0f;
+};
+
+/**
+ * @brief Curvas completas (decimadas) guardadas em intervalos logarítmicos
+ *
+ * Armazena a curva dos ciclos 1, 2, 4, 8, ... em slots estáticos. Cada curva
+ * é decimada para no máximo Points pontos: basta informar quantas amostras
+ * o curso produz por ciclo para definir o passo de decimação.
+ */
+template <int Slots, int Points>
+class CurveLog {
+public:
+    struct Curve {
+        uint32_t cycle;
+        int      count;
+        float    xMm[Points];
+        float    forceKg[Points];
+    };
+
+    void begin(int samplesPerStroke) {
+        _used = 0;
+        _recording = -1;
+        _stride = (samplesPerStroke + Points - 1) / Points;
+        if (_stride < 1) _stride = 1;
+    }
+
+    // Deve ser chamado no início de cada ciclo (1-based)
+    void beginCycle(uint32_t cycle) {
+        _recording = -1;
+        _sampleIndex = 0;
+        bool powerOfTwo = (cycle != 0) && ((cycle & (cycle - 1)) == 0);
+        if (!powerOfTwo || _used >= Slots) return;
+        _recording = _used++;
+        _curves[_recording].cycle = cycle;
+        _curves[_recording].count = 0;
+    }
+
+    void addSample(float xMm, float forceKg) {
+        if (_recording < 0) return;
+        Curve& c = _curves[_recording];
+        if ((_sampleIndex++ % _stride) != 0 || c.count >= Points) return;
+        c.xMm[c.count] = xMm;
+        c.forceKg[c.count] = forceKg;
+        c.count++;
+    }
+
+    int size() const { return _used; }
+    const Curve& at(int i) const { return _curves[i]; }
+
+private:
+    Curve _curves[Slots];
+    int   _used = 0;
+    int   _recording = -1;
+    int   _stride = 1;
+    int   _sampleIndex = 0;
+};
+
+#endif // CYCLE_STATS_H
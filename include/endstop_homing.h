@@ -0,0 +1,100 @@
+#ifndef ENDSTOP_HOMING_H
+#define ENDSTOP_HOMING_H
+
+#include <cstdint>
+
+#ifdef ARDUINO
+#include <esp_attr.h>
+#endif
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+enum EndstopLatchState : uint8_t {
+    LATCH_DISARMED = 0,
+    LATCH_ARMED,        // aguardando a primeira borda de acionamento
+    LATCH_PENDING,      // borda capturada, debounce em andamento (movimento parado)
+    LATCH_CONFIRMED     // sinal estável acionado: posição capturada vale
+};
+
+/**
+ * @brief Captura da posição no acionamento do fim de curso (sem Arduino)
+ *
+ * onEdge() roda na ISR de borda do endstop: a primeira borda de acionamento
+ * com a latch armada guarda a posição daquele instante e pede a parada do
+ * laço de passos, sem esperar o próximo passo para ler o pino. Cada borda
+ * seguinte (bounce) reinicia a janela de debounce; onDebounceTimer() é
+ * chamado pelo temporizador quando o sinal fica estável por uma janela
+ * inteira. Acionado nesse instante: confirma a posição da primeira borda.
+ * Solto: era ruído; a latch volta a armar e o laço segue.
+ */
+class EndstopLatch {
+public:
+    // Arma para um novo homing. Se o fim de curso já está acionado não haverá
+    // borda: confirma direto na posição atual.
+    void arm(bool pressedNow, int32_t position);
+    void disarm() { _state = LATCH_DISARMED; }
+
+    // ISR: nível após a borda; true = (re)iniciar o temporizador de debounce
+    bool IRAM_ATTR onEdge(bool pressed, int32_t position);
+    // Temporizador de debounce: nível ao fim da janela
+    void onDebounceTimer(bool pressed);
+
+    EndstopLatchState state() const { return _state; }
+    bool stopRequested() const { return _state == LATCH_PENDING || _state == LATCH_CONFIRMED; }
+    bool pending() const { return _state == LATCH_PENDING; }
+    bool confirmed() const { return _state == LATCH_CONFIRMED; }
+    int32_t position() const { return _position; }
+    uint16_t edges() const { return _edges; }        // bordas no último acionamento
+    uint16_t rejected() const { return _rejected; }  // acionamentos descartados como ruído
+
+private:
+    volatile EndstopLatchState _state = LATCH_DISARMED;
+    volatile int32_t  _position = 0;
+    volatile uint16_t _edges = 0;
+    volatile uint16_t _rejected = 0;
+};
+
+/**
+ * @brief Homing pelo fim de curso (sem StallGuard), independente do hardware
+ *
+ * Anda em direção ao home um pulso por vez até o fim de curso. Com latch, a
+ * parada vem da ISR e o zero é a posição capturada na borda; sem latch
+ * (nullptr) o pino é lido antes de cada passo, como antes. Como a sequência
+ * sem sensor, tudo passa por uma HAL: roda também contra o simulador da
+ * bancada (rig_sim.h).
+ */
+struct EndstopHomingHal {
+    void (*step)(void* ctx);                 // um pulso em direção ao home (atualiza posição)
+    void (*delayUs)(uint32_t us, void* ctx);
+    bool (*endstopPressed)(void* ctx);       // nível atual, sem debounce
+    int32_t (*position)(void* ctx);          // posição atual (unidades do chamador)
+    bool (*abortRequested)(void* ctx);       // opcional (ex.: monitor da balança)
+    void* ctx;
+};
+
+struct EndstopHomingParams {
+    long     maxSteps;
+    uint16_t stepDelayUs;         // intervalo entre pulsos
+    uint32_t settleTimeoutUs;     // espera máxima pelo debounce (bounce contínuo)
+};
+
+enum EndstopHomingResult : uint8_t {
+    ENDSTOP_HOME_OK = 0,
+    ENDSTOP_HOME_NOT_FOUND,       // percorreu maxSteps sem acionar
+    ENDSTOP_HOME_ABORTED
+};
+
+struct EndstopHomingReport {
+    EndstopHomingResult result = ENDSTOP_HOME_NOT_FOUND;
+    long     steps = 0;           // pulsos dados
+    int32_t  homePosition = 0;    // posição que passa a ser o zero
+    uint16_t edges = 0;           // bordas no acionamento (latch)
+    uint16_t rejected = 0;        // acionamentos descartados como ruído (latch)
+};
+
+EndstopHomingReport runEndstopHoming(const EndstopHomingParams& p, const EndstopHomingHal& hal,
+                                     EndstopLatch* latch);
+const char* endstopHomingResultName(EndstopHomingResult r);
+
+#endif // ENDSTOP_HOMING_H
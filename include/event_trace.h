@@ -0,0 +1,86 @@
+#ifndef EVENT_TRACE_H
+#define EVENT_TRACE_H
+
+#include <cstdint>
+
+/**
+ * @brief Gravador de eventos em buffer circular binário (memória estática)
+ *
+ * Registra transições de estado dos grafsets, início/fim de movimentos,
+ * chegada de amostras do HX711, eventos do encoder e desenho de quadros da
+ * UI com timestamp em µs. O comando serial "trace" despeja os eventos como
+ * linhas "EVT <ts_us> <tipo> <origem> <seq> <arg>"; tools/trace_to_perfetto.py
+ * converte o log para o formato JSON do Chrome trace / Perfetto.
+ *
+ * Desabilite com -DEVENT_TRACE_ENABLED=0 para remover todo o custo.
+ */
+enum TraceEventType : uint8_t {
+    EVT_STATE_ENTER  = 1,  // origem = grafset, arg = estado
+    EVT_STATE_EXIT   = 2,
+    EVT_MOTION_START = 3,  // origem = tipo de movimento, arg = passos pedidos (com sinal)
+    EVT_MOTION_END   = 4,  // arg = posição final em passos
+    EVT_SAMPLE       = 5,  // origem = TraceSampleSource, arg = leitura bruta
+    EVT_ENCODER      = 6,  // origem = TraceEncoderEvent, arg = posição
+    EVT_UI_BEGIN     = 7,  // origem = TraceUiFrame
+    EVT_UI_END       = 8
+};
+
+enum TraceGrafset : uint8_t {
+    TRACE_GRAFSET_MOLA   = 0,
+    TRACE_GRAFSET_FADIGA = 1
+};
+
+enum TraceMotion : uint8_t {
+    TRACE_MOTION_MOVE   = 0,
+    TRACE_MOTION_HOMING = 1,
+    TRACE_MOTION_QUEUE  = 2   // arg = número de segmentos / posição final
+};
+
+enum TraceSampleSource : uint8_t {
+    TRACE_SAMPLE_HX711      = 0,
+    TRACE_SAMPLE_STALLGUARD = 1   // SG_RESULT do TMC2209
+};
+
+enum TraceEncoderEvent : uint8_t {
+    TRACE_ENC_ROTATE     = 0,
+    TRACE_ENC_CLICK      = 1,
+    TRACE_ENC_LONG_PRESS = 2
+};
+
+enum TraceUiFrame : uint8_t {
+    TRACE_UI_TEST_STATUS = 0,
+    TRACE_UI_GRAPH_POINT = 1,
+    TRACE_UI_MENU        = 2,
+    TRACE_UI_SPC         = 3
+};
+
+struct TraceEvent {
+    uint32_t tsUs;
+    uint8_t  type;
+    uint8_t  source;
+    uint16_t seq;   // contador para detectar eventos sobrescritos
+    int32_t  arg;
+};
+
+static_assert(sizeof(TraceEvent) == 12, "TraceEvent deve ter 12 bytes");
+
+#ifndef EVENT_TRACE_ENABLED
+#define EVENT_TRACE_ENABLED 1
+#endif
+
+// Eventos mantidos no buffer circular (os mais antigos são sobrescritos)
+constexpr int TRACE_EVENT_CAPACITY = 512;
+
+void traceRecord(TraceEventType type, uint8_t source, int32_t arg);
+void traceClear();
+
+// Despeja os eventos em ordem cronológica via callback, sem alocação
+void traceDump(void (*writeLine)(const char* line));
+
+#if EVENT_TRACE_ENABLED
+#define TRACE_EVENT(type, source, arg) traceRecord((type), (uint8_t)(source), (int32_t)(arg))
+#else
+#define TRACE_EVENT(type, source, arg) ((void)0)
+#endif
+
+#endif // EVENT_TRACE_H
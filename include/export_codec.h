@@ -0,0 +1,75 @@
+#ifndef EXPORT_CODEC_H
+#define EXPORT_CODEC_H
+
+#include <cstdint>
+#include <cstddef>
+#include "result_store.h"
+
+/**
+ * @brief Codificação da exportação em massa de resultados (sem Arduino)
+ *
+ * Três camadas, todas determinísticas (a retomada por offset depende disso):
+ *
+ * 1. Fluxo de registros: cada registro vira 'R', varints do cabeçalho e as
+ *    amostras como deltas zigzag/varint (passo e contagem) e delta de
+ *    tempo sem sinal. A primeira amostra é relativa ao zero de compressão e
+ *    ao offset de tara, então quase todas as amostras cabem em 4-6 bytes
+ *    em vez dos 12 brutos.
+ *
+ * 2. LZSS por bloco (estilo heatshrink): cada bloco de até
+ *    EXPORT_CHUNK_BYTES do fluxo é comprimido de forma independente (janela
+ *    zera a cada bloco), para que qualquer quadro possa ser reenviado sozinho.
+ *    Grupo = byte de controle + 8 itens; bit 1 = referência de 2 bytes
+ *    (distância 1..4096, comprimento 3..18), bit 0 = literal.
+ *
+ * 3. Quadro: A5 5A | tipo | offset u32 | len bruto u16 | len carga u16 |
+ *    carga | CRC-32 (de tipo até o fim da carga). offset = posição do bloco
+ *    no fluxo de registros; o cliente pede "EXPORT <offset>" para retomar.
+ */
+constexpr uint8_t EXPORT_FRAME_MAGIC0 = 0xA5;
+constexpr uint8_t EXPORT_FRAME_MAGIC1 = 0x5A;
+constexpr uint8_t EXPORT_RECORD_TAG   = 'R';
+
+enum ExportFrameType : uint8_t {
+    EXPORT_FRAME_STORED = 0,   // bloco sem compressão (LZ não ajudou)
+    EXPORT_FRAME_LZ     = 1,
+    EXPORT_FRAME_END    = 2    // fim do fluxo; offset = tamanho total
+};
+
+constexpr size_t EXPORT_CHUNK_BYTES     = 512;
+constexpr size_t EXPORT_FRAME_OVERHEAD  = 15;
+constexpr size_t EXPORT_FRAME_MAX_BYTES = EXPORT_CHUNK_BYTES + EXPORT_FRAME_OVERHEAD;
+
+// Pior caso do registro codificado com n amostras
+constexpr size_t exportRecordMaxBytes(int sampleCount) {
+    return 1 + 3 * 5 + 3 + 1 + RESULT_PROFILE_NAME_MAX + 5 * 4 + 2 * 5 + (size_t)sampleCount * 15;
+}
+
+// Codifica um registro no fluxo; retorna bytes escritos (0 se não couber)
+size_t exportEncodeRecord(const ResultRecordHeader& header, const CurveMeta& meta,
+                          const CurveSample* samples, uint8_t* out, size_t cap);
+
+// Bytes da mesma curva em CSV ("stepPos,rawCount,timestampUs" por amostra e
+// uma linha de resumo por registro): referência da taxa de compressão
+size_t exportCsvBytes(const ResultRecordHeader& header, const CurveSample* samples);
+
+// Índices do LZSS (buffers do chamador, sem alocação)
+struct LzWorkspace {
+    int16_t head[1024];
+    int16_t prev[EXPORT_CHUNK_BYTES];
+};
+
+// Comprime até EXPORT_CHUNK_BYTES; 0 se o resultado não for menor que a entrada
+size_t lzCompress(const uint8_t* in, size_t len, uint8_t* out, size_t cap, LzWorkspace& ws);
+
+// Retorna bytes descomprimidos (0 em fluxo inválido ou se exceder cap)
+size_t lzDecompress(const uint8_t* in, size_t len, uint8_t* out, size_t cap);
+
+// Monta um quadro com o bloco raw (LZ se ajudar); retorna o tamanho do quadro
+size_t exportBuildFrame(uint32_t offset, const uint8_t* raw, size_t rawLen,
+                        uint8_t* out, LzWorkspace& ws);
+
+// Quadro de fim do fluxo (EXPORT_FRAME_OVERHEAD bytes)
+size_t exportBuildEndFrame(uint32_t totalBytes, uint8_t* out);
+
+#endif // EXPORT_CODEC_H
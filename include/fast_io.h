@@ -0,0 +1,85 @@
+#ifndef FAST_IO_H
+#define FAST_IO_H
+
+#include <cstdint>
+#include "rig_profile.h"
+
+#ifdef ARDUINO
+#include <soc/gpio_struct.h>
+#endif
+
+/**
+ * @brief E/S digital direta por registrador, com o pino como parâmetro de template
+ *
+ * digitalWrite()/digitalRead() resolvem o pino em tempo de execução a cada
+ * chamada; no laço de passos isso limita a frequência e adiciona jitter.
+ * FastPin<Pin> escreve direto em GPIO.out_w1ts/out_w1tc (só pinos 0..31:
+ * 32..39 aqui são entradas, endstop e DIAG) e lê GPIO.in/in1: com o pino
+ * constante cada acesso vira um store/load de uma máscara fixa. A
+ * configuração (pinMode, pull-up) continua com as funções do Arduino, feita
+ * uma vez no begin().
+ *
+ * Com o perfil simulado (SimRig, -DRIG_SIM) ou fora do Arduino a mesma
+ * interface opera sobre simGpioPort: as saídas ficam em `out` e chamam o
+ * gancho onWrite (o simulador da bancada move o eixo a cada borda de STEP),
+ * e as leituras vêm de `in`, que o simulador controla.
+ */
+struct SimGpioPort {
+    volatile uint64_t out = 0;             // nível das saídas (bit = pino)
+    volatile uint64_t in  = ~0ULL;         // nível das entradas (repouso alto: pull-up)
+    void (*onWrite)(int pin, bool level, void* ctx) = nullptr;
+    void* ctx = nullptr;
+};
+extern SimGpioPort simGpioPort;
+
+#ifdef ARDUINO
+constexpr bool FAST_IO_SIMULATED = ActiveRig::SIMULATED;
+#else
+constexpr bool FAST_IO_SIMULATED = true;
+#endif
+
+template <int Pin, bool Simulated = FAST_IO_SIMULATED>
+struct FastPin;
+
+// Porta simulada (SimRig / host)
+template <int Pin>
+struct FastPin<Pin, true> {
+    static_assert(Pin >= 0 && Pin < 64, "pino fora da porta simulada");
+    static constexpr uint64_t MASK = 1ULL << Pin;
+
+    static inline void high() {
+        simGpioPort.out = simGpioPort.out | MASK;
+        if (simGpioPort.onWrite) simGpioPort.onWrite(Pin, true, simGpioPort.ctx);
+    }
+    static inline void low() {
+        simGpioPort.out = simGpioPort.out & ~MASK;
+        if (simGpioPort.onWrite) simGpioPort.onWrite(Pin, false, simGpioPort.ctx);
+    }
+    static inline void write(bool level) { level ? high() : low(); }
+    static inline bool read() { return (simGpioPort.in & MASK) != 0; }
+};
+
+#ifdef ARDUINO
+// ESP32: registradores de set/clear (sem read-modify-write, seguro contra ISR)
+template <int Pin>
+struct FastPin<Pin, false> {
+    static_assert(Pin >= 0 && Pin < 40, "GPIO inexistente no ESP32");
+    static constexpr uint32_t MASK = 1UL << (Pin & 31);
+
+    // Saída só pelo banco 0; o static_assert só dispara se o pino for escrito
+    static inline void high() {
+        static_assert(Pin < 32, "FastPin escreve só em GPIO 0..31 (out_w1ts)");
+        GPIO.out_w1ts = MASK;
+    }
+    static inline void low() {
+        static_assert(Pin < 32, "FastPin escreve só em GPIO 0..31 (out_w1tc)");
+        GPIO.out_w1tc = MASK;
+    }
+    static inline void write(bool level) { level ? high() : low(); }
+    static inline bool read() {
+        return ((Pin < 32) ? GPIO.in : GPIO.in1.val) & MASK;
+    }
+};
+#endif
+
+#endif // FAST_IO_H
@@ -0,0 +1,63 @@
+#ifndef FATIGUE_STROKE_H
+#define FATIGUE_STROKE_H
+
+#include <cstdint>
+#include "motion_queue.h"
+#include "cycle_stats.h"
+
+/**
+ * @brief Fila de UM ciclo de fadiga: descida amostrada e retorno ao zero
+ *
+ * Cada ponto da descida (FATIGUE_SAMPLE_STEP_MM) é um segmento
+ * SEG_ACTION_SAMPLE: o carro não para, os segmentos se combinam no
+ * look-ahead e o callback só pega a conversão do HX711 se houver uma nova
+ * (a 10 SPS sai ~1 ponto em 4; a 80 SPS quase todos). tag = índice do ponto.
+ * Unidades em unitsPerMm (StepperManager::getStepsPerMm()).
+ * @return número de pontos da descida (incluindo o zero, que só descarta)
+ */
+int buildFatigueStroke(MotionQueue& q, long zeroUnits, float unitsPerMm, uint16_t usDelay);
+
+// Compressão (mm) do ponto de amostra tag
+float fatigueStrokePointMm(uint16_t tag);
+
+/**
+ * @brief Um ciclo de fadiga, do lado do callback de segmento (sem bloqueio)
+ *
+ * onPoint() recebe cada ponto com fresh = havia conversão nova do HX711;
+ * sem conversão o ponto fica de fora. No ponto 0 a conversão pendente é do
+ * retorno do ciclo anterior: o chamador lê (limpa o HX711) e ela é
+ * descartada; sampled() diz se o último ponto entrou no ciclo. endCycle()
+ * aceita o ciclo no resumo se juntou minSamples pontos; só rejeições
+ * SEGUIDAS acima de maxConsecutiveRejects param o teste (HX711 parado),
+ * rejeições esparsas numa ciclagem de horas apenas somam em rejected().
+ */
+enum FatigueCycleOutcome : uint8_t {
+    FATIGUE_CYCLE_ACCEPTED = 0,
+    FATIGUE_CYCLE_REJECTED,
+    FATIGUE_CYCLE_HX711_LOST   // rejeições seguidas demais: interrompe
+};
+
+class FatigueCycleGate {
+public:
+    void begin(int minSamples, uint32_t maxConsecutiveRejects);
+
+    // Um ponto da descida; false se a força passou de maxForceKg (aborta)
+    bool onPoint(CycleAccumulator& cycle, uint16_t tag, bool fresh, float forceKg, float maxForceKg);
+
+    FatigueCycleOutcome endCycle(const CycleAccumulator& cycle, FatigueSummary& summary);
+
+    uint32_t rejected() const { return _rejected; }
+    uint32_t consecutiveRejects() const { return _consecutive; }
+    uint32_t missedPoints() const { return _missed; }
+    bool sampled() const { return _sampled; }
+
+private:
+    int      _minSamples = 0;
+    uint32_t _maxConsecutive = 0;
+    uint32_t _rejected = 0;
+    uint32_t _consecutive = 0;
+    uint32_t _missed = 0;
+    bool     _sampled = false;
+};
+
+#endif // FATIGUE_STROKE_H
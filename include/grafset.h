@@ -37,10 +37,25 @@ public:
      */
     virtual void reset() {
         finished = false;
+        cancelPending = false;
     }
 
+    /**
+     * @brief Pede o cancelamento (comando remoto ABORT)
+     * Atendido nos mesmos pontos que aceitam long press do encoder
+     */
+    void requestCancel() { cancelPending = true; }
+
 protected:
     bool finished;  // Flag indicando conclusão da operação
+    bool cancelPending = false;
+
+    // Consome um pedido de cancelamento remoto pendente
+    bool takeCancelRequest() {
+        bool pending = cancelPending;
+        cancelPending = false;
+        return pending;
+    }
 };
 
 #endif // GRAFSET_H
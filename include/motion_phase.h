@@ -0,0 +1,59 @@
+#ifndef MOTION_PHASE_H
+#define MOTION_PHASE_H
+
+#include <cstdint>
+#include "config.h"
+
+// Fase de movimento: define microsteps/corrente/modo do TMC2209 (ver config.h)
+enum MotionPhase {
+    MOTION_PHASE_NONE = -1,
+    MOTION_PHASE_TRAVEL = 0,
+    MOTION_PHASE_HOMING,
+    MOTION_PHASE_MEASURE
+};
+
+const MotionPhaseConfig& motionPhaseConfig(MotionPhase phase);
+
+// Acesso ao driver (TMC2209Manager no firmware, mock nos testes)
+struct MotionPhaseDriverHal {
+    void (*setMicrosteps)(uint16_t microsteps, void* ctx);       // CHOPCONF.MRES
+    void (*setCurrent)(uint16_t runMa, uint16_t holdMa, void* ctx); // IHOLD_IRUN (+ VSENSE)
+    void (*enableStealthChop)(bool enable, void* ctx);           // GCONF.en_SpreadCycle
+    bool (*waitFlushed)(uint32_t timeoutMs, void* ctx);          // escritas chegaram ao driver
+    void* ctx;
+};
+
+// Estado do eixo que depende da fase (posição sempre em 1/TMC_FINE_MICROSTEPS)
+struct MotionPhaseAxis {
+    long     pulseIncrement = 1;   // unidades de posição por pulso STEP
+    uint16_t microsteps = TMC_DEFAULT_MICROSTEPS;
+    uint8_t  speedPct = 100;
+    bool     stealthChop = true;
+};
+
+/**
+ * @brief Aplica a configuração de uma fase ao driver e ao eixo
+ *
+ * Sequência: MRES, corrente de run/hold e modo de chopper só mudam as
+ * cópias locais do driver; waitFlushed() segura até todas as escritas
+ * chegarem pela UART, porque o próximo pulso já precisa da nova resolução.
+ * Só então o eixo passa a avançar TMC_FINE_MICROSTEPS/microsteps unidades
+ * por pulso. O eixo é atualizado mesmo sem confirmação (aviso do chamador).
+ * @return false se o driver não confirmou as escritas em TMC_FLUSH_TIMEOUT_MS
+ */
+bool applyMotionPhase(const MotionPhaseDriverHal& hal, const MotionPhaseConfig& cfg,
+                      MotionPhaseAxis& axis);
+
+// Posição em passos do perfil (1/TMC_DEFAULT_MICROSTEPS) -> unidades finas
+long motionPhaseFineUnits(long coarseUnits);
+
+/**
+ * @brief Intervalo após cada pulso para manter a velocidade pedida em mm/s
+ *
+ * usDelay + STEP_PULSE_US é o período de um passo de 1/TMC_DEFAULT_MICROSTEPS;
+ * com pulseIncrement unidades finas por pulso o período escala na mesma
+ * razão e speedPct acelera (>100) ou freia a fase.
+ */
+uint32_t motionPhasePulseDelayUs(uint16_t usDelay, const MotionPhaseAxis& axis);
+
+#endif // MOTION_PHASE_H
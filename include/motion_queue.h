@@ -0,0 +1,68 @@
+#ifndef MOTION_QUEUE_H
+#define MOTION_QUEUE_H
+
+#include <cstdint>
+
+/**
+ * @brief Ação executada ao fim de um segmento da fila de movimento
+ *
+ * SEG_ACTION_SAMPLE chama o callback sem parar o carro (o callback deve ser
+ * rápido, ex.: peekWeightKgFast); SEG_ACTION_DWELL para, aguarda dwellMs e
+ * então chama o callback.
+ */
+enum SegmentAction : uint8_t {
+    SEG_ACTION_NONE = 0,
+    SEG_ACTION_SAMPLE,
+    SEG_ACTION_DWELL
+};
+
+struct MotionSegment {
+    // Pedido
+    long          target;     // posição final (unidades de StepperManager::getStepsPerMm())
+    uint16_t      usDelay;    // velocidade de cruzeiro (mesma semântica de moveSteps)
+    SegmentAction action;
+    uint16_t      dwellMs;
+    uint16_t      tag;        // livre para o chamador (ex.: índice da amostra)
+
+    // Planejado (em pulsos da fase atual)
+    long     pulses;
+    int8_t   dir;             // +1 FORWARD, -1 BACKWARD, 0 parado
+    float    cruisePps;
+    float    entryPps;
+    float    exitPps;
+};
+
+constexpr int MOTION_QUEUE_CAPACITY = 64;
+
+/**
+ * @brief Fila de segmentos com planejamento look-ahead (perfil trapezoidal)
+ *
+ * plan() percorre a fila para trás e para frente (como em planejadores de
+ * CNC): entre segmentos no mesmo sentido e sem dwell a velocidade de junção
+ * é a menor das duas velocidades de cruzeiro, limitada pelo que a
+ * aceleração permite frear até o próximo ponto de parada; reversões e
+ * dwells forçam a velocidade inicial (minPps). Sem alocação dinâmica.
+ */
+class MotionQueue {
+public:
+    void clear() { _count = 0; }
+    bool push(long target, uint16_t usDelay,
+              SegmentAction action = SEG_ACTION_NONE, uint16_t dwellMs = 0, uint16_t tag = 0);
+
+    // cruisePpsOf converte usDelay em pulsos/s na fase atual
+    void plan(long startPos, long unitsPerPulse, float accelPps2, float minPps,
+              float (*cruisePpsOf)(uint16_t usDelay, void* ctx), void* ctx);
+
+    int size() const { return _count; }
+    bool full() const { return _count >= MOTION_QUEUE_CAPACITY; }
+    const MotionSegment& operator[](int i) const { return _segments[i]; }
+
+private:
+    MotionSegment _segments[MOTION_QUEUE_CAPACITY];
+    int _count = 0;
+};
+
+// Velocidade (pulsos/s) no pulso k (0..pulses-1) de um segmento planejado
+float segmentRateAt(const MotionSegment& seg, long k, float accelPps2);
+
+#endif // MOTION_QUEUE_H
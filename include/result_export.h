@@ -0,0 +1,61 @@
+#ifndef RESULT_EXPORT_H
+#define RESULT_EXPORT_H
+
+#include <cstdint>
+#include <cstddef>
+#include "export_codec.h"
+#include "config.h"
+
+/**
+ * @brief Exportação em massa do registro de resultados pela Serial
+ *
+ * Não bloqueante: service() é chamado a cada volta do loop e só escreve o
+ * que cabe no buffer de transmissão (Serial.availableForWrite()); o quadro
+ * seguinte é montado quando o atual termina de sair. Formato e retomada em
+ * export_codec.h. Ao final envia o quadro de fim e uma linha
+ * "OK EXPORT done ..." com bytes CSV equivalentes, bytes no fio e duração.
+ */
+class ResultExporter {
+public:
+    // Inicia (ou retoma) a partir de offset do fluxo de registros
+    bool begin(uint32_t offset);
+    void abort();
+    bool active() const { return _active; }
+
+    void service();
+
+private:
+    bool _active = false;
+    bool _endQueued = false;
+
+    // Leitura do registro e codificação
+    uint32_t _cursor = 0;           // offset no arquivo do próximo registro
+    uint32_t _streamPos = 0;        // bytes do fluxo de registros já gerados
+    uint32_t _resumeOffset = 0;
+    uint8_t  _rec[exportRecordMaxBytes(SPRING_SAMPLE_CAPACITY)];
+    size_t   _recLen = 0;
+    size_t   _recPos = 0;
+    CurveSample _samples[SPRING_SAMPLE_CAPACITY];
+
+    // Bloco atual e quadro em transmissão
+    uint8_t  _chunk[EXPORT_CHUNK_BYTES];
+    uint8_t  _frame[EXPORT_FRAME_MAX_BYTES];
+    size_t   _frameLen = 0;
+    size_t   _framePos = 0;
+    LzWorkspace _lz;
+
+    // Estatísticas para o relatório final
+    uint32_t _records = 0;
+    uint32_t _samplesOut = 0;
+    uint32_t _csvBytes = 0;
+    uint32_t _wireBytes = 0;
+    uint32_t _startMs = 0;
+
+    bool loadNextRecord();
+    void buildNextFrame();
+    void report();
+};
+
+extern ResultExporter resultExporter;
+
+#endif // RESULT_EXPORT_H
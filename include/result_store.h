@@ -0,0 +1,89 @@
+#ifndef RESULT_STORE_H
+#define RESULT_STORE_H
+
+#include <cstdint>
+#include <cstddef>
+#include "sample_arena.h"
+#include "curve_codec.h"
+
+constexpr uint32_t RESULT_RECORD_MAGIC   = 0x52534C54;   // "TLSR" em little-endian
+constexpr uint16_t RESULT_RECORD_VERSION = 2;   // 2: curva em curve_codec
+constexpr int      RESULT_PROFILE_NAME_MAX = 15;
+
+// Veredito gravado (ResultRecordHeader::verdict)
+enum StoredVerdict : uint8_t {
+    STORED_VERDICT_NO_LIMITS = 0,
+    STORED_VERDICT_PASS,
+    STORED_VERDICT_FAIL,
+    STORED_VERDICT_INVALID      // passos perdidos: eixo não confiável
+};
+
+constexpr uint8_t RESULT_FLAG_EARLY_REJECT = 0x01;
+
+/**
+ * @brief Cabeçalho de um registro de teste gravado na flash
+ *
+ * Seguido de curveBytes de blob de curva (curve_codec.h), que leva a
+ * calibração (steps/mm, offset de tara, fator, passo do zero) e os tempos.
+ * Sem RTC: uptimeMs é o millis() da gravação; seq ordena os registros entre
+ * reinícios.
+ */
+struct ResultRecordHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t sampleCount;
+    uint32_t seq;
+    uint32_t uptimeMs;
+    float    kKgfMm;
+    float    r2;
+    float    maxForceKg;
+    uint8_t  verdict;         // StoredVerdict
+    uint8_t  reason;          // VerdictReason
+    uint8_t  flags;           // RESULT_FLAG_*
+    uint8_t  reserved;
+    char     profile[RESULT_PROFILE_NAME_MAX + 1];
+    uint32_t curveBytes;
+    uint32_t curveCrc;        // CRC-32 do blob (detecta gravação interrompida)
+};
+
+static_assert(sizeof(ResultRecordHeader) == 56, "ResultRecordHeader deve ter 56 bytes");
+
+/**
+ * @brief Registro de resultados em arquivo único no LittleFS (só acrescenta)
+ *
+ * begin() monta o sistema de arquivos, percorre os cabeçalhos para achar o
+ * próximo seq e descarta uma cauda incompleta (queda de energia durante a
+ * gravação). append() recusa quando o arquivo passaria de
+ * RESULT_STORE_MAX_BYTES: exporte e limpe com "STORE CLEAR". Um arquivo de
+ * versão anterior é renomeado para /results_old.bin em vez de descartado.
+ */
+class ResultStore {
+public:
+    bool begin();
+    bool isMounted() const { return _mounted; }
+
+    // Codifica a curva, preenche magic/version/seq/curveBytes/curveCrc e grava
+    bool append(ResultRecordHeader& header, const CurveMeta& meta,
+                const CurveSample* samples, int count);
+
+    // Leitura sequencial a partir de *cursor (0 = início); avança o cursor.
+    // false no fim do arquivo ou se o registro não couber em maxSamples
+    bool readNext(uint32_t* cursor, ResultRecordHeader* header, CurveMeta* meta,
+                  CurveSample* samples, int maxSamples) const;
+
+    void clear();
+
+    uint32_t recordCount() const { return _records; }
+    uint32_t bytesUsed() const { return _bytes; }
+    uint32_t nextSeq() const { return _nextSeq; }
+
+private:
+    bool     _mounted = false;
+    uint32_t _records = 0;
+    uint32_t _bytes = 0;
+    uint32_t _nextSeq = 1;
+};
+
+extern ResultStore resultStore;
+
+#endif // RESULT_STORE_H
@@ -0,0 +1,121 @@
+#ifndef RIG_PROFILE_H
+#define RIG_PROFILE_H
+
+#include <cstdint>
+
+/**
+ * @brief Perfis de hardware da bancada, resolvidos em tempo de compilação
+ *
+ * RigPins fixa o mapa de pinos; RigProfile junta pinos, microsteps do
+ * driver, passos/volta do motor, passo do fuso (µm) e capacidade da célula.
+ * Tudo é constexpr: a conversão mm <-> passos vira multiplicação por
+ * constante inteira (static_assert exige passos/mm inteiro), e os pinos
+ * podem ser parâmetros de template (ex.: escrita direta em registrador).
+ *
+ * A revisão é escolhida por flag de build (platformio.ini):
+ *   (padrão)      RigRevA  - placa original, fuso 1 mm, 1/8, célula 10 kg
+ *   -DRIG_REV_B   RigRevB  - fuso TR8x2 com 1/16 nativo, célula 20 kg
+ *                            (valores de projeto: exige -DRIG_REV_B_MEASURED)
+ *   -DRIG_SIM     SimRig   - simulação no host (sem GPIO real)
+ * config.h expõe ActiveRig com os nomes de sempre (STEP_PIN, ...).
+ */
+template <int Step, int Dir, int En, int Endstop,
+          int LoadcellDout, int LoadcellSck,
+          int TmcTx, int TmcRx, int TmcDiag,
+          int EncClk, int EncDt, int EncSw, int Backlight>
+struct RigPins {
+    static constexpr int STEP_PIN          = Step;
+    static constexpr int DIR_PIN           = Dir;
+    static constexpr int EN_PIN            = En;
+    static constexpr int ENDSTOP_PIN       = Endstop;
+    static constexpr int LOADCELL_DOUT_PIN = LoadcellDout;
+    static constexpr int LOADCELL_SCK_PIN  = LoadcellSck;
+    static constexpr int TMC_UART_TX_PIN   = TmcTx;
+    static constexpr int TMC_UART_RX_PIN   = TmcRx;
+    static constexpr int TMC_DIAG_PIN      = TmcDiag;
+    static constexpr int ENC_CLK_PIN       = EncClk;
+    static constexpr int ENC_DT_PIN        = EncDt;
+    static constexpr int ENC_SW_PIN        = EncSw;
+    static constexpr int BL_PIN            = Backlight;
+};
+
+template <class Pins, uint16_t Microsteps, uint16_t FullStepsPerRev,
+          uint32_t LeadUm, uint16_t CapacityKg, bool Simulated = false>
+struct RigProfile : Pins {
+    static constexpr uint16_t MICROSTEPS          = Microsteps;
+    static constexpr uint16_t FULL_STEPS_PER_REV  = FullStepsPerRev;
+    static constexpr uint32_t LEAD_UM             = LeadUm;
+    static constexpr uint16_t LOADCELL_CAPACITY_KG = CapacityKg;
+    static constexpr bool     SIMULATED           = Simulated;
+
+    static constexpr uint32_t STEPS_PER_REV = (uint32_t)FullStepsPerRev * Microsteps;
+    static_assert((STEPS_PER_REV * 1000UL) % LeadUm == 0,
+                  "passos/mm deve ser inteiro (conversões exatas em inteiros)");
+    static constexpr int32_t STEPS_PER_MM = (int32_t)(STEPS_PER_REV * 1000UL / LeadUm);
+};
+
+/**
+ * @brief Conversões do eixo numa unidade de posição (1/UnitMicrosteps)
+ *
+ * Com a troca de fase do TMC2209 a posição é contada em 1/TMC_FINE_MICROSTEPS;
+ * sem ela, em 1/MICROSTEPS do perfil. Uma instância por unidade, tudo
+ * constexpr: o compilador reduz as conversões a multiplicações.
+ */
+template <class Rig, uint16_t UnitMicrosteps>
+struct AxisScale {
+    static_assert(UnitMicrosteps % Rig::MICROSTEPS == 0,
+                  "unidade de posição deve ser múltipla do microstep do perfil");
+    static constexpr int32_t UNITS_PER_MM = Rig::STEPS_PER_MM * (UnitMicrosteps / Rig::MICROSTEPS);
+
+    static constexpr int32_t umToUnits(int32_t um) {
+        // Arredonda para o mais próximo (divisão por constante)
+        return (int32_t)(((int64_t)um * UNITS_PER_MM + (um >= 0 ? 500 : -500)) / 1000);
+    }
+    static constexpr int32_t unitsToUm(int32_t units) {
+        return (int32_t)(((int64_t)units * 1000 + (units >= 0 ? UNITS_PER_MM / 2 : -UNITS_PER_MM / 2))
+                         / UNITS_PER_MM);
+    }
+    static constexpr float unitsToMm(int32_t units) {
+        return (float)units * (1.0f / (float)UNITS_PER_MM);
+    }
+    // mm de config/comando: arredonda para µm e converte em inteiros, como
+    // umToUnits (o float não entra na contagem de passos)
+    static constexpr int32_t mmToUm(float mm) {
+        return (int32_t)(mm * 1000.0f + (mm >= 0.0f ? 0.5f : -0.5f));
+    }
+    static constexpr int32_t mmToUnits(float mm) {
+        return umToUnits(mmToUm(mm));
+    }
+};
+
+// ==== REVISÕES ====
+//                     STEP DIR EN END  HX_DOUT HX_SCK  TMC_TX TMC_RX DIAG  ENC_CLK DT  SW  BL
+using RigPinsRevA = RigPins<25, 26, 27, 33,   34,     16,     22,    35,    32,   13,    14, 17, 21>;
+
+// Rev A: NEMA11 200 passos/volta, 1/8 (MS flutuando), fuso 1 mm -> 1600 passos/mm
+using RigRevA = RigProfile<RigPinsRevA, 8, 200, 1000, 10>;
+
+// Rev B: mesmo mapa de pinos, fuso TR8x2 (2 mm/volta) com 1/16 amarrado
+// (1600 passos/mm) e célula de 20 kg. Valores do projeto, ainda não
+// conferidos na bancada (passo do fuso com relógio comparador, MS1/MS2 na
+// placa, capacidade da célula): selecionável com RIG_REV_B_MEASURED ou,
+// só para compilar (env:esp32dev_revb), com RIG_REV_B_PLACEHOLDER
+using RigRevB = RigProfile<RigPinsRevA, 16, 200, 2000, 20>;
+
+// Simulação no host: mecânica da rev A, GPIO simulado
+using SimRig = RigProfile<RigPinsRevA, 8, 200, 1000, 10, true>;
+
+#if defined(RIG_REV_B)
+#if defined(RIG_REV_B_PLACEHOLDER) && !defined(RIG_REV_B_MEASURED)
+#warning "RigRevB com valores de projeto (RIG_REV_B_PLACEHOLDER): não usar em ensaio antes de medir na bancada"
+#elif !defined(RIG_REV_B_MEASURED)
+#error "RigRevB ainda não foi medido na bancada: confira fuso, microstep e célula e compile com -DRIG_REV_B_MEASURED"
+#endif
+using ActiveRig = RigRevB;
+#elif defined(RIG_SIM)
+using ActiveRig = SimRig;
+#else
+using ActiveRig = RigRevA;
+#endif
+
+#endif // RIG_PROFILE_H
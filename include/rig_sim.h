@@ -0,0 +1,99 @@
+#ifndef RIG_SIM_H
+#define RIG_SIM_H
+
+#include <cstdint>
+#include "motion_queue.h"
+#include "config.h"
+
+// Modelo do micro switch de home (tempos em µs do relógio simulado)
+struct RigSimConfig {
+    float    tripJitterUm;   // repetibilidade mecânica do switch (desvio padrão)
+    uint32_t bounceUs;       // duração do bounce após o contato (0 = sem bounce)
+    uint32_t bounceEdgeUs;   // intervalo médio entre bordas no bounce
+    float    glitchPerS;     // pulsos de ruído (EMI) por segundo antes do contato
+    uint32_t glitchUs;       // largura de cada pulso de ruído
+    uint16_t stepDelayUs;    // intervalo entre pulsos do homing
+    float    startMm;        // distância inicial até o switch
+    uint32_t seed;
+};
+
+struct HomeRepeatability {
+    uint16_t runs = 0;
+    uint16_t notFound = 0;     // homing sem acionamento
+    uint16_t falseHomes = 0;   // zero antes do contato real (ruído aceito)
+    float    meanUm = 0.0f;    // erro do zero em relação ao switch nominal
+    float    stdUm = 0.0f;     // repetibilidade (desvio padrão)
+    float    spanUm = 0.0f;    // máximo - mínimo
+    float    meanEdges = 0.0f; // bordas por acionamento (latch)
+};
+
+/**
+ * @brief Simulador da bancada para o homing pelo fim de curso (sem Arduino)
+ *
+ * Roda runEndstopHoming() (a mesma sequência do firmware) contra um eixo e
+ * um micro switch simulados: os pulsos saem por FastPin na porta simulada
+ * (simGpioPort), o switch aciona num ponto com espalhamento mecânico, com
+ * bounce e ruído configuráveis, e o relógio só anda nas esperas da HAL.
+ * Com latch as bordas chegam como na ISR (posição do instante da borda) e
+ * o debounce é um temporizador simulado de ENDSTOP_DEBOUNCE_US; sem latch o
+ * pino é lido antes de cada passo. O zero de cada repetição é comparado ao
+ * switch nominal: o desvio padrão é a repetibilidade do home.
+ */
+HomeRepeatability rigSimHomeRepeatability(const RigSimConfig& cfg, uint16_t runs, bool useLatch);
+
+// Ciclagem de fadiga simulada: mola linear e HX711 convertendo em taxa fixa
+struct RigSimFatigueConfig {
+    float    kKgfMm;          // K da mola no primeiro ciclo
+    float    kDriftPct;       // variação de K (%) a cada 10000 ciclos
+    float    noiseKg;         // ruído de cada conversão (desvio padrão)
+    float    sps;             // taxa do HX711 (10 ou 80)
+    uint32_t missEvery;       // a cada N ciclos um ciclo sem conversões (0 = nunca)
+    uint32_t hx711StopCycle;  // a partir deste ciclo o HX711 para (0 = nunca)
+    bool     blockingPoints;  // modo antigo: para em cada ponto e espera a conversão
+    uint32_t seed;
+};
+
+struct FatigueSoakReport {
+    uint32_t cycles = 0;          // ciclos aceitos no resumo
+    uint32_t rejected = 0;
+    bool     hx711Lost = false;   // rejeições seguidas interromperam a ciclagem
+    float    cycleMs = 0.0f;      // duração média de um ciclo
+    float    samplesPerCycle = 0.0f;
+    float    meanK = 0.0f, stdK = 0.0f, firstK = 0.0f, lastK = 0.0f, driftPct = 0.0f;
+    int      storedCurves = 0;
+};
+
+/**
+ * @brief Ciclagem de fadiga no simulador (sem Arduino)
+ *
+ * Cada ciclo monta a fila com buildFatigueStroke() (a mesma do firmware, em
+ * unidades de 1/16 da fase de medição), planeja com MotionQueue::plan() e
+ * executa os trapézios num relógio simulado. As conversões do HX711 saem em
+ * taxa fixa com a força da posição do instante da conversão; o callback de
+ * cada ponto passa por FatigueCycleGate, FatigueSummary e CurveLog como no
+ * TestFadigaGrafset. Memória fixa: nada é alocado durante a ciclagem.
+ */
+FatigueSoakReport rigSimFatigueSoak(const RigSimFatigueConfig& cfg, uint32_t cycles);
+
+// Duração (µs) de um segmento planejado pelo modelo contínuo do simulador
+float rigSimSegmentUs(const MotionSegment& seg, float accelPps2);
+
+// Um deslocamento (parado a parado) numa fase de movimento
+struct PhaseMoveReport {
+    uint32_t pulses = 0;
+    float    travelMs = 0.0f;
+    float    cruiseMmS = 0.0f;
+    float    resolutionUm = 0.0f;    // deslocamento por pulso STEP
+    float    targetErrorUm = 0.0f;   // alvo que não cai num pulso inteiro
+};
+
+/**
+ * @brief Tempo e resolução de um deslocamento numa fase (sem Arduino)
+ *
+ * Aplica cfg com applyMotionPhase() (driver simulado), planeja o movimento
+ * de 0 a distanceMm como runMotionQueue() (aceleração e partida em mm/s
+ * convertidas para pulsos da fase) e mede o trapézio com rigSimSegmentUs().
+ */
+PhaseMoveReport rigSimPhaseMove(const MotionPhaseConfig& cfg, float distanceMm, uint16_t usDelay);
+
+#endif // RIG_SIM_H
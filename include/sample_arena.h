@@ -0,0 +1,80 @@
+#ifndef SAMPLE_ARENA_H
+#define SAMPLE_ARENA_H
+
+#include <cstdint>
+
+/**
+ * @brief Amostra bruta de uma curva de teste (12 bytes)
+ *
+ * Guarda apenas grandezas inteiras do hardware; a conversão para mm/kg é
+ * feita na análise com steps/mm, offset de tara e fator de calibração.
+ */
+struct CurveSample {
+    int32_t  stepPos;      // posição do motor em passos
+    int32_t  rawCount;     // leitura bruta do HX711 (contagens)
+    uint32_t timestampUs;  // micros() no momento da leitura
+};
+
+static_assert(sizeof(CurveSample) == 12, "CurveSample deve ter 12 bytes");
+
+/**
+ * @brief Arena estática de amostras com capacidade fixa em tempo de compilação
+ *
+ * Nunca usa heap. Quando cheia, descarta uma amostra a cada duas (mantendo
+ * a primeira) e passa a aceitar só 1 de cada 2^k amostras oferecidas, de
+ * modo que testes longos continuam cobrindo todo o curso com resolução
+ * uniforme.
+ */
+template <int Capacity>
+class SampleArena {
+    static_assert(Capacity >= 2, "Capacidade minima: 2 amostras");
+
+public:
+    void clear() {
+        _size = 0;
+        _stride = 1;
+        _offered = 0;
+    }
+
+    // Retorna true se a amostra foi armazenada (false se descartada pela decimação)
+    bool push(const CurveSample& s) {
+        if ((_offered++ % _stride) != 0) {
+            return false;
+        }
+        if (_size >= Capacity) {
+            decimate();
+            // Após dobrar o passo, a amostra atual só entra se cair no novo grid
+            if (((_offered - 1) % _stride) != 0) {
+                return false;
+            }
+        }
+        _samples[_size++] = s;
+        return true;
+    }
+
+    int size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    static constexpr int capacity() { return Capacity; }
+    uint32_t stride() const { return _stride; }
+
+    const CurveSample& operator[](int i) const { return _samples[i]; }
+    const CurveSample* data() const { return _samples; }
+    const CurveSample& back() const { return _samples[_size - 1]; }
+
+private:
+    CurveSample _samples[Capacity];
+    int      _size = 0;
+    uint32_t _stride = 1;    // aceita 1 de cada _stride amostras oferecidas
+    uint32_t _offered = 0;
+
+    void decimate() {
+        int w = 0;
+        for (int r = 0; r < _size; r += 2) {
+            _samples[w++] = _samples[r];
+        }
+        _size = w;
+        _stride *= 2;
+    }
+};
+
+#endif // SAMPLE_ARENA_H
@@ -3,11 +3,24 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "zero_tracker.h"
+#include "tare_estimator.h"
 
 class ScaleManager {
 public:
     void begin();
-    void tare(uint8_t times = 10);
+    // Igual a begin(), mas a tara roda numa tarefa FreeRTOS (core 0) enquanto
+    // o setup continua; até tareReady() o update() não lê o HX711
+    void beginAsync();
+    bool tareReady() const { return _tareReady; }
+    // Bloqueia até a tara de boot liberar o HX711. A tarefa sempre termina:
+    // no máximo TARE_MAX_SAMPLES esperas de SCALE_READ_TIMEOUT_MS
+    void waitTareReady();
+    // Tara com parada estatística; offset só muda se houve leituras.
+    // zeroReference: plataforma livre (boot, menu); só essa tara alimenta o
+    // rastreamento do zero (a de um teste inclui mola e fixação)
+    const TareResult& tare(bool zeroReference = false);
+    const TareResult& lastTare() const { return _tare.result(); }
     void update();
 
     float getWeightKg() const;
@@ -30,10 +43,40 @@ public:
     long getRawReading();
     long getRawReadingAbsolute();
 
+    // Uma conversão (espera o HX711 até SCALE_READ_TIMEOUT_MS); false se não respondeu
+    bool readRaw(long* raw);
+
+    // Última média bruta obtida em update() (sem nova conversão no HX711)
+    long getLastRaw() const;
+
+    // Offset de tara atual e conversão contagens -> kg
+    long getOffset() const;
+    float rawToKg(long raw) const;
+
+    // Rastreamento do zero: com a balança ociosa update() observa e, quando a
+    // medida mostra a célula livre e estável, atualiza o offset. Congelado
+    // (teste rodando) o offset fica o da tara do teste
+    void setZeroFrozen(bool frozen) { _zeroFrozen = frozen; }
+    const ZeroTracker& zeroTracker() const { return _zero; }
+    float temperatureC();   // NaN sem fonte de temperatura
+
 private:
     float _calibFactor = SCALE_CALIB_DEFAULT;
     float _currentKg   = 0.0f;
     long  _lastRaw     = 0;
+
+    TareEstimator _tare;
+    ZeroTracker _zero;
+    bool     _zeroFrozen = true;
+    float    _tempC     = 0.0f;
+    uint32_t _tempMs    = 0;
+    bool     _tempValid = false;
+    volatile bool _tareReady = false;
+
+    void setupHardware();
+    const TareResult& runTare(bool zeroReference);
+    void trackZero(long raw);
+    static void tareTaskEntry(void* arg);
 };
 
 extern ScaleManager scaleManager;
@@ -0,0 +1,53 @@
+#ifndef SENSORLESS_HOMING_H
+#define SENSORLESS_HOMING_H
+
+#include <cstdint>
+
+/**
+ * @brief Sequência de homing sem sensor (StallGuard do TMC2209)
+ *
+ * 1. Aproximação rápida em direção ao home até o DIAG indicar stall
+ *    (os primeiros passos são ignorados enquanto o StallGuard estabiliza);
+ * 2. Recuo curto;
+ * 3. Reaproximação lenta até novo stall;
+ * 4. O fim de curso serve apenas de verificação: o zero só é aceito se o
+ *    micro switch estiver acionado no ponto de parada.
+ *
+ * A lógica não acessa hardware diretamente: tudo passa por HomingHal, de modo
+ * que pode rodar contra um modelo simulado do driver fora do ESP32.
+ */
+struct HomingHal {
+    void (*setDirection)(bool towardHome, void* ctx);
+    void (*step)(void* ctx);                 // um pulso STEP (atualiza posição)
+    void (*delayUs)(uint32_t us, void* ctx);
+    bool (*stallActive)(void* ctx);          // DIAG do TMC2209
+    bool (*endstopPressed)(void* ctx);
+    bool (*abortRequested)(void* ctx);       // opcional (ex.: monitor da balança)
+    void* ctx;
+};
+
+struct SensorlessHomingParams {
+    long     maxSteps;        // limite da aproximação rápida
+    long     backoffSteps;    // recuo entre as aproximações
+    long     blankSteps;      // passos iniciais em que o DIAG é ignorado
+    uint16_t fastDelayUs;
+    uint16_t slowDelayUs;
+};
+
+enum HomingResult : uint8_t {
+    HOMING_OK = 0,
+    HOMING_NO_CONTACT,            // percorreu maxSteps sem stall nem fim de curso
+    HOMING_STALL_WITHOUT_ENDSTOP, // stall fora do home (travamento ou falso positivo)
+    HOMING_ABORTED                // abortRequested() retornou true
+};
+
+struct HomingReport {
+    HomingResult result = HOMING_NO_CONTACT;
+    long fastSteps = 0;   // passos na aproximação rápida
+    long slowSteps = 0;   // passos na reaproximação lenta
+};
+
+HomingReport runSensorlessHoming(const SensorlessHomingParams& p, const HomingHal& hal);
+const char* homingResultName(HomingResult r);
+
+#endif // SENSORLESS_HOMING_H
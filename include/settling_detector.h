@@ -0,0 +1,73 @@
+#ifndef SETTLING_DETECTOR_H
+#define SETTLING_DETECTOR_H
+
+#include <cstdint>
+
+// Parâmetros em contagens do HX711 (o grafset converte de kg)
+struct SettlingConfig {
+    uint8_t  window;            // mínimo de conversões na janela
+    uint16_t minSpanMs;         // duração mínima da janela (cobre a oscilação)
+    float    maxDriftCounts;    // |inclinação| x duração da janela
+    float    maxStdCounts;      // desvio padrão da janela (oscilação residual)
+    float    relTol;            // limites crescem com a força: max(abs, relTol x |F|)
+    int32_t  zeroCounts;        // offset de tara (força = média - zeroCounts)
+    uint16_t timeoutMs;         // desiste e usa a última janela
+};
+
+enum SettleStatus : uint8_t {
+    SETTLE_WAITING = 0,
+    SETTLE_DONE,
+    SETTLE_TIMEOUT
+};
+
+/**
+ * @brief Detecção de acomodação da força após um movimento (sem Arduino)
+ *
+ * start() marca o fim do movimento; push() recebe cada conversão do HX711
+ * com seu instante. A janela são as últimas conversões: no mínimo `window`
+ * e cobrindo pelo menos minSpanMs (a 80 SPS 8 conversões são só 90 ms,
+ * menos que um período da oscilação de uma mola mole), até
+ * SETTLE_WINDOW_MAX. Ajusta uma reta força x tempo à janela: acomodado
+ * quando a variação prevista ao longo dela (inclinação x duração) e o
+ * desvio padrão em torno da média ficam abaixo dos limites. Oscilação
+ * amortecida passa pela inclinação mas não pelo desvio; fluência
+ * (relaxação lenta) é o contrário. Os limites crescem com a força
+ * (relTol): a fluência de uma mola dura é proporcional ao degrau de força.
+ * A média da janela é o valor do ponto.
+ */
+class SettlingDetector {
+public:
+    static constexpr int SETTLE_WINDOW_MAX = 32;
+
+    void begin(const SettlingConfig& cfg);
+    void start(uint32_t nowMs);
+    SettleStatus push(int32_t raw, uint32_t nowMs);
+
+    SettleStatus status() const { return _status; }
+    uint32_t settlingMs() const { return _settlingMs; }   // fim do movimento -> decisão
+    float    windowMean() const { return _mean; }          // contagens
+    float    windowStd() const { return _std; }
+    float    windowDrift() const { return _drift; }
+    uint16_t conversions() const { return _conversions; }
+
+private:
+    SettlingConfig _cfg = {};
+    SettleStatus _status = SETTLE_WAITING;
+    uint32_t _startMs = 0;
+    uint32_t _settlingMs = 0;
+    uint16_t _conversions = 0;
+
+    int32_t  _raw[SETTLE_WINDOW_MAX] = {};
+    uint32_t _t[SETTLE_WINDOW_MAX] = {};
+    int      _count = 0;       // conversões no buffer
+    int      _head = 0;
+    int      _used = 0;        // conversões na janela avaliada
+
+    float _mean = 0.0f;
+    float _std = 0.0f;
+    float _drift = 0.0f;
+
+    bool evaluate();   // false se a janela ainda não cobre o mínimo
+};
+
+#endif // SETTLING_DETECTOR_H
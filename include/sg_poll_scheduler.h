@@ -0,0 +1,112 @@
+#ifndef SG_POLL_SCHEDULER_H
+#define SG_POLL_SCHEDULER_H
+
+#include <cstdint>
+
+/**
+ * @brief Leitor de SG_RESULT (mockável): retorna false se a transação UART falhar
+ */
+struct SgUart {
+    bool (*readSgResult)(uint16_t* out, void* ctx);
+    void* ctx;
+};
+
+/**
+ * @brief Agenda de leituras de SG_RESULT via UART durante movimentos
+ *
+ * Lógica pura (sem Arduino/FreeRTOS), dirigida por poll(agoraMs):
+ * - só lê com o motor em movimento (parado, o StallGuard não tem significado);
+ * - respeita um período mínimo entre transações;
+ * - após falhas de UART dobra o período (até maxBackoff vezes) para não
+ *   ocupar o barramento com um driver que não responde;
+ * - com o abort armado, N leituras seguidas <= limiar travam o pedido de abort
+ *   até clearAbort() ou o início do próximo movimento.
+ */
+class SgPollScheduler {
+public:
+    void configure(uint32_t periodMs, uint8_t maxBackoff,
+                   uint16_t abortThreshold, uint8_t abortConsecutive) {
+        _periodMs = periodMs;
+        _maxBackoff = maxBackoff;
+        _abortThreshold = abortThreshold;
+        _abortConsecutive = abortConsecutive;
+    }
+
+    // Chamado no início/fim de cada movimento; abortArmed = movimento que carrega a mola.
+    // O abort travado vale até o fim do movimento em que apareceu: um movimento
+    // novo (retorno, recuperação, jog) começa destravado
+    void setMotion(bool active, bool abortArmed) {
+        if (active && !_active) {
+            _lowCount = 0;
+            _abortLatched = false;
+            _hasDeadline = false;   // primeira leitura logo no início do movimento
+        }
+        _active = active;
+        _abortArmed = abortArmed;
+    }
+
+    // Retorna true se uma leitura válida foi feita nesta chamada
+    bool poll(uint32_t nowMs, const SgUart& uart) {
+        if (!_active) return false;
+        if (_hasDeadline && (int32_t)(nowMs - _nextMs) < 0) return false;
+
+        uint16_t v = 0;
+        bool ok = uart.readSgResult(&v, uart.ctx);
+        if (!ok) {
+            ++_failCount;
+            if (_backoff < _maxBackoff) ++_backoff;
+            scheduleNext(nowMs);
+            return false;
+        }
+
+        _backoff = 0;
+        scheduleNext(nowMs);
+        ++_readCount;
+        _lastValue = v;
+        _lastReadMs = nowMs;
+
+        if (_abortArmed && v <= _abortThreshold) {
+            if (++_lowCount >= _abortConsecutive) {
+                _abortLatched = true;
+            }
+        } else {
+            _lowCount = 0;
+        }
+        return true;
+    }
+
+    bool abortLatched() const { return _abortLatched; }
+    void clearAbort() { _abortLatched = false; _lowCount = 0; }
+
+    uint16_t lastValue() const { return _lastValue; }
+    uint32_t lastReadMs() const { return _lastReadMs; }
+    uint32_t readCount() const { return _readCount; }
+    uint32_t failCount() const { return _failCount; }
+    uint32_t currentPeriodMs() const { return _periodMs << _backoff; }
+
+private:
+    uint32_t _periodMs = 10;
+    uint8_t  _maxBackoff = 3;
+    uint16_t _abortThreshold = 0;
+    uint8_t  _abortConsecutive = 3;
+
+    bool     _active = false;
+    bool     _abortArmed = false;
+    bool     _abortLatched = false;
+    bool     _hasDeadline = false;
+    uint8_t  _backoff = 0;
+    uint8_t  _lowCount = 0;
+    uint32_t _nextMs = 0;
+
+    uint16_t _lastValue = 0;
+    uint32_t _lastReadMs = 0;
+    uint32_t _readCount = 0;
+    uint32_t _failCount = 0;
+
+    void scheduleNext(uint32_t nowMs) {
+        _nextMs = nowMs + currentPeriodMs();
+        _hasDeadline = true;
+    }
+};
+
+#endif // SG_POLL_SCHEDULER_H
@@ -0,0 +1,61 @@
+#ifndef SPC_CHART_H
+#define SPC_CHART_H
+
+#include <cstdint>
+#include "spc_stats.h"
+
+constexpr int SPC_PANEL_ROWS = 10;       // linhas do painel numérico
+constexpr int SPC_PANEL_TEXT_MAX = 22;   // colunas na fonte 1
+
+// Primitivas de desenho da tela de CEP (TFT_eSPI no firmware, contador nos
+// testes). Texto sempre com fundo preto (setTextColor(fg, TFT_BLACK))
+struct SpcCanvas {
+    void (*fillScreen)(uint16_t color, void* ctx);
+    void (*fillRect)(int x, int y, int w, int h, uint16_t color, void* ctx);
+    void (*drawRect)(int x, int y, int w, int h, uint16_t color, void* ctx);
+    void (*hLine)(int x, int y, int w, uint16_t color, void* ctx);
+    void (*line)(int x0, int y0, int x1, int y1, uint16_t color, void* ctx);
+    void (*fillCircle)(int x, int y, int r, uint16_t color, void* ctx);
+    void (*text)(int x, int y, uint8_t size, uint16_t color, const char* s, void* ctx);
+    void* ctx;
+};
+
+/**
+ * @brief Cartas X-barra/R do lote com fundo em cache na própria tela
+ *
+ * draw() desenha tudo: moldura, linhas de controle/tolerância, rótulos,
+ * pontos da página e painel. drawNew() só plota os subgrupos ainda não
+ * desenhados e reescreve as linhas do painel cujo texto mudou (o painel
+ * fica em cache, sem limpar a área); vale enquanto needsRedraw() for false
+ * (escala e limites sem mudança visível, página com espaço).
+ */
+class SpcChartView {
+public:
+    void invalidate() { _valid = false; }
+    bool needsRedraw(const SpcBatch& b) const;
+
+    void draw(const SpcBatch& b, const SpcCanvas& c);
+    void drawNew(const SpcBatch& b, const SpcCanvas& c);
+
+private:
+    bool     _valid = false;
+    float    _yMin = 0.0f, _yMax = 0.0f;      // escala da carta X-barra
+    float    _rMax = 0.0f;                    // escala da carta R
+    float    _ucl = 0.0f, _lcl = 0.0f, _rUcl = 0.0f;  // limites desenhados
+    uint32_t _pageStart = 0;                  // primeiro subgrupo da página
+    uint32_t _drawn = 0;                      // subgrupos já plotados
+    char     _panel[SPC_PANEL_ROWS][SPC_PANEL_TEXT_MAX + 1] = {};  // texto na tela
+    uint16_t _panelColor[SPC_PANEL_ROWS] = {};
+
+    int x(uint32_t subgroup) const;
+    int yXbar(float v) const;
+    int yR(float r) const;
+    void computeScale(const SpcBatch& b);
+    void drawBackground(const SpcBatch& b, const SpcCanvas& c);
+    void plotPoint(const SpcBatch& b, uint32_t i, const SpcCanvas& c);
+    void panelLine(int row, int y, uint8_t size, uint16_t color, const char* text,
+                   const SpcCanvas& c);
+    void drawPanel(const SpcBatch& b, const SpcCanvas& c);
+};
+
+#endif // SPC_CHART_H
@@ -0,0 +1,85 @@
+#ifndef SPC_STATS_H
+#define SPC_STATS_H
+
+#include <cstdint>
+
+// Tamanho do subgrupo racional (molas consecutivas) e pontos no gráfico
+constexpr int SPC_SUBGROUP_SIZE = 5;
+constexpr int SPC_CHART_POINTS  = 25;
+constexpr int SPC_PART_NAME_MAX = 15;
+
+// Um ponto da carta X-barra/R (um subgrupo completo)
+struct SpcPoint {
+    float xbar;
+    float range;
+};
+
+/**
+ * @brief Controle estatístico de processo do lote (K de cada mola)
+ *
+ * add() é O(1): Welford para média/desvio de todas as molas, e médias
+ * corridas de X-barra e R dos subgrupos completos. Limites de controle
+ * pelas constantes clássicas (A2, D3, D4, d2) do tamanho do subgrupo; Cpk
+ * usa o desvio dentro dos subgrupos (R-barra/d2) e, antes de haver dois
+ * subgrupos, o desvio amostral. O histórico do gráfico fica num buffer
+ * circular dos últimos SPC_CHART_POINTS subgrupos.
+ */
+class SpcBatch {
+public:
+    // Novo lote; lsl/usl = 0 sem tolerância (Cpk indisponível)
+    void begin(const char* partName, float lsl, float usl);
+    void add(float value);
+
+    const char* partName() const { return _part; }
+    bool hasTolerance() const { return _usl > _lsl; }
+    float lsl() const { return _lsl; }
+    float usl() const { return _usl; }
+
+    uint32_t count() const { return _n; }
+    float mean() const { return (float)_mean; }
+    float stdDev() const;
+    float minValue() const { return _min; }
+    float maxValue() const { return _max; }
+
+    // Subgrupos completos
+    uint32_t subgroups() const { return _subgroups; }
+    float grandMean() const { return (float)_grandMean; }
+    float meanRange() const { return (float)_meanRange; }
+    float xbarUcl() const;
+    float xbarLcl() const;
+    float rUcl() const;
+    float rLcl() const;
+    float sigmaWithin() const;
+    float cpk() const;            // 0 se indisponível
+
+    // Ponto do subgrupo de índice absoluto (0 = primeiro do lote); false se
+    // já saiu do buffer ou ainda não existe
+    bool chartPoint(uint32_t subgroup, SpcPoint* out) const;
+
+private:
+    char     _part[SPC_PART_NAME_MAX + 1] = {0};
+    float    _lsl = 0.0f;
+    float    _usl = 0.0f;
+
+    uint32_t _n = 0;
+    double   _mean = 0.0;
+    double   _m2 = 0.0;
+    float    _min = 0.0f;
+    float    _max = 0.0f;
+
+    // Subgrupo em formação
+    int      _groupCount = 0;
+    double   _groupSum = 0.0;
+    float    _groupMin = 0.0f;
+    float    _groupMax = 0.0f;
+
+    uint32_t _subgroups = 0;
+    double   _grandMean = 0.0;
+    double   _meanRange = 0.0;
+
+    SpcPoint _chart[SPC_CHART_POINTS];
+};
+
+extern SpcBatch spcBatch;
+
+#endif // SPC_STATS_H
@@ -0,0 +1,41 @@
+#ifndef SPRING_CURVE_FIT_H
+#define SPRING_CURVE_FIT_H
+
+#include <cstdint>
+
+/**
+ * @brief Caracterização de molas não lineares (progressivas / dupla taxa)
+ *
+ * - Ajuste linear por partes (1 a 3 segmentos) com busca exaustiva dos pontos
+ *   de quebra via somas prefixadas; o número de segmentos é escolhido por BIC,
+ *   então uma mola linear continua sendo reportada com um único K.
+ * - Ajuste polinomial de 2ª ordem F = c0 + c1*x + c2*x².
+ *
+ * Sem alocação dinâmica: buffers estáticos dimensionados por
+ * SPRING_CURVE_MAX_POINTS (entradas maiores são decimadas). Pior caso
+ * O(n²) na busca de 3 segmentos.
+ */
+constexpr int SPRING_CURVE_MAX_POINTS     = 256;
+constexpr int SPRING_CURVE_MAX_SEGMENTS   = 3;
+constexpr int SPRING_CURVE_MIN_SEG_POINTS = 3;
+
+struct PiecewiseFit {
+    int   segments = 0;
+    float rateKgfMm[SPRING_CURVE_MAX_SEGMENTS] = {0.0f, 0.0f, 0.0f};
+    float breakMm[SPRING_CURVE_MAX_SEGMENTS - 1] = {0.0f, 0.0f};
+    float rmsKg = 0.0f;   // erro RMS do ajuste escolhido
+    bool  valid = false;
+};
+
+struct PolyFit {
+    float c0 = 0.0f;  // kg
+    float c1 = 0.0f;  // kgf/mm (taxa em x = 0)
+    float c2 = 0.0f;  // kgf/mm² (progressividade: dK/dx = 2*c2)
+    float r2 = 0.0f;
+    bool  valid = false;
+};
+
+PiecewiseFit fitPiecewiseLinear(const float* x, const float* y, int n);
+PolyFit fitQuadratic(const float* x, const float* y, int n);
+
+#endif // SPRING_CURVE_FIT_H
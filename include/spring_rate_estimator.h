@@ -0,0 +1,54 @@
+#ifndef SPRING_RATE_ESTIMATOR_H
+#define SPRING_RATE_ESTIMATOR_H
+
+#include <cstdint>
+
+/**
+ * @brief Estimadores da constante elástica K (inclinação de F = a + k*x)
+ *
+ * Todos trabalham sobre vetores x (mm) / y (kg) já coletados, sem alocação
+ * dinâmica: usam um buffer estático de tamanho fixo, de modo que tempo e
+ * memória são limitados mesmo com centenas de pontos. Entradas maiores que
+ * SPRING_RATE_MAX_POINTS são decimadas uniformemente.
+ */
+enum SpringRateMethod {
+    RATE_LEAST_SQUARES = 0,  // mínimos quadrados (comportamento original)
+    RATE_THEIL_SEN     = 1,  // mediana das inclinações entre pares
+    RATE_RANSAC        = 2,  // consenso por amostragem + MQ nos inliers
+    RATE_HUBER         = 3   // IRLS com perda de Huber
+};
+
+struct LineFit {
+    float k      = 0.0f;  // inclinação (kgf/mm)
+    float a      = 0.0f;  // intercepto (kg)
+    float r2     = 0.0f;  // R² sobre os pontos considerados inliers
+    int   inliers = 0;    // pontos usados no ajuste final
+    bool  valid  = false;
+};
+
+// Limites de memória/tempo dos estimadores
+constexpr int SPRING_RATE_MAX_POINTS = 512;   // pontos considerados por ajuste
+constexpr int SPRING_RATE_MAX_PAIRS  = 1024;  // pares avaliados pelo Theil-Sen
+constexpr int SPRING_RATE_RANSAC_ITERATIONS = 64;
+constexpr int SPRING_RATE_HUBER_ITERATIONS  = 10;
+
+/**
+ * @brief Ajusta a reta com o método escolhido sobre os pontos [first, last]
+ */
+LineFit fitSpringRate(const float* x, const float* y, int first, int last,
+                      SpringRateMethod method);
+
+/**
+ * @brief Detecta a maior faixa contígua de comportamento linear
+ *
+ * Calcula a inclinação local entre pontos vizinhos e retorna o maior trecho
+ * cujas inclinações estão a até relTol (ex.: 0.25 = 25%) da mediana global.
+ * Descarta automaticamente o assentamento de contato no início e eventual
+ * saturação/encosto no final. Retorna false se não houver ao menos minPoints.
+ */
+bool detectLinearRegion(const float* x, const float* y, int n, float relTol,
+                        int minPoints, int* outFirst, int* outLast);
+
+const char* springRateMethodName(SpringRateMethod method);
+
+#endif // SPRING_RATE_ESTIMATOR_H
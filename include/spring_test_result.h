@@ -0,0 +1,38 @@
+#ifndef SPRING_TEST_RESULT_H
+#define SPRING_TEST_RESULT_H
+
+#include "spring_curve_fit.h"
+#include "spring_verdict.h"
+
+/**
+ * @brief Resultado consolidado de um teste de mola
+ *
+ * Além do K linear (região linear + estimador robusto), guarda a
+ * caracterização não linear: segmentos com taxa própria e pontos de quebra,
+ * e o polinômio de 2ª ordem. positionVerified = false indica que o eixo de
+ * deslocamento não é confiável (pulsos perdidos no MSCNT ou stall).
+ * hasLimits/passed refletem o veredito contra os limites da peça (perfil).
+ */
+struct SpringTestResult {
+    float courseMm    = 0.0f;
+    float kKgfMm      = 0.0f;
+    float kNmm        = 0.0f;
+    float r2          = 0.0f;
+    float maxForceKg  = 0.0f;
+    int   sampleCount = 0;
+    bool  positionVerified = true;
+    long  lostStepUnits    = 0;   // unidades de StepperManager::getStepsPerMm()
+    bool  hasLimits = false;
+    bool  passed    = true;
+    VerdictReason verdictReason = VERDICT_REASON_NONE;
+    float freeLengthMm     = 0.0f;
+    bool  earlyRejected    = false;
+    uint32_t estimatedSavedMs = 0;  // curso poupado pela reprovação antecipada
+    uint32_t settleMeanMs = 0;      // acomodação média por ponto (SETTLE_ADAPTIVE)
+    uint32_t settleMaxMs  = 0;
+    uint16_t settleTimeouts = 0;    // pontos medidos sem acomodar
+    PiecewiseFit piecewise;
+    PolyFit      poly;
+};
+
+#endif // SPRING_TEST_RESULT_H
@@ -0,0 +1,82 @@
+#ifndef SPRING_VERDICT_H
+#define SPRING_VERDICT_H
+
+#include <cstdint>
+#include "test_profile.h"
+
+enum VerdictState : uint8_t {
+    VERDICT_NONE = 0,     // perfil sem limites
+    VERDICT_PENDING,
+    VERDICT_PASS,
+    VERDICT_FAIL
+};
+
+enum VerdictReason : uint8_t {
+    VERDICT_REASON_NONE = 0,
+    VERDICT_REASON_FREE_LENGTH,
+    VERDICT_REASON_FORCE_AT,
+    VERDICT_REASON_K_LOW,
+    VERDICT_REASON_K_HIGH,
+    VERDICT_REASON_OVERFORCE,
+    VERDICT_REASON_INCOMPLETE
+};
+
+/**
+ * @brief Veredito aprovado/reprovado de um teste de mola, incremental
+ *
+ * Recebe as amostras na ordem em que chegam e decide o mais cedo possível:
+ * - comprimento livre: antes da compressão;
+ * - força em comprimento: interpolada entre as amostras que cercam a
+ *   posição da checagem, assim que a compressão passa por ela;
+ * - K: inclinação por mínimos quadrados acumulada (O(1) por amostra);
+ *   reprova antecipadamente só fora da faixa com margem extra
+ *   (earlyMargin) e após minPoints pontos, para não rejeitar por ruído ou
+ *   pela folga inicial de molas progressivas. O K final (estimador robusto)
+ *   é avaliado em finish() contra a faixa sem margem.
+ *
+ * Sem dependência de Arduino: roda igual no host.
+ */
+class SpringVerdict {
+public:
+    void begin(const ProfileSettings& limits, float earlyMargin, int minPoints, float minXMm);
+
+    // Comprimento livre medido no contato aliviado; true = reprovado
+    bool checkFreeLength(float freeLengthMm);
+
+    // Amostra (compressão mm, força kg); true = reprovado (abortar o curso)
+    bool addSample(float xMm, float fKg);
+
+    // Fim do curso: K final e checagens não alcançadas
+    VerdictState finish(float kFinalKgfMm, bool completed);
+
+    VerdictState  state() const { return _state; }
+    VerdictReason reason() const { return _reason; }
+    bool failed() const { return _state == VERDICT_FAIL; }
+    float failValue() const { return _failValue; }   // medida que reprovou (mm, kg ou kgf/mm)
+    float runningK() const;
+
+private:
+    const ProfileSettings* _limits = nullptr;
+    VerdictState  _state = VERDICT_NONE;
+    VerdictReason _reason = VERDICT_REASON_NONE;
+    float _failValue = 0.0f;
+    float _earlyMargin = 0.0f;
+    int   _minPoints = 0;
+    float _minXMm = 0.0f;
+
+    // Checagens de força: próxima pendente e amostra anterior
+    int   _nextCheck = 0;
+    bool  _hasPrev = false;
+    float _prevX = 0.0f;
+    float _prevF = 0.0f;
+
+    // Somas para a inclinação por mínimos quadrados
+    int    _n = 0;
+    double _sx = 0.0, _sy = 0.0, _sxx = 0.0, _sxy = 0.0;
+
+    bool reject(VerdictReason reason, float value);
+};
+
+const char* verdictReasonName(VerdictReason reason);
+
+#endif // SPRING_VERDICT_H
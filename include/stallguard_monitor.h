@@ -0,0 +1,56 @@
+#ifndef STALLGUARD_MONITOR_H
+#define STALLGUARD_MONITOR_H
+
+#include <Arduino.h>
+#include "sg_poll_scheduler.h"
+
+/**
+ * @brief Canal secundário de carga: SG_RESULT do TMC2209 lido em segundo plano
+ *
+ * Uma tarefa FreeRTOS no core 0 consulta o SG_RESULT via UART enquanto o
+ * motor se move (o loop e a geração de passos ficam no core 1, então as
+ * transações não alteram o tempo entre pulsos). O último valor fica
+ * disponível para log junto da força do HX711 e, durante movimentos que
+ * carregam a mola, leituras seguidas abaixo do limiar pedem abort do
+ * movimento antes de sobrecarregar a célula de carga.
+ *
+ * A mesma tarefa envia os registradores pendentes do TMC2209Manager.
+ *
+ * Sem UART do TMC2209 a tarefa não é criada e tudo vira no-op.
+ */
+class StallGuardMonitor {
+public:
+    // Cria a tarefa se o TMC2209 estiver pronto; retorna false caso contrário
+    bool begin();
+    bool isRunning() const { return _task != nullptr; }
+
+    // Chamado por StepperManager no início/fim de cada movimento; o início
+    // de um movimento limpa o abort travado no anterior
+    void setMotion(bool active, bool abortArmed);
+
+    // Lido a cada passo em moveSteps: apenas uma flag volátil. Continua
+    // verdadeiro depois do movimento até clearAbort() ou o próximo movimento
+    bool abortRequested() const { return _abort && !_clearRequested; }
+    void clearAbort();
+
+    // Último SG_RESULT lido (-1 se nenhum)
+    int lastValue() const { return _hasValue ? (int)_lastValue : -1; }
+
+private:
+    static void taskEntry(void* arg);
+    void run();
+
+    TaskHandle_t   _task = nullptr;
+    SgPollScheduler _scheduler;
+
+    volatile bool     _motionActive = false;
+    volatile bool     _abortArmed = false;
+    volatile bool     _abort = false;
+    volatile bool     _clearRequested = false;
+    volatile bool     _hasValue = false;
+    volatile uint16_t _lastValue = 0;
+};
+
+extern StallGuardMonitor stallGuardMonitor;
+
+#endif // STALLGUARD_MONITOR_H
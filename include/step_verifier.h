@@ -0,0 +1,88 @@
+#ifndef STEP_VERIFIER_H
+#define STEP_VERIFIER_H
+
+#include <cstdint>
+
+/**
+ * @brief Verificação de passos pelo contador MSCNT do TMC2209
+ *
+ * MSCNT (0-1023) é a posição do driver na tabela de seno em 1/256 de
+ * micropasso e dá uma volta a cada 4 passos inteiros. Somando os pulsos
+ * comandados (256/microsteps cada) obtém-se o valor esperado; a diferença
+ * para a leitura indica pulsos que o driver não recebeu. Perdas mecânicas
+ * (o rotor escorrega enquanto o driver avança) não aparecem no MSCNT, por
+ * isso stalls (DIAG / SG_RESULT) também são contabilizados.
+ *
+ * Divergências acima de ±2 passos inteiros entre verificações sofrem
+ * aliasing: verificar com frequência (ao fim de movimentos curtos).
+ */
+class StepVerifier {
+public:
+    static constexpr int32_t MSCNT_PERIOD = 1024;
+
+    void begin(uint16_t mscnt) {
+        _expected = mscnt % MSCNT_PERIOD;
+        _lostMicro256 = 0;
+        _lastError = 0;
+        _stallEvents = 0;
+        _checks = 0;
+        _active = true;
+    }
+
+    // Re-referencia sem zerar os acumulados (ex.: após troca de MRES)
+    void rebase(uint16_t mscnt) {
+        _expected = mscnt % MSCNT_PERIOD;
+    }
+
+    void stop() { _active = false; }
+    bool active() const { return _active; }
+
+    // pulses com sinal; increment = 256 / microsteps da fase atual
+    void addPulses(long pulses, int32_t increment) {
+        if (!_active) return;
+        int32_t delta = (int32_t)((pulses * increment) % MSCNT_PERIOD);
+        _expected = wrap(_expected + delta);
+    }
+
+    // Compara com a leitura; retorna o erro em 1/256 de micropasso (com sinal)
+    int32_t check(uint16_t mscnt) {
+        if (!_active) return 0;
+        int32_t err = (int32_t)(mscnt % MSCNT_PERIOD) - _expected;
+        if (err > MSCNT_PERIOD / 2) err -= MSCNT_PERIOD;
+        if (err <= -MSCNT_PERIOD / 2) err += MSCNT_PERIOD;
+        _lastError = err;
+        _lostMicro256 += (err < 0) ? -err : err;
+        _expected = mscnt % MSCNT_PERIOD;   // não conta a mesma perda duas vezes
+        ++_checks;
+        return err;
+    }
+
+    void noteStall() {
+        if (_active) ++_stallEvents;
+    }
+
+    // Perda acumulada em unidades de 1/unitMicrosteps de passo
+    long lostUnits(uint16_t unitMicrosteps) const {
+        return (long)((_lostMicro256 * (int64_t)unitMicrosteps + 255) / 256);
+    }
+
+    int32_t  lastError() const { return _lastError; }
+    uint32_t stallEvents() const { return _stallEvents; }
+    uint32_t checks() const { return _checks; }
+    bool     lossDetected() const { return _lostMicro256 > 0 || _stallEvents > 0; }
+
+private:
+    int32_t  _expected = 0;
+    int64_t  _lostMicro256 = 0;
+    int32_t  _lastError = 0;
+    uint32_t _stallEvents = 0;
+    uint32_t _checks = 0;
+    bool     _active = false;
+
+    static int32_t wrap(int32_t v) {
+        v %= MSCNT_PERIOD;
+        return (v < 0) ? v + MSCNT_PERIOD : v;
+    }
+};
+
+#endif // STEP_VERIFIER_H
@@ -2,6 +2,10 @@
 #define STEPPER_MANAGER_H
 
 #include <Arduino.h>
+#include "step_verifier.h"
+#include "motion_queue.h"
+#include "endstop_homing.h"
+#include "motion_phase.h"
 
 enum StepperDirection {
     STEPPER_DIR_FORWARD  = 0,
@@ -9,29 +13,53 @@ enum StepperDirection {
 };
 
 class StepperManager {
+    // Captura da posição no acionamento do fim de curso
+    friend void IRAM_ATTR endstopISR();
+    friend void endstopDebounceTimer(void* arg);
+
 public:
-    void begin();
+    void begin();   // pinos e posição; driver segue desabilitado até enable(true)
     void enable(bool on);
 
-    // Movimento em passos "bruto"
+    // Habilita a troca de microsteps/corrente por fase (chamar após
+    // tmc2209Manager.begin() bem-sucedido). Passa a contar posição em
+    // 1/TMC_FINE_MICROSTEPS; getStepsPerMm() reflete a nova unidade.
+    void enablePhaseSwitching();
+    void setMotionPhase(MotionPhase phase);
+    MotionPhase getMotionPhase() const;
+
+    // Movimento em passos "bruto" (unidades de getStepsPerMm()); usDelay é o
+    // intervalo equivalente a um passo de 1/TMC_DEFAULT_MICROSTEPS
     void moveSteps(long steps, StepperDirection dir, uint16_t usDelay = 800);
 
     // Homing até o fim de curso
     void homeToEndstop(long maxSteps, uint16_t usDelay = 800);
     // Homing com monitoramento externo para abortar (ex.: variação na balança)
-    // monitorFunc(ctx) deve retornar true para ABORTAR imediatamente
+    // monitorFunc(ctx) deve retornar true para ABORTAR imediatamente.
+    // Com o TMC2209 ativo via UART usa StallGuard (rápido + lento) e o fim de
+    // curso apenas confirma o zero; sem UART rasteja até o micro switch.
     void homeToEndstopWithMonitor(long maxSteps, uint16_t usDelay,
                                   bool (*monitorFunc)(void*), void* ctx);
 
     // Verifica se o último homing foi bem-sucedido
     bool wasLastHomingSuccessful() const;
 
-    // Configuração / posição
-    void setStepsPerMm(float s);
+    // Posição: unidades/mm vêm do perfil de hardware (ActiveRig, config.h)
     float getStepsPerMm() const;
+    // mm -> unidades de posição na unidade corrente (grossa ou fina), pela
+    // conversão inteira do perfil (AxisScale::umToUnits)
+    long  mmToUnits(float mm) const;
 
     void resetPosition(); // zera posição em passos
     float getPositionMm() const;
+    long getPositionSteps() const;
+
+    // Executa a fila de segmentos com junções suaves (sem parar entre
+    // segmentos no mesmo sentido). onSegment é chamado ao fim de cada
+    // segmento com ação SAMPLE/DWELL; retornar false aborta a fila.
+    // Retorna true se todos os segmentos foram concluídos.
+    typedef bool (*SegmentCallback)(const MotionSegment& seg, int index, void* ctx);
+    bool runMotionQueue(MotionQueue& queue, SegmentCallback onSegment, void* ctx);
 
     // Movimento absoluto em mm (a partir de zero definido na home)
     void moveToPositionMm(float targetMm, uint16_t usDelay = 800);
@@ -39,13 +67,53 @@ public:
     // Leitura do endstop
     bool isEndstopPressed() const;
 
-    // StallGuard - verifica se houve detecção de stall e trata
+    // Verificação de passos (MSCNT + stalls). Sem UART sempre "sem perda".
+    void resetStepVerification();       // zera acumulados e re-referencia
+    bool stepLossDetected() const;
+    long lostStepUnits() const;         // em unidades de getStepsPerMm()
+    uint32_t stallEventCount() const;
+
+    // StallGuard - verifica se houve detecção de stall e trata (recua
+    // TMC_STALL_RETRACT_MM no sentido oposto ao último movimento)
     bool checkAndHandleStall();
 
+    // Frequência máxima do laço de passos (leitura do endstop + pulso STEP,
+    // sem atrasos) com digitalWrite/digitalRead e com FastPin (fast_io.h).
+    // O driver fica desabilitado durante a medição (pulsos ignorados, eixo
+    // parado) e volta ao estado anterior.
+    struct StepIoBench {
+        uint32_t pulses;
+        float    arduinoKhz;
+        float    fastKhz;
+    };
+    StepIoBench benchmarkStepIo(uint32_t pulses);
+
 private:
-    float _stepsPerMm     = 1600.0f;
-    long  _positionSteps  = 0;
+    volatile long _positionSteps = 0;   // lida pela ISR do fim de curso
+    bool  _enabled        = false;
     bool  _lastHomingSuccess = false;
+    StepperDirection _lastDir = STEPPER_DIR_FORWARD;
+
+    // Troca de fase: cada pulso avança _axis.pulseIncrement unidades de posição
+    bool            _phaseSwitching = false;
+    MotionPhase     _phase = MOTION_PHASE_NONE;
+    MotionPhaseAxis _axis;
+
+    // Fim de curso por interrupção (ENDSTOP_LATCH_ENABLED)
+    EndstopLatch _endstopLatch;
+    bool         _endstopIrq = false;
+
+    StepVerifier  _verifier;
+    unsigned long _lastVerifyMs = 0;
+    void rebaseStepVerifier();
+    void verifyAfterMove(long signedPulses, bool stallSeen);
+
+    float unitsToMm(long units) const;
+
+    uint32_t pulseDelayUs(uint16_t usDelay) const;
+    static float cruisePpsFor(uint16_t usDelay, void* self);
+
+    void homeSensorless(long maxSteps, bool (*monitorFunc)(void*), void* ctx);
 };
 
 extern StepperManager stepperManager;
@@ -0,0 +1,74 @@
+#ifndef TARE_ESTIMATOR_H
+#define TARE_ESTIMATOR_H
+
+#include <cstdint>
+
+// Parâmetros em contagens do HX711 (ScaleManager converte de kg)
+struct TareConfig {
+    float    targetSeCounts;   // para quando o erro padrão da média fica abaixo
+    uint16_t minSamples;       // mínimo para confiar no desvio estimado
+    uint16_t maxSamples;       // orçamento total de conversões (com reinícios)
+    float    trendT;           // |t| da inclinação acima disso = ainda acomodando
+};
+
+enum TareQuality : uint8_t {
+    TARE_QUALITY_GOOD = 0,     // atingiu o alvo sem descartar leituras
+    TARE_QUALITY_SETTLED,      // atingiu o alvo após descartar trecho em acomodação
+    TARE_QUALITY_NOISY,        // orçamento esgotado acima do alvo (média do último trecho)
+    TARE_QUALITY_FAILED        // sem leituras (HX711 não respondeu)
+};
+
+struct TareResult {
+    int32_t     offset;
+    float       stdErrCounts;  // erro padrão da média do trecho usado
+    uint16_t    samples;       // conversões consumidas (inclui descartadas)
+    uint8_t     restarts;
+    TareQuality quality;
+};
+
+const char* tareQualityName(TareQuality quality);
+
+/**
+ * @brief Decisão da tara por parada estatística (sem Arduino)
+ *
+ * Recebe as conversões uma a uma e mantém média/variância (Welford) e a
+ * regressão linear contra o índice da leitura. Termina assim que
+ * desvio/sqrt(n) <= targetSeCounts com n >= minSamples: com a célula
+ * quieta isso leva poucas conversões em vez das 10 fixas. Se a inclinação
+ * é significativa (|t| > trendT: plataforma ainda oscilando, mola
+ * acomodando), o trecho é descartado e a contagem recomeça da leitura atual.
+ * Esgotado maxSamples, devolve a média do último trecho como NOISY.
+ */
+class TareEstimator {
+public:
+    void begin(const TareConfig& cfg);
+    void reset();
+
+    // true quando a decisão está tomada (result() válido)
+    bool push(int32_t raw);
+    // Encerra sem mais leituras (timeout do HX711)
+    void abort();
+
+    bool done() const { return _done; }
+    const TareResult& result() const { return _result; }
+
+private:
+    TareConfig _cfg = {};
+    TareResult _result = {};
+    bool     _done = false;
+    uint16_t _total = 0;
+
+    // Trecho atual: valores relativos à primeira leitura do trecho
+    int32_t _ref = 0;
+    int     _n = 0;
+    double  _mean = 0.0;
+    double  _m2 = 0.0;
+    double  _sumI = 0.0;
+    double  _sumII = 0.0;
+    double  _sumIX = 0.0;
+
+    void restartSegment(int32_t raw);
+    void finish(TareQuality quality, double stdErr);
+};
+
+#endif // TARE_ESTIMATOR_H
@@ -0,0 +1,86 @@
+#ifndef TEST_FADIGA_GRAFSET_H
+#define TEST_FADIGA_GRAFSET_H
+
+#include "grafset.h"
+#include "cycle_stats.h"
+#include "motion_queue.h"
+#include "fatigue_stroke.h"
+#include "config.h"
+#include <cstdint>
+
+/**
+ * @brief Grafset para teste de fadiga/durabilidade (ciclagem da mola)
+ *
+ * Comprime a mola N vezes entre o contato aliviado e FATIGUE_COURSE_MM,
+ * acumulando apenas estatísticas por ciclo (memória constante). Curvas
+ * completas são guardadas somente nos ciclos 1, 2, 4, 8, ...
+ *
+ * -2: Seleção do número de ciclos
+ * 10: Homing
+ * 20: Aguarda usuário posicionar mola
+ * 30: Tara
+ * 40: Busca ponto de contato e alivia
+ * 50: Ciclagem
+ * 60: Retorna à posição inicial
+ * 70: Exibe resultados
+ */
+class TestFadigaGrafset : public Grafset {
+public:
+    enum FadigaState {
+        STATE_SELECT_CYCLES = -2,
+        STATE_HOMING = 10,
+        STATE_AWAIT_SPRING_PLACEMENT = 20,
+        STATE_TARE = 30,
+        STATE_FIND_SPRING_CONTACT = 40,
+        STATE_CYCLING = 50,
+        STATE_RETURN_INITIAL = 60,
+        STATE_SHOW_RESULTS = 70
+    };
+
+    TestFadigaGrafset();
+    virtual ~TestFadigaGrafset() {}
+
+    void start() override;
+    void tick() override;
+    void reset() override;
+
+private:
+    FadigaState currentState;
+
+    uint32_t targetCycles;
+    float    zeroPositionMm;      // posição do motor no contato aliviado
+    bool     contactFound;
+    bool     screenShown;
+    bool     aborted;
+    bool     positionLost;        // verificação MSCNT/stall invalidou o eixo
+    unsigned long entryTimeMs;
+    unsigned long lastUiUpdateMs;
+    int      cycleOptionIndex = 0;
+    long     lastEncPos = 0;
+
+    MotionQueue      strokeQueue;  // descida amostrada + retorno de um ciclo
+    bool             overForce = false;
+    FatigueCycleGate gate;         // ciclos com poucas conversões (fora do resumo)
+    CycleAccumulator cycle;
+    FatigueSummary   summary;
+    CurveLog<FATIGUE_STORED_CURVES, FATIGUE_CURVE_POINTS> curveLog;
+
+    void executeStateSelectCycles();
+    void executeStateHoming();
+    void executeStateAwaitSpringPlacement();
+    void executeStateTare();
+    void executeStateFindSpringContact();
+    void executeStateCycling();
+    void executeStateReturnInitial();
+    void executeStateShowResults();
+
+    // Executa um ciclo completo (comprime e alivia). Retorna false se abortou.
+    bool runOneCycle(uint32_t cycleNumber);
+    static bool onStrokeSegment(const MotionSegment& seg, int index, void* ctx);
+
+    void drawCyclingStatus();
+    void printStoredCurves();
+    void enterState(FadigaState next);
+};
+
+#endif // TEST_FADIGA_GRAFSET_H
@@ -2,6 +2,12 @@
 #define TEST_MOLA_GRAFSET_H
 
 #include "grafset.h"
+#include "spring_test_result.h"
+#include "sample_arena.h"
+#include "test_profile.h"
+#include "spring_verdict.h"
+#include "settling_detector.h"
+#include "config.h"
 #include <cstdint>
 
 /**
@@ -45,8 +51,35 @@ public:
     void tick() override;
     void reset() override;
 
+    /**
+     * @brief Inicia o teste por comando remoto, sem encoder
+     * Pula seleção, homing e confirmações: o eixo deve estar em
+     * SPRING_PLACEMENT_MM após homeRemote() (remoteStartGate() no chamador)
+     * e a mola já posicionada; começa pela tara. Sem contato, encerra em vez
+     * de aguardar o alarme; o resultado não espera clique. false se o
+     * índice ou o perfil forem inválidos.
+     */
+    bool startRemote(int profileIndex);
+
+    /**
+     * @brief HOME remoto: homing e posição de colocação, com a plataforma livre
+     * Mesmas etapas (e alarme de peso no homing) do início local; encerra
+     * ao chegar em SPRING_PLACEMENT_MM, sem resultado.
+     */
+    void homeRemote();
+
+    bool isRemote() const { return remoteMode; }
+    bool isHomeOnly() const { return homeOnly; }
+    int stateCode() const { return (int)currentState; }
+    const char* profileName() const { return profile.settings().name; }
+
+    // Resultado do último teste (válido após a análise, até o próximo start)
+    bool hasResult() const { return resultAvailable; }
+    const SpringTestResult& result() const { return lastResult; }
+
 private:
     TestState currentState;
+    TestState tracedState;   // último estado registrado no event trace
     
     // Variáveis de progresso entre etapas
     float motorRealPositionMm;
@@ -58,6 +91,9 @@ private:
     float lastR2;
     float lastForceKg;
     float selectedCourseMm;
+
+    // Resultado completo do último teste (K, R², ajuste por partes e polinomial)
+    SpringTestResult lastResult;
     
     int compressionStepCounter;
     const int MAX_COMPRESSION_STEPS = 11;  // 0 a 10mm
@@ -79,6 +115,11 @@ private:
     bool taraReached;
     bool userConfirmedRemoval;
     bool compressionSamplingDone;
+    bool stallAborted;            // compressão interrompida pelo monitor de SG_RESULT
+    bool forceLimitExceeded;      // compressão interrompida pelo limite de força do perfil
+    bool remoteMode = false;      // iniciado por comando serial (sem encoder)
+    bool homeOnly = false;        // HOME remoto: para na colocação da mola
+    bool resultAvailable = false;
     
     // Flags de execução para estados (não usar static nos métodos)
     bool screenShownReady;
@@ -94,11 +135,28 @@ private:
     // Tempo de entrada no estado AWAIT_SPRING_PLACEMENT para gating de clique
     unsigned long awaitSpringEntryTimeMs = 0;
 
-    // Amostras de compressão para regressão linear
-    static constexpr int MAX_SAMPLES = 41; // até 0..40 mm
-    float sampleX_mm[MAX_SAMPLES];
-    float sampleF_kg[MAX_SAMPLES];
-    int sampleCount = 0;
+    // Perfil selecionado (bytecode na flash); conduz a amostragem de compressão
+    ProfileInterpreter profile;
+
+    // Veredito da peça, alimentado amostra a amostra (reprovação antecipada)
+    SpringVerdict verdict;
+    float freeLengthMm = 0.0f;
+    bool earlyRejected = false;
+    unsigned long compressionStartMs = 0;
+    uint32_t estimatedSavedMs = 0;   // tempo de curso poupado pela reprovação antecipada
+
+    // Acomodação após cada movimento e estatística por teste
+    SettlingDetector settling;
+    uint32_t settleTotalMs = 0;
+    uint32_t settleMaxMs = 0;
+    uint16_t settlePoints = 0;
+    uint16_t settleTimeouts = 0;
+
+    // Amostras brutas de compressão (arena estática, decima ao encher)
+    SampleArena<SPRING_SAMPLE_CAPACITY> samples;
+
+    // Posição (passos) do zero de compressão, referência para converter amostras em mm
+    long zeroReferenceSteps = 0;
     
     // Métodos internos para cada etapa
     void executeStateSelectCourse();
@@ -118,9 +176,21 @@ private:
     // Auxiliares
     bool checkUserInteractionTimeout(unsigned long timeout);
 
-    // Calcula regressão linear F = a + k*x no intervalo [lowMm, highMm]
-    // Retorna k em kgf/mm e opcionalmente R^2 via ponteiro
-    float computeSpringRateRegression(float lowMm, float highMm, float* outR2 = nullptr);
+    // Lê conversões até a força acomodar; média da janela em *avgRaw
+    SettleStatus measureSettled(const ProfileStep& step, long* avgRaw);
+
+    // Calcula K (kgf/mm) com o estimador SPRING_RATE_METHOD sobre a região
+    // linear detectada automaticamente; opcionalmente R^2 via ponteiro
+    float computeSpringRate(float* outR2 = nullptr);
+
+    // Ajustes não lineares (por partes e polinomial) sobre todas as amostras
+    void computeNonlinearFits();
+
+    // Converte a arena (passos/contagens) para mm/kg nos buffers de análise
+    int loadSamplesForAnalysis();
+
+    // Grava resultado e curva bruta no registro de resultados (LittleFS)
+    void storeResult();
 };
 
 #endif // TEST_MOLA_GRAFSET_H
@@ -0,0 +1,145 @@
+#ifndef TEST_PROFILE_H
+#define TEST_PROFILE_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Perfis de teste de mola em bytecode (gravados na flash)
+ *
+ * Os perfis são escritos em texto (tools/test_profiles.txt) e compilados no
+ * host por tools/profile_compiler.py para include/test_profiles_data.h; o
+ * firmware só decodifica opcodes de tamanho fixo, sem parsing de texto.
+ *
+ * Formato (little-endian):
+ *   'S' 'P' <versão> <N> <nome[N]>  seguido de opcodes até PROFILE_OP_END
+ *
+ * Unidades inteiras: posições em centésimos de mm (compressão a partir do
+ * zero aliviado), forças em gramas, K em milésimos de kgf/mm.
+ */
+constexpr uint8_t PROFILE_MAGIC0  = 'S';
+constexpr uint8_t PROFILE_MAGIC1  = 'P';
+constexpr uint8_t PROFILE_VERSION = 1;
+constexpr int     PROFILE_NAME_MAX = 15;      // nome = código da peça nos perfis de produção
+constexpr int     PROFILE_MAX_FORCE_CHECKS = 4;
+
+enum ProfileOp : uint8_t {
+    PROFILE_OP_END         = 0x00,
+    // Configuração (valem para o programa inteiro)
+    PROFILE_OP_COURSE      = 0x01,  // u16 curso máximo (cmm): limite de segurança e escala do gráfico
+    PROFILE_OP_CONTACT     = 0x02,  // u16 força de contato (g)
+    PROFILE_OP_APPROACH    = 0x03,  // u16 usDelay da busca de contato em pulsos
+    PROFILE_OP_LIMIT_FORCE = 0x04,  // u16 força máxima (g): aborta a compressão acima disso
+    PROFILE_OP_LIMIT_K     = 0x05,  // u16 K mín, u16 K máx (mkgf/mm): aprovado/reprovado
+    PROFILE_OP_K_NOMINAL   = 0x06,  // u16 K nominal (mkgf/mm), u16 tolerância (0,1 %): define K mín/máx
+    PROFILE_OP_FORCE_AT    = 0x07,  // u16 posição (cmm), u16 força mín, u16 força máx (g)
+    PROFILE_OP_FREE_LENGTH = 0x08,  // u16 comprimento livre nominal (cmm), u16 tolerância (cmm)
+    // Parâmetros modais (valem para os passos seguintes)
+    PROFILE_OP_SPEED       = 0x10,  // u16 usDelay da compressão
+    PROFILE_OP_FILTER      = 0x11,  // u8 média de N leituras, u16 acomodação (ms), u16 intervalo entre leituras (ms)
+    // Passos
+    PROFILE_OP_SAMPLE      = 0x20,  // u16 posição (cmm)
+    PROFILE_OP_RANGE       = 0x21,  // u16 início, u16 fim, u16 passo (cmm), fim incluso
+    PROFILE_OP_DWELL       = 0x22   // u16 ms parado na posição atual
+};
+
+// Entrada da tabela gerada (programa na flash)
+struct TestProfileEntry {
+    const uint8_t* data;
+    uint16_t       size;
+};
+
+// Força em um comprimento de compressão (checagem de desenho da peça)
+struct ForceCheck {
+    float xMm;
+    float minKg;
+    float maxKg;
+};
+
+struct ProfileSettings {
+    char     name[PROFILE_NAME_MAX + 1];
+    float    courseMm;
+    float    contactForceKg;
+    uint16_t approachUsDelay;
+    float    maxForceKg;        // 0 = sem limite
+    float    kNominalKgfMm;     // 0 = só faixa (LIMIT_K) ou sem critério
+    float    kMinKgfMm;         // kMin == kMax == 0: sem critério de aprovação
+    float    kMaxKgfMm;
+    ForceCheck forceChecks[PROFILE_MAX_FORCE_CHECKS];  // ordenadas por posição
+    uint8_t  forceCheckCount;
+    float    freeLengthMm;      // 0 = sem checagem de comprimento livre
+    float    freeLengthTolMm;
+    uint16_t sampleCount;       // pontos gerados pelo programa
+
+    bool hasKLimits() const { return kMaxKgfMm > 0.0f; }
+    bool hasFreeLength() const { return freeLengthMm > 0.0f; }
+    bool hasLimits() const {
+        return hasKLimits() || hasFreeLength() || forceCheckCount > 0 || maxForceKg > 0.0f;
+    }
+};
+
+enum ProfileStepKind : uint8_t {
+    PROFILE_STEP_SAMPLE = 0,
+    PROFILE_STEP_DWELL,
+    PROFILE_STEP_END
+};
+
+struct ProfileStep {
+    ProfileStepKind kind;
+    uint16_t index;            // índice da amostra (SAMPLE)
+    float    positionMm;       // compressão alvo (SAMPLE)
+    uint16_t usDelay;
+    uint8_t  average;
+    uint16_t settleMs;
+    uint16_t readIntervalMs;
+    uint16_t dwellMs;          // DWELL
+};
+
+/**
+ * @brief Interpretador de perfis: entrega um passo por chamada
+ *
+ * load() percorre o programa uma vez para validar tamanhos/opcodes e
+ * extrair a configuração; next() então produz os passos (faixas são
+ * expandidas sob demanda). Não depende de Arduino nem do hardware: o
+ * grafset executa os passos, e no host pode ser exercitado isoladamente.
+ */
+class ProfileInterpreter {
+public:
+    bool load(const uint8_t* program, size_t size);
+    void rewind();
+    bool next(ProfileStep* out);   // false no fim do programa
+
+    bool loaded() const { return _program != nullptr; }
+    const ProfileSettings& settings() const { return _settings; }
+    const char* error() const { return _error; }
+
+private:
+    const uint8_t* _program = nullptr;
+    size_t   _size = 0;
+    size_t   _bodyStart = 0;
+    size_t   _pc = 0;
+    const char* _error = nullptr;
+    ProfileSettings _settings = {};
+
+    // Estado modal
+    uint16_t _usDelay = 0;
+    uint8_t  _average = 0;
+    uint16_t _settleMs = 0;
+    uint16_t _readIntervalMs = 0;
+    uint16_t _sampleIndex = 0;
+
+    // Faixa em expansão
+    bool     _inRange = false;
+    uint32_t _rangeNext = 0;
+    uint16_t _rangeEnd = 0;
+    uint16_t _rangeStep = 0;
+
+    bool fail(const char* msg) { _error = msg; _program = nullptr; return false; }
+    void resetModal();
+    void emitSample(ProfileStep* out, uint16_t cmm);
+};
+
+// Tamanho dos operandos de cada opcode (-1 = opcode desconhecido)
+int profileOperandSize(uint8_t op);
+
+#endif // TEST_PROFILE_H
@@ -0,0 +1,60 @@
+// Gerado por tools/profile_compiler.py a partir de tools/test_profiles.txt - NAO EDITAR
+#ifndef TEST_PROFILES_DATA_H
+#define TEST_PROFILES_DATA_H
+
+#include "test_profile.h"
+
+// Curso 10 mm (41 bytes)
+constexpr uint8_t TEST_PROFILE_0[] = {
+    0x53, 0x50, 0x01, 0x0B, 0x43, 0x75, 0x72, 0x73, 0x6F, 0x20, 0x31, 0x30,
+    0x20, 0x6D, 0x6D, 0x01, 0xE8, 0x03, 0x02, 0x2C, 0x01, 0x03, 0x64, 0x00,
+    0x10, 0x20, 0x03, 0x11, 0x05, 0x64, 0x00, 0x14, 0x00, 0x21, 0x00, 0x00,
+    0xE8, 0x03, 0x64, 0x00, 0x00,
+};
+
+// Curso 8 mm (40 bytes)
+constexpr uint8_t TEST_PROFILE_1[] = {
+    0x53, 0x50, 0x01, 0x0A, 0x43, 0x75, 0x72, 0x73, 0x6F, 0x20, 0x38, 0x20,
+    0x6D, 0x6D, 0x01, 0x20, 0x03, 0x02, 0x2C, 0x01, 0x03, 0x64, 0x00, 0x10,
+    0x20, 0x03, 0x11, 0x05, 0x64, 0x00, 0x14, 0x00, 0x21, 0x00, 0x00, 0x20,
+    0x03, 0x64, 0x00, 0x00,
+};
+
+// Curso 5 mm (40 bytes)
+constexpr uint8_t TEST_PROFILE_2[] = {
+    0x53, 0x50, 0x01, 0x0A, 0x43, 0x75, 0x72, 0x73, 0x6F, 0x20, 0x35, 0x20,
+    0x6D, 0x6D, 0x01, 0xF4, 0x01, 0x02, 0x2C, 0x01, 0x03, 0x64, 0x00, 0x10,
+    0x20, 0x03, 0x11, 0x05, 0x64, 0x00, 0x14, 0x00, 0x21, 0x00, 0x00, 0xF4,
+    0x01, 0x64, 0x00, 0x00,
+};
+
+// Fino 6 mm (61 bytes)
+constexpr uint8_t TEST_PROFILE_3[] = {
+    0x53, 0x50, 0x01, 0x09, 0x46, 0x69, 0x6E, 0x6F, 0x20, 0x36, 0x20, 0x6D,
+    0x6D, 0x01, 0x58, 0x02, 0x02, 0x2C, 0x01, 0x03, 0x64, 0x00, 0x04, 0x1C,
+    0x25, 0x10, 0x20, 0x03, 0x11, 0x05, 0x64, 0x00, 0x14, 0x00, 0x21, 0x00,
+    0x00, 0xC8, 0x00, 0x32, 0x00, 0x21, 0x2C, 0x01, 0x58, 0x02, 0x64, 0x00,
+    0x11, 0x08, 0x2C, 0x01, 0x14, 0x00, 0x22, 0xD0, 0x07, 0x20, 0x58, 0x02,
+    0x00,
+};
+
+// PN 4471-A (66 bytes)
+constexpr uint8_t TEST_PROFILE_4[] = {
+    0x53, 0x50, 0x01, 0x09, 0x50, 0x4E, 0x20, 0x34, 0x34, 0x37, 0x31, 0x2D,
+    0x41, 0x01, 0x20, 0x03, 0x02, 0x2C, 0x01, 0x03, 0x64, 0x00, 0x08, 0xD0,
+    0x07, 0x32, 0x00, 0x06, 0x8A, 0x02, 0x64, 0x00, 0x07, 0x90, 0x01, 0x98,
+    0x08, 0xB8, 0x0B, 0x07, 0x20, 0x03, 0x5C, 0x12, 0xA8, 0x16, 0x04, 0x40,
+    0x1F, 0x10, 0x20, 0x03, 0x11, 0x05, 0x64, 0x00, 0x14, 0x00, 0x21, 0x00,
+    0x00, 0x20, 0x03, 0x64, 0x00, 0x00,
+};
+
+constexpr TestProfileEntry TEST_PROFILES[] = {
+    {TEST_PROFILE_0, sizeof(TEST_PROFILE_0)},
+    {TEST_PROFILE_1, sizeof(TEST_PROFILE_1)},
+    {TEST_PROFILE_2, sizeof(TEST_PROFILE_2)},
+    {TEST_PROFILE_3, sizeof(TEST_PROFILE_3)},
+    {TEST_PROFILE_4, sizeof(TEST_PROFILE_4)},
+};
+constexpr int TEST_PROFILES_COUNT = sizeof(TEST_PROFILES) / sizeof(TEST_PROFILES[0]);
+
+#endif // TEST_PROFILES_DATA_H
@@ -3,6 +3,9 @@
 
 #include <Arduino.h>
 #include <TMCStepper.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "tmc_register_cache.h"
 
 /**
  * @brief Gerenciador do driver TMC2209 com suporte a StallGuard
@@ -13,6 +16,11 @@
  * - StallGuard para detecção de colisão/travamento
  * - Recuo automático quando detectar stall
  * - Monitoramento contínuo de stall durante movimentos
+ *
+ * Os setters de configuração não fazem UART: alteram registradores shadow
+ * (TmcRegisterCache) e a tarefa de fundo (StallGuardMonitor, core 0) envia
+ * só o que mudou, coalescendo escritas repetidas. Sem a tarefa, o envio é
+ * feito na própria chamada.
  */
 class TMC2209Manager {
 public:
@@ -22,6 +30,27 @@ public:
      */
     bool begin();
 
+    /**
+     * @brief Indica se o driver foi inicializado via UART (StallGuard disponível)
+     */
+    bool isReady() const;
+
+    /**
+     * @brief Envia os registradores pendentes ao driver (chamado pela tarefa de fundo)
+     */
+    void service();
+
+    /**
+     * @brief Passa o envio de registradores para a tarefa de fundo
+     */
+    void setAsyncService(bool enable);
+
+    /**
+     * @brief Aguarda o envio das escritas pendentes (ex.: antes de pulsar com novos microsteps)
+     * @return false se o tempo esgotar
+     */
+    bool waitFlushed(uint32_t timeoutMs);
+
     /**
      * @brief Configura corrente do motor (RMS e hold)
      * @param currentRMS Corrente RMS em mA (ex: 800 para NEMA11)
@@ -65,14 +94,28 @@ public:
     void markStallTreated();
 
     /**
-     * @brief Retorna leitura do valor StallGuard atual (para debug)
-     * Valores típicos: 0-511 (quanto menor, mais próximo do stall)
+     * @brief Retorna o último SG_RESULT (para debug)
+     * Valores típicos: 0-511 (quanto menor, mais próximo do stall). Com a
+     * tarefa de fundo ativa devolve a última leitura dela, sem nova transação.
      */
     int getStallGuardValue();
 
+    /**
+     * @brief Lê SG_RESULT para a tarefa de monitoramento (thread-safe)
+     * @param out Valor lido (0-510)
+     * @return false se a UART estiver ocupada ou o driver não responder
+     */
+    bool readStallGuard(uint16_t* out);
+
+    /**
+     * @brief Lê o contador de micropasso MSCNT (0-1023, 1/256 de micropasso)
+     * @return false se a UART não estiver disponível
+     */
+    bool readMicrostepCounter(uint16_t* out);
+
     /**
      * @brief Verifica se comunicação UART está funcionando
-     * @return true se driver responde corretamente
+     * @return true se o driver respondeu na inicialização (valor em cache, sem UART)
      */
     bool isCommunicationOK();
 
@@ -83,10 +126,16 @@ public:
     void enableStealthChop(bool enable);
 
     /**
-     * @brief Obtém status de diagnóstico do driver
-     * @return String com informações de status (corrente, temperatura, erros)
+     * @brief Obtém status de diagnóstico do driver (sem alocação dinâmica)
+     * @param buf Buffer de saída (ex.: 128 bytes)
+     * @param len Tamanho do buffer
+     * @return Número de caracteres escritos (como snprintf)
      */
-    String getDiagnostics();
+    int getDiagnostics(char* buf, size_t len);
+
+    // Contadores do cache (transações UART efetivas x escritas pedidas)
+    uint32_t uartTransactions() const { return _uartTransactions; }
+    const TmcRegisterCache& registers() const { return _regs; }
 
 private:
     TMC2209Stepper* _driver = nullptr;
@@ -96,6 +145,23 @@ private:
     
     // Hardware Serial para comunicação UART
     HardwareSerial* _serial = nullptr;
+
+    // A UART é compartilhada entre o loop (configuração) e a tarefa de
+    // monitoramento do StallGuard no core 0: toda transação passa pelo mutex
+    SemaphoreHandle_t _uartMutex = nullptr;
+    bool lockUart(TickType_t timeout = portMAX_DELAY);
+    void unlockUart();
+
+    TmcRegisterCache _regs;
+    portMUX_TYPE _regsMux = portMUX_INITIALIZER_UNLOCKED;
+    volatile bool _asyncService = false;
+    volatile bool _commOk = false;
+    volatile int  _lastSg = -1;
+    uint32_t _uartTransactions = 0;
+
+    void writeReg(TmcReg reg, uint32_t value);
+    void modifyReg(TmcReg reg, uint32_t clearMask, uint32_t setBits);
+    void sendReg(TmcReg reg, uint32_t value);
 };
 
 extern TMC2209Manager tmc2209Manager;
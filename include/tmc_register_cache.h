@@ -0,0 +1,106 @@
+#ifndef TMC_REGISTER_CACHE_H
+#define TMC_REGISTER_CACHE_H
+
+#include <cstdint>
+
+/**
+ * @brief Registradores do TMC2209 mantidos em cópia local (shadow)
+ */
+enum TmcReg : uint8_t {
+    TMC_REG_GCONF = 0,
+    TMC_REG_IHOLD_IRUN,
+    TMC_REG_CHOPCONF,
+    TMC_REG_TCOOLTHRS,
+    TMC_REG_SGTHRS,
+    TMC_REG_COUNT
+};
+
+// Campos usados pelo firmware (datasheet TMC2209, seção 5)
+constexpr uint32_t TMC_GCONF_EN_SPREADCYCLE = 1UL << 2;
+constexpr uint32_t TMC_CHOPCONF_VSENSE      = 1UL << 17;
+constexpr int      TMC_CHOPCONF_MRES_SHIFT  = 24;
+constexpr uint32_t TMC_CHOPCONF_MRES_MASK   = 0xFUL << TMC_CHOPCONF_MRES_SHIFT;
+constexpr uint32_t TMC_IHOLD_MASK           = 0x1FUL;
+constexpr int      TMC_IRUN_SHIFT           = 8;
+constexpr uint32_t TMC_IRUN_MASK            = 0x1FUL << TMC_IRUN_SHIFT;
+
+/**
+ * @brief Cache de registradores com coalescência de escritas
+ *
+ * write() só atualiza a cópia local e marca o registrador como pendente;
+ * várias escritas antes do envio resultam em uma única transação UART com o
+ * último valor, e escritas iguais ao valor já presente no driver são
+ * descartadas. takePending()/commit() são usados pela tarefa que fala com a
+ * UART. Sem sincronização própria: quem usa protege com seção crítica.
+ */
+class TmcRegisterCache {
+public:
+    // Define o valor conhecido do driver (após inicialização síncrona)
+    void seed(TmcReg reg, uint32_t value) {
+        _shadow[reg] = value;
+        _applied[reg] = value;
+        _pendingMask &= ~bit(reg);
+    }
+
+    // Retorna true se a escrita gerou (ou manteve) uma transação pendente
+    bool write(TmcReg reg, uint32_t value) {
+        ++_requested;
+        if (_pendingMask & bit(reg)) {
+            ++_coalesced;   // substitui a escrita ainda não enviada
+        }
+        _shadow[reg] = value;
+        if (value == _applied[reg]) {
+            _pendingMask &= ~bit(reg);
+            ++_skipped;
+            return false;
+        }
+        _pendingMask |= bit(reg);
+        return true;
+    }
+
+    // Próximo registrador pendente (em ordem de índice); false se nenhum
+    bool takePending(TmcReg* outReg, uint32_t* outValue) const {
+        for (uint8_t r = 0; r < TMC_REG_COUNT; ++r) {
+            if (_pendingMask & bit((TmcReg)r)) {
+                *outReg = (TmcReg)r;
+                *outValue = _shadow[r];
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Confirma que value foi escrito no driver. Uma escrita feita durante o
+    // envio pode ter limpado o pendente (igual ao valor antigo do driver):
+    // o pendente passa a ser shadow != valor enviado
+    void commit(TmcReg reg, uint32_t value) {
+        _applied[reg] = value;
+        ++_flushed;
+        if (_shadow[reg] == value) {
+            _pendingMask &= ~bit(reg);
+        } else {
+            _pendingMask |= bit(reg);
+        }
+    }
+
+    uint32_t shadow(TmcReg reg) const { return _shadow[reg]; }
+    bool hasPending() const { return _pendingMask != 0; }
+
+    uint32_t requested() const { return _requested; }  // chamadas de write()
+    uint32_t coalesced() const { return _coalesced; }  // sobrescritas antes do envio
+    uint32_t skipped() const { return _skipped; }      // iguais ao valor do driver
+    uint32_t flushed() const { return _flushed; }      // transações UART efetivas
+
+private:
+    uint32_t _shadow[TMC_REG_COUNT] = {};
+    uint32_t _applied[TMC_REG_COUNT] = {};
+    uint8_t  _pendingMask = 0;
+    uint32_t _requested = 0;
+    uint32_t _coalesced = 0;
+    uint32_t _skipped = 0;
+    uint32_t _flushed = 0;
+
+    static uint8_t bit(TmcReg reg) { return (uint8_t)(1u << reg); }
+};
+
+#endif // TMC_REGISTER_CACHE_H
@@ -0,0 +1,78 @@
+#ifndef TRACE_PROBE_H
+#define TRACE_PROBE_H
+
+#include <cstdint>
+
+/**
+ * @brief Sondas de tempo para caminhos críticos (loop, balança, UI, grafset)
+ *
+ * PROBE_SCOPE(id) mede o tempo do escopo atual e acumula min/max/média e um
+ * histograma log2 (em µs) em memória estática. No ESP32 usa o contador de
+ * ciclos da CPU; fora do Arduino (build nativo) usa std::chrono, de modo que
+ * os números são comparáveis.
+ *
+ * Só é compilado com -DPROBES_ENABLED=1 (ambiente esp32dev_probes); no build
+ * normal as macros viram nada e não há custo algum.
+ */
+enum ProbeId : uint8_t {
+    PROBE_LOOP = 0,
+    PROBE_SCALE_UPDATE,
+    PROBE_UI_DRAW_TEST_STATUS,
+    PROBE_UI_PLOT_POINT,
+    PROBE_GRAFSET_TICK,
+    PROBE_MOLA_COMPRESSION_STEP,
+    PROBE_STEPPER_MOVE,
+    PROBE_SPC_ADD,
+    PROBE_UI_SPC_UPDATE,
+    PROBE_EXPORT_FRAME,
+    PROBE_COUNT
+};
+
+// Baldes do histograma: [0,1) µs, [1,2), [2,4), ... [2^(N-2), inf)
+constexpr int PROBE_HIST_BUCKETS = 24;
+
+#ifndef PROBES_ENABLED
+#define PROBES_ENABLED 0
+#endif
+
+// Escreve uma linha por sonda (e histograma) via callback, sem alocação.
+// Com sondas desabilitadas apenas informa que não há dados.
+void probeDump(void (*writeLine)(const char* line));
+void probeReset();
+
+#if PROBES_ENABLED
+
+struct ProbeStats {
+    uint32_t count;
+    uint32_t minTicks;
+    uint32_t maxTicks;
+    uint64_t sumTicks;
+    uint32_t hist[PROBE_HIST_BUCKETS];
+};
+
+uint32_t probeNowTicks();
+void probeRecord(ProbeId id, uint32_t ticks);
+const ProbeStats& probeStats(ProbeId id);
+const char* probeName(ProbeId id);
+
+class ScopedProbe {
+public:
+    explicit ScopedProbe(ProbeId id) : _id(id), _t0(probeNowTicks()) {}
+    ~ScopedProbe() { probeRecord(_id, probeNowTicks() - _t0); }
+
+private:
+    ProbeId  _id;
+    uint32_t _t0;
+};
+
+#define PROBE_CONCAT_INNER(a, b) a##b
+#define PROBE_CONCAT(a, b) PROBE_CONCAT_INNER(a, b)
+#define PROBE_SCOPE(id) ScopedProbe PROBE_CONCAT(_probe_, __LINE__)(id)
+
+#else
+
+#define PROBE_SCOPE(id) ((void)0)
+
+#endif // PROBES_ENABLED
+
+#endif // TRACE_PROBE_H
@@ -3,6 +3,8 @@
 
 #include <Arduino.h>
 
+class SpcBatch;
+
 // Modo geral da tela
 enum UiMode {
     UI_MODE_MENU = 0,
@@ -43,14 +45,24 @@ public:
     void plotGraphPointYellow(float xNorm, float yNorm, bool firstPoint);
 
     // Desenha valor de K na lista lateral (incrementalmente)
-    // step: número do passo (0, 1, 2...)
+    // row: linha da lista (índice da amostra: 0, 1, 2...)
+    // xMm: compressão do ponto em mm
     // k_kgf_mm: valor da constante elástica em kgf/mm
     // k_N_mm: valor da constante elástica em N/mm
-    void drawKValueAtStep(int step, float k_kgf_mm, float k_N_mm);
+    void drawKValueAtStep(int row, float xMm, float k_kgf_mm, float k_N_mm);
 
     // Limpa a área do gráfico
     void clearGraphArea();
 
+    // ---- TELA DE CEP (SPC) DO LOTE ----
+    // Cartas X-barra/R, limites de controle/tolerância e painel (média, desvio, Cpk)
+    // drawSpcScreen: desenha tudo (fundo + pontos da página atual)
+    // updateSpcScreen: só o novo ponto e o painel; refaz o fundo se a escala
+    // ou os limites mudarem de forma visível
+    void drawSpcScreen(const SpcBatch& batch);
+    void updateSpcScreen(const SpcBatch& batch);
+    void invalidateSpcScreen();
+
     // ---- TELA DE CALIBRAÇÃO DA BALANÇA ----
     // stage: 0 = aguardando início, 1 = após tara, aguardando peso, 2 = concluído
     void drawCalibScreen(uint8_t stage,
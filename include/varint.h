@@ -0,0 +1,48 @@
+#ifndef VARINT_H
+#define VARINT_H
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Inteiros de tamanho variável (LEB128) e zigzag
+ *
+ * Varint: 7 bits por byte, bit 7 = continua. Zigzag leva inteiros com
+ * sinal pequenos (deltas) para sem sinal pequenos: 0,-1,1,-2 -> 0,1,2,3.
+ * Um delta de |d| < 64 ocupa 1 byte. Sem dependência de Arduino.
+ */
+constexpr int VARINT_MAX_BYTES = 5;   // uint32_t
+
+inline uint32_t zigzagEncode(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+inline int32_t zigzagDecode(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+// Escreve v em out (até VARINT_MAX_BYTES); retorna bytes escritos
+inline size_t varintPut(uint8_t* out, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+// Lê um varint de [in, in+len); retorna bytes consumidos (0 se truncado/inválido)
+inline size_t varintGet(const uint8_t* in, size_t len, uint32_t* v) {
+    uint32_t result = 0;
+    for (size_t i = 0; i < len && i < (size_t)VARINT_MAX_BYTES; ++i) {
+        result |= (uint32_t)(in[i] & 0x7F) << (7 * i);
+        if ((in[i] & 0x80) == 0) {
+            *v = result;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+#endif // VARINT_H
@@ -0,0 +1,79 @@
+#ifndef ZERO_TRACKER_H
+#define ZERO_TRACKER_H
+
+#include <cstdint>
+
+// Parâmetros em contagens do HX711 (ScaleManager converte de kg)
+struct ZeroTrackerConfig {
+    uint32_t observeIntervalMs;   // no máximo uma observação por intervalo
+    float    stableCounts;        // desvio padrão máximo da janela
+    float    maxJumpCounts;       // |média - previsão| acima disso = carga, não deriva
+    float    forgetting;          // fator de esquecimento do RLS (0.98..1)
+};
+
+/**
+ * @brief Rastreamento do zero da célula de carga (deriva por tempo e temperatura)
+ *
+ * Modelo único para o turno: offset(t, T) = a + b*(t - t0)[h] + c*(T - T0)[°C],
+ * ajustado por mínimos quadrados recursivos com esquecimento; t0 e T0 são os
+ * da primeira tara. observe() recebe cada leitura bruta com a balança ociosa;
+ * é a própria medida que diz se a célula está descarregada: só quando a
+ * janela de ZERO_TRACK_WINDOW leituras está estável e perto da previsão a
+ * média entra no ajuste (no máximo uma vez por intervalo). Carga, vibração
+ * ou toque reprovam a janela. interrupt() descarta a janela em curso (teste
+ * rodando: nenhuma leitura dele vira observação).
+ *
+ * tare() também é uma observação do modelo, e o resíduo que sobra vira um
+ * viés somado à previsão: logo após a tara offsetAt() devolve o valor medido,
+ * e o viés decai a cada observação aceita. Uma tara longe da previsão (troca
+ * de fixação) desloca a e reabre sua incerteza em vez de entrar no ajuste.
+ * Só a tara com a plataforma livre (boot, menu) deve chegar aqui: a tara de
+ * um teste inclui a mola e a fixação. offsetAt() custa três multiplicações.
+ * Temperatura NaN = sem sensor. Sem dependência de Arduino.
+ */
+class ZeroTracker {
+public:
+    static constexpr int ZERO_TRACK_WINDOW = 8;
+
+    void begin(const ZeroTrackerConfig& cfg);
+    void tare(float offsetCounts, uint32_t nowMs, float tempC);
+
+    // true se a janela foi aceita como observação do zero
+    bool observe(int32_t raw, uint32_t nowMs, float tempC);
+    // Descarta a janela em curso (leituras seguintes começam outra)
+    void interrupt() { _windowCount = 0; }
+
+    float offsetAt(uint32_t nowMs, float tempC) const;
+
+    float driftCountsPerHour() const { return _theta[1]; }
+    float tempCoefCountsPerC() const { return _theta[2]; }
+    uint32_t accepted() const { return _accepted; }
+    uint32_t rejected() const { return _rejected; }
+
+private:
+    ZeroTrackerConfig _cfg = {};
+    bool     _anchored = false;
+    uint32_t _originMs = 0;
+    float    _originTempC = 0.0f;
+    bool     _hasTemp = false;
+    float    _bias = 0.0f;          // resíduo da última tara (decai)
+
+    // RLS: theta = [a, b, c], P = covariância (3x3)
+    float _theta[3] = {0.0f, 0.0f, 0.0f};
+    float _P[3][3] = {};
+
+    // Janela de leituras ociosas consecutivas
+    int32_t  _window[ZERO_TRACK_WINDOW] = {};
+    int      _windowCount = 0;
+    int      _windowHead = 0;
+    uint32_t _lastObserveMs = 0;
+    bool     _observedOnce = false;
+
+    uint32_t _accepted = 0;
+    uint32_t _rejected = 0;
+
+    void regressors(uint32_t nowMs, float tempC, float phi[3]) const;
+    void rlsUpdate(const float phi[3], float y);
+};
+
+#endif // ZERO_TRACKER_H
@@ -0,0 +1,174 @@
+#include "command_parser.h"
+#include "config.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+struct VerbEntry {
+    const char* name;
+    CommandId   id;
+};
+
+static const VerbEntry VERBS[] = {
+    {"HELP",     CMD_HELP},
+    {"STATUS",   CMD_STATUS},
+    {"PROFILES", CMD_PROFILES},
+    {"START",    CMD_START},
+    {"ABORT",    CMD_ABORT},
+    {"TARE",     CMD_TARE},
+    {"CAL",      CMD_CAL},
+    {"JOG",      CMD_JOG},
+    {"RESULT",   CMD_RESULT},
+    {"PROBES",   CMD_PROBES},
+    {"TRACE",    CMD_TRACE},
+    {"EXPORT",   CMD_EXPORT},
+    {"STORE",    CMD_STORE},
+    {"STEPBENCH", CMD_STEPBENCH},
+    {"HOMESIM",  CMD_HOMESIM},
+    {"HOME",     CMD_HOME},
+};
+
+static char upper(char c) {
+    return (c >= 'a' && c <= 'z') ? (char)(c - 'a' + 'A') : c;
+}
+
+CommandId commandIdFromVerb(const char* verb) {
+    for (const VerbEntry& v : VERBS) {
+        if (strcmp(verb, v.name) == 0) return v.id;
+    }
+    return CMD_UNKNOWN;
+}
+
+const char* commandErrorName(CommandError err) {
+    switch (err) {
+        case CMD_ERR_TOO_LONG:      return "token_too_long";
+        case CMD_ERR_TOO_MANY_ARGS: return "too_many_args";
+        case CMD_ERR_BAD_CHAR:      return "bad_char";
+        default:                    return "none";
+    }
+}
+
+RemoteStartGate remoteStartGate(bool homed, float positionMm) {
+    if (!homed) return REMOTE_START_NOT_HOMED;
+    if (fabsf(positionMm - SPRING_PLACEMENT_MM) > REMOTE_START_PARK_TOL_MM) return REMOTE_START_NOT_PARKED;
+    return REMOTE_START_OK;
+}
+
+const char* remoteStartGateName(RemoteStartGate gate) {
+    switch (gate) {
+        case REMOTE_START_NOT_HOMED:  return "not_homed";
+        case REMOTE_START_NOT_PARKED: return "not_parked";
+        default:                      return "none";
+    }
+}
+
+void CommandParser::resetLine() {
+    _cmd.id = CMD_NONE;
+    _cmd.error = CMD_ERR_NONE;
+    _cmd.argc = 0;
+    _cmd.verb[0] = '\0';
+    _state = ST_GAP;
+    _tokenIndex = 0;
+    _tokenLen = 0;
+    _delivered = false;
+}
+
+void CommandParser::fail(CommandError err) {
+    // Mantém o verbo legível para a resposta ERR
+    if (_tokenIndex == 0) _cmd.verb[_tokenLen] = '\0';
+    _cmd.error = err;
+    _state = ST_DISCARD;
+}
+
+void CommandParser::finishToken() {
+    if (_tokenIndex == 0) {
+        _cmd.verb[_tokenLen] = '\0';
+    } else {
+        _cmd.args[_tokenIndex - 1][_tokenLen] = '\0';
+        _cmd.argc = _tokenIndex;
+    }
+    ++_tokenIndex;
+    _tokenLen = 0;
+}
+
+bool CommandParser::feed(uint8_t c) {
+    // Comando anterior fica válido até o primeiro byte da linha seguinte
+    if (_delivered) resetLine();
+
+    if (c == '\r') return false;
+
+    if (c == '\n') {
+        if (_state == ST_TOKEN) finishToken();
+        if (_tokenIndex == 0 && _cmd.error == CMD_ERR_NONE) {
+            resetLine();   // linha vazia
+            return false;
+        }
+        if (_cmd.error == CMD_ERR_NONE) {
+            _cmd.id = commandIdFromVerb(_cmd.verb);
+        }
+        _delivered = true;
+        return true;
+    }
+
+    if (_state == ST_DISCARD) return false;
+
+    if (c == ' ' || c == '\t') {
+        if (_state == ST_TOKEN) {
+            finishToken();
+            _state = ST_GAP;
+        }
+        return false;
+    }
+
+    if (c < 0x21 || c > 0x7E) {
+        fail(CMD_ERR_BAD_CHAR);
+        return false;
+    }
+
+    if (_state == ST_GAP) {
+        if (_tokenIndex > CMD_MAX_ARGS) {
+            fail(CMD_ERR_TOO_MANY_ARGS);
+            return false;
+        }
+        _state = ST_TOKEN;
+    }
+    if (_tokenLen >= CMD_TOKEN_MAX) {
+        fail(CMD_ERR_TOO_LONG);
+        return false;
+    }
+    if (_tokenIndex == 0) {
+        _cmd.verb[_tokenLen++] = upper((char)c);
+    } else {
+        _cmd.args[_tokenIndex - 1][_tokenLen++] = (char)c;
+    }
+    return false;
+}
+
+bool Command::argFloat(int i, float* out) const {
+    if (i < 0 || i >= argc) return false;
+    char* end = nullptr;
+    float v = strtof(args[i], &end);
+    if (end == args[i] || *end != '\0') return false;
+    *out = v;
+    return true;
+}
+
+bool Command::argInt(int i, long* out) const {
+    if (i < 0 || i >= argc) return false;
+    char* end = nullptr;
+    long v = strtol(args[i], &end, 10);
+    if (end == args[i] || *end != '\0') return false;
+    *out = v;
+    return true;
+}
+
+bool Command::argIs(int i, const char* word) const {
+    if (i < 0 || i >= argc) return false;
+    const char* a = args[i];
+    while (*a && *word) {
+        if (upper(*a) != upper(*word)) return false;
+        ++a;
+        ++word;
+    }
+    return *a == '\0' && *word == '\0';
+}
@@ -0,0 +1,124 @@
+#include "curve_codec.h"
+#include "varint.h"
+#include <cstring>
+
+size_t curveEncode(const CurveMeta& meta, const CurveSample* samples, int count,
+                   uint8_t* out, size_t cap, int checkpointInterval) {
+    if (count < 0 || count > 0xFFFF || checkpointInterval < 1 || checkpointInterval > 255) return 0;
+    if (cap < curveMaxBytes(count, checkpointInterval)) return 0;
+
+    CurveBlobHeader hdr = {};
+    hdr.magic = CURVE_MAGIC;
+    hdr.version = CURVE_VERSION;
+    hdr.checkpointInterval = (uint8_t)checkpointInterval;
+    hdr.sampleCount = (uint16_t)count;
+    hdr.checkpointCount = (uint16_t)((count + checkpointInterval - 1) / checkpointInterval);
+    hdr.meta = meta;
+    if (count > 0) {
+        hdr.meta.startUs = samples[0].timestampUs;
+        hdr.meta.endUs = samples[count - 1].timestampUs;
+    }
+
+    uint8_t* table = out + sizeof(hdr);
+    uint8_t* data = table + hdr.checkpointCount * sizeof(CurveCheckpoint);
+    uint32_t n = 0;
+
+    for (int i = 0; i < count; ++i) {
+        const CurveSample& s = samples[i];
+        if (i % checkpointInterval == 0) {
+            // Âncora: amostra absoluta; deltas recomeçam a partir dela
+            CurveCheckpoint cp;
+            cp.dataOffset = n;
+            cp.stepPos = s.stepPos;
+            cp.rawCount = s.rawCount;
+            cp.timestampUs = s.timestampUs;
+            memcpy(table + (i / checkpointInterval) * sizeof(cp), &cp, sizeof(cp));
+            continue;
+        }
+        const CurveSample& p = samples[i - 1];
+        n += varintPut(data + n, zigzagEncode(s.stepPos - p.stepPos));
+        n += varintPut(data + n, zigzagEncode(s.rawCount - p.rawCount));
+        n += varintPut(data + n, s.timestampUs - p.timestampUs);
+    }
+
+    hdr.dataBytes = n;
+    memcpy(out, &hdr, sizeof(hdr));
+    return (size_t)(data - out) + n;
+}
+
+bool CurveReader::open(const uint8_t* blob, size_t len) {
+    _table = nullptr;
+    _data = nullptr;
+    if (len < sizeof(_hdr)) return false;
+    memcpy(&_hdr, blob, sizeof(_hdr));
+    if (_hdr.magic != CURVE_MAGIC || _hdr.version != CURVE_VERSION ||
+        _hdr.checkpointInterval == 0) {
+        return false;
+    }
+    uint32_t expectedCps = (_hdr.sampleCount + _hdr.checkpointInterval - 1) / _hdr.checkpointInterval;
+    size_t tableBytes = (size_t)_hdr.checkpointCount * sizeof(CurveCheckpoint);
+    if (_hdr.checkpointCount != expectedCps ||
+        len < sizeof(_hdr) + tableBytes + _hdr.dataBytes) {
+        return false;
+    }
+    _table = blob + sizeof(_hdr);
+    _data = _table + tableBytes;
+    rewind();
+    return true;
+}
+
+void CurveReader::checkpoint(int k, CurveSample* s, uint32_t* pos) const {
+    CurveCheckpoint cp;
+    memcpy(&cp, _table + k * sizeof(cp), sizeof(cp));
+    s->stepPos = cp.stepPos;
+    s->rawCount = cp.rawCount;
+    s->timestampUs = cp.timestampUs;
+    *pos = cp.dataOffset;
+}
+
+bool CurveReader::decodeDelta(uint32_t* pos, CurveSample* s) const {
+    uint32_t dStep, dRaw, dT;
+    size_t used;
+    if ((used = varintGet(_data + *pos, _hdr.dataBytes - *pos, &dStep)) == 0) return false;
+    *pos += used;
+    if ((used = varintGet(_data + *pos, _hdr.dataBytes - *pos, &dRaw)) == 0) return false;
+    *pos += used;
+    if ((used = varintGet(_data + *pos, _hdr.dataBytes - *pos, &dT)) == 0) return false;
+    *pos += used;
+    s->stepPos += zigzagDecode(dStep);
+    s->rawCount += zigzagDecode(dRaw);
+    s->timestampUs += dT;
+    return true;
+}
+
+bool CurveReader::sampleAt(int index, CurveSample* out) const {
+    if (_table == nullptr || index < 0 || index >= _hdr.sampleCount) return false;
+    int k = index / _hdr.checkpointInterval;
+    CurveSample s;
+    uint32_t pos;
+    checkpoint(k, &s, &pos);
+    if (pos > _hdr.dataBytes) return false;
+    for (int i = k * _hdr.checkpointInterval; i < index; ++i) {
+        if (!decodeDelta(&pos, &s)) return false;
+    }
+    *out = s;
+    return true;
+}
+
+void CurveReader::rewind() {
+    _index = 0;
+    _pos = 0;
+}
+
+bool CurveReader::next(CurveSample* out) {
+    if (_table == nullptr || _index >= _hdr.sampleCount) return false;
+    if (_index % _hdr.checkpointInterval == 0) {
+        checkpoint(_index / _hdr.checkpointInterval, &_cur, &_pos);
+        if (_pos > _hdr.dataBytes) return false;
+    } else if (!decodeDelta(&_pos, &_cur)) {
+        return false;
+    }
+    ++_index;
+    *out = _cur;
+    return true;
+}
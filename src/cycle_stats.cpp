@@ -0,0 +1,91 @@
+#include "cycle_stats.h"
+#include <cmath>
+
+// 1 kgf·mm = 9.80665 N * 0.001 m = 9.80665 mJ
+static const float KGF_MM_TO_MJ = 9.80665f;
+
+// ============== CICLO ==============
+
+void CycleAccumulator::begin() {
+    _n = 0;
+    _sumX = _sumY = _sumXX = _sumXY = 0.0f;
+    _minF = _maxF = _maxX = 0.0f;
+    _lastX = _lastF = 0.0f;
+    _workKgfMm = 0.0f;
+}
+
+void CycleAccumulator::addSample(float xMm, float forceKg) {
+    if (_n == 0) {
+        _minF = _maxF = forceKg;
+        _maxX = xMm;
+    } else {
+        if (forceKg < _minF) _minF = forceKg;
+        if (forceKg > _maxF) _maxF = forceKg;
+        if (xMm > _maxX) _maxX = xMm;
+        // Trapézio entre a amostra anterior e a atual
+        _workKgfMm += 0.5f * (forceKg + _lastF) * (xMm - _lastX);
+    }
+    _sumX += xMm;
+    _sumY += forceKg;
+    _sumXX += xMm * xMm;
+    _sumXY += xMm * forceKg;
+    _lastX = xMm;
+    _lastF = forceKg;
+    _n++;
+}
+
+float CycleAccumulator::springRateKgfMm() const {
+    if (_n < 2) return 0.0f;
+    float n = (float)_n;
+    float denom = n * _sumXX - _sumX * _sumX;
+    if (denom == 0.0f) return 0.0f;
+    return (n * _sumXY - _sumX * _sumY) / denom;
+}
+
+float CycleAccumulator::energyMj() const {
+    return _workKgfMm * KGF_MM_TO_MJ;
+}
+
+// ============== RESUMO DE FADIGA ==============
+
+void FatigueSummary::begin() {
+    _cycles = 0;
+    _firstK = _lastK = _minK = _maxK = 0.0f;
+    _meanK = _m2K = 0.0f;
+    _minF = _maxF = 0.0f;
+    _meanEnergy = 0.0f;
+}
+
+void FatigueSummary::addCycle(const CycleAccumulator& cycle) {
+    float k = cycle.springRateKgfMm();
+    _cycles++;
+
+    if (_cycles == 1) {
+        _firstK = _minK = _maxK = k;
+        _minF = cycle.minForceKg();
+        _maxF = cycle.maxForceKg();
+    } else {
+        if (k < _minK) _minK = k;
+        if (k > _maxK) _maxK = k;
+        if (cycle.minForceKg() < _minF) _minF = cycle.minForceKg();
+        if (cycle.maxForceKg() > _maxF) _maxF = cycle.maxForceKg();
+    }
+    _lastK = k;
+
+    // Welford: estável mesmo após milhares de ciclos
+    float delta = k - _meanK;
+    _meanK += delta / (float)_cycles;
+    _m2K += delta * (k - _meanK);
+
+    _meanEnergy += (cycle.energyMj() - _meanEnergy) / (float)_cycles;
+}
+
+float FatigueSummary::stdDevK() const {
+    if (_cycles < 2) return 0.0f;
+    return sqrtf(_m2K / (float)(_cycles - 1));
+}
+
+float FatigueSummary::driftPercent() const {
+    if (_cycles < 2 || _firstK == 0.0f) return 0.0f;
+    return 100.0f * (_lastK - _firstK) / _firstK;
+}
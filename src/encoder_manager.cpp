@@ -1,5 +1,6 @@
 #include "encoder_manager.h"
 #include "config.h"
+#include "event_trace.h"
 
 EncoderManager encoderManager;
 
@@ -113,6 +114,7 @@ bool EncoderManager::wasButtonClicked() {
 
     if (clicked) {
         _lastClickMillis = now;
+        TRACE_EVENT(EVT_ENCODER, TRACE_ENC_CLICK, _position);
         return true;
     }
     
@@ -130,6 +132,9 @@ bool EncoderManager::wasButtonLongPressed() {
         pressed = true;
     }
     interrupts();
+    if (pressed) {
+        TRACE_EVENT(EVT_ENCODER, TRACE_ENC_LONG_PRESS, _position);
+    }
     return pressed;
 }
 
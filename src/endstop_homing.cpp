@@ -0,0 +1,97 @@
+#include "endstop_homing.h"
+
+// Intervalo de consulta enquanto o debounce decide (latch pendente)
+static const uint32_t LATCH_POLL_US = 100;
+
+void EndstopLatch::arm(bool pressedNow, int32_t position) {
+    _edges = 0;
+    _rejected = 0;
+    _position = position;
+    _state = pressedNow ? LATCH_CONFIRMED : LATCH_ARMED;
+}
+
+bool IRAM_ATTR EndstopLatch::onEdge(bool pressed, int32_t position) {
+    // if/else em vez de switch: tabela de saltos iria para a flash (ISR em IRAM)
+    if (_state == LATCH_ARMED) {
+        if (!pressed) return false;
+        _position = position;
+        _edges = 1;
+        _state = LATCH_PENDING;
+        return true;
+    }
+    if (_state == LATCH_PENDING) {
+        _edges = _edges + 1;
+        return true;
+    }
+    return false;
+}
+
+void EndstopLatch::onDebounceTimer(bool pressed) {
+    if (_state != LATCH_PENDING) return;
+    if (pressed) {
+        _state = LATCH_CONFIRMED;
+    } else {
+        _rejected = _rejected + 1;
+        _state = LATCH_ARMED;
+    }
+}
+
+EndstopHomingReport runEndstopHoming(const EndstopHomingParams& p, const EndstopHomingHal& hal,
+                                     EndstopLatch* latch) {
+    EndstopHomingReport rep;
+    if (latch) latch->arm(hal.endstopPressed(hal.ctx), hal.position(hal.ctx));
+
+    while (true) {
+        if (latch) {
+            if (latch->stopRequested()) {
+                // A ISR já parou o laço; espera o temporizador de debounce
+                uint32_t waited = 0;
+                while (latch->pending() && waited < p.settleTimeoutUs) {
+                    hal.delayUs(LATCH_POLL_US, hal.ctx);
+                    waited += LATCH_POLL_US;
+                }
+                // Sinal que não estabiliza: decide pelo nível atual
+                if (latch->pending()) latch->onDebounceTimer(hal.endstopPressed(hal.ctx));
+                if (latch->confirmed()) {
+                    rep.result = ENDSTOP_HOME_OK;
+                    rep.homePosition = latch->position();
+                    break;
+                }
+                // Ruído descartado: a latch rearmou, segue em direção ao home
+            }
+        } else if (hal.endstopPressed(hal.ctx)) {
+            rep.result = ENDSTOP_HOME_OK;
+            rep.homePosition = hal.position(hal.ctx);
+            break;
+        }
+
+        if (rep.steps >= p.maxSteps) {
+            rep.result = ENDSTOP_HOME_NOT_FOUND;
+            break;
+        }
+        if (hal.abortRequested && hal.abortRequested(hal.ctx)) {
+            rep.result = ENDSTOP_HOME_ABORTED;
+            break;
+        }
+
+        hal.step(hal.ctx);
+        hal.delayUs(p.stepDelayUs, hal.ctx);
+        ++rep.steps;
+    }
+
+    if (latch) {
+        rep.edges = latch->edges();
+        rep.rejected = latch->rejected();
+        latch->disarm();
+    }
+    return rep;
+}
+
+const char* endstopHomingResultName(EndstopHomingResult r) {
+    switch (r) {
+        case ENDSTOP_HOME_OK:        return "OK";
+        case ENDSTOP_HOME_NOT_FOUND: return "sem fim de curso";
+        case ENDSTOP_HOME_ABORTED:   return "abortado";
+        default:                     return "?";
+    }
+}
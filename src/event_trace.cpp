@@ -0,0 +1,75 @@
+#include "event_trace.h"
+#include <cstdio>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+static TraceEvent s_events[TRACE_EVENT_CAPACITY];
+static uint32_t s_head = 0;   // total de eventos já gravados
+static uint16_t s_seq = 0;
+
+#ifdef ARDUINO
+// Protege o buffer contra gravações concorrentes (tarefas em outro núcleo)
+static portMUX_TYPE s_traceMux = portMUX_INITIALIZER_UNLOCKED;
+#define TRACE_LOCK()   portENTER_CRITICAL(&s_traceMux)
+#define TRACE_UNLOCK() portEXIT_CRITICAL(&s_traceMux)
+#else
+#define TRACE_LOCK()
+#define TRACE_UNLOCK()
+#endif
+
+static uint32_t traceNowUs() {
+#ifdef ARDUINO
+    return micros();
+#else
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+void traceRecord(TraceEventType type, uint8_t source, int32_t arg) {
+    uint32_t ts = traceNowUs();
+    TRACE_LOCK();
+    TraceEvent& e = s_events[s_head % TRACE_EVENT_CAPACITY];
+    e.tsUs = ts;
+    e.type = (uint8_t)type;
+    e.source = source;
+    e.seq = s_seq++;
+    e.arg = arg;
+    s_head++;
+    TRACE_UNLOCK();
+}
+
+void traceClear() {
+    TRACE_LOCK();
+    s_head = 0;
+    s_seq = 0;
+    TRACE_UNLOCK();
+}
+
+void traceDump(void (*writeLine)(const char* line)) {
+    char line[64];
+
+    // Foto do índice: eventos gravados durante o dump podem sobrescrever os
+    // mais antigos; o campo seq permite ao conversor descartá-los
+    TRACE_LOCK();
+    uint32_t head = s_head;
+    TRACE_UNLOCK();
+
+    uint32_t count = (head < (uint32_t)TRACE_EVENT_CAPACITY) ? head : (uint32_t)TRACE_EVENT_CAPACITY;
+    snprintf(line, sizeof(line), "TRACE begin %lu %lu",
+             (unsigned long)count, (unsigned long)(head - count));
+    writeLine(line);
+
+    for (uint32_t i = head - count; i < head; ++i) {
+        const TraceEvent& e = s_events[i % TRACE_EVENT_CAPACITY];
+        snprintf(line, sizeof(line), "EVT %lu %u %u %u %ld",
+                 (unsigned long)e.tsUs, (unsigned)e.type, (unsigned)e.source,
+                 (unsigned)e.seq, (long)e.arg);
+        writeLine(line);
+    }
+    writeLine("TRACE end");
+}
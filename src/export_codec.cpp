@@ -0,0 +1,199 @@
+#include "export_codec.h"
+#include "varint.h"
+#include "crc32.h"
+#include <cstdio>
+#include <cstring>
+
+static size_t putFloat(uint8_t* out, float v) {
+    memcpy(out, &v, 4);   // ESP32 e x86 são little-endian
+    return 4;
+}
+
+static void putU16(uint8_t* out, uint16_t v) {
+    out[0] = (uint8_t)v;
+    out[1] = (uint8_t)(v >> 8);
+}
+
+static void putU32(uint8_t* out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out[i] = (uint8_t)(v >> (8 * i));
+}
+
+size_t exportEncodeRecord(const ResultRecordHeader& h, const CurveMeta& meta,
+                          const CurveSample* samples, uint8_t* out, size_t cap) {
+    if (cap < exportRecordMaxBytes(h.sampleCount)) return 0;
+
+    size_t n = 0;
+    out[n++] = EXPORT_RECORD_TAG;
+    n += varintPut(out + n, h.seq);
+    n += varintPut(out + n, h.uptimeMs);
+    n += varintPut(out + n, h.sampleCount);
+    out[n++] = h.verdict;
+    out[n++] = h.reason;
+    out[n++] = h.flags;
+
+    size_t nameLen = strnlen(h.profile, RESULT_PROFILE_NAME_MAX);
+    out[n++] = (uint8_t)nameLen;
+    memcpy(out + n, h.profile, nameLen);
+    n += nameLen;
+
+    n += putFloat(out + n, meta.stepsPerMm);
+    n += putFloat(out + n, meta.calibFactor);
+    n += putFloat(out + n, h.kKgfMm);
+    n += putFloat(out + n, h.r2);
+    n += putFloat(out + n, h.maxForceKg);
+    n += varintPut(out + n, zigzagEncode(meta.tareOffset));
+    n += varintPut(out + n, zigzagEncode(meta.zeroSteps));
+
+    // Deltas: primeira amostra relativa ao zero de compressão e à tara
+    int32_t prevStep = meta.zeroSteps;
+    int32_t prevRaw = meta.tareOffset;
+    uint32_t prevT = 0;
+    for (int i = 0; i < h.sampleCount; ++i) {
+        const CurveSample& s = samples[i];
+        n += varintPut(out + n, zigzagEncode(s.stepPos - prevStep));
+        n += varintPut(out + n, zigzagEncode(s.rawCount - prevRaw));
+        n += varintPut(out + n, s.timestampUs - prevT);   // micros() dá a volta: módulo 2^32
+        prevStep = s.stepPos;
+        prevRaw = s.rawCount;
+        prevT = s.timestampUs;
+    }
+    return n;
+}
+
+size_t exportCsvBytes(const ResultRecordHeader& h, const CurveSample* samples) {
+    char line[80];
+    size_t total = (size_t)snprintf(line, sizeof(line), "%lu,%s,%.4f,%.4f,%u\n",
+                                    (unsigned long)h.seq, h.profile, h.kKgfMm, h.r2, h.verdict);
+    for (int i = 0; i < h.sampleCount; ++i) {
+        total += (size_t)snprintf(line, sizeof(line), "%ld,%ld,%lu\n",
+                                  (long)samples[i].stepPos, (long)samples[i].rawCount,
+                                  (unsigned long)samples[i].timestampUs);
+    }
+    return total;
+}
+
+// ================= LZSS =================
+static constexpr int LZ_MIN_MATCH  = 3;
+static constexpr int LZ_MAX_MATCH  = 18;     // 4 bits de comprimento
+static constexpr int LZ_MAX_DIST   = 4096;   // 12 bits de distância
+static constexpr int LZ_MAX_CHAIN  = 16;     // candidatos examinados por posição
+
+static inline int lzHash(const uint8_t* p) {
+    return ((p[0] << 6) ^ (p[1] << 3) ^ p[2]) & 1023;
+}
+
+size_t lzCompress(const uint8_t* in, size_t len, uint8_t* out, size_t cap, LzWorkspace& ws) {
+    if (len == 0 || len > EXPORT_CHUNK_BYTES) return 0;
+    for (int16_t& h : ws.head) h = -1;
+
+    size_t o = 0;
+    size_t ctrlPos = 0;
+    int items = 8;   // força um novo byte de controle no primeiro item
+    size_t i = 0;
+
+    while (i < len) {
+        if (items == 8) {
+            if (o >= cap) return 0;
+            ctrlPos = o++;
+            out[ctrlPos] = 0;
+            items = 0;
+        }
+
+        int bestLen = 0;
+        int bestDist = 0;
+        if (i + LZ_MIN_MATCH <= len) {
+            int h = lzHash(in + i);
+            int cand = ws.head[h];
+            int maxLen = (int)((len - i < (size_t)LZ_MAX_MATCH) ? len - i : LZ_MAX_MATCH);
+            for (int chain = 0; cand >= 0 && chain < LZ_MAX_CHAIN; ++chain) {
+                int dist = (int)i - cand;
+                if (dist > LZ_MAX_DIST) break;
+                int l = 0;
+                while (l < maxLen && in[cand + l] == in[i + l]) ++l;
+                if (l > bestLen) {
+                    bestLen = l;
+                    bestDist = dist;
+                    if (l == maxLen) break;
+                }
+                cand = ws.prev[cand];
+            }
+        }
+
+        // Posições consumidas entram no índice (hash das 3 próximas)
+        size_t advance = (bestLen >= LZ_MIN_MATCH) ? (size_t)bestLen : 1;
+        for (size_t k = 0; k < advance; ++k) {
+            size_t p = i + k;
+            if (p + LZ_MIN_MATCH <= len) {
+                int h = lzHash(in + p);
+                ws.prev[p] = ws.head[h];
+                ws.head[h] = (int16_t)p;
+            }
+        }
+
+        if (bestLen >= LZ_MIN_MATCH) {
+            if (o + 2 > cap) return 0;
+            int d = bestDist - 1;
+            out[ctrlPos] |= (uint8_t)(1 << items);
+            out[o++] = (uint8_t)(((d >> 8) << 4) | (bestLen - LZ_MIN_MATCH));
+            out[o++] = (uint8_t)d;
+        } else {
+            if (o + 1 > cap) return 0;
+            out[o++] = in[i];
+        }
+        i += advance;
+        ++items;
+    }
+    return (o < len) ? o : 0;
+}
+
+size_t lzDecompress(const uint8_t* in, size_t len, uint8_t* out, size_t cap) {
+    size_t i = 0;
+    size_t o = 0;
+    while (i < len) {
+        uint8_t ctrl = in[i++];
+        for (int bit = 0; bit < 8 && i < len; ++bit) {
+            if (ctrl & (1 << bit)) {
+                if (i + 2 > len) return 0;
+                int matchLen = (in[i] & 0x0F) + LZ_MIN_MATCH;
+                int dist = (((in[i] >> 4) << 8) | in[i + 1]) + 1;
+                i += 2;
+                if ((size_t)dist > o || o + matchLen > cap) return 0;
+                for (int k = 0; k < matchLen; ++k, ++o) out[o] = out[o - dist];
+            } else {
+                if (o >= cap) return 0;
+                out[o++] = in[i++];
+            }
+        }
+    }
+    return o;
+}
+
+// ================= QUADROS =================
+static size_t finishFrame(uint8_t* out, ExportFrameType type, uint32_t offset,
+                          size_t rawLen, size_t payloadLen) {
+    out[0] = EXPORT_FRAME_MAGIC0;
+    out[1] = EXPORT_FRAME_MAGIC1;
+    out[2] = type;
+    putU32(out + 3, offset);
+    putU16(out + 7, (uint16_t)rawLen);
+    putU16(out + 9, (uint16_t)payloadLen);
+    uint32_t crc = crc32Update(0, out + 2, 9 + payloadLen);
+    putU32(out + 11 + payloadLen, crc);
+    return EXPORT_FRAME_OVERHEAD + payloadLen;
+}
+
+size_t exportBuildFrame(uint32_t offset, const uint8_t* raw, size_t rawLen,
+                        uint8_t* out, LzWorkspace& ws) {
+    if (rawLen > EXPORT_CHUNK_BYTES) return 0;
+    uint8_t* payload = out + 11;
+    size_t packed = lzCompress(raw, rawLen, payload, rawLen, ws);
+    if (packed > 0) {
+        return finishFrame(out, EXPORT_FRAME_LZ, offset, rawLen, packed);
+    }
+    memcpy(payload, raw, rawLen);
+    return finishFrame(out, EXPORT_FRAME_STORED, offset, rawLen, rawLen);
+}
+
+size_t exportBuildEndFrame(uint32_t totalBytes, uint8_t* out) {
+    return finishFrame(out, EXPORT_FRAME_END, totalBytes, 0, 0);
+}
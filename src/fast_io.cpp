@@ -0,0 +1,4 @@
+#include "fast_io.h"
+
+// Porta simulada: usada por FastPin com o perfil SimRig ou fora do Arduino
+SimGpioPort simGpioPort;
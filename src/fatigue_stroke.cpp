@@ -0,0 +1,51 @@
+#include "fatigue_stroke.h"
+#include "config.h"
+#include <cmath>
+
+int buildFatigueStroke(MotionQueue& q, long zeroUnits, float unitsPerMm, uint16_t usDelay) {
+    int strokePoints = (int)(FATIGUE_COURSE_MM / FATIGUE_SAMPLE_STEP_MM);
+    q.clear();
+    for (int i = 0; i <= strokePoints; ++i) {
+        long target = zeroUnits - lroundf(fatigueStrokePointMm((uint16_t)i) * unitsPerMm);
+        q.push(target, usDelay, SEG_ACTION_SAMPLE, 0, (uint16_t)i);
+    }
+    q.push(zeroUnits, usDelay);
+    return strokePoints + 1;
+}
+
+float fatigueStrokePointMm(uint16_t tag) {
+    return (float)tag * FATIGUE_SAMPLE_STEP_MM;
+}
+
+void FatigueCycleGate::begin(int minSamples, uint32_t maxConsecutiveRejects) {
+    _minSamples = minSamples;
+    _maxConsecutive = maxConsecutiveRejects;
+    _rejected = 0;
+    _consecutive = 0;
+    _missed = 0;
+}
+
+bool FatigueCycleGate::onPoint(CycleAccumulator& cycle, uint16_t tag, bool fresh,
+                               float forceKg, float maxForceKg) {
+    _sampled = false;
+    if (!fresh) {
+        ++_missed;
+        return true;
+    }
+    // A conversão pronta no ponto 0 foi feita durante o retorno: só descarta
+    if (tag == 0) return true;
+    cycle.addSample(fatigueStrokePointMm(tag), forceKg);
+    _sampled = true;
+    return forceKg <= maxForceKg;
+}
+
+FatigueCycleOutcome FatigueCycleGate::endCycle(const CycleAccumulator& cycle, FatigueSummary& summary) {
+    if (cycle.count() < _minSamples) {
+        ++_rejected;
+        ++_consecutive;
+        return (_consecutive > _maxConsecutive) ? FATIGUE_CYCLE_HX711_LOST : FATIGUE_CYCLE_REJECTED;
+    }
+    _consecutive = 0;
+    summary.addCycle(cycle);
+    return FATIGUE_CYCLE_ACCEPTED;
+}
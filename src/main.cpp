@@ -3,9 +3,21 @@
 #include "config.h"
 #include "scale_manager.h"
 #include "stepper_manager.h"
+#include "tmc2209_manager.h"
+#include "stallguard_monitor.h"
 #include "encoder_manager.h"
 #include "ui_manager.h"
 #include "test_mola_grafset.h"
+#include "test_fadiga_grafset.h"
+#include "trace_probe.h"
+#include "event_trace.h"
+#include "spc_stats.h"
+#include "command_parser.h"
+#include "test_profiles_data.h"
+#include "result_store.h"
+#include "result_export.h"
+#include "boot_profile.h"
+#include "rig_sim.h"
 
 // ---- ESTADOS ----
 
@@ -21,7 +33,9 @@ static AppState appState = APP_STATE_MENU;
 static const char* MENU_ITEMS[] = {
     "Teste mola (k)",
     "Calibrar balanca",
-    "Teste hardware"
+    "Teste hardware",
+    "Teste fadiga",
+    "CEP do lote"
 };
 static const int MENU_COUNT = sizeof(MENU_ITEMS) / sizeof(MENU_ITEMS[0]);
 static int menuIndex = 0;
@@ -32,52 +46,142 @@ static long lastEncPosRaw = 0;
 // Grafset para teste de mola
 static TestMolaGrafset testMolaGrafset;
 
+// Grafset para teste de fadiga (ciclagem)
+static TestFadigaGrafset testFadigaGrafset;
+
+// Grafset em execução no APP_STATE_IDLE
+static Grafset* activeGrafset = nullptr;
+
+// Tela bloqueante do menu (CEP) em primeiro plano: comandos de movimento recusados
+static bool menuScreenOpen = false;
+
+// JOG remoto em andamento (a plataforma pode estar encostando na mola)
+static bool jogActive = false;
+
 // ---- Prototipos ----
 void runSpringTestWithGraph();
 void runLoadcellCalibration();
 void runHardwareTest();
+void runSpcDashboard();
+void handleSerialCommands();
+static void finishRemoteTest();
 
 // Bot�o frontal removido: retorno ao menu ser� pelo bot�o do encoder
 
 // ---- SETUP ----
+// Fases do boot (relatório "[BOOT]" no fim do setup)
+static BootProfile bootProfile;
+
+static void printBootReport() {
+    Serial.print("[BOOT]");
+    for (int i = 0; i < bootProfile.count(); ++i) {
+        Serial.print(" ");
+        Serial.print(bootProfile.name(i));
+        Serial.print("=");
+        Serial.print(bootProfile.durationUs(i) / 1000.0f, 1);
+    }
+    Serial.print(" | total=");
+    Serial.print(bootProfile.totalUs() / 1000.0f, 1);
+    Serial.println(" ms");
+}
+
+// O splash sai após BOOT_SPLASH_MAX_MS mesmo com a tara de boot ainda no
+// HX711 (core 0): teste, tara e calibração esperam a tarefa terminar
+static void waitBootTare() {
+    if (scaleManager.tareReady()) return;
+    Serial.println("[SETUP] Aguardando a tara de boot...");
+    scaleManager.waitTareReady();
+}
+
 void setup() {
+    bootProfile.begin(0);
+    bootProfile.mark("core", micros());
+
+    Serial.setTxBufferSize(SERIAL_TX_BUFFER_BYTES);   // antes de begin()
     Serial.begin(115200);
-    delay(1000);
     Serial.println();
     Serial.println("=== Medidor de mola - Inicializando ===");
+    bootProfile.mark("serial", micros());
+
+    // Splash primeiro: fica na tela enquanto o resto inicializa
+    uiManager.begin();
+    uiManager.clearScreen();
+    uiManager.drawCenteredText("CARNAUBA TECH", TFT_YELLOW, 6);
+    unsigned long splashStartMs = millis();
+    bootProfile.mark("display", micros());
+
+    // Tara de boot em tarefa no core 0, em paralelo com o restante
+    scaleManager.beginAsync();
+    bootProfile.mark("hx711", micros());
 
-    scaleManager.begin();
     stepperManager.begin();
+    if (tmc2209Manager.begin()) {
+        Serial.println("[SETUP] TMC2209 via UART: homing por StallGuard ativo");
+        stallGuardMonitor.begin();
+        stepperManager.enablePhaseSwitching();
+    }
+    bootProfile.mark("motor", micros());
+
     encoderManager.begin();
-    uiManager.begin();
+    resultStore.begin();
+    bootProfile.mark("store", micros());
 
-    // Motor j� est� habilitado ap�s stepperManager.begin()
-        // Splash screen inicial (5s)
-        uiManager.clearScreen();
-        uiManager.drawCenteredText("CARNAUBA TECH", TFT_YELLOW, 6);
-        delay(5000);
+    // Splash: no mínimo BOOT_SPLASH_MIN_MS e até a tara terminar
+    while (!scaleManager.tareReady() || millis() - splashStartMs < BOOT_SPLASH_MIN_MS) {
+        if (millis() - splashStartMs >= BOOT_SPLASH_MAX_MS) {
+            break;
+        }
+        delay(10);
+    }
+    bootProfile.mark("splash", micros());
+
+    if (scaleManager.tareReady()) {
+        const TareResult& tare = scaleManager.lastTare();
+        Serial.print("[SETUP] Tara: ");
+        Serial.print(tare.samples);
+        Serial.print(" leituras, ");
+        Serial.println(tareQualityName(tare.quality));
+    } else {
+        Serial.println("[SETUP] AVISO: tara de boot nao concluida (HX711 sem resposta?)");
+    }
+
+    stepperManager.enable(true);
+    Serial.println("[STEPPER] Motor driver ENABLED!");
 
-    // Posi��o inicial do encoder
+    // Posição inicial do encoder
     lastEncPosRaw = encoderManager.getPosition();
 
     // Mostra menu inicial
     uiManager.drawMenu(MENU_ITEMS, MENU_COUNT, menuIndex);
 
     appState = APP_STATE_MENU;
+    bootProfile.mark("menu", micros());
 
     Serial.print("Fator de calib inicial: ");
     Serial.println(scaleManager.getCalibFactor(), 4);
+    printBootReport();
 }
 
 // ---- LOOP PRINCIPAL ----
 void loop() {
+    PROBE_SCOPE(PROBE_LOOP);
+
+    handleSerialCommands();
     encoderManager.update();
-    scaleManager.update();
+    // Exportação em curso (só no menu): read_average do HX711 seguraria o
+    // loop por centenas de ms e o buffer de TX ficaria ocioso
+    if (!resultExporter.active()) {
+        // Fora do menu (teste) ou na calibração o offset fica congelado; no
+        // menu é a medida que decide se a célula está livre
+        scaleManager.setZeroFrozen(appState != APP_STATE_MENU || menuScreenOpen);
+        scaleManager.update();
+    }
 
     long encPosRaw = encoderManager.getPosition();
     long deltaEnc  = encPosRaw - lastEncPosRaw;
     if (deltaEnc != 0) {
         lastEncPosRaw = encPosRaw;
+        TRACE_EVENT(EVT_ENCODER, TRACE_ENC_ROTATE, encPosRaw);
     }
 
     switch (appState) {
@@ -101,10 +205,13 @@ void loop() {
                 delay(100);
                 encoderManager.wasButtonClicked(); // Consome qualquer clique residual
                 encoderManager.wasButtonLongPressed(); // Consome long press tamb�m
+                waitBootTare();
                 testMolaGrafset.start();
+                activeGrafset = &testMolaGrafset;
                 appState = APP_STATE_IDLE;
             } else if (menuIndex == 1) {
                 // Calibrar balanca
+                waitBootTare();
                 runLoadcellCalibration();
                 // Ao terminar, volta ao menu
                 appState = APP_STATE_MENU;
@@ -115,6 +222,22 @@ void loop() {
                 // Ao terminar, volta ao menu
                 appState = APP_STATE_MENU;
                 uiManager.drawMenu(MENU_ITEMS, MENU_COUNT, menuIndex);
+            } else if (menuIndex == 3) {
+                // Teste de fadiga com Grafset
+                delay(100);
+                encoderManager.wasButtonClicked();
+                encoderManager.wasButtonLongPressed();
+                waitBootTare();
+                testFadigaGrafset.start();
+                activeGrafset = &testFadigaGrafset;
+                appState = APP_STATE_IDLE;
+            } else if (menuIndex == 4) {
+                // CEP (SPC) do lote de molas
+                menuScreenOpen = true;
+                runSpcDashboard();
+                menuScreenOpen = false;
+                appState = APP_STATE_MENU;
+                uiManager.drawMenu(MENU_ITEMS, MENU_COUNT, menuIndex);
             }
         }
 
@@ -123,11 +246,15 @@ void loop() {
 
     case APP_STATE_IDLE: {
         // Grafset rodando
-        testMolaGrafset.tick();
+        activeGrafset->tick();
         
-        // Se terminou, aguarda clique para voltar ao menu
-        if (testMolaGrafset.isFinished()) {
-            appState = APP_STATE_WAITING_TO_RETURN_MENU;
+        // Se terminou, aguarda clique para voltar ao menu (remoto: volta direto)
+        if (activeGrafset->isFinished()) {
+            if (activeGrafset == &testMolaGrafset && testMolaGrafset.isRemote()) {
+                finishRemoteTest();
+            } else {
+                appState = APP_STATE_WAITING_TO_RETURN_MENU;
+            }
         }
         break;
     }
@@ -137,7 +264,8 @@ void loop() {
         // N�O chamar update() aqui - j� � feito no loop principal!
         
         if (encoderManager.wasButtonClicked()) {
-            testMolaGrafset.reset();
+            activeGrafset->reset();
+            activeGrafset = nullptr;
             appState = APP_STATE_MENU;
             menuIndex = 0;
             uiManager.drawMenu(MENU_ITEMS, MENU_COUNT, menuIndex);
@@ -156,6 +284,9 @@ void loop() {
 // ========================================================
 
 void runLoadcellCalibration() {
+    // Peso de referência na plataforma: offset só pela tara da etapa 2
+    // (loop() volta a liberar o rastreamento do zero)
+    scaleManager.setZeroFrozen(true);
 
     // ---- ETAPA 1: SELE��O DO PESO ----
     int weightIndex = 2; // Padr�o: 2.0 kg (�ndice 2)
@@ -214,7 +345,7 @@ void runLoadcellCalibration() {
         if (encoderManager.wasButtonClicked()) {
             if (stage == 0) {
                 // Fazer tara sem peso
-                scaleManager.tare();
+                scaleManager.tare(true);
                 stage = 1;
             } else if (stage == 1) {
                 // Peso de referencia
@@ -251,6 +382,65 @@ void runLoadcellCalibration() {
     }
 }
 
+// ========================================================
+//  CEP (SPC) DO LOTE
+// ========================================================
+
+void runSpcDashboard() {
+    if (spcBatch.count() == 0) {
+        uiManager.clearScreen();
+        uiManager.drawText("=== CEP do lote ===", 60, 40, TFT_YELLOW, 3);
+        uiManager.drawText("Nenhuma mola medida no lote.", 60, 140, TFT_WHITE, 2);
+        uiManager.drawText("Click para voltar", 130, 290, TFT_YELLOW, 2);
+        while (!encoderManager.wasButtonClicked()) {
+            encoderManager.update();
+            delay(10);
+        }
+        return;
+    }
+
+    uiManager.drawSpcScreen(spcBatch);
+    uint32_t shownCount = spcBatch.count();
+
+    Serial.print("[CEP] Lote ");
+    Serial.print(spcBatch.partName());
+    Serial.print(": n=");
+    Serial.print((unsigned long)spcBatch.count());
+    Serial.print(" subgrupos=");
+    Serial.print((unsigned long)spcBatch.subgroups());
+    Serial.print(" X=");
+    Serial.print(spcBatch.grandMean(), 4);
+    Serial.print(" R=");
+    Serial.print(spcBatch.meanRange(), 4);
+    Serial.print(" Cpk=");
+    Serial.println(spcBatch.cpk(), 2);
+
+    for (;;) {
+        encoderManager.update();
+        handleSerialCommands();
+
+        // Resultado novo com a tela aberta: só o ponto e o painel
+        if (spcBatch.count() != shownCount) {
+            uiManager.updateSpcScreen(spcBatch);
+            shownCount = spcBatch.count();
+        }
+        if (encoderManager.wasButtonLongPressed()) {
+            Serial.println("[CEP] Novo lote iniciado.");
+            spcBatch.begin(spcBatch.partName(), spcBatch.lsl(), spcBatch.usl());
+            uiManager.invalidateSpcScreen();
+            uiManager.clearScreen();
+            uiManager.drawText("Lote zerado.", 160, 150, TFT_YELLOW, 2);
+            delay(800);
+            return;
+        }
+        if (encoderManager.wasButtonClicked()) {
+            uiManager.invalidateSpcScreen();
+            return;
+        }
+        delay(10);
+    }
+}
+
 // ============================
 // runHardwareTest
 // =============================
@@ -338,7 +528,7 @@ void runHardwareTest() {
             // Move o motor para a nova posi��o com velocidade fixa de 130 us
             float currentAbsMm = stepperManager.getPositionMm();
             float deltaMm = targetAbsMm - currentAbsMm;
-            long deltaSteps = (long)round(deltaMm * stepperManager.getStepsPerMm());
+            long deltaSteps = stepperManager.mmToUnits(deltaMm);
 
             if (deltaSteps != 0) {
                 StepperDirection dir = (deltaSteps > 0) ? STEPPER_DIR_FORWARD : STEPPER_DIR_BACKWARD;
@@ -350,3 +540,434 @@ void runHardwareTest() {
     }
 }
 
+// ============================
+// Comandos remotos via Serial (não bloqueante, ver command_parser.h)
+// Respostas: "OK <VERBO> chave=valor ..." ou "ERR <VERBO> <motivo>"
+// PROBES [RESET] e TRACE [CLEAR] mantêm os despejos de depuração
+// =============================
+static CommandParser commandParser;
+
+// Alvo do JOG em andamento (executado em fatias por serviceRemoteJog)
+static float jogTargetMm = 0.0f;
+
+static void serialWriteLine(const char* line) {
+    Serial.println(line);
+}
+
+static void replyError(const char* verb, const char* reason) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "ERR %s %s", verb[0] ? verb : "?", reason);
+    Serial.println(buf);
+}
+
+// Comandos que movem o eixo ou mexem na balança só valem com o menu ocioso
+static bool remoteIdle() {
+    return appState == APP_STATE_MENU && !jogActive && !menuScreenOpen &&
+           !resultExporter.active();
+}
+
+// Texto para campo chave=valor (sem espaços)
+static void copyToken(char* dst, size_t len, const char* src) {
+    size_t i = 0;
+    for (; src[i] && i + 1 < len; ++i) {
+        dst[i] = (src[i] == ' ') ? '_' : src[i];
+    }
+    dst[i] = '\0';
+}
+
+static const char* appStateName() {
+    switch (appState) {
+        case APP_STATE_MENU:                   return "menu";
+        case APP_STATE_IDLE:                   return "running";
+        case APP_STATE_WAITING_TO_RETURN_MENU: return "done";
+        default:                               return "?";
+    }
+}
+
+static void replyStatus() {
+    const char* test = "none";
+    if (activeGrafset == &testMolaGrafset) test = "mola";
+    else if (activeGrafset == &testFadigaGrafset) test = "fadiga";
+
+    const ZeroTracker& zero = scaleManager.zeroTracker();
+    char buf[192];
+    snprintf(buf, sizeof(buf), "OK STATUS app=%s test=%s state=%d remote=%d jog=%d homed=%d pos=%.2f kg=%.3f"
+             " zdrift=%.1f ztc=%.2f zobs=%lu/%lu",
+             appStateName(), test,
+             (activeGrafset == &testMolaGrafset) ? testMolaGrafset.stateCode() : 0,
+             testMolaGrafset.isRemote() ? 1 : 0,
+             jogActive ? 1 : 0,
+             stepperManager.wasLastHomingSuccessful() ? 1 : 0,
+             stepperManager.getPositionMm(),
+             scaleManager.getWeightKg(),
+             zero.driftCountsPerHour(), zero.tempCoefCountsPerC(),
+             (unsigned long)zero.accepted(), (unsigned long)zero.rejected());
+    Serial.println(buf);
+}
+
+static void replyResult(const char* prefix) {
+    if (!testMolaGrafset.hasResult()) {
+        replyError("RESULT", "none");
+        return;
+    }
+    const SpringTestResult& r = testMolaGrafset.result();
+    const char* verdictText = "NA";
+    if (!r.positionVerified) verdictText = "INVALID";
+    else if (r.hasLimits) verdictText = r.passed ? "PASS" : "FAIL";
+
+    char profileName[24];
+    char reason[24];
+    copyToken(profileName, sizeof(profileName), testMolaGrafset.profileName());
+    copyToken(reason, sizeof(reason), verdictReasonName(r.verdictReason));
+
+    char buf[288];
+    snprintf(buf, sizeof(buf),
+             "%s profile=%s k=%.4f kN=%.3f r2=%.4f fmax=%.3f n=%d verdict=%s reason=%s "
+             "early=%d saved_ms=%lu free=%.2f lost=%ld settle_ms=%lu settle_max=%lu settle_to=%u",
+             prefix, profileName, r.kKgfMm, r.kNmm, r.r2, r.maxForceKg, r.sampleCount,
+             verdictText, reason, r.earlyRejected ? 1 : 0, (unsigned long)r.estimatedSavedMs,
+             r.freeLengthMm, r.lostStepUnits, (unsigned long)r.settleMeanMs,
+             (unsigned long)r.settleMaxMs, (unsigned)r.settleTimeouts);
+    Serial.println(buf);
+}
+
+static void replyProfiles() {
+    char buf[64];
+    for (int i = 0; i < TEST_PROFILES_COUNT; ++i) {
+        ProfileInterpreter p;
+        if (!p.load(TEST_PROFILES[i].data, TEST_PROFILES[i].size)) continue;
+        // Nome por último: pode conter espaços
+        snprintf(buf, sizeof(buf), "PROFILE %d course=%.2f points=%d name=%s",
+                 i, p.settings().courseMm, p.settings().sampleCount, p.settings().name);
+        Serial.println(buf);
+    }
+    snprintf(buf, sizeof(buf), "OK PROFILES n=%d", TEST_PROFILES_COUNT);
+    Serial.println(buf);
+}
+
+static void startRemoteTest(const Command& cmd) {
+    long index = 0;
+    if (!cmd.argInt(0, &index)) {
+        replyError(cmd.verb, "bad_arg");
+        return;
+    }
+    if (!remoteIdle()) {
+        replyError(cmd.verb, "busy");
+        return;
+    }
+    RemoteStartGate gate = remoteStartGate(stepperManager.wasLastHomingSuccessful(),
+                                           stepperManager.getPositionMm());
+    if (gate != REMOTE_START_OK) {
+        replyError(cmd.verb, remoteStartGateName(gate));
+        return;
+    }
+    waitBootTare();
+    if (!testMolaGrafset.startRemote((int)index)) {
+        replyError(cmd.verb, "bad_profile");
+        return;
+    }
+    activeGrafset = &testMolaGrafset;
+    appState = APP_STATE_IDLE;
+
+    char buf[64];
+    snprintf(buf, sizeof(buf), "OK START profile=%ld", index);
+    Serial.println(buf);
+}
+
+// HOME: mesmas etapas do início local até a posição de colocação da mola
+// (plataforma livre); "DONE HOME" sai ao chegar (finishRemoteTest)
+static void startRemoteHome(const Command& cmd) {
+    if (!remoteIdle()) {
+        replyError(cmd.verb, "busy");
+        return;
+    }
+    waitBootTare();
+    testMolaGrafset.homeRemote();
+    activeGrafset = &testMolaGrafset;
+    appState = APP_STATE_IDLE;
+    Serial.println("OK HOME");
+}
+
+static void startRemoteJog(const Command& cmd) {
+    float deltaMm = 0.0f;
+    if (!cmd.argFloat(0, &deltaMm)) {
+        replyError(cmd.verb, "bad_arg");
+        return;
+    }
+    if (!remoteIdle()) {
+        replyError(cmd.verb, "busy");
+        return;
+    }
+    float target = stepperManager.getPositionMm() + deltaMm;
+    if (target < 0.0f || target > STEPPER_MAX_TRAVEL_MM) {
+        replyError(cmd.verb, "range");
+        return;
+    }
+    jogTargetMm = target;
+    jogActive = true;   // "OK JOG" sai ao chegar (serviceRemoteJog)
+}
+
+// Uma fatia do JOG por volta do loop
+static void serviceRemoteJog() {
+    if (!jogActive) return;
+
+    float pos = stepperManager.getPositionMm();
+    float remaining = jogTargetMm - pos;
+    if (fabsf(remaining) * stepperManager.getStepsPerMm() < 1.0f) {
+        jogActive = false;
+        char buf[48];
+        snprintf(buf, sizeof(buf), "OK JOG pos=%.2f", pos);
+        Serial.println(buf);
+        return;
+    }
+    if (remaining > REMOTE_JOG_CHUNK_MM) remaining = REMOTE_JOG_CHUNK_MM;
+    if (remaining < -REMOTE_JOG_CHUNK_MM) remaining = -REMOTE_JOG_CHUNK_MM;
+    stepperManager.moveToPositionMm(pos + remaining, REMOTE_JOG_US_DELAY);
+}
+
+static void abortRemote(const char* verb) {
+    if (resultExporter.active()) {
+        resultExporter.abort();
+        return;
+    }
+    if (jogActive) {
+        jogActive = false;
+        char buf[48];
+        snprintf(buf, sizeof(buf), "OK ABORT jog pos=%.2f", stepperManager.getPositionMm());
+        Serial.println(buf);
+        return;
+    }
+    if (appState == APP_STATE_IDLE && activeGrafset != nullptr) {
+        activeGrafset->requestCancel();
+        Serial.println("OK ABORT test");
+        return;
+    }
+    replyError(verb, "idle");
+}
+
+// HOMESIM [bounce_us] [runs] [ruído/s]: homing pelo fim de curso no simulador,
+// lendo o pino a cada passo e com a captura por interrupção
+static void replyHomeSim(const Command& cmd) {
+    long bounceUs = (long)RIG_SIM_BOUNCE_US;
+    long runs = (long)RIG_SIM_DEFAULT_RUNS;
+    float glitchPerS = 0.0f;
+    if ((cmd.argc > 0 && (!cmd.argInt(0, &bounceUs) || bounceUs < 0 || bounceUs > 100000))
+        || (cmd.argc > 1 && (!cmd.argInt(1, &runs) || runs <= 0 || runs > (long)RIG_SIM_MAX_RUNS))
+        || (cmd.argc > 2 && (!cmd.argFloat(2, &glitchPerS) || glitchPerS < 0.0f))) {
+        replyError(cmd.verb, "bad_arg");
+        return;
+    }
+    if (!remoteIdle()) {
+        replyError(cmd.verb, "busy");
+        return;
+    }
+
+    RigSimConfig cfg = {RIG_SIM_TRIP_JITTER_UM, (uint32_t)bounceUs, RIG_SIM_BOUNCE_EDGE_US,
+                        glitchPerS, RIG_SIM_GLITCH_US, RIG_SIM_STEP_DELAY_US,
+                        RIG_SIM_START_MM, (uint32_t)millis()};
+    HomeRepeatability polled = rigSimHomeRepeatability(cfg, (uint16_t)runs, false);
+    HomeRepeatability latched = rigSimHomeRepeatability(cfg, (uint16_t)runs, true);
+
+    char buf[224];
+    snprintf(buf, sizeof(buf),
+             "OK HOMESIM runs=%u bounce_us=%ld poll_std_um=%.3f poll_span_um=%.2f poll_false=%u "
+             "latch_std_um=%.3f latch_span_um=%.2f latch_false=%u latch_nf=%u edges=%.1f",
+             (unsigned)runs, bounceUs, polled.stdUm, polled.spanUm, (unsigned)polled.falseHomes,
+             latched.stdUm, latched.spanUm, (unsigned)latched.falseHomes,
+             (unsigned)latched.notFound, latched.meanEdges);
+    Serial.println(buf);
+}
+
+static void executeCommand(const Command& cmd) {
+    if (cmd.error != CMD_ERR_NONE) {
+        replyError(cmd.verb, commandErrorName(cmd.error));
+        return;
+    }
+
+    char buf[64];
+    switch (cmd.id) {
+    case CMD_HELP:
+        Serial.println("OK HELP verbs=STATUS,PROFILES,HOME,START,ABORT,TARE,CAL,JOG,RESULT,EXPORT,STORE,PROBES,TRACE,STEPBENCH,HOMESIM");
+        break;
+
+    case CMD_STATUS:
+        replyStatus();
+        break;
+
+    case CMD_PROFILES:
+        replyProfiles();
+        break;
+
+    case CMD_HOME:
+        startRemoteHome(cmd);
+        break;
+
+    case CMD_START:
+        startRemoteTest(cmd);
+        break;
+
+    case CMD_ABORT:
+        abortRemote(cmd.verb);
+        break;
+
+    case CMD_TARE: {
+        if (!remoteIdle()) {
+            replyError(cmd.verb, "busy");
+            break;
+        }
+        waitBootTare();
+        const TareResult& tare = scaleManager.tare();
+        if (tare.quality == TARE_QUALITY_FAILED) {
+            replyError(cmd.verb, "hx711");
+            break;
+        }
+        snprintf(buf, sizeof(buf), "OK TARE offset=%ld n=%u se=%.1f q=%s",
+                 scaleManager.getOffset(), (unsigned)tare.samples,
+                 tare.stdErrCounts, tareQualityName(tare.quality));
+        Serial.println(buf);
+        break;
+    }
+
+    case CMD_CAL: {
+        float knownKg = 0.0f;
+        if (!cmd.argFloat(0, &knownKg) || knownKg <= 0.0f) {
+            replyError(cmd.verb, "bad_arg");
+            break;
+        }
+        if (!remoteIdle()) {
+            replyError(cmd.verb, "busy");
+            break;
+        }
+        scaleManager.calibrateWithKnownWeight(knownKg);
+        scaleManager.saveCalibrationToEEPROM();
+        snprintf(buf, sizeof(buf), "OK CAL factor=%.4f", scaleManager.getCalibFactor());
+        Serial.println(buf);
+        break;
+    }
+
+    case CMD_JOG:
+        startRemoteJog(cmd);
+        break;
+
+    case CMD_RESULT:
+        replyResult("OK RESULT");
+        break;
+
+    case CMD_EXPORT: {
+        long offset = 0;
+        if (cmd.argc > 0 && (!cmd.argInt(0, &offset) || offset < 0)) {
+            replyError(cmd.verb, "bad_arg");
+            break;
+        }
+        if (!remoteIdle()) {
+            replyError(cmd.verb, "busy");
+            break;
+        }
+        if (!resultExporter.begin((uint32_t)offset)) {
+            replyError(cmd.verb, "no_store");
+            break;
+        }
+        // Quadros binários seguem esta linha (ver export_codec.h)
+        snprintf(buf, sizeof(buf), "OK EXPORT offset=%ld records=%lu", offset,
+                 (unsigned long)resultStore.recordCount());
+        Serial.println(buf);
+        break;
+    }
+
+    case CMD_STORE:
+        if (cmd.argIs(0, "clear")) {
+            if (!remoteIdle()) {
+                replyError(cmd.verb, "busy");
+                break;
+            }
+            resultStore.clear();
+        }
+        snprintf(buf, sizeof(buf), "OK STORE records=%lu bytes=%lu max=%lu",
+                 (unsigned long)resultStore.recordCount(), (unsigned long)resultStore.bytesUsed(),
+                 (unsigned long)RESULT_STORE_MAX_BYTES);
+        Serial.println(buf);
+        break;
+
+    case CMD_STEPBENCH: {
+        long pulses = (long)STEP_BENCH_DEFAULT_PULSES;
+        if (cmd.argc > 0 && (!cmd.argInt(0, &pulses) || pulses <= 0
+                             || pulses > (long)STEP_BENCH_MAX_PULSES)) {
+            replyError(cmd.verb, "bad_arg");
+            break;
+        }
+        if (!remoteIdle()) {
+            replyError(cmd.verb, "busy");
+            break;
+        }
+        StepperManager::StepIoBench bench = stepperManager.benchmarkStepIo((uint32_t)pulses);
+        snprintf(buf, sizeof(buf), "OK STEPBENCH n=%lu arduino_khz=%.1f fast_khz=%.1f",
+                 (unsigned long)bench.pulses, bench.arduinoKhz, bench.fastKhz);
+        Serial.println(buf);
+        break;
+    }
+
+    case CMD_HOMESIM:
+        replyHomeSim(cmd);
+        break;
+
+    case CMD_PROBES:
+        if (cmd.argIs(0, "reset")) {
+            probeReset();
+            Serial.println("PROBE reset");
+        } else {
+            probeDump(serialWriteLine);
+        }
+        break;
+
+    case CMD_TRACE:
+        if (cmd.argIs(0, "clear")) {
+            traceClear();
+            Serial.println("TRACE clear");
+        } else {
+            traceDump(serialWriteLine);
+        }
+        break;
+
+    default:
+        replyError(cmd.verb, "unknown");
+        break;
+    }
+}
+
+// Teste remoto encerrado: envia o resultado e volta ao menu sem esperar clique
+static void finishRemoteTest() {
+    if (testMolaGrafset.isHomeOnly()) {
+        // Mesma condição que o START vai exigir
+        RemoteStartGate gate = remoteStartGate(stepperManager.wasLastHomingSuccessful(),
+                                               stepperManager.getPositionMm());
+        char buf[48];
+        if (gate == REMOTE_START_OK) {
+            snprintf(buf, sizeof(buf), "DONE HOME pos=%.2f", stepperManager.getPositionMm());
+        } else {
+            snprintf(buf, sizeof(buf), "DONE HOME %s", remoteStartGateName(gate));
+        }
+        Serial.println(buf);
+    } else if (testMolaGrafset.hasResult()) {
+        replyResult("DONE");
+    } else {
+        Serial.println("DONE aborted");
+    }
+    activeGrafset->reset();
+    activeGrafset = nullptr;
+    appState = APP_STATE_MENU;
+    menuIndex = 0;
+    uiManager.drawMenu(MENU_ITEMS, MENU_COUNT, menuIndex);
+}
+
+void handleSerialCommands() {
+    while (Serial.available() > 0) {
+        if (commandParser.feed((uint8_t)Serial.read())) {
+            const Command& cmd = commandParser.command();
+            // Durante a exportação só ABORT: uma resposta de texto cortaria um quadro
+            if (resultExporter.active() && cmd.id != CMD_ABORT) continue;
+            executeCommand(cmd);
+        }
+    }
+    serviceRemoteJog();
+    resultExporter.service();
+}
@@ -0,0 +1,35 @@
+#include "motion_phase.h"
+
+const MotionPhaseConfig& motionPhaseConfig(MotionPhase phase) {
+    switch (phase) {
+        case MOTION_PHASE_HOMING:  return MOTION_PHASE_HOMING_CFG;
+        case MOTION_PHASE_MEASURE: return MOTION_PHASE_MEASURE_CFG;
+        case MOTION_PHASE_TRAVEL:
+        default:                   return MOTION_PHASE_TRAVEL_CFG;
+    }
+}
+
+bool applyMotionPhase(const MotionPhaseDriverHal& hal, const MotionPhaseConfig& cfg,
+                      MotionPhaseAxis& axis) {
+    hal.setMicrosteps(cfg.microsteps, hal.ctx);
+    hal.setCurrent(cfg.currentMa, TMC_CURRENT_HOLD, hal.ctx);
+    hal.enableStealthChop(cfg.stealthChop, hal.ctx);
+    bool flushed = hal.waitFlushed(TMC_FLUSH_TIMEOUT_MS, hal.ctx);
+
+    axis.pulseIncrement = TMC_FINE_MICROSTEPS / cfg.microsteps;
+    axis.microsteps = cfg.microsteps;
+    axis.speedPct = cfg.speedPct;
+    axis.stealthChop = cfg.stealthChop;
+    return flushed;
+}
+
+long motionPhaseFineUnits(long coarseUnits) {
+    return coarseUnits * (long)(TMC_FINE_MICROSTEPS / TMC_DEFAULT_MICROSTEPS);
+}
+
+uint32_t motionPhasePulseDelayUs(uint16_t usDelay, const MotionPhaseAxis& axis) {
+    uint32_t unitsPerDefaultStep = TMC_FINE_MICROSTEPS / TMC_DEFAULT_MICROSTEPS;
+    uint32_t periodUs = ((uint32_t)usDelay + STEP_PULSE_US) * (uint32_t)axis.pulseIncrement
+                        * 100u / (unitsPerDefaultStep * axis.speedPct);
+    return (periodUs > STEP_PULSE_US + 2u) ? periodUs - STEP_PULSE_US : 2u;
+}
@@ -0,0 +1,84 @@
+#include "motion_queue.h"
+#include <cmath>
+#include <cstdlib>
+
+bool MotionQueue::push(long target, uint16_t usDelay,
+                       SegmentAction action, uint16_t dwellMs, uint16_t tag) {
+    if (full()) return false;
+    MotionSegment& s = _segments[_count++];
+    s.target = target;
+    s.usDelay = usDelay;
+    s.action = action;
+    s.dwellMs = dwellMs;
+    s.tag = tag;
+    s.pulses = 0;
+    s.dir = 0;
+    s.cruisePps = 0.0f;
+    s.entryPps = 0.0f;
+    s.exitPps = 0.0f;
+    return true;
+}
+
+// Velocidade máxima alcançável partindo de v0 em n pulsos com aceleração a
+static float reachable(float v0, long n, float a) {
+    return sqrtf(v0 * v0 + 2.0f * a * (float)n);
+}
+
+void MotionQueue::plan(long startPos, long unitsPerPulse, float accelPps2, float minPps,
+                       float (*cruisePpsOf)(uint16_t, void*), void* ctx) {
+    if (unitsPerPulse < 1) unitsPerPulse = 1;
+
+    // Pulsos/sentido de cada segmento; o resto fracionário passa adiante
+    long pos = startPos;
+    for (int i = 0; i < _count; ++i) {
+        MotionSegment& s = _segments[i];
+        long delta = s.target - pos;
+        long pulses = (labs(delta) + unitsPerPulse / 2) / unitsPerPulse;
+        s.pulses = pulses;
+        s.dir = (pulses == 0) ? 0 : ((delta > 0) ? 1 : -1);
+        s.cruisePps = cruisePpsOf(s.usDelay, ctx);
+        if (s.cruisePps < minPps) s.cruisePps = minPps;
+        pos += s.dir * pulses * unitsPerPulse;
+    }
+
+    // Velocidade de junção máxima na entrada de cada segmento
+    for (int i = 0; i < _count; ++i) {
+        MotionSegment& s = _segments[i];
+        bool blend = (i > 0) &&
+                     _segments[i - 1].action != SEG_ACTION_DWELL &&
+                     _segments[i - 1].dir == s.dir && s.dir != 0;
+        s.entryPps = blend ? fminf(_segments[i - 1].cruisePps, s.cruisePps) : minPps;
+    }
+
+    // Passe para trás: cada segmento precisa conseguir frear até a saída
+    float nextEntry = minPps;  // fim da fila: parado
+    for (int i = _count - 1; i >= 0; --i) {
+        MotionSegment& s = _segments[i];
+        bool stopsAfter = (s.action == SEG_ACTION_DWELL) || (i == _count - 1) ||
+                          _segments[i + 1].dir != s.dir;
+        s.exitPps = stopsAfter ? minPps : nextEntry;
+        float maxEntry = reachable(s.exitPps, s.pulses, accelPps2);
+        if (s.entryPps > maxEntry) s.entryPps = maxEntry;
+        nextEntry = s.entryPps;
+    }
+
+    // Passe para frente: cada segmento só chega à saída se a aceleração permitir
+    for (int i = 0; i < _count; ++i) {
+        MotionSegment& s = _segments[i];
+        float maxExit = reachable(s.entryPps, s.pulses, accelPps2);
+        if (s.exitPps > maxExit) s.exitPps = maxExit;
+        if (i + 1 < _count && _segments[i + 1].entryPps > s.exitPps &&
+            s.action != SEG_ACTION_DWELL && _segments[i + 1].dir == s.dir) {
+            _segments[i + 1].entryPps = s.exitPps;
+        }
+    }
+}
+
+float segmentRateAt(const MotionSegment& seg, long k, float accelPps2) {
+    float v = seg.cruisePps;
+    float up = reachable(seg.entryPps, k, accelPps2);
+    float down = reachable(seg.exitPps, seg.pulses - 1 - k, accelPps2);
+    if (up < v) v = up;
+    if (down < v) v = down;
+    return v;
+}
@@ -0,0 +1,122 @@
+#include "result_export.h"
+#include "result_store.h"
+#include "trace_probe.h"
+#include <Arduino.h>
+
+ResultExporter resultExporter;
+
+bool ResultExporter::begin(uint32_t offset) {
+    if (!resultStore.isMounted()) return false;
+
+    _active = true;
+    _endQueued = false;
+    _cursor = 0;
+    _streamPos = 0;
+    _resumeOffset = offset;
+    _recLen = 0;
+    _recPos = 0;
+    _frameLen = 0;
+    _framePos = 0;
+    _records = 0;
+    _samplesOut = 0;
+    _csvBytes = 0;
+    _wireBytes = 0;
+    _startMs = millis();
+    return true;
+}
+
+void ResultExporter::abort() {
+    if (!_active) return;
+    _active = false;
+    // Quadro parcial no fio: o cliente descarta pelo CRC e retoma pelo offset
+    Serial.println();
+    Serial.println("OK EXPORT aborted");
+}
+
+bool ResultExporter::loadNextRecord() {
+    ResultRecordHeader header;
+    CurveMeta meta;
+    if (!resultStore.readNext(&_cursor, &header, &meta, _samples, SPRING_SAMPLE_CAPACITY)) {
+        return false;
+    }
+    _recLen = exportEncodeRecord(header, meta, _samples, _rec, sizeof(_rec));
+    _recPos = 0;
+
+    // Só conta o que de fato vai para o fio nesta sessão
+    if (_streamPos + _recLen > _resumeOffset) {
+        ++_records;
+        _samplesOut += header.sampleCount;
+        _csvBytes += exportCsvBytes(header, _samples);
+    }
+    return _recLen > 0;
+}
+
+void ResultExporter::buildNextFrame() {
+    PROBE_SCOPE(PROBE_EXPORT_FRAME);
+    size_t chunkLen = 0;
+    uint32_t chunkOffset = 0;
+
+    while (chunkLen < EXPORT_CHUNK_BYTES) {
+        if (_recPos >= _recLen && !loadNextRecord()) break;
+
+        // Retomada: pula o que o cliente já tem sem montar quadros
+        if (_streamPos < _resumeOffset) {
+            size_t skip = _recLen - _recPos;
+            if (skip > _resumeOffset - _streamPos) skip = _resumeOffset - _streamPos;
+            _recPos += skip;
+            _streamPos += skip;
+            continue;
+        }
+
+        if (chunkLen == 0) chunkOffset = _streamPos;
+        size_t n = _recLen - _recPos;
+        if (n > EXPORT_CHUNK_BYTES - chunkLen) n = EXPORT_CHUNK_BYTES - chunkLen;
+        memcpy(_chunk + chunkLen, _rec + _recPos, n);
+        chunkLen += n;
+        _recPos += n;
+        _streamPos += n;
+    }
+
+    if (chunkLen > 0) {
+        _frameLen = exportBuildFrame(chunkOffset, _chunk, chunkLen, _frame, _lz);
+    } else {
+        _frameLen = exportBuildEndFrame(_streamPos, _frame);
+        _endQueued = true;
+    }
+    _framePos = 0;
+}
+
+void ResultExporter::service() {
+    // Enche o buffer de TX com quantos quadros couberem e retorna
+    while (_active) {
+        if (_framePos >= _frameLen) {
+            if (_endQueued) {
+                report();
+                _active = false;
+                return;
+            }
+            buildNextFrame();
+        }
+
+        int room = Serial.availableForWrite();
+        if (room <= 0) return;
+        size_t n = _frameLen - _framePos;
+        if (n > (size_t)room) n = (size_t)room;
+        Serial.write(_frame + _framePos, n);
+        _framePos += n;
+        _wireBytes += n;
+    }
+}
+
+void ResultExporter::report() {
+    uint32_t elapsedMs = millis() - _startMs;
+    char buf[160];
+    snprintf(buf, sizeof(buf),
+             "OK EXPORT done records=%lu samples=%lu stream=%lu csv=%lu wire=%lu ms=%lu ratio=%.2f",
+             (unsigned long)_records, (unsigned long)_samplesOut,
+             (unsigned long)(_streamPos - _resumeOffset), (unsigned long)_csvBytes,
+             (unsigned long)_wireBytes, (unsigned long)elapsedMs,
+             _wireBytes ? (float)_csvBytes / (float)_wireBytes : 0.0f);
+    Serial.println();
+    Serial.println(buf);
+}
@@ -0,0 +1,168 @@
+#include "result_store.h"
+#include "crc32.h"
+#include "config.h"
+#include <Arduino.h>
+#include <FS.h>
+#include <LittleFS.h>
+#include <unistd.h>
+#include <cstring>
+
+ResultStore resultStore;
+
+static const char* RESULT_FILE = "/results.bin";
+static const char* RESULT_FILE_VFS = "/littlefs/results.bin";   // mesmo arquivo via VFS (truncate)
+static const char* RESULT_FILE_OLD = "/results_old.bin";
+
+static constexpr size_t CURVE_BLOB_MAX = curveMaxBytes(SPRING_SAMPLE_CAPACITY);
+
+// Blob da curva em codificação/leitura (um registro por vez, loop único)
+static uint8_t s_curveBlob[CURVE_BLOB_MAX];
+
+static bool headerLooksValid(const ResultRecordHeader& h) {
+    return h.magic == RESULT_RECORD_MAGIC && h.version == RESULT_RECORD_VERSION &&
+           h.sampleCount <= SPRING_SAMPLE_CAPACITY && h.curveBytes <= CURVE_BLOB_MAX;
+}
+
+bool ResultStore::begin() {
+    // true: formata na primeira montagem (partição nova)
+    if (!LittleFS.begin(true)) {
+        Serial.println("[STORE] ERRO: falha ao montar LittleFS.");
+        _mounted = false;
+        return false;
+    }
+    _mounted = true;
+    _records = 0;
+    _bytes = 0;
+    _nextSeq = 1;
+
+    File f = LittleFS.open(RESULT_FILE, "r");
+    if (!f) {
+        Serial.println("[STORE] Registro de resultados vazio.");
+        return true;
+    }
+
+    // Percorre só cabeçalhos; o último blob completo define o fim válido
+    uint32_t fileSize = f.size();
+    uint32_t pos = 0;
+    ResultRecordHeader h;
+    if (fileSize >= sizeof(h) && f.read((uint8_t*)&h, sizeof(h)) == sizeof(h) &&
+        h.magic == RESULT_RECORD_MAGIC && h.version != RESULT_RECORD_VERSION) {
+        // Formato anterior: preserva para exportação manual e recomeça
+        f.close();
+        LittleFS.remove(RESULT_FILE_OLD);
+        LittleFS.rename(RESULT_FILE, RESULT_FILE_OLD);
+        Serial.print("[STORE] Registro na versao ");
+        Serial.print(h.version);
+        Serial.print(" movido para ");
+        Serial.println(RESULT_FILE_OLD);
+        return true;
+    }
+    while (pos + sizeof(h) <= fileSize) {
+        f.seek(pos);
+        if (f.read((uint8_t*)&h, sizeof(h)) != sizeof(h) || !headerLooksValid(h)) break;
+        uint32_t next = pos + sizeof(h) + h.curveBytes;
+        if (next > fileSize) break;
+        pos = next;
+        ++_records;
+        _nextSeq = h.seq + 1;
+    }
+    f.close();
+    _bytes = pos;
+
+    if (pos < fileSize) {
+        Serial.print("[STORE] AVISO: cauda incompleta descartada (");
+        Serial.print((unsigned long)(fileSize - pos));
+        Serial.println(" bytes).");
+        truncate(RESULT_FILE_VFS, pos);
+    }
+
+    Serial.print("[STORE] ");
+    Serial.print((unsigned long)_records);
+    Serial.print(" registros, ");
+    Serial.print((unsigned long)_bytes);
+    Serial.println(" bytes.");
+    return true;
+}
+
+bool ResultStore::append(ResultRecordHeader& header, const CurveMeta& meta,
+                         const CurveSample* samples, int count) {
+    if (!_mounted || count < 0 || count > SPRING_SAMPLE_CAPACITY) return false;
+
+    size_t curveBytes = curveEncode(meta, samples, count, s_curveBlob, sizeof(s_curveBlob));
+    if (curveBytes == 0) {
+        Serial.println("[STORE] ERRO: falha ao codificar a curva.");
+        return false;
+    }
+    uint32_t size = sizeof(header) + (uint32_t)curveBytes;
+    if (_bytes + size > RESULT_STORE_MAX_BYTES) {
+        Serial.println("[STORE] AVISO: registro cheio - exporte e use STORE CLEAR.");
+        return false;
+    }
+
+    header.magic = RESULT_RECORD_MAGIC;
+    header.version = RESULT_RECORD_VERSION;
+    header.sampleCount = (uint16_t)count;
+    header.seq = _nextSeq;
+    header.curveBytes = (uint32_t)curveBytes;
+    header.curveCrc = crc32Update(0, s_curveBlob, curveBytes);
+
+    File f = LittleFS.open(RESULT_FILE, "a");
+    if (!f) {
+        Serial.println("[STORE] ERRO: falha ao abrir registro para gravar.");
+        return false;
+    }
+    size_t written = f.write((const uint8_t*)&header, sizeof(header));
+    written += f.write(s_curveBlob, curveBytes);
+    f.close();
+
+    if (written != size) {
+        // Cauda parcial: o próximo begin() descarta
+        Serial.println("[STORE] ERRO: gravação incompleta.");
+        return false;
+    }
+    _bytes += size;
+    ++_records;
+    ++_nextSeq;
+    return true;
+}
+
+bool ResultStore::readNext(uint32_t* cursor, ResultRecordHeader* header, CurveMeta* meta,
+                           CurveSample* samples, int maxSamples) const {
+    if (!_mounted || *cursor + sizeof(ResultRecordHeader) > _bytes) return false;
+
+    File f = LittleFS.open(RESULT_FILE, "r");
+    if (!f) return false;
+    f.seek(*cursor);
+    bool ok = f.read((uint8_t*)header, sizeof(*header)) == sizeof(*header) &&
+              headerLooksValid(*header) && header->sampleCount <= maxSamples;
+    if (ok) {
+        ok = f.read(s_curveBlob, header->curveBytes) == header->curveBytes;
+    }
+    f.close();
+    if (!ok) return false;
+
+    if (crc32Update(0, s_curveBlob, header->curveBytes) != header->curveCrc) {
+        Serial.print("[STORE] AVISO: CRC divergente no registro ");
+        Serial.println((unsigned long)header->seq);
+    }
+
+    CurveReader reader;
+    if (!reader.open(s_curveBlob, header->curveBytes) || reader.count() != header->sampleCount) {
+        return false;
+    }
+    *meta = reader.meta();
+    for (int i = 0; i < header->sampleCount; ++i) {
+        if (!reader.next(&samples[i])) return false;
+    }
+    *cursor += sizeof(*header) + header->curveBytes;
+    return true;
+}
+
+void ResultStore::clear() {
+    if (!_mounted) return;
+    LittleFS.remove(RESULT_FILE);
+    _records = 0;
+    _bytes = 0;
+    // seq segue crescendo nesta sessão; após reiniciar com o arquivo vazio volta a 1
+    Serial.println("[STORE] Registro de resultados apagado.");
+}
@@ -0,0 +1,469 @@
+#include "rig_sim.h"
+#include "config.h"
+#include "fast_io.h"
+#include "endstop_homing.h"
+#include "fatigue_stroke.h"
+#include "motion_phase.h"
+#include <cmath>
+
+// Sempre na porta simulada, mesmo no build do ESP32
+using SimStepPin    = FastPin<STEP_PIN, true>;
+using SimDirPin     = FastPin<DIR_PIN, true>;
+using SimEndstopPin = FastPin<ENDSTOP_PIN, true>;
+
+static const int      SIM_EDGE_MAX = 128;
+static const uint32_t SIM_NO_EVENT = 0xFFFFFFFFu;
+
+struct SimEdge {
+    uint32_t t;
+    bool     pressed;
+};
+
+struct RigSimState {
+    RigSimConfig  cfg;
+    EndstopLatch* latch;
+    uint32_t rng;
+    uint32_t nowUs;
+    int32_t  axis;          // posição mecânica em pulsos (switch nominal em 0)
+    int32_t  firmware;      // contador de posição do firmware (começa em 0)
+    float    tripUnits;     // ponto de acionamento desta repetição
+    bool     contacted;
+    bool     pressed;       // nível lógico atual (acionado)
+    SimEdge  edges[SIM_EDGE_MAX];
+    int      edgeCount;
+    uint32_t nextGlitchUs;
+    uint32_t timerDeadline;
+    bool     timerArmed;
+};
+
+static float simUniform(uint32_t& rng) {
+    // xorshift32: reprodutível pela semente
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return (float)(rng >> 8) * (1.0f / 16777216.0f);
+}
+
+static float simGaussian(uint32_t& rng) {
+    float sum = 0.0f;
+    for (int i = 0; i < 12; ++i) sum += simUniform(rng);
+    return sum - 6.0f;
+}
+
+static void scheduleEdge(RigSimState& s, uint32_t t, bool pressed) {
+    if (s.edgeCount >= SIM_EDGE_MAX) return;
+    int i = s.edgeCount++;
+    while (i > 0 && s.edges[i - 1].t > t) {
+        s.edges[i] = s.edges[i - 1];
+        --i;
+    }
+    s.edges[i] = {t, pressed};
+}
+
+static void scheduleGlitch(RigSimState& s, uint32_t fromUs) {
+    if (s.cfg.glitchPerS <= 0.0f) {
+        s.nextGlitchUs = SIM_NO_EVENT;
+        return;
+    }
+    float gapUs = -logf(1.0f - simUniform(s.rng)) / s.cfg.glitchPerS * 1e6f;
+    s.nextGlitchUs = fromUs + (uint32_t)gapUs;
+}
+
+static void applyEdge(RigSimState& s, bool pressed) {
+    s.pressed = pressed;
+    // Endstop para GND com pull-up: acionado = nível baixo
+    if (pressed) simGpioPort.in = simGpioPort.in & ~(1ULL << ENDSTOP_PIN);
+    else         simGpioPort.in = simGpioPort.in | (1ULL << ENDSTOP_PIN);
+    // ISR: posição do instante da borda
+    if (s.latch && s.latch->onEdge(pressed, s.firmware)) {
+        s.timerArmed = true;
+        s.timerDeadline = s.nowUs + ENDSTOP_DEBOUNCE_US;
+    }
+}
+
+// Avança o relógio entregando bordas, ruído e o temporizador de debounce em ordem
+static void advance(RigSimState& s, uint32_t toUs) {
+    while (true) {
+        uint32_t tEdge = s.edgeCount ? s.edges[0].t : SIM_NO_EVENT;
+        uint32_t tTimer = s.timerArmed ? s.timerDeadline : SIM_NO_EVENT;
+        uint32_t tGlitch = s.contacted ? SIM_NO_EVENT : s.nextGlitchUs;
+        uint32_t t = tEdge;
+        if (tGlitch < t) t = tGlitch;
+        if (tTimer < t) t = tTimer;
+        if (t == SIM_NO_EVENT || t > toUs) break;
+        s.nowUs = t;
+
+        if (t == tGlitch && tGlitch < tEdge) {
+            scheduleEdge(s, t, true);
+            scheduleEdge(s, t + s.cfg.glitchUs, false);
+            scheduleGlitch(s, t);
+        } else if (t == tEdge) {
+            bool pressed = s.edges[0].pressed;
+            --s.edgeCount;
+            for (int i = 0; i < s.edgeCount; ++i) s.edges[i] = s.edges[i + 1];
+            applyEdge(s, pressed);
+        } else {
+            s.timerArmed = false;
+            if (s.latch) s.latch->onDebounceTimer(s.pressed);
+        }
+    }
+    s.nowUs = toUs;
+}
+
+static void onContact(RigSimState& s) {
+    s.contacted = true;
+    s.edgeCount = 0;   // ruído pendente some: o switch fechou
+    scheduleEdge(s, s.nowUs, true);
+    if (s.cfg.bounceUs == 0 || s.cfg.bounceEdgeUs == 0) return;
+
+    uint32_t end = s.nowUs + s.cfg.bounceUs;
+    bool level = true;
+    uint32_t t = s.nowUs + (uint32_t)(s.cfg.bounceEdgeUs * (0.5f + simUniform(s.rng)));
+    // Reserva a última vaga: o bounce sempre termina acionado
+    while (t < end && s.edgeCount < SIM_EDGE_MAX - 1) {
+        level = !level;
+        scheduleEdge(s, t, level);
+        t += (uint32_t)(s.cfg.bounceEdgeUs * (0.5f + simUniform(s.rng)));
+    }
+    if (!level) scheduleEdge(s, end, true);
+}
+
+// Gancho da porta simulada: cada borda de subida do STEP move o eixo
+static void onPinWrite(int pin, bool level, void* ctx) {
+    if (pin != STEP_PIN || !level) return;
+    RigSimState& s = *static_cast<RigSimState*>(ctx);
+    bool towardHome = (simGpioPort.out & (1ULL << DIR_PIN)) == 0;   // LOW = backward
+    s.axis += towardHome ? -1 : 1;
+    if (!s.contacted && (float)s.axis <= s.tripUnits) onContact(s);
+    advance(s, s.nowUs);
+}
+
+// ---- HAL do homing sobre o eixo simulado ----
+static void simStep(void* ctx) {
+    RigSimState& s = *static_cast<RigSimState*>(ctx);
+    // Como no firmware: conta antes do pulso, a ISR vê a posição já dada
+    s.firmware -= 1;
+    SimStepPin::high();
+    advance(s, s.nowUs + STEP_PULSE_US);
+    SimStepPin::low();
+}
+
+static void simDelayUs(uint32_t us, void* ctx) {
+    RigSimState& s = *static_cast<RigSimState*>(ctx);
+    advance(s, s.nowUs + us);
+}
+
+static bool simEndstopPressed(void*) {
+    return !SimEndstopPin::read();
+}
+
+static int32_t simPosition(void* ctx) {
+    return static_cast<RigSimState*>(ctx)->firmware;
+}
+
+HomeRepeatability rigSimHomeRepeatability(const RigSimConfig& cfg, uint16_t runs, bool useLatch) {
+    HomeRepeatability out;
+    const float unitsPerUm = (float)ActiveRig::STEPS_PER_MM / 1000.0f;
+    const int32_t startUnits = (int32_t)lroundf(cfg.startMm * 1000.0f * unitsPerUm);
+
+    EndstopLatch latch;
+    RigSimState s = {};
+    s.cfg = cfg;
+    s.latch = useLatch ? &latch : nullptr;
+    s.rng = cfg.seed ? cfg.seed : 1u;
+
+    void (*prevHook)(int, bool, void*) = simGpioPort.onWrite;
+    void* prevCtx = simGpioPort.ctx;
+    simGpioPort.onWrite = onPinWrite;
+    simGpioPort.ctx = &s;
+
+    EndstopHomingHal hal = {simStep, simDelayUs, simEndstopPressed, simPosition, nullptr, &s};
+    EndstopHomingParams p = {startUnits * 2L + 1000L, cfg.stepDelayUs, ENDSTOP_SETTLE_TIMEOUT_US};
+
+    double mean = 0.0, m2 = 0.0;
+    float minUm = 0.0f, maxUm = 0.0f;
+    uint32_t edgeSum = 0;
+    uint16_t good = 0;
+
+    for (uint16_t run = 0; run < runs; ++run) {
+        s.nowUs = 0;
+        s.axis = startUnits;
+        s.firmware = 0;
+        s.tripUnits = simGaussian(s.rng) * cfg.tripJitterUm * unitsPerUm;
+        s.contacted = false;
+        s.edgeCount = 0;
+        s.timerArmed = false;
+        scheduleGlitch(s, 0);
+        SimDirPin::low();
+        applyEdge(s, false);
+
+        EndstopHomingReport rep = runEndstopHoming(p, hal, s.latch);
+        ++out.runs;
+        if (rep.result != ENDSTOP_HOME_OK) {
+            ++out.notFound;
+            continue;
+        }
+        // Zero em coordenadas da máquina: o contador do firmware começou em 0
+        float homeUnits = (float)(startUnits + rep.homePosition);
+        if (homeUnits > s.tripUnits + 1.0f) {
+            ++out.falseHomes;
+            continue;
+        }
+        float errUm = homeUnits / unitsPerUm;
+        ++good;
+        double delta = errUm - mean;
+        mean += delta / good;
+        m2 += delta * (errUm - mean);
+        if (good == 1 || errUm < minUm) minUm = errUm;
+        if (good == 1 || errUm > maxUm) maxUm = errUm;
+        edgeSum += rep.edges;
+    }
+
+    simGpioPort.onWrite = prevHook;
+    simGpioPort.ctx = prevCtx;
+
+    if (good > 0) {
+        out.meanUm = (float)mean;
+        out.stdUm = (good > 1) ? (float)sqrt(m2 / (good - 1)) : 0.0f;
+        out.spanUm = maxUm - minUm;
+        out.meanEdges = (float)edgeSum / good;
+    }
+    return out;
+}
+
+// ---- Ciclagem de fadiga ----
+
+static const float SIM_HX711_READ_US = 60.0f;   // leitura dos 24 bits no callback
+
+// Posição em 1/TMC_FINE_MICROSTEPS (StepperManager com troca de fase)
+static const float SIM_FINE_UNITS_PER_MM =
+    (float)ActiveRig::STEPS_PER_MM * (float)(TMC_FINE_MICROSTEPS / TMC_DEFAULT_MICROSTEPS);
+
+// Mesmo cálculo de StepperManager::cruisePpsFor(); ctx = MotionPhaseAxis
+static float simCruisePps(uint16_t usDelay, void* ctx) {
+    const MotionPhaseAxis& axis = *static_cast<const MotionPhaseAxis*>(ctx);
+    return 1e6f / (float)(motionPhasePulseDelayUs(usDelay, axis) + STEP_PULSE_US);
+}
+
+// Driver simulado: a troca de fase só muda o eixo, o flush é imediato
+static void simSetMicrosteps(uint16_t, void*) {}
+static void simSetCurrent(uint16_t, uint16_t, void*) {}
+static void simEnableStealthChop(bool, void*) {}
+static bool simWaitFlushed(uint32_t, void*) { return true; }
+
+static MotionPhaseAxis simPhaseAxis(const MotionPhaseConfig& cfg) {
+    static const MotionPhaseDriverHal hal = {
+        simSetMicrosteps, simSetCurrent, simEnableStealthChop, simWaitFlushed, nullptr
+    };
+    MotionPhaseAxis axis;
+    applyMotionPhase(hal, cfg, axis);
+    return axis;
+}
+
+// Trapézio contínuo equivalente a segmentRateAt(): aceleração, cruzeiro, frenagem
+struct SimSegmentMotion {
+    float ve, vp, vx, a;
+    float n1, nc;             // pulsos acelerando e em cruzeiro
+    float tAcc, tCruise, tDec; // segundos
+};
+
+static SimSegmentMotion segmentMotion(const MotionSegment& seg, float a) {
+    SimSegmentMotion m;
+    float n = (float)seg.pulses;
+    m.a = a;
+    m.ve = seg.entryPps;
+    m.vx = seg.exitPps;
+    m.vp = seg.cruisePps;
+    float n1 = (m.vp * m.vp - m.ve * m.ve) / (2.0f * a);
+    float n3 = (m.vp * m.vp - m.vx * m.vx) / (2.0f * a);
+    if (n1 < 0.0f) n1 = 0.0f;
+    if (n3 < 0.0f) n3 = 0.0f;
+    if (n1 + n3 > n) {
+        // Não chega ao cruzeiro: pico onde aceleração e frenagem se encontram
+        m.vp = sqrtf(fmaxf((2.0f * a * n + m.ve * m.ve + m.vx * m.vx) * 0.5f,
+                           fmaxf(m.ve * m.ve, m.vx * m.vx)));
+        n1 = fmaxf(0.0f, (m.vp * m.vp - m.ve * m.ve) / (2.0f * a));
+        n3 = fmaxf(0.0f, n - n1);
+    }
+    m.n1 = n1;
+    m.nc = fmaxf(0.0f, n - n1 - n3);
+    m.tAcc = (m.vp - m.ve) / a;
+    m.tCruise = m.nc / m.vp;
+    m.tDec = fmaxf(0.0f, (m.vp - m.vx) / a);
+    if (n <= 0.0f) m.tAcc = m.tCruise = m.tDec = 0.0f;
+    return m;
+}
+
+// Pulsos dados t segundos após o início do segmento
+static float pulsesAt(const SimSegmentMotion& m, float t) {
+    if (t <= m.tAcc) return m.ve * t + 0.5f * m.a * t * t;
+    t -= m.tAcc;
+    if (t <= m.tCruise) return m.n1 + m.vp * t;
+    t -= m.tCruise;
+    if (t > m.tDec) t = m.tDec;
+    return m.n1 + m.nc + m.vp * t - 0.5f * m.a * t * t;
+}
+
+float rigSimSegmentUs(const MotionSegment& seg, float accelPps2) {
+    SimSegmentMotion m = segmentMotion(seg, accelPps2);
+    return (m.tAcc + m.tCruise + m.tDec) * 1e6f;
+}
+
+struct FatigueSimState {
+    const RigSimFatigueConfig* cfg;
+    uint32_t rng;
+    double   nowUs;
+    double   nextConvUs;
+    float    periodUs;
+    bool     converting;
+    bool     ready;
+    float    latchedKg;       // última conversão (força no instante em que terminou)
+    float    kKgfMm;
+    long     zeroUnits;
+};
+
+static float springKg(FatigueSimState& s, float posUnits) {
+    float compressionMm = ((float)s.zeroUnits - posUnits) / SIM_FINE_UNITS_PER_MM;
+    if (compressionMm < 0.0f) compressionMm = 0.0f;
+    return s.kKgfMm * compressionMm + s.cfg->noiseKg * simGaussian(s.rng);
+}
+
+// Conversões que terminam até endUs, com a posição do instante de cada uma
+static void convertUntil(FatigueSimState& s, double endUs, const SimSegmentMotion* m,
+                         double segStartUs, float segStartPos, int8_t dir) {
+    if (!s.converting) {
+        s.nextConvUs = endUs;   // parado: recomeça em fase quando voltar
+        return;
+    }
+    while (s.nextConvUs <= endUs) {
+        float pos = segStartPos;
+        if (m) pos += dir * pulsesAt(*m, (float)((s.nextConvUs - segStartUs) * 1e-6));
+        s.latchedKg = springKg(s, pos);
+        s.ready = true;
+        s.nextConvUs += s.periodUs;
+    }
+}
+
+FatigueSoakReport rigSimFatigueSoak(const RigSimFatigueConfig& cfg, uint32_t cycles) {
+    FatigueSoakReport out;
+    static MotionQueue queue;
+    static CurveLog<FATIGUE_STORED_CURVES, FATIGUE_CURVE_POINTS> curveLog;
+    CycleAccumulator cycle;
+    FatigueSummary summary;
+    FatigueCycleGate gate;
+
+    FatigueSimState s = {};
+    s.cfg = &cfg;
+    s.rng = cfg.seed ? cfg.seed : 1u;
+    s.periodUs = 1e6f / cfg.sps;
+    s.nextConvUs = simUniform(s.rng) * s.periodUs;
+    s.zeroUnits = 0;   // contato aliviado
+
+    MotionPhaseAxis axis = simPhaseAxis(MOTION_PHASE_MEASURE_CFG);
+    const float pulsesPerMm = SIM_FINE_UNITS_PER_MM / (float)axis.pulseIncrement;
+    const float accel = STEPPER_ACCEL_MM_S2 * pulsesPerMm;
+    const float minPps = STEPPER_START_MM_S * pulsesPerMm;
+    int samplesPerStroke = (int)(FATIGUE_COURSE_MM / FATIGUE_SAMPLE_STEP_MM) + 1;
+    curveLog.begin(samplesPerStroke);
+    summary.begin();
+    gate.begin(FATIGUE_MIN_CYCLE_SAMPLES, FATIGUE_MAX_REJECTED_CYCLES);
+    uint64_t samples = 0;
+    uint32_t n = 0;
+
+    while (summary.cycles() < cycles) {
+        n = summary.cycles() + gate.rejected() + 1;
+        s.kKgfMm = cfg.kKgfMm * (1.0f + cfg.kDriftPct * 0.01f * (float)(n - 1) / 10000.0f);
+        bool stopped = cfg.hx711StopCycle != 0 && n >= cfg.hx711StopCycle;
+        bool missed = cfg.missEvery != 0 && (n % cfg.missEvery) == 0;
+        s.converting = !stopped && !missed;
+        s.ready = s.ready && s.converting;
+
+        buildFatigueStroke(queue, s.zeroUnits, SIM_FINE_UNITS_PER_MM, FATIGUE_STEP_DELAY_US);
+        if (cfg.blockingPoints) {
+            // Como antes da correção: DWELL em todo ponto e espera da conversão
+            MotionQueue blocking;
+            for (int i = 0; i < queue.size(); ++i) {
+                const MotionSegment& q = queue[i];
+                blocking.push(q.target, q.usDelay,
+                              q.action == SEG_ACTION_SAMPLE ? SEG_ACTION_DWELL : q.action, 0, q.tag);
+            }
+            queue = blocking;
+        }
+        queue.plan(s.zeroUnits, axis.pulseIncrement, accel, minPps, simCruisePps, &axis);
+
+        cycle.begin();
+        curveLog.beginCycle(n);
+        double cycleStart = s.nowUs;
+        float pos = (float)s.zeroUnits;
+        bool overForce = false;
+        for (int i = 0; i < queue.size() && !overForce; ++i) {
+            const MotionSegment& seg = queue[i];
+            SimSegmentMotion m = segmentMotion(seg, accel);
+            double endUs = s.nowUs + (m.tAcc + m.tCruise + m.tDec) * 1e6;
+            convertUntil(s, endUs, &m, s.nowUs, pos, seg.dir);
+            s.nowUs = endUs;
+            pos += seg.dir * (float)seg.pulses;
+            if (seg.action == SEG_ACTION_NONE) continue;
+
+            bool fresh = s.ready;
+            if (!fresh && seg.action == SEG_ACTION_DWELL && s.converting) {
+                // readRaw(): carro parado até a próxima conversão
+                convertUntil(s, s.nextConvUs, nullptr, s.nowUs, pos, 0);
+                s.nowUs = s.nextConvUs - s.periodUs;
+                fresh = true;
+            }
+            if (fresh) {
+                s.nowUs += SIM_HX711_READ_US;
+                s.ready = false;
+            }
+            overForce = !gate.onPoint(cycle, seg.tag, fresh, s.latchedKg, FATIGUE_MAX_FORCE_KG);
+            if (gate.sampled()) {
+                curveLog.addSample(fatigueStrokePointMm(seg.tag), s.latchedKg);
+                ++samples;
+            }
+        }
+        out.cycleMs += (float)((s.nowUs - cycleStart) / 1000.0);
+
+        if (overForce || gate.endCycle(cycle, summary) == FATIGUE_CYCLE_HX711_LOST) {
+            out.hx711Lost = !overForce;
+            break;
+        }
+    }
+
+    out.cycles = summary.cycles();
+    out.rejected = gate.rejected();
+    if (n > 0) {
+        out.cycleMs /= (float)n;
+        out.samplesPerCycle = (float)samples / (float)n;
+    }
+    out.meanK = summary.meanK();
+    out.stdK = summary.stdDevK();
+    out.firstK = summary.firstK();
+    out.lastK = summary.lastK();
+    out.driftPct = summary.driftPercent();
+    out.storedCurves = curveLog.size();
+    return out;
+}
+
+// ---- Deslocamento por fase ----
+
+PhaseMoveReport rigSimPhaseMove(const MotionPhaseConfig& cfg, float distanceMm, uint16_t usDelay) {
+    PhaseMoveReport out;
+    MotionPhaseAxis axis = simPhaseAxis(cfg);
+    const float pulsesPerMm = SIM_FINE_UNITS_PER_MM / (float)axis.pulseIncrement;
+
+    MotionQueue queue;
+    long target = lroundf(distanceMm * SIM_FINE_UNITS_PER_MM);
+    queue.push(target, usDelay);
+    queue.plan(0, axis.pulseIncrement, STEPPER_ACCEL_MM_S2 * pulsesPerMm,
+               STEPPER_START_MM_S * pulsesPerMm, simCruisePps, &axis);
+
+    const MotionSegment& seg = queue[0];
+    out.pulses = (uint32_t)seg.pulses;
+    out.travelMs = rigSimSegmentUs(seg, STEPPER_ACCEL_MM_S2 * pulsesPerMm) / 1000.0f;
+    out.cruiseMmS = seg.cruisePps / pulsesPerMm;
+    out.resolutionUm = 1000.0f / pulsesPerMm;
+    long reached = (long)seg.pulses * axis.pulseIncrement;
+    out.targetErrorUm = fabsf((float)(target - reached)) * 1000.0f / SIM_FINE_UNITS_PER_MM;
+    return out;
+}
@@ -2,6 +2,8 @@
 #include <HX711.h>
 #include <EEPROM.h>
 #include "config.h"
+#include "trace_probe.h"
+#include "event_trace.h"
 
 static HX711 scale;
 ScaleManager scaleManager;
@@ -11,7 +13,13 @@ static const int EEPROM_ADDR_MAGIC = 0;
 static const int EEPROM_ADDR_CALIB = 4;
 static const uint32_t EEPROM_MAGIC = 0xA5A5DEAD;
 
-void ScaleManager::begin() {
+// Sensor externo de temperatura (ZERO_TRACK_TEMP_SOURCE == 2): ainda não
+// instalado; NaN desliga o termo de temperatura do modelo
+static float readExternalTempC() {
+    return NAN;
+}
+
+void ScaleManager::setupHardware() {
 #ifdef ESP32
     EEPROM.begin(64);   // tamanho suficiente
 #endif
@@ -21,17 +29,131 @@ void ScaleManager::begin() {
 
     scale.begin(LOADCELL_DOUT_PIN, LOADCELL_SCK_PIN);
     scale.set_scale(_calibFactor);
-    tare();
+
+    // Limiares em contagens com o fator carregado (recalibração muda pouco)
+    float countsPerKg = fabsf(_calibFactor);
+    ZeroTrackerConfig cfg;
+    cfg.observeIntervalMs = ZERO_TRACK_OBSERVE_MS;
+    cfg.stableCounts      = ZERO_TRACK_STABLE_KG * countsPerKg;
+    cfg.maxJumpCounts     = ZERO_TRACK_MAX_JUMP_KG * countsPerKg;
+    cfg.forgetting        = ZERO_TRACK_FORGET;
+    _zero.begin(cfg);
+}
+
+void ScaleManager::begin() {
+    setupHardware();
+    runTare(true);
+    _tareReady = true;
+}
+
+void ScaleManager::beginAsync() {
+    setupHardware();
+    _tareReady = false;
+    BaseType_t ok = xTaskCreatePinnedToCore(tareTaskEntry, "tare", TARE_TASK_STACK,
+                                            this, TARE_TASK_PRIORITY, nullptr, TARE_TASK_CORE);
+    if (ok != pdPASS) {
+        runTare(true);   // sem tarefa: tara no próprio setup
+        _tareReady = true;
+    }
+}
+
+void ScaleManager::tareTaskEntry(void* arg) {
+    ScaleManager* self = static_cast<ScaleManager*>(arg);
+    self->runTare(true);
+    self->_tareReady = true;
+    vTaskDelete(nullptr);
+}
+
+void ScaleManager::waitTareReady() {
+    while (!_tareReady) {
+        delay(1);
+    }
+}
+
+const TareResult& ScaleManager::tare(bool zeroReference) {
+    // Splash pode ter saído com a tara de boot ainda lendo o HX711 (core 0)
+    waitTareReady();
+    return runTare(zeroReference);
+}
+
+const TareResult& ScaleManager::runTare(bool zeroReference) {
+    TareConfig cfg;
+    cfg.targetSeCounts = TARE_TARGET_SE_KG * fabsf(_calibFactor);
+    cfg.minSamples     = TARE_MIN_SAMPLES;
+    cfg.maxSamples     = TARE_MAX_SAMPLES;
+    cfg.trendT         = TARE_TREND_T;
+    _tare.begin(cfg);
+
+    while (!_tare.done()) {
+        // Espera cedendo 1 ms: na tarefa de boot o core 0 não fica preso
+        if (!scale.wait_ready_timeout(SCALE_READ_TIMEOUT_MS, 1)) {
+            _tare.abort();
+            break;
+        }
+        _tare.push((int32_t)scale.read());
+    }
+
+    const TareResult& result = _tare.result();
+    if (result.quality == TARE_QUALITY_FAILED) {
+        return result;   // mantém o offset anterior
+    }
+    scale.set_offset(result.offset);
+    if (ZERO_TRACK_ENABLED && zeroReference) {
+        // Também é observação do zero (deriva e temperatura aprendidas continuam)
+        _zero.tare((float)result.offset, millis(), temperatureC());
+    }
+    return result;
 }
 
-void ScaleManager::tare(uint8_t times) {
-    scale.tare(times);
+float ScaleManager::temperatureC() {
+    if (ZERO_TRACK_TEMP_SOURCE == 0) return NAN;
+    uint32_t now = millis();
+    if (!_tempValid || now - _tempMs >= ZERO_TRACK_TEMP_PERIOD_MS) {
+        _tempC = (ZERO_TRACK_TEMP_SOURCE == 1) ? temperatureRead() : readExternalTempC();
+        _tempMs = now;
+        _tempValid = true;
+    }
+    return _tempC;
 }
 
 void ScaleManager::update() {
+    PROBE_SCOPE(PROBE_SCALE_UPDATE);
+    if (!_tareReady) return;   // tara de boot ainda usando o HX711
     if (scale.is_ready()) {
-        _currentKg = scale.get_units(5);  // média de 5 leituras em kg
-        _lastRaw   = scale.read();
+        // Média de 5 leituras: a mesma média bruta alimenta kg e _lastRaw
+        _lastRaw   = scale.read_average(5);
+        trackZero(_lastRaw);
+        _currentKg = rawToKg(_lastRaw);
+        TRACE_EVENT(EVT_SAMPLE, TRACE_SAMPLE_HX711, _lastRaw);
+    }
+}
+
+bool ScaleManager::readRaw(long* raw) {
+    waitTareReady();
+    if (!scale.wait_ready_timeout(SCALE_READ_TIMEOUT_MS)) {
+        return false;
+    }
+    _lastRaw   = scale.read();
+    trackZero(_lastRaw);
+    _currentKg = rawToKg(_lastRaw);
+    *raw = _lastRaw;
+    return true;
+}
+
+void ScaleManager::trackZero(long raw) {
+    if (!ZERO_TRACK_ENABLED) return;
+    if (_zeroFrozen) {
+        // Teste rodando: vale a tara do teste, sem extrapolar o modelo
+        _zero.interrupt();
+        return;
+    }
+    // Offset só muda quando a janela mostra a célula livre e estável
+    uint32_t now = millis();
+    float tempC = temperatureC();
+    if (!_zero.observe((int32_t)raw, now, tempC)) return;
+    long offset = lroundf(_zero.offsetAt(now, tempC));
+    if (offset != scale.get_offset()) {
+        scale.set_offset(offset);
     }
 }
 
@@ -54,6 +176,7 @@ void ScaleManager::calibrateWithKnownWeight(float knownKg) {
         return;
     }
 
+    waitTareReady();
     // Pressupõe que já foi feito tare() sem peso
     // Fórmula típica: SCALE = (raw - offset) / peso
     long raw    = scale.read_average(10);
@@ -100,7 +223,7 @@ bool ScaleManager::isReady() const {
 
 float ScaleManager::peekWeightKgFast() {
     // Leitura instantânea: usa leitura bruta e converte com offset e fator
-    if (!scale.is_ready()) {
+    if (!_tareReady || !scale.is_ready()) {
         return _currentKg;  // mantém último valor se não estiver pronto
     }
 
@@ -112,7 +235,7 @@ float ScaleManager::peekWeightKgFast() {
 }
 
 long ScaleManager::getRawReading() {
-    if (scale.is_ready()) {
+    if (_tareReady && scale.is_ready()) {
         _lastRaw = scale.read();
     }
     return _lastRaw;
@@ -122,3 +245,15 @@ long ScaleManager::getRawReadingAbsolute() {
     long raw = getRawReading();
     return (raw >= 0) ? raw : -raw;
 }
+
+long ScaleManager::getLastRaw() const {
+    return _lastRaw;
+}
+
+long ScaleManager::getOffset() const {
+    return scale.get_offset();
+}
+
+float ScaleManager::rawToKg(long raw) const {
+    return (float)(raw - scale.get_offset()) / _calibFactor;
+}
@@ -0,0 +1,83 @@
+#include "sensorless_homing.h"
+
+enum ApproachStop : uint8_t {
+    STOP_NONE = 0,
+    STOP_STALL,
+    STOP_ENDSTOP,
+    STOP_ABORT
+};
+
+// Anda em direção ao home até stall, fim de curso, abort ou limite de passos
+static ApproachStop approach(const HomingHal& hal, long maxSteps, long blankSteps,
+                             uint16_t delayUs, long* outSteps) {
+    hal.setDirection(true, hal.ctx);
+    long n = 0;
+    ApproachStop stop = STOP_NONE;
+    while (n < maxSteps) {
+        if (hal.endstopPressed(hal.ctx)) {
+            stop = STOP_ENDSTOP;
+            break;
+        }
+        if (hal.abortRequested && hal.abortRequested(hal.ctx)) {
+            stop = STOP_ABORT;
+            break;
+        }
+        if (n >= blankSteps && hal.stallActive(hal.ctx)) {
+            stop = STOP_STALL;
+            break;
+        }
+        hal.step(hal.ctx);
+        hal.delayUs(delayUs, hal.ctx);
+        ++n;
+    }
+    *outSteps = n;
+    return stop;
+}
+
+HomingReport runSensorlessHoming(const SensorlessHomingParams& p, const HomingHal& hal) {
+    HomingReport rep;
+
+    // 1) Aproximação rápida
+    ApproachStop stop = approach(hal, p.maxSteps, p.blankSteps, p.fastDelayUs, &rep.fastSteps);
+    if (stop == STOP_ABORT) {
+        rep.result = HOMING_ABORTED;
+        return rep;
+    }
+    if (stop == STOP_NONE) {
+        rep.result = HOMING_NO_CONTACT;
+        return rep;
+    }
+
+    // 2) Recuo (afasta também do micro switch, se ele parou a aproximação)
+    hal.setDirection(false, hal.ctx);
+    for (long i = 0; i < p.backoffSteps; ++i) {
+        hal.step(hal.ctx);
+        hal.delayUs(p.slowDelayUs, hal.ctx);
+    }
+
+    // 3) Reaproximação lenta: não deve passar muito do ponto de contato
+    long slowLimit = p.backoffSteps * 2 + p.blankSteps;
+    stop = approach(hal, slowLimit, p.blankSteps, p.slowDelayUs, &rep.slowSteps);
+    if (stop == STOP_ABORT) {
+        rep.result = HOMING_ABORTED;
+        return rep;
+    }
+    if (stop == STOP_NONE) {
+        rep.result = HOMING_NO_CONTACT;
+        return rep;
+    }
+
+    // 4) Verificação pelo fim de curso
+    rep.result = hal.endstopPressed(hal.ctx) ? HOMING_OK : HOMING_STALL_WITHOUT_ENDSTOP;
+    return rep;
+}
+
+const char* homingResultName(HomingResult r) {
+    switch (r) {
+        case HOMING_OK:                    return "OK";
+        case HOMING_NO_CONTACT:            return "sem contato";
+        case HOMING_STALL_WITHOUT_ENDSTOP: return "stall sem fim de curso";
+        case HOMING_ABORTED:               return "abortado";
+        default:                           return "?";
+    }
+}
@@ -0,0 +1,97 @@
+#include "settling_detector.h"
+#include <cmath>
+
+void SettlingDetector::begin(const SettlingConfig& cfg) {
+    _cfg = cfg;
+    if (_cfg.window < 3) _cfg.window = 3;
+    if (_cfg.window > SETTLE_WINDOW_MAX) _cfg.window = SETTLE_WINDOW_MAX;
+    start(0);
+}
+
+void SettlingDetector::start(uint32_t nowMs) {
+    _status = SETTLE_WAITING;
+    _startMs = nowMs;
+    _settlingMs = 0;
+    _conversions = 0;
+    _count = 0;
+    _head = 0;
+    _used = 0;
+    _mean = 0.0f;
+    _std = 0.0f;
+    _drift = 0.0f;
+}
+
+bool SettlingDetector::evaluate() {
+    // Janela: volta a partir da mais recente até cobrir window e minSpanMs
+    int newest = (_head - 1 + SETTLE_WINDOW_MAX) % SETTLE_WINDOW_MAX;
+    uint32_t tNewest = _t[newest];
+    int used = 0;
+    bool covered = false;
+    while (used < _count) {
+        int i = (newest - used + SETTLE_WINDOW_MAX) % SETTLE_WINDOW_MAX;
+        ++used;
+        if (used >= _cfg.window && tNewest - _t[i] >= _cfg.minSpanMs) {
+            covered = true;
+            break;
+        }
+    }
+    _used = used;
+
+    // Relativos à conversão mais antiga da janela (contagens grandes, float sem perda)
+    int oldest = (newest - used + 1 + SETTLE_WINDOW_MAX) % SETTLE_WINDOW_MAX;
+    int32_t rawRef = _raw[oldest];
+    uint32_t tRef = _t[oldest];
+
+    float sumT = 0.0f, sumX = 0.0f;
+    for (int k = 0; k < used; ++k) {
+        int i = (oldest + k) % SETTLE_WINDOW_MAX;
+        sumT += (float)(_t[i] - tRef);
+        sumX += (float)(_raw[i] - rawRef);
+    }
+    float n = (float)used;
+    float meanT = sumT / n;
+    float meanX = sumX / n;
+
+    float stt = 0.0f, stx = 0.0f, sxx = 0.0f;
+    for (int k = 0; k < used; ++k) {
+        int i = (oldest + k) % SETTLE_WINDOW_MAX;
+        float dt = (float)(_t[i] - tRef) - meanT;
+        float dx = (float)(_raw[i] - rawRef) - meanX;
+        stt += dt * dt;
+        stx += dt * dx;
+        sxx += dx * dx;
+    }
+
+    float spanMs = (float)(tNewest - tRef);
+    float slope = (stt > 0.0f) ? stx / stt : 0.0f;   // contagens/ms
+
+    _mean = (float)rawRef + meanX;
+    _std = (used > 1) ? sqrtf(sxx / (n - 1.0f)) : 0.0f;
+    _drift = fabsf(slope) * spanMs;
+    return covered;
+}
+
+SettleStatus SettlingDetector::push(int32_t raw, uint32_t nowMs) {
+    if (_status != SETTLE_WAITING) return _status;
+
+    _raw[_head] = raw;
+    _t[_head] = nowMs;
+    _head = (_head + 1) % SETTLE_WINDOW_MAX;
+    if (_count < SETTLE_WINDOW_MAX) ++_count;
+    ++_conversions;
+
+    bool timedOut = (nowMs - _startMs) >= _cfg.timeoutMs;
+    bool covered = evaluate();
+    if (!covered && !timedOut) return _status;
+
+    float relLimit = _cfg.relTol * fabsf(_mean - (float)_cfg.zeroCounts);
+    float maxDrift = (relLimit > _cfg.maxDriftCounts) ? relLimit : _cfg.maxDriftCounts;
+    float maxStd = (relLimit > _cfg.maxStdCounts) ? relLimit : _cfg.maxStdCounts;
+    if (covered && _drift <= maxDrift && _std <= maxStd) {
+        _status = SETTLE_DONE;
+    } else if (timedOut) {
+        _status = SETTLE_TIMEOUT;
+    }
+    if (_status != SETTLE_WAITING) _settlingMs = nowMs - _startMs;
+    return _status;
+}
@@ -0,0 +1,213 @@
+#include "spc_chart.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+// Cores RGB565 (mesmos valores de TFT_eSPI)
+static const uint16_t SPC_BLACK    = 0x0000;
+static const uint16_t SPC_WHITE    = 0xFFFF;
+static const uint16_t SPC_RED      = 0xF800;
+static const uint16_t SPC_GREEN    = 0x07E0;
+static const uint16_t SPC_CYAN     = 0x07FF;
+static const uint16_t SPC_YELLOW   = 0xFFE0;
+static const uint16_t SPC_ORANGE   = 0xFDA0;
+static const uint16_t SPC_DARKGREY = 0x7BEF;
+
+// O fundo (moldura, linhas de controle/tolerância, rótulos) fica desenhado
+// na tela; a cada mola só o novo ponto e as linhas do painel que mudaram
+// são redesenhados. O fundo só é refeito quando a escala ou os limites
+// mudam de forma visível ou a página do gráfico enche.
+static const int SPC_XBAR_X0 = 40;
+static const int SPC_XBAR_Y0 = 30;
+static const int SPC_XBAR_H  = 130;
+static const int SPC_R_Y0    = 185;
+static const int SPC_R_H     = 80;
+static const int SPC_CHART_W = 290;
+static const int SPC_PANEL_X = 345;
+
+int SpcChartView::x(uint32_t subgroup) const {
+    return SPC_XBAR_X0 + (int)((subgroup - _pageStart) * (SPC_CHART_W - 1) / (SPC_CHART_POINTS - 1));
+}
+
+int SpcChartView::yXbar(float v) const {
+    float t = (v - _yMin) / (_yMax - _yMin);
+    if (t < 0.0f) t = 0.0f;
+    if (t > 1.0f) t = 1.0f;
+    return SPC_XBAR_Y0 + SPC_XBAR_H - 1 - (int)(t * (SPC_XBAR_H - 1));
+}
+
+int SpcChartView::yR(float r) const {
+    float t = (_rMax > 0.0f) ? r / _rMax : 0.0f;
+    if (t > 1.0f) t = 1.0f;
+    return SPC_R_Y0 + SPC_R_H - 1 - (int)(t * (SPC_R_H - 1));
+}
+
+static void hLineIn(const SpcCanvas& c, int y0, int h, int y, uint16_t color) {
+    if (y > y0 && y < y0 + h - 1) c.hLine(SPC_XBAR_X0 + 1, y, SPC_CHART_W - 2, color, c.ctx);
+}
+
+// Escala que contém limites de controle, tolerância e os pontos da página
+void SpcChartView::computeScale(const SpcBatch& b) {
+    float lo = b.xbarLcl(), hi = b.xbarUcl();
+    if (b.hasTolerance()) {
+        if (b.lsl() < lo) lo = b.lsl();
+        if (b.usl() > hi) hi = b.usl();
+    }
+    float rHi = b.rUcl();
+    SpcPoint p;
+    for (uint32_t i = _pageStart; i < b.subgroups(); ++i) {
+        if (!b.chartPoint(i, &p)) continue;
+        if (p.xbar < lo) lo = p.xbar;
+        if (p.xbar > hi) hi = p.xbar;
+        if (p.range > rHi) rHi = p.range;
+    }
+    float pad = (hi - lo) * 0.15f;
+    if (pad <= 0.0f) pad = (hi != 0.0f) ? fabsf(hi) * 0.05f : 0.01f;
+    _yMin = lo - pad;
+    _yMax = hi + pad;
+    _rMax = (rHi > 0.0f) ? rHi * 1.2f : 0.01f;
+    _ucl = b.xbarUcl();
+    _lcl = b.xbarLcl();
+    _rUcl = b.rUcl();
+}
+
+void SpcChartView::drawBackground(const SpcBatch& b, const SpcCanvas& c) {
+    char buf[24];
+    c.fillScreen(SPC_BLACK, c.ctx);
+    snprintf(buf, sizeof(buf), "CEP %s", b.partName());
+    c.text(5, 5, 2, SPC_YELLOW, buf, c.ctx);
+
+    c.drawRect(SPC_XBAR_X0, SPC_XBAR_Y0, SPC_CHART_W, SPC_XBAR_H, SPC_DARKGREY, c.ctx);
+    c.drawRect(SPC_XBAR_X0, SPC_R_Y0, SPC_CHART_W, SPC_R_H, SPC_DARKGREY, c.ctx);
+
+    if (b.subgroups() > 0) {
+        hLineIn(c, SPC_XBAR_Y0, SPC_XBAR_H, yXbar(b.grandMean()), SPC_GREEN);
+        hLineIn(c, SPC_XBAR_Y0, SPC_XBAR_H, yXbar(_ucl), SPC_ORANGE);
+        hLineIn(c, SPC_XBAR_Y0, SPC_XBAR_H, yXbar(_lcl), SPC_ORANGE);
+        hLineIn(c, SPC_R_Y0, SPC_R_H, yR(b.meanRange()), SPC_GREEN);
+        hLineIn(c, SPC_R_Y0, SPC_R_H, yR(_rUcl), SPC_ORANGE);
+    }
+    if (b.hasTolerance()) {
+        hLineIn(c, SPC_XBAR_Y0, SPC_XBAR_H, yXbar(b.lsl()), SPC_RED);
+        hLineIn(c, SPC_XBAR_Y0, SPC_XBAR_H, yXbar(b.usl()), SPC_RED);
+    }
+
+    snprintf(buf, sizeof(buf), "%.3f", _yMax);
+    c.text(2, SPC_XBAR_Y0, 1, SPC_CYAN, buf, c.ctx);
+    snprintf(buf, sizeof(buf), "%.3f", _yMin);
+    c.text(2, SPC_XBAR_Y0 + SPC_XBAR_H - 8, 1, SPC_CYAN, buf, c.ctx);
+    c.text(SPC_XBAR_X0 + 3, SPC_XBAR_Y0 + 3, 1, SPC_CYAN, "X-barra K", c.ctx);
+    snprintf(buf, sizeof(buf), "%.3f", _rMax);
+    c.text(2, SPC_R_Y0, 1, SPC_CYAN, buf, c.ctx);
+    c.text(SPC_XBAR_X0 + 3, SPC_R_Y0 + 3, 1, SPC_CYAN, "R", c.ctx);
+
+    c.text(40, 295, 2, SPC_YELLOW, "Click=menu  Long=novo lote", c.ctx);
+
+    _valid = true;
+    _drawn = _pageStart;
+    memset(_panel, 0, sizeof(_panel));   // tela limpa: painel inteiro de novo
+}
+
+void SpcChartView::plotPoint(const SpcBatch& b, uint32_t i, const SpcCanvas& c) {
+    SpcPoint p, prev;
+    if (!b.chartPoint(i, &p)) return;
+    int px = x(i);
+    uint16_t cx = (p.xbar > _ucl || p.xbar < _lcl) ? SPC_RED : SPC_WHITE;
+    uint16_t cr = (p.range > _rUcl) ? SPC_RED : SPC_WHITE;
+    if (i > _pageStart && b.chartPoint(i - 1, &prev)) {
+        int ppx = x(i - 1);
+        c.line(ppx, yXbar(prev.xbar), px, yXbar(p.xbar), SPC_CYAN, c.ctx);
+        c.line(ppx, yR(prev.range), px, yR(p.range), SPC_CYAN, c.ctx);
+    }
+    c.fillCircle(px, yXbar(p.xbar), 2, cx, c.ctx);
+    c.fillCircle(px, yR(p.range), 2, cr, c.ctx);
+}
+
+// Uma linha do painel: texto com fundo, completado com espaços até a largura
+// do painel (apaga o valor anterior sem limpar a área); só se mudou
+void SpcChartView::panelLine(int row, int y, uint8_t size, uint16_t color, const char* text,
+                             const SpcCanvas& c) {
+    char buf[SPC_PANEL_TEXT_MAX + 1];
+    int cols = (480 - SPC_PANEL_X) / (6 * size);
+    if (cols > SPC_PANEL_TEXT_MAX) cols = SPC_PANEL_TEXT_MAX;
+    snprintf(buf, sizeof(buf), "%-*.*s", cols, cols, text);
+    if (color == _panelColor[row] && strcmp(buf, _panel[row]) == 0) return;
+    memcpy(_panel[row], buf, sizeof(buf));
+    _panelColor[row] = color;
+    c.text(SPC_PANEL_X, y, size, color, buf, c.ctx);
+}
+
+void SpcChartView::drawPanel(const SpcBatch& b, const SpcCanvas& c) {
+    char buf[24];
+    int y = SPC_XBAR_Y0;
+    snprintf(buf, sizeof(buf), "n=%lu", (unsigned long)b.count());
+    panelLine(0, y, 2, SPC_WHITE, buf, c);
+    snprintf(buf, sizeof(buf), "m=%.3f", b.mean());
+    panelLine(1, y += 24, 2, SPC_WHITE, buf, c);
+    snprintf(buf, sizeof(buf), "s=%.4f", b.stdDev());
+    panelLine(2, y += 24, 2, SPC_WHITE, buf, c);
+
+    float cpk = b.cpk();
+    uint16_t cpkColor = !b.hasTolerance() ? SPC_DARKGREY
+                        : (cpk >= 1.33f ? SPC_GREEN : (cpk >= 1.0f ? SPC_YELLOW : SPC_RED));
+    if (b.hasTolerance() && b.count() >= 2) {
+        snprintf(buf, sizeof(buf), "Cpk=%.2f", cpk);
+    } else {
+        snprintf(buf, sizeof(buf), "Cpk=--");
+    }
+    panelLine(3, y += 30, 2, cpkColor, buf, c);
+
+    snprintf(buf, sizeof(buf), "UCL %.3f", b.xbarUcl());
+    panelLine(4, y += 30, 1, SPC_ORANGE, buf, c);
+    snprintf(buf, sizeof(buf), "LCL %.3f", b.xbarLcl());
+    panelLine(5, y += 14, 1, SPC_ORANGE, buf, c);
+    snprintf(buf, sizeof(buf), "R-barra %.4f", b.meanRange());
+    panelLine(6, y += 14, 1, SPC_ORANGE, buf, c);
+    snprintf(buf, sizeof(buf), "subgrupos %lu", (unsigned long)b.subgroups());
+    panelLine(7, y += 14, 1, SPC_ORANGE, buf, c);
+    if (b.hasTolerance()) {
+        snprintf(buf, sizeof(buf), "LIE %.3f", b.lsl());
+        panelLine(8, y += 14, 1, SPC_RED, buf, c);
+        snprintf(buf, sizeof(buf), "LSE %.3f", b.usl());
+        panelLine(9, y += 14, 1, SPC_RED, buf, c);
+    }
+}
+
+// Limites/escala mudaram o bastante para as linhas desenhadas ficarem erradas?
+bool SpcChartView::needsRedraw(const SpcBatch& b) const {
+    if (!_valid) return true;
+    if (b.subgroups() - _pageStart > (uint32_t)SPC_CHART_POINTS) return true;
+    float tol = (_yMax - _yMin) / SPC_XBAR_H * 2.0f;   // ~2 px
+    if (fabsf(b.xbarUcl() - _ucl) > tol || fabsf(b.xbarLcl() - _lcl) > tol) return true;
+    if (fabsf(b.rUcl() - _rUcl) > _rMax / SPC_R_H * 2.0f) return true;
+    SpcPoint p;
+    for (uint32_t i = _drawn; i < b.subgroups(); ++i) {
+        if (b.chartPoint(i, &p) && (p.xbar < _yMin || p.xbar > _yMax || p.range > _rMax)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SpcChartView::draw(const SpcBatch& b, const SpcCanvas& c) {
+    // Página cheia: recomeça a partir do último subgrupo
+    uint32_t total = b.subgroups();
+    _pageStart = (total > (uint32_t)SPC_CHART_POINTS)
+                     ? total - 1 - ((total - 1) % (SPC_CHART_POINTS - 1))
+                     : 0;
+    computeScale(b);
+    drawBackground(b, c);
+    for (uint32_t i = _pageStart; i < total; ++i) {
+        plotPoint(b, i, c);
+    }
+    _drawn = total;
+    drawPanel(b, c);
+}
+
+void SpcChartView::drawNew(const SpcBatch& b, const SpcCanvas& c) {
+    for (uint32_t i = _drawn; i < b.subgroups(); ++i) {
+        plotPoint(b, i, c);
+    }
+    _drawn = b.subgroups();
+    drawPanel(b, c);
+}
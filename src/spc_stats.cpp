@@ -0,0 +1,81 @@
+#include "spc_stats.h"
+#include "trace_probe.h"
+#include <cmath>
+#include <cstring>
+
+SpcBatch spcBatch;
+
+// Constantes de cartas de controle para n = 2..10
+static const float SPC_A2[] = {1.880f, 1.023f, 0.729f, 0.577f, 0.483f, 0.419f, 0.373f, 0.337f, 0.308f};
+static const float SPC_D3[] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.076f, 0.136f, 0.184f, 0.223f};
+static const float SPC_D4[] = {3.267f, 2.574f, 2.282f, 2.114f, 2.004f, 1.924f, 1.864f, 1.816f, 1.777f};
+static const float SPC_d2[] = {1.128f, 1.693f, 2.059f, 2.326f, 2.534f, 2.704f, 2.847f, 2.970f, 3.078f};
+
+static_assert(SPC_SUBGROUP_SIZE >= 2 && SPC_SUBGROUP_SIZE <= 10, "SPC_SUBGROUP_SIZE fora da tabela");
+static constexpr int SPC_K = SPC_SUBGROUP_SIZE - 2;
+
+void SpcBatch::begin(const char* partName, float lsl, float usl) {
+    *this = SpcBatch();
+    if (partName) {
+        strncpy(_part, partName, SPC_PART_NAME_MAX);
+        _part[SPC_PART_NAME_MAX] = '\0';
+    }
+    _lsl = lsl;
+    _usl = usl;
+}
+
+void SpcBatch::add(float value) {
+    PROBE_SCOPE(PROBE_SPC_ADD);
+    // Welford (estável para lotes longos com K ~ constante)
+    ++_n;
+    double delta = value - _mean;
+    _mean += delta / _n;
+    _m2 += delta * (value - _mean);
+    if (_n == 1 || value < _min) _min = value;
+    if (_n == 1 || value > _max) _max = value;
+
+    if (_groupCount == 0 || value < _groupMin) _groupMin = value;
+    if (_groupCount == 0 || value > _groupMax) _groupMax = value;
+    _groupSum += value;
+    if (++_groupCount < SPC_SUBGROUP_SIZE) return;
+
+    SpcPoint p;
+    p.xbar = (float)(_groupSum / SPC_SUBGROUP_SIZE);
+    p.range = _groupMax - _groupMin;
+    _chart[_subgroups % SPC_CHART_POINTS] = p;
+    ++_subgroups;
+    _grandMean += (p.xbar - _grandMean) / _subgroups;
+    _meanRange += (p.range - _meanRange) / _subgroups;
+
+    _groupCount = 0;
+    _groupSum = 0.0;
+}
+
+float SpcBatch::stdDev() const {
+    return (_n < 2) ? 0.0f : (float)sqrt(_m2 / (_n - 1));
+}
+
+float SpcBatch::xbarUcl() const { return (float)(_grandMean + SPC_A2[SPC_K] * _meanRange); }
+float SpcBatch::xbarLcl() const { return (float)(_grandMean - SPC_A2[SPC_K] * _meanRange); }
+float SpcBatch::rUcl() const { return (float)(SPC_D4[SPC_K] * _meanRange); }
+float SpcBatch::rLcl() const { return (float)(SPC_D3[SPC_K] * _meanRange); }
+
+float SpcBatch::sigmaWithin() const {
+    return (_subgroups >= 2) ? (float)(_meanRange / SPC_d2[SPC_K]) : stdDev();
+}
+
+float SpcBatch::cpk() const {
+    float sigma = sigmaWithin();
+    if (!hasTolerance() || _n < 2 || sigma <= 0.0f) return 0.0f;
+    float m = mean();
+    float upper = (_usl - m) / (3.0f * sigma);
+    float lower = (m - _lsl) / (3.0f * sigma);
+    return (upper < lower) ? upper : lower;
+}
+
+bool SpcBatch::chartPoint(uint32_t subgroup, SpcPoint* out) const {
+    if (subgroup >= _subgroups) return false;
+    if (_subgroups - subgroup > (uint32_t)SPC_CHART_POINTS) return false;
+    *out = _chart[subgroup % SPC_CHART_POINTS];
+    return true;
+}
@@ -0,0 +1,224 @@
+#include "spring_curve_fit.h"
+#include <cmath>
+
+// Somas prefixadas em double: evita cancelamento ao subtrair somas grandes
+static double s_sx[SPRING_CURVE_MAX_POINTS + 1];
+static double s_sy[SPRING_CURVE_MAX_POINTS + 1];
+static double s_sxx[SPRING_CURVE_MAX_POINTS + 1];
+static double s_sxy[SPRING_CURVE_MAX_POINTS + 1];
+static double s_syy[SPRING_CURVE_MAX_POINTS + 1];
+static float  s_px[SPRING_CURVE_MAX_POINTS];
+static float  s_py[SPRING_CURVE_MAX_POINTS];
+
+// Copia com decimação uniforme; retorna número de pontos em s_px/s_py
+static int loadPoints(const float* x, const float* y, int n) {
+    int m = (n <= SPRING_CURVE_MAX_POINTS) ? n : SPRING_CURVE_MAX_POINTS;
+    for (int i = 0; i < m; ++i) {
+        int src = (m > 1) ? (int)(((long)i * (n - 1)) / (m - 1)) : 0;
+        s_px[i] = x[src];
+        s_py[i] = y[src];
+    }
+    return m;
+}
+
+// Reta MQ sobre pontos [i, j) usando as somas prefixadas (O(1))
+static double segmentFit(int i, int j, double* outSlope, double* outIntercept) {
+    double m   = (double)(j - i);
+    double sx  = s_sx[j] - s_sx[i];
+    double sy  = s_sy[j] - s_sy[i];
+    double sxx = (s_sxx[j] - s_sxx[i]) - sx * sx / m;
+    double sxy = (s_sxy[j] - s_sxy[i]) - sx * sy / m;
+    double syy = (s_syy[j] - s_syy[i]) - sy * sy / m;
+
+    double slope = (sxx > 1e-12) ? sxy / sxx : 0.0;
+    if (outSlope) *outSlope = slope;
+    if (outIntercept) *outIntercept = (sy - slope * sx) / m;
+    double sse = syy - slope * sxy;
+    return (sse > 0.0) ? sse : 0.0;
+}
+
+// Quebra entre dois segmentos: interseção das retas, limitada ao intervalo entre eles
+static float breakBetween(int lastOfLeft, int firstOfRight,
+                          double k1, double a1, double k2, double a2) {
+    float lo = s_px[lastOfLeft];
+    float hi = s_px[firstOfRight];
+    float xb = 0.5f * (lo + hi);
+    if (fabs(k1 - k2) > 1e-9) {
+        xb = (float)((a2 - a1) / (k1 - k2));
+    }
+    if (xb < lo) xb = lo;
+    if (xb > hi) xb = hi;
+    return xb;
+}
+
+PiecewiseFit fitPiecewiseLinear(const float* x, const float* y, int n) {
+    PiecewiseFit fit;
+    if (n < 2) return fit;
+
+    int m = loadPoints(x, y, n);
+
+    // Centraliza para melhorar o condicionamento
+    double xm = 0.0, ym = 0.0;
+    for (int i = 0; i < m; ++i) {
+        xm += s_px[i];
+        ym += s_py[i];
+    }
+    xm /= m;
+    ym /= m;
+
+    s_sx[0] = s_sy[0] = s_sxx[0] = s_sxy[0] = s_syy[0] = 0.0;
+    for (int i = 0; i < m; ++i) {
+        double dx = s_px[i] - xm;
+        double dy = s_py[i] - ym;
+        s_sx[i + 1]  = s_sx[i] + dx;
+        s_sy[i + 1]  = s_sy[i] + dy;
+        s_sxx[i + 1] = s_sxx[i] + dx * dx;
+        s_sxy[i + 1] = s_sxy[i] + dx * dy;
+        s_syy[i + 1] = s_syy[i] + dy * dy;
+    }
+
+    const int minPts = SPRING_CURVE_MIN_SEG_POINTS;
+
+    // 1 segmento
+    double bestSse[SPRING_CURVE_MAX_SEGMENTS + 1];
+    int b2 = -1, b3a = -1, b3b = -1;
+    bestSse[1] = segmentFit(0, m, nullptr, nullptr);
+    bestSse[2] = bestSse[3] = -1.0;
+
+    // 2 segmentos: O(n)
+    for (int b = minPts; b <= m - minPts; ++b) {
+        double sse = segmentFit(0, b, nullptr, nullptr) + segmentFit(b, m, nullptr, nullptr);
+        if (bestSse[2] < 0.0 || sse < bestSse[2]) {
+            bestSse[2] = sse;
+            b2 = b;
+        }
+    }
+
+    // 3 segmentos: O(n²)
+    for (int b1 = minPts; b1 <= m - 2 * minPts; ++b1) {
+        double left = segmentFit(0, b1, nullptr, nullptr);
+        for (int b = b1 + minPts; b <= m - minPts; ++b) {
+            double sse = left + segmentFit(b1, b, nullptr, nullptr) + segmentFit(b, m, nullptr, nullptr);
+            if (bestSse[3] < 0.0 || sse < bestSse[3]) {
+                bestSse[3] = sse;
+                b3a = b1;
+                b3b = b;
+            }
+        }
+    }
+
+    // Seleção por BIC: cada segmento extra custa 3 parâmetros (k, a, quebra)
+    int bestSeg = 1;
+    double bestBic = 0.0;
+    for (int s = 1; s <= SPRING_CURVE_MAX_SEGMENTS; ++s) {
+        if (bestSse[s] < 0.0) continue;
+        double mse = bestSse[s] / m;
+        if (mse < 1e-12) mse = 1e-12;
+        double bic = m * log(mse) + (3 * s - 1) * log((double)m);
+        if (s == 1 || bic < bestBic) {
+            bestBic = bic;
+            bestSeg = s;
+        }
+    }
+
+    // Reconstrói os segmentos escolhidos (coeficientes em coordenadas centradas)
+    int bounds[SPRING_CURVE_MAX_SEGMENTS + 1] = {0, m, m, m};
+    if (bestSeg == 2) {
+        bounds[1] = b2;
+        bounds[2] = m;
+    } else if (bestSeg == 3) {
+        bounds[1] = b3a;
+        bounds[2] = b3b;
+        bounds[3] = m;
+    }
+
+    double k[SPRING_CURVE_MAX_SEGMENTS], a[SPRING_CURVE_MAX_SEGMENTS];
+    for (int s = 0; s < bestSeg; ++s) {
+        segmentFit(bounds[s], bounds[s + 1], &k[s], &a[s]);
+        // Volta para coordenadas originais: y = ym + a + k*(x - xm)
+        a[s] = ym + a[s] - k[s] * xm;
+        fit.rateKgfMm[s] = (float)k[s];
+    }
+    for (int s = 0; s + 1 < bestSeg; ++s) {
+        fit.breakMm[s] = breakBetween(bounds[s + 1] - 1, bounds[s + 1], k[s], a[s], k[s + 1], a[s + 1]);
+    }
+
+    fit.segments = bestSeg;
+    fit.rmsKg = (float)sqrt(bestSse[bestSeg] / m);
+    fit.valid = true;
+    return fit;
+}
+
+PolyFit fitQuadratic(const float* x, const float* y, int n) {
+    PolyFit fit;
+    if (n < 3) return fit;
+
+    int m = loadPoints(x, y, n);
+
+    double xm = 0.0, ym = 0.0;
+    for (int i = 0; i < m; ++i) {
+        xm += s_px[i];
+        ym += s_py[i];
+    }
+    xm /= m;
+    ym /= m;
+
+    // Equações normais em u = x - xm
+    double s1 = 0, s2 = 0, s3 = 0, s4 = 0, t0 = 0, t1 = 0, t2 = 0, syy = 0;
+    for (int i = 0; i < m; ++i) {
+        double u = s_px[i] - xm;
+        double v = s_py[i];
+        double u2 = u * u;
+        s1 += u;
+        s2 += u2;
+        s3 += u2 * u;
+        s4 += u2 * u2;
+        t0 += v;
+        t1 += u * v;
+        t2 += u2 * v;
+        syy += (v - ym) * (v - ym);
+    }
+    double A[3][4] = {
+        {(double)m, s1, s2, t0},
+        {s1,        s2, s3, t1},
+        {s2,        s3, s4, t2}
+    };
+
+    // Eliminação de Gauss com pivotamento parcial
+    for (int c = 0; c < 3; ++c) {
+        int piv = c;
+        for (int r = c + 1; r < 3; ++r) {
+            if (fabs(A[r][c]) > fabs(A[piv][c])) piv = r;
+        }
+        if (fabs(A[piv][c]) < 1e-12) return fit;
+        if (piv != c) {
+            for (int k = 0; k < 4; ++k) {
+                double tmp = A[c][k];
+                A[c][k] = A[piv][k];
+                A[piv][k] = tmp;
+            }
+        }
+        for (int r = c + 1; r < 3; ++r) {
+            double f = A[r][c] / A[c][c];
+            for (int k = c; k < 4; ++k) A[r][k] -= f * A[c][k];
+        }
+    }
+    double b2 = A[2][3] / A[2][2];
+    double b1 = (A[1][3] - A[1][2] * b2) / A[1][1];
+    double b0 = (A[0][3] - A[0][1] * b1 - A[0][2] * b2) / A[0][0];
+
+    // y = b0 + b1*u + b2*u², u = x - xm  ->  coeficientes em x
+    fit.c2 = (float)b2;
+    fit.c1 = (float)(b1 - 2.0 * b2 * xm);
+    fit.c0 = (float)(b0 - b1 * xm + b2 * xm * xm);
+
+    double sse = 0.0;
+    for (int i = 0; i < m; ++i) {
+        double u = s_px[i] - xm;
+        double r = s_py[i] - (b0 + b1 * u + b2 * u * u);
+        sse += r * r;
+    }
+    fit.r2 = (syy > 0.0) ? (float)(1.0 - sse / syy) : 0.0f;
+    fit.valid = true;
+    return fit;
+}
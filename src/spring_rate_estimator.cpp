@@ -0,0 +1,329 @@
+#include "spring_rate_estimator.h"
+#include <algorithm>
+#include <cmath>
+
+// Buffers estáticos compartilhados (uso sequencial, sem reentrância)
+static float s_x[SPRING_RATE_MAX_POINTS];
+static float s_y[SPRING_RATE_MAX_POINTS];
+static float s_w[SPRING_RATE_MAX_POINTS];
+static float s_work[SPRING_RATE_MAX_PAIRS];
+
+// Número de trechos usados para medir a inclinação local na detecção de região linear
+static const int LINEAR_REGION_SEGMENTS = 24;
+
+// Maior lacuna (em trechos) tolerada dentro da região linear
+static const int LINEAR_REGION_MAX_GAP = 2;
+
+// Limiar mínimo de inlier para RANSAC (kg): evita limiar nulo com dados perfeitos
+static const float RANSAC_MIN_THRESHOLD_KG = 0.01f;
+
+// LCG determinístico: mesmo resultado a cada execução
+static uint32_t s_rng = 1;
+static uint32_t nextRandom() {
+    s_rng = s_rng * 1664525u + 1013904223u;
+    return s_rng >> 8;
+}
+
+// Mediana in-place (reordena buf)
+static float medianInPlace(float* buf, int n) {
+    if (n <= 0) return 0.0f;
+    int mid = n / 2;
+    std::nth_element(buf, buf + mid, buf + n);
+    float m = buf[mid];
+    if ((n & 1) == 0) {
+        float lower = *std::max_element(buf, buf + mid);
+        m = 0.5f * (m + lower);
+    }
+    return m;
+}
+
+// Mínimos quadrados ponderados (centrado para estabilidade em float)
+static bool weightedLine(const float* x, const float* y, const float* w, int n,
+                         float* outK, float* outA) {
+    float sw = 0.0f, sx = 0.0f, sy = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        float wi = w ? w[i] : 1.0f;
+        sw += wi;
+        sx += wi * x[i];
+        sy += wi * y[i];
+    }
+    if (sw <= 0.0f) return false;
+    float xm = sx / sw;
+    float ym = sy / sw;
+
+    float sxx = 0.0f, sxy = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        float wi = w ? w[i] : 1.0f;
+        float dx = x[i] - xm;
+        sxx += wi * dx * dx;
+        sxy += wi * dx * (y[i] - ym);
+    }
+    if (sxx <= 0.0f) return false;
+    *outK = sxy / sxx;
+    *outA = ym - (*outK) * xm;
+    return true;
+}
+
+// R² considerando apenas pontos com peso > 0
+static float rSquared(const float* x, const float* y, const float* w, int n, float k, float a) {
+    float sy = 0.0f;
+    int m = 0;
+    for (int i = 0; i < n; ++i) {
+        if (w && w[i] <= 0.0f) continue;
+        sy += y[i];
+        m++;
+    }
+    if (m < 2) return 0.0f;
+    float ym = sy / m;
+    float ssTot = 0.0f, ssRes = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        if (w && w[i] <= 0.0f) continue;
+        float r = y[i] - (a + k * x[i]);
+        ssTot += (y[i] - ym) * (y[i] - ym);
+        ssRes += r * r;
+    }
+    return (ssTot > 0.0f) ? (1.0f - ssRes / ssTot) : 0.0f;
+}
+
+// Desvio robusto dos resíduos (1.4826 * MAD)
+static float robustSigma(const float* x, const float* y, int n, float k, float a) {
+    for (int i = 0; i < n; ++i) {
+        s_work[i] = y[i] - (a + k * x[i]);
+    }
+    float med = medianInPlace(s_work, n);
+    for (int i = 0; i < n; ++i) {
+        s_work[i] = fabsf(s_work[i] - med);
+    }
+    return 1.4826f * medianInPlace(s_work, n);
+}
+
+static bool theilSen(const float* x, const float* y, int n, float* outK, float* outA) {
+    long totalPairs = (long)n * (n - 1) / 2;
+    int m = 0;
+
+    if (totalPairs <= SPRING_RATE_MAX_PAIRS) {
+        for (int i = 0; i < n; ++i) {
+            for (int j = i + 1; j < n; ++j) {
+                float dx = x[j] - x[i];
+                if (dx == 0.0f) continue;
+                s_work[m++] = (y[j] - y[i]) / dx;
+            }
+        }
+    } else {
+        // Subamostragem determinística de pares: custo O(MAX_PAIRS) independente de n
+        for (int attempt = 0; attempt < 2 * SPRING_RATE_MAX_PAIRS && m < SPRING_RATE_MAX_PAIRS; ++attempt) {
+            int i = (int)(nextRandom() % (uint32_t)n);
+            int j = (int)(nextRandom() % (uint32_t)n);
+            float dx = x[j] - x[i];
+            if (dx == 0.0f) continue;
+            s_work[m++] = (y[j] - y[i]) / dx;
+        }
+    }
+    if (m == 0) return false;
+
+    float k = medianInPlace(s_work, m);
+    for (int i = 0; i < n; ++i) {
+        s_work[i] = y[i] - k * x[i];
+    }
+    *outK = k;
+    *outA = medianInPlace(s_work, n);
+    return true;
+}
+
+static bool ransac(const float* x, const float* y, int n, float* outK, float* outA, int* outInliers) {
+    float k0, a0;
+    if (!theilSen(x, y, n, &k0, &a0)) return false;
+    float thr = 2.5f * robustSigma(x, y, n, k0, a0);
+    if (thr < RANSAC_MIN_THRESHOLD_KG) thr = RANSAC_MIN_THRESHOLD_KG;
+
+    int bestCount = -1;
+    float bestK = k0, bestA = a0;
+    for (int it = 0; it < SPRING_RATE_RANSAC_ITERATIONS; ++it) {
+        int i = (int)(nextRandom() % (uint32_t)n);
+        int j = (int)(nextRandom() % (uint32_t)n);
+        float dx = x[j] - x[i];
+        if (dx == 0.0f) continue;
+        float k = (y[j] - y[i]) / dx;
+        float a = y[i] - k * x[i];
+        int count = 0;
+        for (int p = 0; p < n; ++p) {
+            if (fabsf(y[p] - (a + k * x[p])) <= thr) count++;
+        }
+        if (count > bestCount) {
+            bestCount = count;
+            bestK = k;
+            bestA = a;
+        }
+    }
+
+    // Reajuste por MQ apenas nos inliers do melhor modelo
+    int inliers = 0;
+    for (int p = 0; p < n; ++p) {
+        bool in = fabsf(y[p] - (bestA + bestK * x[p])) <= thr;
+        s_w[p] = in ? 1.0f : 0.0f;
+        if (in) inliers++;
+    }
+    if (inliers < 2 || !weightedLine(x, y, s_w, n, outK, outA)) {
+        *outK = bestK;
+        *outA = bestA;
+    }
+    *outInliers = inliers;
+    return true;
+}
+
+static bool huber(const float* x, const float* y, int n, float* outK, float* outA, int* outInliers) {
+    float k, a;
+    if (!theilSen(x, y, n, &k, &a)) return false;
+
+    float delta = 0.0f;
+    for (int it = 0; it < SPRING_RATE_HUBER_ITERATIONS; ++it) {
+        delta = 1.345f * robustSigma(x, y, n, k, a);
+        if (delta < 1e-4f) delta = 1e-4f;
+        for (int p = 0; p < n; ++p) {
+            float r = fabsf(y[p] - (a + k * x[p]));
+            s_w[p] = (r <= delta) ? 1.0f : delta / r;
+        }
+        float kNew, aNew;
+        if (!weightedLine(x, y, s_w, n, &kNew, &aNew)) break;
+        bool converged = fabsf(kNew - k) <= 1e-5f * (fabsf(k) + 1e-6f);
+        k = kNew;
+        a = aNew;
+        if (converged) break;
+    }
+
+    int inliers = 0;
+    for (int p = 0; p < n; ++p) {
+        if (fabsf(y[p] - (a + k * x[p])) <= delta) inliers++;
+    }
+    *outK = k;
+    *outA = a;
+    *outInliers = inliers;
+    return true;
+}
+
+LineFit fitSpringRate(const float* x, const float* y, int first, int last,
+                      SpringRateMethod method) {
+    LineFit fit;
+    int count = last - first + 1;
+    if (count < 2) return fit;
+
+    // Copia (com decimação uniforme se necessário) para os buffers de trabalho
+    int n = (count <= SPRING_RATE_MAX_POINTS) ? count : SPRING_RATE_MAX_POINTS;
+    for (int i = 0; i < n; ++i) {
+        int src = first + (int)(((long)i * (count - 1)) / ((n > 1) ? (n - 1) : 1));
+        s_x[i] = x[src];
+        s_y[i] = y[src];
+    }
+    s_rng = 1;
+
+    float k = 0.0f, a = 0.0f;
+    int inliers = n;
+    bool ok = false;
+    const float* mask = nullptr;
+
+    switch (method) {
+        case RATE_THEIL_SEN:
+            ok = theilSen(s_x, s_y, n, &k, &a);
+            break;
+        case RATE_RANSAC:
+            ok = ransac(s_x, s_y, n, &k, &a, &inliers);
+            mask = s_w;
+            break;
+        case RATE_HUBER:
+            ok = huber(s_x, s_y, n, &k, &a, &inliers);
+            break;
+        case RATE_LEAST_SQUARES:
+        default:
+            ok = weightedLine(s_x, s_y, nullptr, n, &k, &a);
+            break;
+    }
+    if (!ok) return fit;
+
+    fit.k = k;
+    fit.a = a;
+    fit.r2 = rSquared(s_x, s_y, mask, n, k, a);
+    fit.inliers = inliers;
+    fit.valid = true;
+    return fit;
+}
+
+bool detectLinearRegion(const float* x, const float* y, int n, float relTol,
+                        int minPoints, int* outFirst, int* outLast) {
+    if (n < 2 || n < minPoints) return false;
+
+    // Passo arredondado para cima: no máximo LINEAR_REGION_SEGMENTS trechos
+    int stride = (n - 2) / LINEAR_REGION_SEGMENTS + 1;
+    int segments = (n - 1 + stride - 1) / stride;
+
+    // Inclinação de cada trecho [j*stride, (j+1)*stride]
+    float slopes[LINEAR_REGION_SEGMENTS];
+    bool  validSeg[LINEAR_REGION_SEGMENTS];
+    int m = 0;
+    for (int j = 0; j < segments; ++j) {
+        int i0 = j * stride;
+        int i1 = (j + 1) * stride;
+        if (i1 > n - 1) i1 = n - 1;
+        float dx = x[i1] - x[i0];
+        validSeg[j] = (dx != 0.0f);
+        slopes[j] = validSeg[j] ? (y[i1] - y[i0]) / dx : 0.0f;
+        if (validSeg[j]) s_work[m++] = slopes[j];
+    }
+    if (m == 0) return false;
+
+    float med = medianInPlace(s_work, m);
+    if (med <= 0.0f) return false;
+    float tol = relTol * med;
+
+    // Trechos coerentes com a mediana
+    bool good[LINEAR_REGION_SEGMENTS];
+    for (int j = 0; j < segments; ++j) {
+        good[j] = validSeg[j] && fabsf(slopes[j] - med) <= tol;
+    }
+
+    // Um ponto espúrio isolado estraga os dois trechos vizinhos: lacunas internas
+    // curtas são aceitas e o outlier fica a cargo do estimador robusto
+    for (int j = 1; j < segments; ++j) {
+        if (good[j] || !good[j - 1]) continue;
+        int gapEnd = j;
+        while (gapEnd < segments && !good[gapEnd]) gapEnd++;
+        if (gapEnd < segments && (gapEnd - j) <= LINEAR_REGION_MAX_GAP) {
+            for (int g = j; g < gapEnd; ++g) good[g] = true;
+        }
+        j = gapEnd;
+    }
+
+    // Maior sequência contígua de trechos coerentes
+    int bestStart = -1, bestLen = 0;
+    int runStart = -1;
+    for (int j = 0; j <= segments; ++j) {
+        bool ok = (j < segments) && good[j];
+        if (ok && runStart < 0) runStart = j;
+        if (!ok && runStart >= 0) {
+            int len = j - runStart;
+            if (len > bestLen) {
+                bestLen = len;
+                bestStart = runStart;
+            }
+            runStart = -1;
+        }
+    }
+    if (bestStart < 0) return false;
+
+    int first = bestStart * stride;
+    int last = (bestStart + bestLen) * stride;
+    if (last > n - 1) last = n - 1;
+    if (last - first + 1 < minPoints) return false;
+
+    *outFirst = first;
+    *outLast = last;
+    return true;
+}
+
+const char* springRateMethodName(SpringRateMethod method) {
+    switch (method) {
+        case RATE_THEIL_SEN: return "Theil-Sen";
+        case RATE_RANSAC:    return "RANSAC";
+        case RATE_HUBER:     return "Huber";
+        default:             return "MQ";
+    }
+}
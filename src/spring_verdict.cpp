@@ -0,0 +1,117 @@
+#include "spring_verdict.h"
+#include <cmath>
+
+void SpringVerdict::begin(const ProfileSettings& limits, float earlyMargin, int minPoints, float minXMm) {
+    _limits = &limits;
+    _state = limits.hasLimits() ? VERDICT_PENDING : VERDICT_NONE;
+    _reason = VERDICT_REASON_NONE;
+    _failValue = 0.0f;
+    _earlyMargin = earlyMargin;
+    _minPoints = minPoints;
+    _minXMm = minXMm;
+    _nextCheck = 0;
+    _hasPrev = false;
+    _n = 0;
+    _sx = _sy = _sxx = _sxy = 0.0;
+}
+
+bool SpringVerdict::reject(VerdictReason reason, float value) {
+    _state = VERDICT_FAIL;
+    _reason = reason;
+    _failValue = value;
+    return true;
+}
+
+bool SpringVerdict::checkFreeLength(float freeLengthMm) {
+    if (_state != VERDICT_PENDING || !_limits->hasFreeLength()) return false;
+    if (fabsf(freeLengthMm - _limits->freeLengthMm) > _limits->freeLengthTolMm) {
+        return reject(VERDICT_REASON_FREE_LENGTH, freeLengthMm);
+    }
+    return false;
+}
+
+float SpringVerdict::runningK() const {
+    if (_n < 2) return 0.0f;
+    double den = _n * _sxx - _sx * _sx;
+    if (den <= 0.0) return 0.0f;
+    return (float)((_n * _sxy - _sx * _sy) / den);
+}
+
+bool SpringVerdict::addSample(float xMm, float fKg) {
+    if (_state != VERDICT_PENDING) return _state == VERDICT_FAIL;
+    const ProfileSettings& lim = *_limits;
+
+    if (lim.maxForceKg > 0.0f && fKg > lim.maxForceKg) {
+        return reject(VERDICT_REASON_OVERFORCE, fKg);
+    }
+
+    // Checagens de força cujo comprimento foi alcançado nesta amostra
+    while (_nextCheck < lim.forceCheckCount && xMm >= lim.forceChecks[_nextCheck].xMm) {
+        const ForceCheck& fc = lim.forceChecks[_nextCheck];
+        float f = fKg;
+        if (_hasPrev && xMm > _prevX && fc.xMm > _prevX) {
+            float t = (fc.xMm - _prevX) / (xMm - _prevX);
+            f = _prevF + t * (fKg - _prevF);
+        }
+        if (f < fc.minKg || f > fc.maxKg) {
+            return reject(VERDICT_REASON_FORCE_AT, f);
+        }
+        ++_nextCheck;
+    }
+    _hasPrev = true;
+    _prevX = xMm;
+    _prevF = fKg;
+
+    // K acumulado: reprova cedo apenas com margem
+    if (xMm >= _minXMm) {
+        ++_n;
+        _sx += xMm;
+        _sy += fKg;
+        _sxx += (double)xMm * xMm;
+        _sxy += (double)xMm * fKg;
+        if (lim.hasKLimits() && _n >= _minPoints) {
+            float k = runningK();
+            if (k > 0.0f && k < lim.kMinKgfMm * (1.0f - _earlyMargin)) {
+                return reject(VERDICT_REASON_K_LOW, k);
+            }
+            if (k > lim.kMaxKgfMm * (1.0f + _earlyMargin)) {
+                return reject(VERDICT_REASON_K_HIGH, k);
+            }
+        }
+    }
+    return false;
+}
+
+VerdictState SpringVerdict::finish(float kFinalKgfMm, bool completed) {
+    if (_state != VERDICT_PENDING) return _state;
+    const ProfileSettings& lim = *_limits;
+
+    if (!completed || _nextCheck < lim.forceCheckCount) {
+        reject(VERDICT_REASON_INCOMPLETE, 0.0f);
+        return _state;
+    }
+    if (lim.hasKLimits()) {
+        if (kFinalKgfMm < lim.kMinKgfMm) {
+            reject(VERDICT_REASON_K_LOW, kFinalKgfMm);
+            return _state;
+        }
+        if (kFinalKgfMm > lim.kMaxKgfMm) {
+            reject(VERDICT_REASON_K_HIGH, kFinalKgfMm);
+            return _state;
+        }
+    }
+    _state = VERDICT_PASS;
+    return _state;
+}
+
+const char* verdictReasonName(VerdictReason reason) {
+    switch (reason) {
+        case VERDICT_REASON_FREE_LENGTH: return "comprimento livre";
+        case VERDICT_REASON_FORCE_AT:    return "forca em comprimento";
+        case VERDICT_REASON_K_LOW:       return "K baixo";
+        case VERDICT_REASON_K_HIGH:      return "K alto";
+        case VERDICT_REASON_OVERFORCE:   return "forca maxima";
+        case VERDICT_REASON_INCOMPLETE:  return "teste incompleto";
+        default:                         return "-";
+    }
+}
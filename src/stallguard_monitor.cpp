@@ -0,0 +1,79 @@
+#include "stallguard_monitor.h"
+#include "config.h"
+#include "tmc2209_manager.h"
+#include "event_trace.h"
+
+StallGuardMonitor stallGuardMonitor;
+
+static bool uartReadSg(uint16_t* out, void*) {
+    return tmc2209Manager.readStallGuard(out);
+}
+
+bool StallGuardMonitor::begin() {
+    if (_task || !tmc2209Manager.isReady()) {
+        return _task != nullptr;
+    }
+
+    _scheduler.configure(SG_POLL_PERIOD_MS, SG_POLL_MAX_BACKOFF,
+                         SG_ABORT_RESULT, SG_ABORT_CONSECUTIVE);
+
+    BaseType_t ok = xTaskCreatePinnedToCore(taskEntry, "sg_poll", SG_TASK_STACK,
+                                            this, SG_TASK_PRIORITY, &_task, SG_TASK_CORE);
+    if (ok != pdPASS) {
+        _task = nullptr;
+        Serial.println("[SG] Falha ao criar tarefa de monitoramento");
+        return false;
+    }
+    tmc2209Manager.setAsyncService(true);
+    Serial.println("[SG] Monitoramento de SG_RESULT ativo (core 0)");
+    return true;
+}
+
+void StallGuardMonitor::setMotion(bool active, bool abortArmed) {
+    // Movimento novo: o abort do anterior já foi tratado (ou ignorado) por
+    // quem o recebeu e não pode quebrar o retorno, o jog ou a recuperação.
+    // Chamadas repetidas dentro de um mesmo movimento (fila) não limpam
+    if (active && !_motionActive) {
+        clearAbort();
+    }
+    _abortArmed = abortArmed;
+    _motionActive = active;
+}
+
+void StallGuardMonitor::clearAbort() {
+    _clearRequested = true;
+    if (!_task) {
+        _abort = false;
+        _clearRequested = false;
+    }
+}
+
+void StallGuardMonitor::taskEntry(void* arg) {
+    static_cast<StallGuardMonitor*>(arg)->run();
+}
+
+void StallGuardMonitor::run() {
+    const SgUart uart = {uartReadSg, nullptr};
+    for (;;) {
+        // Estado compartilhado com o core 1 só é aplicado aqui, na tarefa
+        if (_clearRequested) {
+            _scheduler.clearAbort();
+            _abort = false;
+            _clearRequested = false;
+        }
+        _scheduler.setMotion(_motionActive, _abortArmed);
+
+        // Escritas de configuração pendentes (coalescidas no cache)
+        tmc2209Manager.service();
+
+        if (_scheduler.poll(millis(), uart)) {
+            _lastValue = _scheduler.lastValue();
+            _hasValue = true;
+            TRACE_EVENT(EVT_SAMPLE, TRACE_SAMPLE_STALLGUARD, _lastValue);
+            if (_scheduler.abortLatched()) {
+                _abort = true;
+            }
+        }
+        vTaskDelay(1);
+    }
+}
@@ -1,8 +1,42 @@
 #include "stepper_manager.h"
 #include "config.h"
+#include "trace_probe.h"
+#include "event_trace.h"
+#include "tmc2209_manager.h"
+#include "sensorless_homing.h"
+#include "stallguard_monitor.h"
+#include "fast_io.h"
+#include <esp_timer.h>
 
 StepperManager stepperManager;
 
+// Unidades de posição do eixo: passos do perfil ou 1/TMC_FINE_MICROSTEPS
+// (troca de fase). Constantes do ActiveRig: conversões sem float de runtime
+using AxisCoarse = AxisScale<ActiveRig, TMC_DEFAULT_MICROSTEPS>;
+using AxisFine   = AxisScale<ActiveRig, TMC_FINE_MICROSTEPS>;
+
+// Pinos do laço de passos em acesso direto (fast_io.h); pinMode segue no begin()
+using StepPin    = FastPin<STEP_PIN>;
+using DirPin     = FastPin<DIR_PIN>;
+using EnPin      = FastPin<EN_PIN>;
+using EndstopPin = FastPin<ENDSTOP_PIN>;
+using DiagPin    = FastPin<TMC_DIAG_PIN>;
+
+// Debounce do fim de curso: one-shot reiniciado a cada borda pela ISR
+static esp_timer_handle_t s_endstopDebounceTimer = nullptr;
+
+void IRAM_ATTR endstopISR() {
+    StepperManager* m = &stepperManager;
+    if (m->_endstopLatch.onEdge(!EndstopPin::read(), (int32_t)m->_positionSteps)) {
+        esp_timer_stop(s_endstopDebounceTimer);   // erro se não estava rodando: ignora
+        esp_timer_start_once(s_endstopDebounceTimer, ENDSTOP_DEBOUNCE_US);
+    }
+}
+
+void endstopDebounceTimer(void*) {
+    stepperManager._endstopLatch.onDebounceTimer(!EndstopPin::read());
+}
+
 void StepperManager::begin() {
     pinMode(STEP_PIN, OUTPUT);
     pinMode(DIR_PIN,  OUTPUT);
@@ -10,38 +44,84 @@ void StepperManager::begin() {
     pinMode(ENDSTOP_PIN, INPUT_PULLUP);
     
     // Estados iniciais - EN_PIN = HIGH desabilita no A4988 (padrão)
-    digitalWrite(STEP_PIN, LOW);
-    digitalWrite(DIR_PIN, LOW);
-    digitalWrite(EN_PIN, HIGH);  // Desabilitado inicialmente
+    StepPin::low();
+    DirPin::low();
+    EnPin::high();  // Desabilitado inicialmente
     
     Serial.println("[STEPPER] Motor STEP/DIR inicializado");
 
-    setStepsPerMm(STEPPER_STEPS_PER_MM);
     resetPosition();
 
-    // Habilita o driver
-    delay(100);
-    enable(true);
-    Serial.println("[STEPPER] Motor driver ENABLED!");
+    if (ENDSTOP_LATCH_ENABLED) {
+        esp_timer_create_args_t args = {};
+        args.callback = endstopDebounceTimer;
+        args.name = "endstop_db";
+        _endstopIrq = (esp_timer_create(&args, &s_endstopDebounceTimer) == ESP_OK);
+        if (_endstopIrq) {
+            attachInterrupt(digitalPinToInterrupt(ENDSTOP_PIN), endstopISR, CHANGE);
+        } else {
+            Serial.println("[STEPPER] Timer do fim de curso indisponivel - homing por leitura do pino");
+        }
+    }
+
+    // Driver fica desabilitado: o setup habilita após o splash (BOOT_SPLASH_MIN_MS
+    // cobre a espera que antes era um delay(100) aqui)
 }
 
 void StepperManager::enable(bool on) {
     // EN = LOW habilita o A4988 (padrão)
-    digitalWrite(EN_PIN, on ? LOW : HIGH);
+    EnPin::write(!on);
+    _enabled = on;
+
+}
+
+StepperManager::StepIoBench StepperManager::benchmarkStepIo(uint32_t pulses) {
+    StepIoBench r = {pulses, 0.0f, 0.0f};
+    if (pulses == 0) return r;
+
+    bool wasEnabled = _enabled;
+    enable(false);
+    volatile uint32_t pressed = 0;   // mantém a leitura do endstop no laço
+
+    // Antes: funções do Arduino (pino resolvido a cada chamada)
+    uint32_t t0 = micros();
+    for (uint32_t i = 0; i < pulses; ++i) {
+        if (digitalRead(ENDSTOP_PIN) == LOW) pressed = pressed + 1;
+        digitalWrite(STEP_PIN, HIGH);
+        digitalWrite(STEP_PIN, LOW);
+    }
+    uint32_t arduinoUs = micros() - t0;
+
+    // Depois: registradores com máscara constante
+    t0 = micros();
+    for (uint32_t i = 0; i < pulses; ++i) {
+        if (!EndstopPin::read()) pressed = pressed + 1;
+        StepPin::high();
+        StepPin::low();
+    }
+    uint32_t fastUs = micros() - t0;
 
+    enable(wasEnabled);
+    if (arduinoUs > 0) r.arduinoKhz = pulses * 1000.0f / arduinoUs;
+    if (fastUs > 0)    r.fastKhz    = pulses * 1000.0f / fastUs;
+    return r;
 }
 
 bool StepperManager::isEndstopPressed() const {
     // Pressionado = LOW (endstop para GND com pull-up interno)
-    return (digitalRead(ENDSTOP_PIN) == LOW);
+    return !EndstopPin::read();
 }
 
-void StepperManager::setStepsPerMm(float s) {
-    _stepsPerMm = s;
+float StepperManager::getStepsPerMm() const {
+    return (float)(_phaseSwitching ? AxisFine::UNITS_PER_MM : AxisCoarse::UNITS_PER_MM);
 }
 
-float StepperManager::getStepsPerMm() const {
-    return _stepsPerMm;
+long StepperManager::mmToUnits(float mm) const {
+    return _phaseSwitching ? AxisFine::mmToUnits(mm) : AxisCoarse::mmToUnits(mm);
+}
+
+float StepperManager::unitsToMm(long units) const {
+    return _phaseSwitching ? AxisFine::unitsToMm(units) : AxisCoarse::unitsToMm(units);
 }
 
 void StepperManager::resetPosition() {
@@ -49,17 +129,143 @@ void StepperManager::resetPosition() {
 }
 
 float StepperManager::getPositionMm() const {
-    return _positionSteps / _stepsPerMm;
+    return unitsToMm(_positionSteps);
+}
+
+long StepperManager::getPositionSteps() const {
+    return _positionSteps;
 }
 
 bool StepperManager::wasLastHomingSuccessful() const {
     return _lastHomingSuccess;
 }
 
+// ---- Acesso ao TMC2209 para a troca de fase ----
+static void halSetMicrosteps(uint16_t microsteps, void*) {
+    tmc2209Manager.setMicrosteps(microsteps);
+}
+
+static void halSetCurrent(uint16_t runMa, uint16_t holdMa, void*) {
+    tmc2209Manager.setCurrent(runMa, holdMa);
+}
+
+static void halEnableStealthChop(bool enable, void*) {
+    tmc2209Manager.enableStealthChop(enable);
+}
+
+static bool halWaitFlushed(uint32_t timeoutMs, void*) {
+    return tmc2209Manager.waitFlushed(timeoutMs);
+}
+
+static const MotionPhaseDriverHal s_tmcPhaseHal = {
+    halSetMicrosteps, halSetCurrent, halEnableStealthChop, halWaitFlushed, nullptr
+};
+
+void StepperManager::enablePhaseSwitching() {
+    if (_phaseSwitching || !tmc2209Manager.isReady()) return;
+
+    // Converte a posição atual para a unidade fina e mantém o eixo coerente
+    _positionSteps = motionPhaseFineUnits(_positionSteps);
+    _phaseSwitching = true;
+    _phase = MOTION_PHASE_NONE;
+    setMotionPhase(MOTION_PHASE_TRAVEL);
+}
+
+void StepperManager::setMotionPhase(MotionPhase phase) {
+    if (!_phaseSwitching || phase == _phase || phase == MOTION_PHASE_NONE) return;
+
+    // Fecha a contagem de MSCNT na resolução antiga antes de trocar MRES
+    _lastVerifyMs = 0;
+    verifyAfterMove(0, false);
+
+    const MotionPhaseConfig& cfg = motionPhaseConfig(phase);
+    if (!applyMotionPhase(s_tmcPhaseHal, cfg, _axis)) {
+        Serial.println("[STEPPER] AVISO: TMC2209 nao confirmou troca de fase");
+    }
+    rebaseStepVerifier();
+    _phase = phase;
+
+    Serial.print("[STEPPER] Fase ");
+    Serial.print((int)phase);
+    Serial.print(": 1/");
+    Serial.print(cfg.microsteps);
+    Serial.print(" uStep, ");
+    Serial.print(cfg.currentMa);
+    Serial.println(cfg.stealthChop ? " mA, StealthChop" : " mA, SpreadCycle");
+}
+
+MotionPhase StepperManager::getMotionPhase() const {
+    return _phase;
+}
+
+// ---- Verificação de passos perdidos (MSCNT) ----
+
+void StepperManager::resetStepVerification() {
+    uint16_t mscnt = 0;
+    if (!tmc2209Manager.readMicrostepCounter(&mscnt)) {
+        _verifier.stop();
+        return;
+    }
+    _verifier.begin(mscnt);
+    _lastVerifyMs = millis();
+}
+
+void StepperManager::rebaseStepVerifier() {
+    uint16_t mscnt = 0;
+    if (_verifier.active() && tmc2209Manager.readMicrostepCounter(&mscnt)) {
+        _verifier.rebase(mscnt);
+    }
+}
+
+void StepperManager::verifyAfterMove(long signedPulses, bool stallSeen) {
+    if (!_verifier.active()) return;
+
+    _verifier.addPulses(signedPulses, 256 / _axis.microsteps);
+    // _lastVerifyMs = 0 força a leitura (troca de fase)
+    if (stallSeen) {
+        _verifier.noteStall();
+    }
+
+    unsigned long now = millis();
+    if (!stallSeen && _lastVerifyMs != 0 && (now - _lastVerifyMs) < STEP_VERIFY_INTERVAL_MS) return;
+    _lastVerifyMs = now;
+
+    uint16_t mscnt = 0;
+    if (!tmc2209Manager.readMicrostepCounter(&mscnt)) return;
+    int32_t err = _verifier.check(mscnt);
+    if (err != 0 || stallSeen) {
+        Serial.print("[STEPPER] AVISO: divergencia MSCNT ");
+        Serial.print(err);
+        Serial.print("/256 uStep | stalls ");
+        Serial.println(_verifier.stallEvents());
+    }
+}
+
+bool StepperManager::stepLossDetected() const {
+    return _verifier.active() && _verifier.lossDetected();
+}
+
+long StepperManager::lostStepUnits() const {
+    return _verifier.active() ? _verifier.lostUnits(_phaseSwitching ? TMC_FINE_MICROSTEPS
+                                                                    : TMC_DEFAULT_MICROSTEPS)
+                              : 0;
+}
+
+uint32_t StepperManager::stallEventCount() const {
+    return _verifier.stallEvents();
+}
+
+// Intervalo após cada pulso para manter a velocidade pedida em mm/s
+// (usDelay + pulso correspondem a um passo de 1/TMC_DEFAULT_MICROSTEPS)
+uint32_t StepperManager::pulseDelayUs(uint16_t usDelay) const {
+    return _phaseSwitching ? motionPhasePulseDelayUs(usDelay, _axis) : usDelay;
+}
+
 void StepperManager::moveSteps(long steps, StepperDirection dir, uint16_t usDelay) {
     if (steps <= 0) return;
+    PROBE_SCOPE(PROBE_STEPPER_MOVE);
     
-    long maxStepsAbs = (long)(STEPPER_MAX_TRAVEL_MM * _stepsPerMm);
+    long maxStepsAbs = mmToUnits(STEPPER_MAX_TRAVEL_MM);
 
     // Segurança: endstop
     if (dir == STEPPER_DIR_BACKWARD && isEndstopPressed()) {
@@ -71,25 +277,49 @@ void StepperManager::moveSteps(long steps, StepperDirection dir, uint16_t usDela
         return;
     }
 
+    TRACE_EVENT(EVT_MOTION_START, TRACE_MOTION_MOVE, (dir == STEPPER_DIR_FORWARD) ? steps : -steps);
+    _lastDir = dir;
+    // Compressão da mola ocorre no sentido BACKWARD: só ela arma o abort por SG
+    // (e o SG_RESULT só é válido em StealthChop)
+    stallGuardMonitor.setMotion(true, dir == STEPPER_DIR_BACKWARD && _axis.stealthChop);
+
+    // Pulsos na resolução da fase atual (arredonda para o pulso mais próximo)
+    long pulses = (steps + _axis.pulseIncrement / 2) / _axis.pulseIncrement;
+    long delta = (dir == STEPPER_DIR_FORWARD) ? _axis.pulseIncrement : -_axis.pulseIncrement;
+    uint32_t delayUs = pulseDelayUs(usDelay);
+    // DIAG só é amostrado com o verificador ativo e em StealthChop (SG válido)
+    bool watchDiag = _verifier.active() && _axis.stealthChop;
+    bool stallSeen = false;
+    long executed = 0;
+
     // Define direção (invertido para TMC2209 no seu hardware: HIGH = FORWARD)
-    digitalWrite(DIR_PIN, (dir == STEPPER_DIR_FORWARD) ? HIGH : LOW);
+    DirPin::write(dir == STEPPER_DIR_FORWARD);
     delayMicroseconds(20);  // Setup time para mudar direção
 
     // Gera pulsos STEP
-    for (long i = 0; i < steps; i++) {
+    for (long i = 0; i < pulses; i++) {
         // Verifica endstop durante movimento
         if (dir == STEPPER_DIR_BACKWARD && isEndstopPressed()) {
             break;
         }
+        // Abort pedido pelo monitor de SG_RESULT (carga excessiva / travamento)
+        if (stallGuardMonitor.abortRequested()) {
+            stallSeen = true;
+            break;
+        }
+        if (watchDiag && DiagPin::read() == (TMC_DIAG_STALL_LEVEL != 0)) {
+            stallSeen = true;
+        }
 
         // Pulso STEP (ativo alto)
-        digitalWrite(STEP_PIN, HIGH);
-        delayMicroseconds(10);
-        digitalWrite(STEP_PIN, LOW);
-        delayMicroseconds(usDelay);
+        StepPin::high();
+        delayMicroseconds(STEP_PULSE_US);
+        StepPin::low();
+        delayMicroseconds(delayUs);
 
         // Atualiza posição
-        _positionSteps += (dir == STEPPER_DIR_FORWARD) ? 1 : -1;
+        _positionSteps += delta;
+        ++executed;
 
         // Proteção de curso máximo por passo
         if (labs(_positionSteps) > maxStepsAbs) {
@@ -97,60 +327,256 @@ void StepperManager::moveSteps(long steps, StepperDirection dir, uint16_t usDela
         }
     }
     // Movimento concluído
+    stallGuardMonitor.setMotion(false, false);
+    verifyAfterMove((dir == STEPPER_DIR_FORWARD) ? executed : -executed, stallSeen);
+    TRACE_EVENT(EVT_MOTION_END, TRACE_MOTION_MOVE, _positionSteps);
 }
 
-void StepperManager::homeToEndstop(long maxSteps, uint16_t usDelay) {
-    StepperDirection dirHome = STEPPER_DIR_BACKWARD;  // Volta para home (para baixo)
-    digitalWrite(DIR_PIN, LOW);  // LOW = backward (ajustado ao invertido acima)
-    for (long i = 0; i < maxSteps; ++i) {
-        if (isEndstopPressed()) {
-            resetPosition();
-            _lastHomingSuccess = true;
-            // Recuar 30mm para posição inicial segura
-            long backoffSteps = (long)(STEPPER_HOME_BACKOFF_MM * _stepsPerMm);
-            moveSteps(backoffSteps, STEPPER_DIR_FORWARD, usDelay);
-            return;
+// ---- Fila de movimento ----
+
+float StepperManager::cruisePpsFor(uint16_t usDelay, void* self) {
+    const StepperManager* sm = static_cast<const StepperManager*>(self);
+    return 1e6f / (float)(sm->pulseDelayUs(usDelay) + STEP_PULSE_US);
+}
+
+bool StepperManager::runMotionQueue(MotionQueue& queue, SegmentCallback onSegment, void* ctx) {
+    if (queue.size() == 0) return true;
+    PROBE_SCOPE(PROBE_STEPPER_MOVE);
+
+    float pulsesPerMm = getStepsPerMm() / (float)_axis.pulseIncrement;
+    float accel = STEPPER_ACCEL_MM_S2 * pulsesPerMm;
+    float minPps = STEPPER_START_MM_S * pulsesPerMm;
+    queue.plan(_positionSteps, _axis.pulseIncrement, accel, minPps, cruisePpsFor, this);
+
+    long maxStepsAbs = mmToUnits(STEPPER_MAX_TRAVEL_MM);
+    long signedPulses = 0;
+    bool stallSeen = false;
+    bool completed = true;
+    bool watchDiag = _verifier.active() && _axis.stealthChop;
+
+    TRACE_EVENT(EVT_MOTION_START, TRACE_MOTION_QUEUE, queue.size());
+
+    // Instante do próximo pulso: atravessa as junções para manter a velocidade
+    uint32_t tNext = micros();
+    for (int i = 0; i < queue.size() && completed; ++i) {
+        const MotionSegment& seg = queue[i];
+        if (seg.dir != 0) {
+            StepperDirection dir = (seg.dir > 0) ? STEPPER_DIR_FORWARD : STEPPER_DIR_BACKWARD;
+            if (i == 0 || queue[i - 1].dir != seg.dir) {
+                _lastDir = dir;
+                stallGuardMonitor.setMotion(true, dir == STEPPER_DIR_BACKWARD && _axis.stealthChop);
+                DirPin::write(dir == STEPPER_DIR_FORWARD);
+                delayMicroseconds(20);
+            }
+            long delta = seg.dir * _axis.pulseIncrement;
+
+            for (long k = 0; k < seg.pulses; ++k) {
+                if (dir == STEPPER_DIR_BACKWARD && isEndstopPressed()) {
+                    completed = false;
+                    break;
+                }
+                if (stallGuardMonitor.abortRequested()) {
+                    stallSeen = true;
+                    completed = false;
+                    break;
+                }
+                if (watchDiag && DiagPin::read() == (TMC_DIAG_STALL_LEVEL != 0)) {
+                    stallSeen = true;
+                }
+
+                uint32_t periodUs = (uint32_t)(1e6f / segmentRateAt(seg, k, accel));
+                // Atrasou (ex.: callback de amostra): não compensa em rajada
+                if ((int32_t)(micros() - tNext) > (int32_t)periodUs) {
+                    tNext = micros();
+                }
+                while ((int32_t)(micros() - tNext) < 0) {
+                }
+                StepPin::high();
+                delayMicroseconds(STEP_PULSE_US);
+                StepPin::low();
+                tNext += periodUs;
+
+                _positionSteps += delta;
+                signedPulses += seg.dir;
+                if (labs(_positionSteps) > maxStepsAbs) {
+                    completed = false;
+                    break;
+                }
+            }
         }
+        if (!completed) break;
 
-        digitalWrite(STEP_PIN, HIGH);
-        delayMicroseconds(10);
-        digitalWrite(STEP_PIN, LOW);
-        delayMicroseconds(usDelay);
+        if (seg.action == SEG_ACTION_DWELL && seg.dwellMs > 0) {
+            delay(seg.dwellMs);
+            tNext = micros();
+        }
+        if (seg.action != SEG_ACTION_NONE && onSegment && !onSegment(seg, i, ctx)) {
+            completed = false;
+        }
     }
 
-    _lastHomingSuccess = false;
+    stallGuardMonitor.setMotion(false, false);
+    verifyAfterMove(signedPulses, stallSeen);
+    TRACE_EVENT(EVT_MOTION_END, TRACE_MOTION_QUEUE, _positionSteps);
+    return completed;
+}
+
+void StepperManager::homeToEndstop(long maxSteps, uint16_t usDelay) {
+    homeToEndstopWithMonitor(maxSteps, usDelay, nullptr, nullptr);
+}
+
+// ---- Acesso ao hardware para a sequência de homing sem sensor ----
+struct HomingMonitor {
+    bool (*func)(void*);
+    void* ctx;
+};
+
+static void halSetDirection(bool towardHome, void*) {
+    DirPin::write(!towardHome);  // LOW = backward (home)
+    delayMicroseconds(20);
+}
+
+static void halStep(void*) {
+    StepPin::high();
+    delayMicroseconds(STEP_PULSE_US);
+    StepPin::low();
+}
+
+static void halDelayUs(uint32_t us, void*) {
+    delayMicroseconds(us);
+}
+
+static bool halStallActive(void*) {
+    return tmc2209Manager.isStallDetected();
+}
+
+static bool halEndstopPressed(void*) {
+    return stepperManager.isEndstopPressed();
+}
+
+static bool halAbortRequested(void* ctx) {
+    HomingMonitor* m = static_cast<HomingMonitor*>(ctx);
+    return m->func && m->func(m->ctx);
+}
+
+// ---- Acesso ao hardware para o homing pelo fim de curso ----
+struct EndstopHomingCtx {
+    volatile long* position;
+    long           increment;   // unidades de posição por pulso
+    HomingMonitor  monitor;
+};
+
+static void halEndstopStep(void* ctx) {
+    EndstopHomingCtx* c = static_cast<EndstopHomingCtx*>(ctx);
+    // Conta antes do pulso: uma borda durante ele já vê a posição deste passo
+    *c->position -= c->increment;
+    StepPin::high();
+    delayMicroseconds(STEP_PULSE_US);
+    StepPin::low();
+}
+
+static bool halEndstopLevel(void*) {
+    return !EndstopPin::read();
+}
+
+static int32_t halEndstopPosition(void* ctx) {
+    return (int32_t)*static_cast<EndstopHomingCtx*>(ctx)->position;
+}
+
+static bool halEndstopAbort(void* ctx) {
+    return halAbortRequested(&static_cast<EndstopHomingCtx*>(ctx)->monitor);
+}
+
+void StepperManager::homeSensorless(long maxSteps, bool (*monitorFunc)(void*), void* ctx) {
+    HomingMonitor monitor = {monitorFunc, ctx};
+    HomingHal hal = {halSetDirection, halStep, halDelayUs, halStallActive,
+                     halEndstopPressed, halAbortRequested, &monitor};
+
+    setMotionPhase(MOTION_PHASE_HOMING);
+
+    // A sequência conta pulsos: converte a partir das unidades de posição
+    SensorlessHomingParams p;
+    p.maxSteps     = maxSteps / _axis.pulseIncrement;
+    p.backoffSteps = mmToUnits(SENSORLESS_HOME_BACKOFF_MM) / _axis.pulseIncrement;
+    p.blankSteps   = mmToUnits(SENSORLESS_HOME_BLANK_MM) / _axis.pulseIncrement;
+    p.fastDelayUs  = (uint16_t)pulseDelayUs(SENSORLESS_HOME_FAST_US);
+    p.slowDelayUs  = (uint16_t)pulseDelayUs(SENSORLESS_HOME_SLOW_US);
+
+    TRACE_EVENT(EVT_MOTION_START, TRACE_MOTION_HOMING, -maxSteps);
+    unsigned long t0 = millis();
+    HomingReport rep = runSensorlessHoming(p, hal);
+    unsigned long elapsed = millis() - t0;
+    TRACE_EVENT(EVT_MOTION_END, TRACE_MOTION_HOMING, _positionSteps);
+
+    tmc2209Manager.clearStall();
+    tmc2209Manager.markStallTreated();
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "[HOMING] StallGuard: %s (rapido=%ld, lento=%ld passos, %lu ms)",
+             homingResultName(rep.result), rep.fastSteps, rep.slowSteps, elapsed);
+    Serial.println(msg);
+
+    setMotionPhase(MOTION_PHASE_TRAVEL);
+    if (rep.result != HOMING_OK) {
+        _lastHomingSuccess = false;
+        return;
+    }
+
+    resetPosition();
+    _lastHomingSuccess = true;
+    // Posição de referência nova: verificação de passos recomeça daqui
+    resetStepVerification();
+    long backoffSteps = mmToUnits(STEPPER_HOME_BACKOFF_MM);
+    moveSteps(backoffSteps, STEPPER_DIR_FORWARD, SENSORLESS_HOME_FAST_US);
 }
 
 void StepperManager::homeToEndstopWithMonitor(long maxSteps, uint16_t usDelay,
                                              bool (*monitorFunc)(void*), void* ctx) {
-    StepperDirection dirHome = STEPPER_DIR_BACKWARD;  // Volta para home (para baixo)
-    digitalWrite(DIR_PIN, LOW);  // LOW = backward (ajustado ao invertido acima)
-
-    for (long i = 0; i < maxSteps; ++i) {
-        // Verifica endstop antes do passo
-        if (isEndstopPressed()) {
-            resetPosition();
-            _lastHomingSuccess = true;
-            // Recuar para posição inicial segura
-            long backoffSteps = (long)(STEPPER_HOME_BACKOFF_MM * _stepsPerMm);
-            moveSteps(backoffSteps, STEPPER_DIR_FORWARD, usDelay);
-            return;
-        }
+    if (STEPPER_SENSORLESS_HOMING && tmc2209Manager.isReady()) {
+        homeSensorless(maxSteps, monitorFunc, ctx);
+        return;
+    }
 
-        // Avalia callback de monitoramento (ex.: balança)
-        if (monitorFunc && monitorFunc(ctx)) {
-            _lastHomingSuccess = false;
-            return;
-        }
+    setMotionPhase(MOTION_PHASE_HOMING);
+    DirPin::low();  // LOW = backward (ajustado ao invertido acima)
+    TRACE_EVENT(EVT_MOTION_START, TRACE_MOTION_HOMING, -maxSteps);
+
+    // A sequência conta pulsos: converte a partir das unidades de posição
+    // (incremento e intervalo da fase de homing, como no homing sem sensor)
+    EndstopHomingCtx c = {&_positionSteps, _axis.pulseIncrement, {monitorFunc, ctx}};
+    EndstopHomingHal hal = {halEndstopStep, halDelayUs, halEndstopLevel, halEndstopPosition,
+                            halEndstopAbort, &c};
+    EndstopHomingParams p;
+    p.maxSteps        = maxSteps / _axis.pulseIncrement;
+    p.stepDelayUs     = (uint16_t)pulseDelayUs(usDelay);
+    p.settleTimeoutUs = ENDSTOP_SETTLE_TIMEOUT_US;
+    EndstopLatch* latch = (ENDSTOP_LATCH_ENABLED && _endstopIrq) ? &_endstopLatch : nullptr;
+    EndstopHomingReport rep = runEndstopHoming(p, hal, latch);
+    TRACE_EVENT(EVT_MOTION_END, TRACE_MOTION_HOMING, _positionSteps);
+
+    setMotionPhase(MOTION_PHASE_TRAVEL);
+    if (rep.result != ENDSTOP_HOME_OK) {
+        _lastHomingSuccess = false;
+        return;
+    }
 
-        // Executa um passo
-        digitalWrite(STEP_PIN, HIGH);
-        delayMicroseconds(10);
-        digitalWrite(STEP_PIN, LOW);
-        delayMicroseconds(usDelay);
+    // Zero na posição capturada na borda; algum pulso dado depois dela
+    // (latência até o laço ver a parada) continua contado
+    long overshoot = _positionSteps - rep.homePosition;
+    _positionSteps = overshoot;
+    _lastHomingSuccess = true;
+    // Posição de referência nova: verificação de passos recomeça daqui
+    resetStepVerification();
+    if (latch) {
+        char msg[80];
+        snprintf(msg, sizeof(msg), "[HOMING] Fim de curso: bordas=%u ruido=%u excesso=%ld",
+                 (unsigned)rep.edges, (unsigned)rep.rejected, overshoot);
+        Serial.println(msg);
     }
 
-    _lastHomingSuccess = false;
+    // Recuar para posição inicial segura
+    long backoffSteps = mmToUnits(STEPPER_HOME_BACKOFF_MM);
+    moveSteps(backoffSteps, STEPPER_DIR_FORWARD, usDelay);
 }
 
 void StepperManager::moveToPositionMm(float targetMm, uint16_t usDelay) {
@@ -163,7 +589,7 @@ void StepperManager::moveToPositionMm(float targetMm, uint16_t usDelay) {
         targetMm = STEPPER_MAX_TRAVEL_MM;
     }
     
-    long targetSteps = (long)round(targetMm * _stepsPerMm);
+    long targetSteps = mmToUnits(targetMm);
     long deltaSteps  = targetSteps - _positionSteps;
 
     if (deltaSteps == 0) return;
@@ -175,5 +601,18 @@ void StepperManager::moveToPositionMm(float targetMm, uint16_t usDelay) {
 }
 
 bool StepperManager::checkAndHandleStall() {
-    return false;  // A4988 não tem StallGuard
+    if (!tmc2209Manager.isReady() || !tmc2209Manager.isStallDetected()) {
+        return false;
+    }
+
+    // Recua no sentido oposto ao movimento que travou, em velocidade baixa
+    StepperDirection retractDir = (_lastDir == STEPPER_DIR_FORWARD) ? STEPPER_DIR_BACKWARD
+                                                                    : STEPPER_DIR_FORWARD;
+    long retractSteps = mmToUnits(TMC_STALL_RETRACT_MM);
+    Serial.println("[STEPPER] Stall detectado - recuando");
+    moveSteps(retractSteps, retractDir, TMC_STALL_MIN_SPEED_US);
+
+    tmc2209Manager.clearStall();
+    tmc2209Manager.markStallTreated();
+    return true;
 }
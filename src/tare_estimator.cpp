@@ -0,0 +1,110 @@
+#include "tare_estimator.h"
+#include <cmath>
+
+// Teste de tendência só com 3+ graus de liberdade: com n = 4 a cauda da t
+// de Student reiniciaria ~6% das taras de uma célula quieta
+static const int TREND_MIN_SAMPLES = 5;
+
+const char* tareQualityName(TareQuality quality) {
+    switch (quality) {
+        case TARE_QUALITY_GOOD:    return "good";
+        case TARE_QUALITY_SETTLED: return "settled";
+        case TARE_QUALITY_NOISY:   return "noisy";
+        case TARE_QUALITY_FAILED:  return "failed";
+        default:                   return "?";
+    }
+}
+
+void TareEstimator::begin(const TareConfig& cfg) {
+    _cfg = cfg;
+    if (_cfg.minSamples < 3) _cfg.minSamples = 3;   // regressão precisa de n-2 > 0
+    if (_cfg.maxSamples < _cfg.minSamples) _cfg.maxSamples = _cfg.minSamples;
+    reset();
+}
+
+void TareEstimator::reset() {
+    _result = {};
+    _done = false;
+    _total = 0;
+    _n = 0;
+}
+
+void TareEstimator::restartSegment(int32_t raw) {
+    _ref = raw;
+    _n = 1;
+    _mean = 0.0;
+    _m2 = 0.0;
+    _sumI = 0.0;
+    _sumII = 0.0;
+    _sumIX = 0.0;
+}
+
+void TareEstimator::finish(TareQuality quality, double stdErr) {
+    _result.offset = _ref + (int32_t)lround(_mean);
+    _result.stdErrCounts = (float)stdErr;
+    _result.samples = _total;
+    _result.quality = quality;
+    _done = true;
+}
+
+bool TareEstimator::push(int32_t raw) {
+    if (_done) return true;
+    ++_total;
+    if (_n == 0) {
+        restartSegment(raw);
+    } else {
+        double i = (double)_n;
+        double x = (double)(raw - _ref);
+        ++_n;
+        double delta = x - _mean;
+        _mean += delta / _n;
+        _m2 += delta * (x - _mean);
+        _sumI += i;
+        _sumII += i * i;
+        _sumIX += i * x;
+    }
+
+    double stdErr = NAN;
+    if (_n >= 2) stdErr = sqrt(_m2 / (_n - 1) / _n);
+
+    if (_n >= _cfg.minSamples) {
+        // Inclinação contra o índice (as somas incluem i = 0 implicitamente)
+        double n = (double)_n;
+        double sii = _sumII - _sumI * _sumI / n;
+        double six = _sumIX - _sumI * _mean;
+        double slope = six / sii;
+        double rss = _m2 - slope * six;
+        bool trending;
+        if (rss > 0.0) {
+            double t2 = slope * slope * sii * (n - 2.0) / rss;
+            trending = t2 > (double)_cfg.trendT * _cfg.trendT;
+        } else {
+            trending = six != 0.0;   // reta perfeita: só acomodação
+        }
+
+        if (trending && _n >= TREND_MIN_SAMPLES) {
+            ++_result.restarts;
+            restartSegment(raw);
+        } else if (stdErr <= _cfg.targetSeCounts) {
+            finish(_result.restarts ? TARE_QUALITY_SETTLED : TARE_QUALITY_GOOD, stdErr);
+            return true;
+        }
+    }
+
+    if (_total >= _cfg.maxSamples) {
+        finish(TARE_QUALITY_NOISY, (_n >= 2) ? sqrt(_m2 / (_n - 1) / _n) : NAN);
+        return true;
+    }
+    return false;
+}
+
+void TareEstimator::abort() {
+    if (_done) return;
+    if (_n == 0) {
+        _result.samples = _total;
+        _result.quality = TARE_QUALITY_FAILED;
+        _done = true;
+        return;
+    }
+    finish(TARE_QUALITY_NOISY, (_n >= 2) ? sqrt(_m2 / (_n - 1) / _n) : NAN);
+}
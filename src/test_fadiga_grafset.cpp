@@ -0,0 +1,490 @@
+#include "test_fadiga_grafset.h"
+#include "scale_manager.h"
+#include "stepper_manager.h"
+#include "encoder_manager.h"
+#include "ui_manager.h"
+#include "config.h"
+#include "trace_probe.h"
+#include "event_trace.h"
+#include <cmath>
+
+// Descida (um segmento por amostra) + retorno ao zero precisam caber na fila
+static_assert((int)(FATIGUE_COURSE_MM / FATIGUE_SAMPLE_STEP_MM) + 2 <= MOTION_QUEUE_CAPACITY,
+              "FATIGUE_SAMPLE_STEP_MM pequeno demais para a fila de movimento");
+static_assert(FATIGUE_MIN_CYCLE_SAMPLES <= (int)(FATIGUE_COURSE_MM / FATIGUE_SAMPLE_STEP_MM) + 1,
+              "FATIGUE_MIN_CYCLE_SAMPLES maior que os pontos do curso");
+
+TestFadigaGrafset::TestFadigaGrafset()
+    : currentState(STATE_SELECT_CYCLES),
+      targetCycles(FATIGUE_CYCLE_OPTIONS[0]),
+      zeroPositionMm(0.0f),
+      contactFound(false),
+      screenShown(false),
+      aborted(false),
+      positionLost(false),
+      entryTimeMs(0),
+      lastUiUpdateMs(0)
+{
+}
+
+void TestFadigaGrafset::start() {
+    Serial.println("[FADIGA] Teste de fadiga selecionado. Selecionando ciclos...");
+    finished = false;
+    cancelPending = false;
+    aborted = false;
+    positionLost = false;
+    contactFound = false;
+    zeroPositionMm = 0.0f;
+    gate.begin(FATIGUE_MIN_CYCLE_SAMPLES, FATIGUE_MAX_REJECTED_CYCLES);
+    summary.begin();
+    cycle.begin();
+    enterState(STATE_SELECT_CYCLES);
+}
+
+void TestFadigaGrafset::reset() {
+    Grafset::reset();
+    currentState = STATE_SELECT_CYCLES;
+    screenShown = false;
+}
+
+void TestFadigaGrafset::enterState(FadigaState next) {
+    TRACE_EVENT(EVT_STATE_EXIT, TRACE_GRAFSET_FADIGA, currentState);
+    TRACE_EVENT(EVT_STATE_ENTER, TRACE_GRAFSET_FADIGA, next);
+    currentState = next;
+    screenShown = false;
+    entryTimeMs = millis();
+}
+
+void TestFadigaGrafset::tick() {
+    if (finished) return;
+    PROBE_SCOPE(PROBE_GRAFSET_TICK);
+
+    scaleManager.update();
+
+    switch (currentState) {
+        case STATE_SELECT_CYCLES:
+            executeStateSelectCycles();
+            break;
+        case STATE_HOMING:
+            executeStateHoming();
+            break;
+        case STATE_AWAIT_SPRING_PLACEMENT:
+            executeStateAwaitSpringPlacement();
+            break;
+        case STATE_TARE:
+            executeStateTare();
+            break;
+        case STATE_FIND_SPRING_CONTACT:
+            executeStateFindSpringContact();
+            break;
+        case STATE_CYCLING:
+            executeStateCycling();
+            break;
+        case STATE_RETURN_INITIAL:
+            executeStateReturnInitial();
+            break;
+        case STATE_SHOW_RESULTS:
+            executeStateShowResults();
+            break;
+        default:
+            enterState(STATE_SELECT_CYCLES);
+            break;
+    }
+}
+
+// ============== SELEÇÃO DO NÚMERO DE CICLOS ==============
+void TestFadigaGrafset::executeStateSelectCycles() {
+    bool redraw = false;
+
+    if (!screenShown) {
+        uiManager.clearScreen();
+        uiManager.drawText("=== Teste Fadiga ===", 60, 20, TFT_YELLOW, 3);
+        uiManager.drawText("Numero de ciclos:", 90, 80, TFT_WHITE, 3);
+        uiManager.drawText("Click = iniciar", 130, 280, TFT_GREEN, 2);
+        uiManager.drawText("Long press = cancelar", 80, 305, TFT_RED, 2);
+
+        lastEncPos = encoderManager.getPosition();
+        encoderManager.wasButtonClicked();  // Consome cliques pendentes
+        encoderManager.wasButtonLongPressed();
+        screenShown = true;
+        redraw = true;
+    }
+
+    long encPos = encoderManager.getPosition();
+    long delta = encPos - lastEncPos;
+    if (delta != 0) {
+        lastEncPos = encPos;
+        cycleOptionIndex += (delta > 0) ? 1 : -1;
+        if (cycleOptionIndex >= FATIGUE_CYCLE_OPTIONS_COUNT) cycleOptionIndex = 0;
+        if (cycleOptionIndex < 0) cycleOptionIndex = FATIGUE_CYCLE_OPTIONS_COUNT - 1;
+        redraw = true;
+    }
+
+    if (redraw) {
+        for (int i = 0; i < FATIGUE_CYCLE_OPTIONS_COUNT; i++) {
+            uiManager.fillRect(150, 130 + i * 35, 20, 16, TFT_BLACK);
+            char buf[32];
+            snprintf(buf, sizeof(buf), "%lu ciclos   ", (unsigned long)FATIGUE_CYCLE_OPTIONS[i]);
+            uint16_t color = (i == cycleOptionIndex) ? TFT_CYAN : TFT_WHITE;
+            uiManager.drawText(buf, 180, 130 + i * 35, color, 2);
+            if (i == cycleOptionIndex) {
+                uiManager.drawText(">", 150, 130 + i * 35, TFT_CYAN, 2);
+            }
+        }
+    }
+
+    // Gating: aguarda período após mostrar tela
+    if (millis() - entryTimeMs < 500) {
+        return;
+    }
+
+    if (encoderManager.wasButtonClicked()) {
+        targetCycles = FATIGUE_CYCLE_OPTIONS[cycleOptionIndex];
+        Serial.print("[FADIGA] Ciclos selecionados: ");
+        Serial.println((unsigned long)targetCycles);
+        enterState(STATE_HOMING);
+        return;
+    }
+
+    if (takeCancelRequest() || encoderManager.wasButtonLongPressed()) {
+        Serial.println("[FADIGA] Teste cancelado pelo usuário.");
+        finished = true;
+    }
+}
+
+// ============== HOMING ==============
+void TestFadigaGrafset::executeStateHoming() {
+    uiManager.clearScreen();
+    uiManager.drawText("=== Homing ===", 120, 80, TFT_CYAN, 3);
+    uiManager.drawText("Buscando HOME...", 70, 150, TFT_YELLOW, 3);
+
+    // Sem mola no dispositivo: homing simples (recua STEPPER_HOME_BACKOFF_MM ao final)
+    long maxSteps = stepperManager.mmToUnits(250.0f);
+    stepperManager.homeToEndstop(maxSteps, 133);
+
+    if (!stepperManager.wasLastHomingSuccessful()) {
+        Serial.println("[FADIGA] ERRO: Homing falhou.");
+        uiManager.drawText("Falha no HOMING!", 70, 220, TFT_RED, 3);
+        delay(3000);
+        finished = true;
+        return;
+    }
+
+    stepperManager.moveToPositionMm(30.0f, 133);
+    enterState(STATE_AWAIT_SPRING_PLACEMENT);
+}
+
+// ============== AGUARDA POSICIONAMENTO DA MOLA ==============
+void TestFadigaGrafset::executeStateAwaitSpringPlacement() {
+    if (!screenShown) {
+        Serial.println("[FADIGA] Aguardando usuario inserir a mola...");
+        uiManager.clearScreen();
+        uiManager.drawText("=== Posicionar Mola ===", 15, 30, TFT_YELLOW, 3);
+        uiManager.drawText("Coloque a mola", 130, 130, TFT_WHITE, 2);
+        uiManager.drawText("entre as plataformas", 85, 155, TFT_WHITE, 2);
+        uiManager.drawText("Click encoder", 100, 220, TFT_CYAN, 3);
+        uiManager.drawText("para confirmar", 90, 265, TFT_CYAN, 3);
+
+        encoderManager.wasButtonClicked();
+        encoderManager.wasButtonLongPressed();
+        screenShown = true;
+    }
+
+    if (millis() - entryTimeMs < 500) {
+        return;
+    }
+
+    if (encoderManager.wasButtonClicked()) {
+        enterState(STATE_TARE);
+        return;
+    }
+
+    if (takeCancelRequest() || encoderManager.wasButtonLongPressed() || (millis() - entryTimeMs) > 120000) {
+        Serial.println("[FADIGA] Teste cancelado.");
+        finished = true;
+    }
+}
+
+// ============== TARA ==============
+void TestFadigaGrafset::executeStateTare() {
+    const TareResult& tare = scaleManager.tare();
+    Serial.print("[FADIGA] Tara feita com a mola posicionada (");
+    Serial.print(tare.samples);
+    Serial.print(" leituras, ");
+    Serial.print(tareQualityName(tare.quality));
+    Serial.println(").");
+    contactFound = false;
+    enterState(STATE_FIND_SPRING_CONTACT);
+}
+
+// ============== BUSCA CONTATO E ALIVIA ==============
+void TestFadigaGrafset::executeStateFindSpringContact() {
+    if (!screenShown) {
+        uiManager.clearScreen();
+        uiManager.drawText("=== Busca Mola ===", 75, 80, TFT_CYAN, 3);
+        uiManager.drawText("Procurando...", 105, 150, TFT_YELLOW, 3);
+        screenShown = true;
+    }
+
+    if (takeCancelRequest() || encoderManager.wasButtonLongPressed()) {
+        Serial.println("[FADIGA] Cancelado durante busca.");
+        finished = true;
+        return;
+    }
+
+    long chunkSteps = stepperManager.mmToUnits(0.25f);
+    if (chunkSteps < 1) chunkSteps = 1;
+
+    if (!contactFound) {
+        // Desce em pulsos até detectar contato
+        if (stepperManager.getPositionMm() <= FATIGUE_COURSE_MM) {
+            Serial.println("[FADIGA] ERRO: Mola nao detectada.");
+            uiManager.drawText("Mola NAO DETECTADA!", 30, 220, TFT_RED, 3);
+            delay(3000);
+            finished = true;
+            return;
+        }
+        stepperManager.moveSteps(chunkSteps, STEPPER_DIR_BACKWARD, 100);
+        scaleManager.update();
+        if (scaleManager.getWeightKg() >= SPRING_CONTACT_FORCE_KG) {
+            contactFound = true;
+        }
+        return;
+    }
+
+    // Sobe em pulsos até aliviar a carga: esse é o zero da ciclagem
+    stepperManager.moveSteps(chunkSteps, STEPPER_DIR_FORWARD, 100);
+    scaleManager.update();
+    if (scaleManager.getWeightKg() <= SPRING_TARA_THRESHOLD_KG ||
+        stepperManager.getPositionMm() >= STEPPER_MAX_TRAVEL_MM) {
+        zeroPositionMm = stepperManager.getPositionMm();
+        Serial.print("[FADIGA] Zero de ciclagem em ");
+        Serial.print(zeroPositionMm, 2);
+        Serial.println(" mm");
+
+        int samplesPerStroke = (int)(FATIGUE_COURSE_MM / FATIGUE_SAMPLE_STEP_MM) + 1;
+        curveLog.begin(samplesPerStroke);
+        summary.begin();
+        enterState(STATE_CYCLING);
+    }
+}
+
+// ============== CICLAGEM ==============
+void TestFadigaGrafset::executeStateCycling() {
+    if (!screenShown) {
+        Serial.print("[FADIGA] Iniciando ");
+        Serial.print((unsigned long)targetCycles);
+        Serial.println(" ciclos...");
+        uiManager.clearScreen();
+        uiManager.drawText("=== Ciclagem ===", 100, 20, TFT_YELLOW, 3);
+        uiManager.drawText("Long press = parar", 100, 295, TFT_RED, 2);
+        encoderManager.wasButtonLongPressed();
+        stepperManager.setMotionPhase(MOTION_PHASE_MEASURE);
+        stepperManager.resetStepVerification();
+        lastUiUpdateMs = 0;
+        screenShown = true;
+    }
+
+    // Um ciclo completo por tick: mantém loop() respondendo ao encoder entre ciclos
+    if (takeCancelRequest() || encoderManager.wasButtonLongPressed()) {
+        Serial.println("[FADIGA] Interrompido pelo usuario.");
+        aborted = true;
+        enterState(STATE_RETURN_INITIAL);
+        return;
+    }
+
+    uint32_t n = summary.cycles() + gate.rejected() + 1;
+    if (!runOneCycle(n)) {
+        aborted = true;
+        enterState(STATE_RETURN_INITIAL);
+        return;
+    }
+
+    // Passos perdidos deslocam o zero da ciclagem: para e invalida o teste
+    if (stepperManager.stepLossDetected()) {
+        Serial.print("[ALARME] Perda de passos no ciclo ");
+        Serial.print((unsigned long)n);
+        Serial.print(": ");
+        Serial.print(stepperManager.lostStepUnits());
+        Serial.println(" passos - teste INVALIDO.");
+        positionLost = true;
+        aborted = true;
+        enterState(STATE_RETURN_INITIAL);
+        return;
+    }
+
+    // Log serial nos mesmos ciclos em que a curva é guardada
+    if ((n & (n - 1)) == 0) {
+        Serial.print("[FADIGA] Ciclo ");
+        Serial.print((unsigned long)n);
+        Serial.print(" | K: ");
+        Serial.print(cycle.springRateKgfMm(), 4);
+        Serial.print(" kgf/mm | Fmax: ");
+        Serial.print(cycle.maxForceKg(), 3);
+        Serial.print(" kg | E: ");
+        Serial.print(cycle.energyMj(), 1);
+        Serial.println(" mJ");
+    }
+
+    if (millis() - lastUiUpdateMs >= FATIGUE_UI_INTERVAL_MS || summary.cycles() >= targetCycles) {
+        lastUiUpdateMs = millis();
+        drawCyclingStatus();
+    }
+
+    if (summary.cycles() >= targetCycles) {
+        enterState(STATE_RETURN_INITIAL);
+    }
+}
+
+bool TestFadigaGrafset::runOneCycle(uint32_t cycleNumber) {
+    cycle.begin();
+    curveLog.beginCycle(cycleNumber);
+
+    // Um ciclo inteiro vai para a fila: a descida não para nos pontos e o
+    // callback só pega a conversão do HX711 que já estiver pronta
+    float stepsPerMm = stepperManager.getStepsPerMm();
+    long zeroUnits = lroundf(zeroPositionMm * stepsPerMm);
+    buildFatigueStroke(strokeQueue, zeroUnits, stepsPerMm, FATIGUE_STEP_DELAY_US);
+
+    overForce = false;
+    if (!stepperManager.runMotionQueue(strokeQueue, onStrokeSegment, this)) {
+        if (!overForce) {
+            Serial.println("[FADIGA] ERRO: Movimento interrompido (fim de curso/stall).");
+        }
+        stepperManager.moveToPositionMm(zeroPositionMm, FATIGUE_STEP_DELAY_US);
+        return false;
+    }
+
+    FatigueCycleOutcome outcome = gate.endCycle(cycle, summary);
+    if (outcome != FATIGUE_CYCLE_ACCEPTED) {
+        Serial.print("[FADIGA] Ciclo ");
+        Serial.print((unsigned long)cycleNumber);
+        Serial.print(" rejeitado: ");
+        Serial.print(cycle.count());
+        Serial.println(" amostras");
+    }
+    if (outcome == FATIGUE_CYCLE_HX711_LOST) {
+        Serial.println("[FADIGA] ERRO: HX711 sem conversoes na ciclagem.");
+        return false;
+    }
+    return true;
+}
+
+// Fim de cada segmento da descida, com o carro andando: não espera o HX711
+bool TestFadigaGrafset::onStrokeSegment(const MotionSegment& seg, int index, void* ctx) {
+    TestFadigaGrafset* self = static_cast<TestFadigaGrafset*>(ctx);
+
+    // Sem conversão nova (10/80 SPS) o ponto fica de fora
+    bool fresh = scaleManager.isReady();
+    float forceKg = fresh ? scaleManager.peekWeightKgFast() : 0.0f;
+    bool ok = self->gate.onPoint(self->cycle, seg.tag, fresh, forceKg, FATIGUE_MAX_FORCE_KG);
+    if (self->gate.sampled()) {
+        self->curveLog.addSample(fatigueStrokePointMm(seg.tag), forceKg);
+    }
+
+    if (!ok) {
+        Serial.print("[FADIGA] ERRO: Forca acima do limite: ");
+        Serial.print(forceKg, 2);
+        Serial.println(" kg");
+        self->overForce = true;
+        return false;
+    }
+    return true;
+}
+
+void TestFadigaGrafset::drawCyclingStatus() {
+    char buf[48];
+
+    snprintf(buf, sizeof(buf), "Ciclo: %lu / %lu   ",
+             (unsigned long)summary.cycles(), (unsigned long)targetCycles);
+    uiManager.drawText(buf, 20, 80, TFT_WHITE, 3);
+
+    snprintf(buf, sizeof(buf), "K: %.3f kgf/mm   ", summary.lastK());
+    uiManager.drawText(buf, 20, 130, TFT_CYAN, 2);
+
+    snprintf(buf, sizeof(buf), "K medio: %.3f +/- %.3f   ", summary.meanK(), summary.stdDevK());
+    uiManager.drawText(buf, 20, 160, TFT_CYAN, 2);
+
+    snprintf(buf, sizeof(buf), "Deriva K: %+.2f %%   ", summary.driftPercent());
+    uiManager.drawText(buf, 20, 190, TFT_YELLOW, 2);
+
+    snprintf(buf, sizeof(buf), "Fmax: %.2f kg  E: %.1f mJ   ", cycle.maxForceKg(), cycle.energyMj());
+    uiManager.drawText(buf, 20, 220, TFT_GREEN, 2);
+}
+
+// ============== RETORNA POSIÇÃO INICIAL ==============
+void TestFadigaGrafset::executeStateReturnInitial() {
+    Serial.println("[FADIGA] Retornando motor para 30mm...");
+    stepperManager.setMotionPhase(MOTION_PHASE_TRAVEL);
+    stepperManager.moveToPositionMm(30.0f, 133);
+    printStoredCurves();
+    enterState(STATE_SHOW_RESULTS);
+}
+
+void TestFadigaGrafset::printStoredCurves() {
+    Serial.println("[FADIGA] Curvas guardadas (ciclo;x_mm;F_kg):");
+    for (int c = 0; c < curveLog.size(); ++c) {
+        const auto& curve = curveLog.at(c);
+        for (int i = 0; i < curve.count; ++i) {
+            Serial.print((unsigned long)curve.cycle);
+            Serial.print(';');
+            Serial.print(curve.xMm[i], 2);
+            Serial.print(';');
+            Serial.println(curve.forceKg[i], 3);
+        }
+    }
+}
+
+// ============== EXIBE RESULTADOS ==============
+void TestFadigaGrafset::executeStateShowResults() {
+    if (!screenShown) {
+        char buf[48];
+        uiManager.clearScreen();
+        uiManager.drawText(aborted ? "=== Fadiga Interrompida ===" : "=== Fadiga Concluida ===",
+                           10, 20, aborted ? TFT_RED : TFT_GREEN, 3);
+
+        snprintf(buf, sizeof(buf), "Ciclos: %lu", (unsigned long)summary.cycles());
+        uiManager.drawText(buf, 20, 75, TFT_WHITE, 2);
+        snprintf(buf, sizeof(buf), "K inicial: %.3f kgf/mm", summary.firstK());
+        uiManager.drawText(buf, 20, 105, TFT_CYAN, 2);
+        snprintf(buf, sizeof(buf), "K final:   %.3f kgf/mm", summary.lastK());
+        uiManager.drawText(buf, 20, 130, TFT_CYAN, 2);
+        snprintf(buf, sizeof(buf), "K medio: %.3f +/- %.3f", summary.meanK(), summary.stdDevK());
+        uiManager.drawText(buf, 20, 155, TFT_CYAN, 2);
+        snprintf(buf, sizeof(buf), "Deriva K: %+.2f %%", summary.driftPercent());
+        uiManager.drawText(buf, 20, 185, TFT_YELLOW, 2);
+        snprintf(buf, sizeof(buf), "Fmax: %.2f..%.2f kg", summary.minForceKg(), summary.maxForceKg());
+        uiManager.drawText(buf, 20, 210, TFT_WHITE, 2);
+        snprintf(buf, sizeof(buf), "Energia media: %.1f mJ", summary.meanEnergyMj());
+        uiManager.drawText(buf, 20, 235, TFT_WHITE, 2);
+        if (positionLost) {
+            uiManager.drawText("INVALIDO: passos perdidos", 20, 262, TFT_RED, 2);
+        }
+        uiManager.drawText("Click para menu", 130, 295, TFT_YELLOW, 2);
+
+        Serial.print("[FADIGA] Resumo: ciclos=");
+        Serial.print((unsigned long)summary.cycles());
+        Serial.print(" K0=");
+        Serial.print(summary.firstK(), 4);
+        Serial.print(" Kf=");
+        Serial.print(summary.lastK(), 4);
+        Serial.print(" Kmed=");
+        Serial.print(summary.meanK(), 4);
+        Serial.print(" Kdp=");
+        Serial.print(summary.stdDevK(), 4);
+        Serial.print(" deriva=");
+        Serial.print(summary.driftPercent(), 2);
+        Serial.print("% rejeitados=");
+        Serial.println((unsigned long)gate.rejected());
+
+        encoderManager.wasButtonClicked();
+        screenShown = true;
+    }
+
+    if (millis() - entryTimeMs < 500) {
+        return;
+    }
+
+    // O retorno ao menu é tratado pelo loop principal após finished
+    finished = true;
+}
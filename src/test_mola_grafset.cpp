@@ -3,7 +3,20 @@
 #include "stepper_manager.h"
 #include "encoder_manager.h"
 #include "ui_manager.h"
+#include "spring_rate_estimator.h"
+#include "trace_probe.h"
+#include "event_trace.h"
+#include "stallguard_monitor.h"
 #include "config.h"
+#include "test_profiles_data.h"
+#include "spring_verdict.h"
+#include "spc_stats.h"
+#include "result_store.h"
+
+// Buffers de análise (mm/kg) preenchidos a partir da arena ao final do teste
+static float s_xMm[SPRING_SAMPLE_CAPACITY];
+static float s_fKg[SPRING_SAMPLE_CAPACITY];
+static int   s_analysisCount = 0;
 
 // Baseline global ao arquivo para monitorar homing
 static float g_homingBaselineKg = 0.0f;
@@ -31,11 +44,13 @@ static bool homingWeightMonitor(void* ctx) {
 
 TestMolaGrafset::TestMolaGrafset()
     : currentState(STATE_INITIAL),
+      tracedState(STATE_INITIAL),
       motorRealPositionMm(0.0f),
       springContactMotorPosRealMm(0.0f),
       moldReadingPositionMm(0.0f),
       lastK_kgf_mm(0.0f),
       lastK_N_mm(0.0f),
+      lastR2(0.0f),
       lastForceKg(0.0f),
       compressionStepCounter(0),
       stateStartTime(0),
@@ -52,6 +67,8 @@ TestMolaGrafset::TestMolaGrafset()
       taraReached(false),
       userConfirmedRemoval(false),
       compressionSamplingDone(false),
+      stallAborted(false),
+      forceLimitExceeded(false),
       screenShownReady(false),
       homingExecuted(false),
       moveExecuted(false)
@@ -61,7 +78,13 @@ TestMolaGrafset::TestMolaGrafset()
 void TestMolaGrafset::start() {
     Serial.println("[TESTE] Teste de mola selecionado. Selecionando curso...");
     currentState = STATE_SELECT_COURSE;
+    tracedState = currentState;
+    TRACE_EVENT(EVT_STATE_ENTER, TRACE_GRAFSET_MOLA, currentState);
     finished = false;
+    cancelPending = false;
+    remoteMode = false;
+    homeOnly = false;
+    resultAvailable = false;
     
     // Reset de variáveis
     motorRealPositionMm = 0.0f;
@@ -69,9 +92,12 @@ void TestMolaGrafset::start() {
     moldReadingPositionMm = 0.0f;
     lastK_kgf_mm = 0.0f;
     lastK_N_mm = 0.0f;
+    lastR2 = 0.0f;
     lastForceKg = 0.0f;
     compressionStepCounter = 0;
-    sampleCount = 0;  // Reinicia buffer de amostras para novo teste
+    samples.clear();  // Reinicia arena de amostras para novo teste
+    s_analysisCount = 0;
+    lastResult = SpringTestResult();
     selectedCourseMm = DEFAULT_TEST_COMPRESSION_MM;
     
     // Reset de flags
@@ -93,14 +119,45 @@ void TestMolaGrafset::start() {
     taraReached = false;
     userConfirmedRemoval = false;
     compressionSamplingDone = false;
+    stallAborted = false;
+    forceLimitExceeded = false;
+    earlyRejected = false;
+    estimatedSavedMs = 0;
+    freeLengthMm = 0.0f;
     
     stateStartTime = millis();
     
     // NÃO desenhar tela aqui - será desenhada no executeStateReady()
 }
 
+bool TestMolaGrafset::startRemote(int profileIndex) {
+    if (profileIndex < 0 || profileIndex >= TEST_PROFILES_COUNT) return false;
+    const TestProfileEntry& entry = TEST_PROFILES[profileIndex];
+    if (!profile.load(entry.data, entry.size)) return false;
+
+    start();
+    remoteMode = true;
+    selectedCourseMm = profile.settings().courseMm;
+    Serial.print("[TESTE] Inicio remoto: perfil ");
+    Serial.println(profile.settings().name);
+    // Eixo já em SPRING_PLACEMENT_MM (HOME) e mola posicionada: tara e contato
+    springReadyConfirmed = true;
+    motorRealPositionMm = stepperManager.getPositionMm();
+    currentState = STATE_TARE;
+    return true;
+}
+
+void TestMolaGrafset::homeRemote() {
+    start();
+    remoteMode = true;
+    homeOnly = true;
+    Serial.println("[TESTE] HOME remoto: plataforma deve estar livre.");
+    currentState = STATE_INITIAL;
+}
+
 void TestMolaGrafset::tick() {
     if (finished) return;
+    PROBE_SCOPE(PROBE_GRAFSET_TICK);
     
     // Atualizar sensores (NÃO chamar encoderManager.update aqui - é no loop principal)
     scaleManager.update();
@@ -149,6 +206,15 @@ void TestMolaGrafset::tick() {
             currentState = STATE_INITIAL;
             break;
     }
+
+    // Registra transições de etapa (e o encerramento) no event trace
+    if (currentState != tracedState || finished) {
+        TRACE_EVENT(EVT_STATE_EXIT, TRACE_GRAFSET_MOLA, tracedState);
+        if (!finished) {
+            TRACE_EVENT(EVT_STATE_ENTER, TRACE_GRAFSET_MOLA, currentState);
+        }
+        tracedState = currentState;
+    }
 }
 
 void TestMolaGrafset::reset() {
@@ -157,6 +223,18 @@ void TestMolaGrafset::reset() {
 }
 
 // ============== ETAPA SELEÇÃO DE CURSO ==============
+// Linhas da lista de perfis (até 6 cabem acima das instruções)
+static int profileRowY(int i) {
+    return 110 + i * 28;
+}
+
+// Nome do perfil para a lista (espaços finais apagam o texto anterior)
+static void profileLabel(int i, char* buf, size_t len) {
+    ProfileInterpreter p;
+    const TestProfileEntry& entry = TEST_PROFILES[i];
+    snprintf(buf, len, "%-15s", p.load(entry.data, entry.size) ? p.settings().name : "(invalido)");
+}
+
 void TestMolaGrafset::executeStateSelectCourse() {
     static int courseIndex = 0;  // Índice da opção selecionada
     static bool screenShown = false;
@@ -169,20 +247,20 @@ void TestMolaGrafset::executeStateSelectCourse() {
         
         uiManager.clearScreen();
         uiManager.drawText("=== Teste de Mola ===", 50, 20, TFT_YELLOW, 3);
-        uiManager.drawText("Curso de leitura:", 90, 80, TFT_WHITE, 3);
+        uiManager.drawText("Perfil de teste:", 95, 80, TFT_WHITE, 3);
         
-        // Mostra opções disponíveis
-        for (int i = 0; i < SPRING_TEST_COURSES_COUNT; i++) {
+        // Mostra perfis disponíveis (compilados em test_profiles_data.h)
+        for (int i = 0; i < TEST_PROFILES_COUNT; i++) {
             char buf[32];
-            snprintf(buf, sizeof(buf), "%.0f mm", SPRING_TEST_COURSES[i]);
+            profileLabel(i, buf, sizeof(buf));
             uint16_t color = (i == courseIndex) ? TFT_CYAN : TFT_WHITE;
-            uiManager.drawText(buf, 180, 140 + i * 50, color, 2);
+            uiManager.drawText(buf, 180, profileRowY(i), color, 2);
             
             // Desenha símbolo para todos os itens
             if (i == courseIndex) {
-                uiManager.drawText(">", 150, 140 + i * 50, TFT_CYAN, 2);
+                uiManager.drawText(">", 150, profileRowY(i), TFT_CYAN, 2);
             } else {
-                uiManager.drawText(" ", 150, 140 + i * 50, TFT_BLACK, 2);
+                uiManager.drawText(" ", 150, profileRowY(i), TFT_BLACK, 2);
             }
         }
         
@@ -212,36 +290,47 @@ void TestMolaGrafset::executeStateSelectCourse() {
         
         if (delta > 0) {
             courseIndex++;
-            if (courseIndex >= SPRING_TEST_COURSES_COUNT) courseIndex = 0;
+            if (courseIndex >= TEST_PROFILES_COUNT) courseIndex = 0;
         } else {
             courseIndex--;
-            if (courseIndex < 0) courseIndex = SPRING_TEST_COURSES_COUNT - 1;
+            if (courseIndex < 0) courseIndex = TEST_PROFILES_COUNT - 1;
         }
         
         // Redesenha todas as opções e símbolos
-        for (int i = 0; i < SPRING_TEST_COURSES_COUNT; i++) {
+        for (int i = 0; i < TEST_PROFILES_COUNT; i++) {
             // Limpa completamente a área do símbolo (20x16 pixels para tamanho 2)
-            uiManager.fillRect(150, 140 + i * 50, 20, 16, TFT_BLACK);
+            uiManager.fillRect(150, profileRowY(i), 20, 16, TFT_BLACK);
             
             // Desenha o texto da opção
             char buf[32];
-            snprintf(buf, sizeof(buf), "%.0f mm     ", SPRING_TEST_COURSES[i]);
+            profileLabel(i, buf, sizeof(buf));
             uint16_t color = (i == courseIndex) ? TFT_CYAN : TFT_WHITE;
-            uiManager.drawText(buf, 180, 140 + i * 50, color, 2);
+            uiManager.drawText(buf, 180, profileRowY(i), color, 2);
             
             // Desenha símbolo apenas no item selecionado
             if (i == courseIndex) {
-                uiManager.drawText(">", 150, 140 + i * 50, TFT_CYAN, 2);
+                uiManager.drawText(">", 150, profileRowY(i), TFT_CYAN, 2);
             }
         }
     }
 
     // Confirma seleção
     if (encoderManager.wasButtonClicked()) {
-        selectedCourseMm = SPRING_TEST_COURSES[courseIndex];
-        Serial.print("[TESTE] Curso selecionado: ");
+        const TestProfileEntry& entry = TEST_PROFILES[courseIndex];
+        if (!profile.load(entry.data, entry.size)) {
+            Serial.print("[TESTE] ERRO: perfil invalido: ");
+            Serial.println(profile.error());
+            uiManager.drawText("Perfil invalido!", 120, 255, TFT_RED, 2);
+            return;
+        }
+        selectedCourseMm = profile.settings().courseMm;
+        Serial.print("[TESTE] Perfil selecionado: ");
+        Serial.print(profile.settings().name);
+        Serial.print(" | curso ");
         Serial.print(selectedCourseMm);
-        Serial.println(" mm");
+        Serial.print(" mm | ");
+        Serial.print(profile.settings().sampleCount);
+        Serial.println(" pontos");
         
         screenShown = false;
         currentState = STATE_READY;
@@ -249,7 +338,7 @@ void TestMolaGrafset::executeStateSelectCourse() {
     }
 
     // Cancela teste
-    if (encoderManager.wasButtonLongPressed()) {
+    if (takeCancelRequest() || encoderManager.wasButtonLongPressed()) {
         Serial.println("[TESTE] Seleção de curso cancelada.");
         finished = true;
         screenShown = false;
@@ -298,7 +387,7 @@ void TestMolaGrafset::executeStateReady() {
     }
     
     // Verifica long press para cancelar
-    if (encoderManager.wasButtonLongPressed()) {
+    if (takeCancelRequest() || encoderManager.wasButtonLongPressed()) {
         Serial.println("[TESTE] Teste cancelado pelo usuário.");
         finished = true;
         screenShownReady = false;
@@ -331,7 +420,7 @@ void TestMolaGrafset::executeStateHoming() {
 
         // IMPORTANTE: Usar limite MUITO grande (250mm = 400000 passos a 1600 spm)
         // O motor será parado APENAS pelo micro switch, não por limite de movimento
-        long maxSteps = (long)(250.0f * stepperManager.getStepsPerMm());
+        long maxSteps = stepperManager.mmToUnits(250.0f);
         
         // Homing com monitoramento de alteração de peso na balança
         stepperManager.homeToEndstopWithMonitor(maxSteps, 133, homingWeightMonitor, this);
@@ -387,7 +476,7 @@ void TestMolaGrafset::executeStateHoming() {
 void TestMolaGrafset::executeStateReturn30mm() {
     if (!moveExecuted) {
         Serial.println("[TESTE] Etapa 3: Retornando 30 mm...");
-        stepperManager.moveToPositionMm(30.0f, 133);
+        stepperManager.moveToPositionMm(SPRING_PLACEMENT_MM, 133);
         moveExecuted = true;
         
         motorRealPositionMm = stepperManager.getPositionMm();
@@ -422,6 +511,14 @@ void TestMolaGrafset::executeStateAwaitSpringPlacement() {
         encoderManager.wasButtonLongPressed();
     }
     
+    // HOME remoto: termina aqui, com o eixo na posição de colocação
+    if (homeOnly) {
+        Serial.println("[TESTE] Modo remoto: eixo em posicao, aguardando mola e START.");
+        finished = true;
+        screenShownAwaitSpringPlacement = false;
+        return;
+    }
+
     // Guard: ignora cliques nos primeiros 500ms após entrada no estado
     if ((millis() - awaitSpringEntryTimeMs) < 500) {
         return;
@@ -437,7 +534,7 @@ void TestMolaGrafset::executeStateAwaitSpringPlacement() {
     }
     
     // Verifica long press (cancelar)
-    if (encoderManager.wasButtonLongPressed()) {
+    if (takeCancelRequest() || encoderManager.wasButtonLongPressed()) {
         Serial.println("[TESTE] Teste cancelado pelo usuário.");
         finished = true;
         screenShownAwaitSpringPlacement = false;
@@ -458,8 +555,12 @@ void TestMolaGrafset::executeStateTare() {
     static bool tareExecuted = false;
     
     if (!tareExecuted) {
-        scaleManager.tare();
-        Serial.println("[TESTE] Etapa 5: Tara feita com a mola posicionada.");
+        const TareResult& tare = scaleManager.tare();
+        Serial.print("[TESTE] Etapa 5: Tara feita com a mola posicionada (");
+        Serial.print(tare.samples);
+        Serial.print(" leituras, ");
+        Serial.print(tareQualityName(tare.quality));
+        Serial.println(").");
         tareExecuted = true;
     }
     
@@ -487,13 +588,13 @@ void TestMolaGrafset::executeStateFindSpringContact() {
     static bool continuousMovementDone = false;
     
     if (!searchStarted) {
-        chunkSteps = (int)(0.25f * stepperManager.getStepsPerMm());
+        chunkSteps = stepperManager.mmToUnits(0.25f);
         if (chunkSteps < 1) chunkSteps = 1;
         searchStarted = true;
         continuousMovementDone = false;
         
         // Fase 1: Movimento contínuo de 10mm (uma única vez)
-        long continuousSteps = (int)(10.0f * stepperManager.getStepsPerMm());  // 10mm contínuo
+        long continuousSteps = stepperManager.mmToUnits(10.0f);  // 10mm contínuo
         stepperManager.moveSteps(continuousSteps, STEPPER_DIR_BACKWARD, 130);  // 130us (mais seguro)
         motorRealPositionMm = stepperManager.getPositionMm();
         
@@ -503,7 +604,7 @@ void TestMolaGrafset::executeStateFindSpringContact() {
         
         // Verifica se mola foi detectada durante o movimento contínuo
         float currentForceKg = scaleManager.getWeightKg();
-        if (currentForceKg >= SPRING_CONTACT_FORCE_KG) {
+        if (currentForceKg >= profile.settings().contactForceKg) {
             springContactDetected = true;
             springContactMotorPosRealMm = motorRealPositionMm;
             Serial.print("[TESTE] MOLA DETECTADA (durante contínuo)! Forca: ");
@@ -526,7 +627,7 @@ void TestMolaGrafset::executeStateFindSpringContact() {
         // Fase 2: Movimento em pulsos (após 10mm contínuos)
         
         // Check for user cancellation
-        if (encoderManager.wasButtonLongPressed()) {
+        if (takeCancelRequest() || encoderManager.wasButtonLongPressed()) {
             Serial.println("[TESTE] Cancelado pelo usuario durante busca.");
             finished = true;
             searchStarted = false;
@@ -536,12 +637,12 @@ void TestMolaGrafset::executeStateFindSpringContact() {
         }
         
         // Move down em pulsos
-        stepperManager.moveSteps(chunkSteps, STEPPER_DIR_BACKWARD, 100);
+        stepperManager.moveSteps(chunkSteps, STEPPER_DIR_BACKWARD, profile.settings().approachUsDelay);
         motorRealPositionMm = stepperManager.getPositionMm();
         
         float currentForceKg = scaleManager.getWeightKg();
         
-        if (currentForceKg >= SPRING_CONTACT_FORCE_KG) {
+        if (currentForceKg >= profile.settings().contactForceKg) {
             springContactDetected = true;
             springContactMotorPosRealMm = motorRealPositionMm;
             Serial.print("[TESTE] MOLA DETECTADA (fase pulsos)! Forca: ");
@@ -571,6 +672,16 @@ void TestMolaGrafset::executeStateFindSpringContact() {
         uiManager.drawText("", 10, 280, TFT_WHITE, 2);
         uiManager.drawText("Click para tentar novamente", 45, 295, TFT_CYAN, 2);
         
+        // Remoto: ninguém para clicar, encerra sem bloquear o loop
+        if (remoteMode) {
+            Serial.println("[TESTE] Modo remoto: teste encerrado sem contato.");
+            finished = true;
+            searchStarted = false;
+            continuousMovementDone = false;
+            screenShownFindSpringContact = false;
+            return;
+        }
+
         Serial.println("[TESTE] Aguardando confirmação para tentar novamente...");
         userInteractionTimeout = millis() + 60000;  // 1 minuto
         searchStarted = false;
@@ -616,13 +727,13 @@ void TestMolaGrafset::executeStateReturnToTare() {
     static bool returnStarted = false;
     
     if (!returnStarted) {
-        chunkSteps = (int)(0.25f * stepperManager.getStepsPerMm());
+        chunkSteps = stepperManager.mmToUnits(0.25f);
         if (chunkSteps < 1) chunkSteps = 1;
         returnStarted = true;
     }
     
     if (motorRealPositionMm < initialPositionMm) {
-        if (encoderManager.wasButtonLongPressed()) {
+        if (takeCancelRequest() || encoderManager.wasButtonLongPressed()) {
             Serial.println("[TESTE] Cancelado durante recuo.");
             finished = true;
             returnStarted = false;
@@ -662,6 +773,7 @@ void TestMolaGrafset::executeStateZeroReference() {
         // evitando comprimir ~2 mm antes da primeira leitura
         motorRealPositionMm = stepperManager.getPositionMm();
         springContactMotorPosRealMm = motorRealPositionMm;
+        zeroReferenceSteps = stepperManager.getPositionSteps();
 
         Serial.println("[TESTE] Etapa 8: Zerando referencia de posicao da mola...");
         Serial.print("[TESTE] Zero fixado em posicao aliviada: ");
@@ -670,128 +782,265 @@ void TestMolaGrafset::executeStateZeroReference() {
         Serial.println("[TESTE] Sistema pronto para compressao automatica (0 mm = contato aliviado)!");
         screenShownZeroReference = true;
     }
+
+    // Veredito incremental: comprimento livre já reprova antes de comprimir
+    verdict.begin(profile.settings(), VERDICT_EARLY_K_MARGIN, VERDICT_EARLY_MIN_POINTS, VERDICT_MIN_X_MM);
+    freeLengthMm = springContactMotorPosRealMm - PLATEN_BASE_POSITION_MM;
+    if (verdict.checkFreeLength(freeLengthMm)) {
+        Serial.print("[TESTE] REPROVADO: comprimento livre ");
+        Serial.print(freeLengthMm, 2);
+        Serial.print(" mm (nominal ");
+        Serial.print(profile.settings().freeLengthMm, 2);
+        Serial.print(" +/- ");
+        Serial.print(profile.settings().freeLengthTolMm, 2);
+        Serial.println(" mm) - sem compressao.");
+        earlyRejected = true;
+        estimatedSavedMs = 0;  // sem amostras, não há base para estimar
+        currentState = STATE_RETURN_INITIAL;
+        return;
+    }
     
+    compressionStartMs = millis();
     currentState = STATE_COMPRESSION_SAMPLING;
 }
 
 // ============== AMOSTRAGEM DE COMPRESSÃO ==============
+// Executa o perfil selecionado: um passo do interpretador por tick
 void TestMolaGrafset::executeStateCompressionSampling() {
     if (!screenShownCompressionSampling) {
-        Serial.println("[TESTE] Etapa 9: Iniciando amostragem de compressão (10mm)...");
+        Serial.print("[TESTE] Etapa 9: Iniciando amostragem de compressão (perfil ");
+        Serial.print(profile.settings().name);
+        Serial.println(")...");
         uiManager.clearScreen();
         uiManager.drawTestStatus(0.0f, selectedCourseMm, 0.0f, 0.0f, true, false);
         uiManager.clearGraphArea();
         
+        // Curso de medição: microstep fino + StealthChop
+        stepperManager.setMotionPhase(MOTION_PHASE_MEASURE);
+        stepperManager.resetStepVerification();
+        profile.rewind();
         compressionStepCounter = 0;
+        settleTotalMs = 0;
+        settleMaxMs = 0;
+        settlePoints = 0;
+        settleTimeouts = 0;
         screenShownCompressionSampling = true;
     }
-    
-    if (compressionStepCounter <= (int)selectedCourseMm) {
-        // Check cancellation
-        if (encoderManager.wasButtonLongPressed()) {
-            Serial.println("[TESTE] Cancelado durante amostragem.");
-            finished = true;
-            screenShownCompressionSampling = false;
-            return;
-        }
-        
-        float moldCompressionReadingMm = (float)compressionStepCounter;
-        float motorRealTargetMm = springContactMotorPosRealMm - moldCompressionReadingMm;
-        
-        float maxMotorCompressionRealMm = springContactMotorPosRealMm - selectedCourseMm;
-        if (motorRealTargetMm < maxMotorCompressionRealMm) {
-            motorRealTargetMm = maxMotorCompressionRealMm;
-            moldCompressionReadingMm = springContactMotorPosRealMm - motorRealTargetMm;
+
+    // Check cancellation
+    if (takeCancelRequest() || encoderManager.wasButtonLongPressed()) {
+        Serial.println("[TESTE] Cancelado durante amostragem.");
+        finished = true;
+        screenShownCompressionSampling = false;
+        return;
+    }
+
+    ProfileStep step;
+    if (!profile.next(&step)) {
+        if (settlePoints > 0) {
+            Serial.print("[TESTE] Acomodacao: media ");
+            Serial.print(settleTotalMs / settlePoints);
+            Serial.print(" ms, max ");
+            Serial.print(settleMaxMs);
+            Serial.print(" ms, ");
+            Serial.print(settleTimeouts);
+            Serial.println(" ponto(s) sem acomodar");
         }
-        
-        Serial.print("[TESTE] Passo ");
-        Serial.print(compressionStepCounter);
-        Serial.print(": Leitura ");
-        Serial.print(moldCompressionReadingMm, 1);
-        Serial.print(" mm | Motor REAL ");
-        Serial.print(motorRealTargetMm, 1);
-        Serial.println(" mm");
-        
-        stepperManager.moveToPositionMm(motorRealTargetMm);
-        delay(100);
-        
-        // Media de 5 leituras
-        const int N = 5;
-        float soma = 0.0f;
-        for (int j = 0; j < N; ++j) {
+        compressionSamplingDone = true;
+        currentState = STATE_RETURN_INITIAL;
+        screenShownCompressionSampling = false;
+        return;
+    }
+
+    if (step.kind == PROFILE_STEP_DWELL) {
+        Serial.print("[TESTE] Dwell de ");
+        Serial.print(step.dwellMs);
+        Serial.println(" ms");
+        delay(step.dwellMs);
+        return;
+    }
+
+    PROBE_SCOPE(PROBE_MOLA_COMPRESSION_STEP);
+
+    // Interpretador garante posição <= curso do perfil
+    float moldCompressionReadingMm = step.positionMm;
+    float motorRealTargetMm = springContactMotorPosRealMm - moldCompressionReadingMm;
+
+    Serial.print("[TESTE] Passo ");
+    Serial.print(step.index);
+    Serial.print(": Leitura ");
+    Serial.print(moldCompressionReadingMm, 2);
+    Serial.print(" mm | Motor REAL ");
+    Serial.print(motorRealTargetMm, 2);
+    Serial.println(" mm");
+    
+    stepperManager.moveToPositionMm(motorRealTargetMm, step.usDelay);
+    if (stallGuardMonitor.abortRequested()) {
+        Serial.print("[ALARME] Stall durante compressao (SG_RESULT=");
+        Serial.print(stallGuardMonitor.lastValue());
+        Serial.println(") - abortando e retornando.");
+        stallGuardMonitor.clearAbort();
+        stallAborted = true;
+        currentState = STATE_RETURN_INITIAL;
+        screenShownCompressionSampling = false;
+        return;
+    }
+    long avgRaw;
+    SettleStatus settleStatus = SETTLE_DONE;
+    if (SETTLE_ADAPTIVE) {
+        settleStatus = measureSettled(step, &avgRaw);
+        uint32_t settleMs = settling.settlingMs();
+        settleTotalMs += settleMs;
+        if (settleMs > settleMaxMs) settleMaxMs = settleMs;
+        settlePoints++;
+        if (settleStatus == SETTLE_TIMEOUT) settleTimeouts++;
+    } else {
+        delay(step.settleMs);
+
+        // Média de N leituras (em contagens brutas), N e intervalo do perfil
+        long somaRaw = 0;
+        for (int j = 0; j < step.average; ++j) {
             scaleManager.update();
-            soma += scaleManager.getWeightKg();
-            delay(20);
+            somaRaw += scaleManager.getLastRaw();
+            delay(step.readIntervalMs);
         }
-        float avgKg = soma / (float)N;
-        lastForceKg = avgKg;
-        // Armazena amostra para regressão
-        if (sampleCount < MAX_SAMPLES) {
-            sampleX_mm[sampleCount] = moldCompressionReadingMm;
-            sampleF_kg[sampleCount] = avgKg;
-            sampleCount++;
-        }
-        
-        // Calcula K
-        float currentK_kgf_mm = 0.0f;
-        float currentK_N_mm = 0.0f;
-        if (moldCompressionReadingMm > 0.5f) {
-            currentK_kgf_mm = avgKg / moldCompressionReadingMm;
-            currentK_N_mm = currentK_kgf_mm * 9.80665f;
-            lastK_kgf_mm = currentK_kgf_mm;
-            lastK_N_mm = currentK_N_mm;
-        }
-        
-        Serial.print("[TESTE] Leitura: ");
-        Serial.print(moldCompressionReadingMm, 1);
-        Serial.print(" mm | Força: ");
-        Serial.print(avgKg, 2);
-        Serial.print(" kg | K: ");
-        Serial.print(lastK_kgf_mm, 3);
-        Serial.println(" kgf/mm");
-        
-        uiManager.drawTestStatus(avgKg,
-                                 moldCompressionReadingMm,
-                                 lastK_kgf_mm,
-                                 lastK_N_mm,
-                                 true,
-                                 false);
-        
-        float xNorm = moldCompressionReadingMm / selectedCourseMm;
-        float yNorm = avgKg / GRAPH_MAX_FORCE_KG;
-        if (yNorm > 1.0f) yNorm = 1.0f;
-        
-        uiManager.plotGraphPoint(xNorm, yNorm, (compressionStepCounter == 0));
-        
-            // Plota curva amarela (K em N/mm)
-            float kNorm = lastK_N_mm / 20.0f;  // Normaliza assumindo K máximo ~20 N/mm
-            uiManager.plotGraphPointYellow(xNorm, kNorm, (compressionStepCounter == 0));
-        
-        // Desenha valor de K na lista lateral
-        if (compressionStepCounter > 0) {  // Pula o passo 0 (sem compressão)
-            uiManager.drawKValueAtStep(compressionStepCounter, lastK_kgf_mm, lastK_N_mm);
-        }
-        
-        compressionStepCounter++;
+        avgRaw = somaRaw / step.average;
+    }
+    float avgKg = scaleManager.rawToKg(avgRaw);
+    lastForceKg = avgKg;
+    // Armazena amostra bruta para regressão
+    CurveSample sample;
+    sample.stepPos = (int32_t)stepperManager.getPositionSteps();
+    sample.rawCount = (int32_t)avgRaw;
+    sample.timestampUs = micros();
+    samples.push(sample);
+    
+    // Calcula K
+    float currentK_kgf_mm = 0.0f;
+    float currentK_N_mm = 0.0f;
+    if (moldCompressionReadingMm > 0.5f) {
+        currentK_kgf_mm = avgKg / moldCompressionReadingMm;
+        currentK_N_mm = currentK_kgf_mm * 9.80665f;
+        lastK_kgf_mm = currentK_kgf_mm;
+        lastK_N_mm = currentK_N_mm;
+    }
+    
+    Serial.print("[TESTE] Leitura: ");
+    Serial.print(moldCompressionReadingMm, 2);
+    Serial.print(" mm | Força: ");
+    Serial.print(avgKg, 2);
+    Serial.print(" kg | K: ");
+    Serial.print(lastK_kgf_mm, 3);
+    Serial.print(" kgf/mm");
+    if (SETTLE_ADAPTIVE) {
+        Serial.print(" | Acomod: ");
+        Serial.print(settling.settlingMs());
+        Serial.print(settleStatus == SETTLE_TIMEOUT ? " ms (timeout)" : " ms");
+    }
+    if (stallGuardMonitor.isRunning()) {
+        Serial.print(" | SG: ");
+        Serial.println(stallGuardMonitor.lastValue());
     } else {
-        compressionSamplingDone = true;
+        Serial.println();
+    }
+    
+    uiManager.drawTestStatus(avgKg,
+                             moldCompressionReadingMm,
+                             lastK_kgf_mm,
+                             lastK_N_mm,
+                             true,
+                             false);
+    
+    float xNorm = moldCompressionReadingMm / selectedCourseMm;
+    float yNorm = avgKg / GRAPH_MAX_FORCE_KG;
+    if (yNorm > 1.0f) yNorm = 1.0f;
+    
+    uiManager.plotGraphPoint(xNorm, yNorm, (step.index == 0));
+    
+        // Plota curva amarela (K em N/mm)
+        float kNorm = lastK_N_mm / 20.0f;  // Normaliza assumindo K máximo ~20 N/mm
+        uiManager.plotGraphPointYellow(xNorm, kNorm, (step.index == 0));
+    
+    // Desenha valor de K na lista lateral
+    if (step.index > 0) {  // Pula o ponto 0 (sem compressão)
+        uiManager.drawKValueAtStep(step.index, moldCompressionReadingMm, lastK_kgf_mm, lastK_N_mm);
+    }
+    
+    compressionStepCounter++;
+
+    // Veredito incremental: reprovação clara encerra o curso aqui
+    if (verdict.addSample(moldCompressionReadingMm, avgKg)) {
+        uint32_t elapsed = millis() - compressionStartMs;
+        int done = step.index + 1;
+        int remaining = profile.settings().sampleCount - done;
+        estimatedSavedMs = (remaining > 0) ? (uint32_t)((uint64_t)elapsed * remaining / done) : 0;
+        earlyRejected = true;
+        forceLimitExceeded = (verdict.reason() == VERDICT_REASON_OVERFORCE);
+
+        Serial.print(forceLimitExceeded ? "[ALARME] " : "[TESTE] ");
+        Serial.print("REPROVADO em ");
+        Serial.print(moldCompressionReadingMm, 2);
+        Serial.print(" mm: ");
+        Serial.print(verdictReasonName(verdict.reason()));
+        Serial.print(" (");
+        Serial.print(verdict.failValue(), 3);
+        Serial.print(") - curso interrompido, economia estimada ");
+        Serial.print(estimatedSavedMs);
+        Serial.println(" ms");
         currentState = STATE_RETURN_INITIAL;
         screenShownCompressionSampling = false;
     }
 }
 
+SettleStatus TestMolaGrafset::measureSettled(const ProfileStep& step, long* avgRaw) {
+    float countsPerKg = fabsf(scaleManager.getCalibFactor());
+    SettlingConfig cfg;
+    cfg.window         = (step.average > SETTLE_WINDOW) ? step.average : SETTLE_WINDOW;
+    cfg.minSpanMs      = SETTLE_MIN_SPAN_MS;
+    cfg.maxDriftCounts = SETTLE_MAX_DRIFT_KG * countsPerKg;
+    cfg.maxStdCounts   = SETTLE_MAX_STD_KG * countsPerKg;
+    cfg.relTol         = SETTLE_REL_TOL;
+    cfg.zeroCounts     = (int32_t)scaleManager.getOffset();
+    cfg.timeoutMs      = SETTLE_TIMEOUT_MS;
+    settling.begin(cfg);
+    settling.start(millis());
+
+    SettleStatus status = SETTLE_WAITING;
+    while (status == SETTLE_WAITING) {
+        long raw;
+        if (!scaleManager.readRaw(&raw)) {
+            status = SETTLE_TIMEOUT;   // HX711 sem resposta
+            break;
+        }
+        status = settling.push((int32_t)raw, millis());
+    }
+    *avgRaw = (settling.conversions() > 0) ? lroundf(settling.windowMean())
+                                           : scaleManager.getLastRaw();
+    return status;
+}
+
 // ============== RETORNA POSIÇÃO INICIAL ==============
 void TestMolaGrafset::executeStateReturnInitial() {
     if (!screenShownReturnInitial) {
-        // Ao finalizar a amostragem, calcula K por regressão linear na faixa útil (2 a 8mm)
+        // Ao finalizar a amostragem, calcula K na região linear detectada
+        loadSamplesForAnalysis();
         float r2 = 0.0f;
-        float upper = selectedCourseMm < 8.0f ? selectedCourseMm : 8.0f;
-        float k_kgf_mm = computeSpringRateRegression(2.0f, upper, &r2);
+        float k_kgf_mm = computeSpringRate(&r2);
         if (k_kgf_mm > 0.0f) {
             lastK_kgf_mm = k_kgf_mm;
             lastK_N_mm = lastK_kgf_mm * 9.80665f;
             lastR2 = r2;
         }
+        computeNonlinearFits();
+        resultAvailable = true;
+        storeResult();
+        stepperManager.setMotionPhase(MOTION_PHASE_TRAVEL);
+        if (stallAborted) {
+            Serial.println("[TESTE] AVISO: compressao abortada por stall - resultado parcial.");
+        }
+        if (forceLimitExceeded) {
+            Serial.println("[TESTE] AVISO: compressao abortada pelo limite de forca - resultado parcial.");
+        }
 
         Serial.println("[TESTE] Etapa 10: Retornando motor para 30mm...");
         uiManager.drawTestStatus(lastForceKg,
@@ -804,7 +1053,7 @@ void TestMolaGrafset::executeStateReturnInitial() {
         Serial.print("[TESTE] Motor movendo de ");
         Serial.print(springContactMotorPosRealMm, 1);
         Serial.print(" mm para 30 mm...");
-        stepperManager.moveToPositionMm(30.0f, 133);
+        stepperManager.moveToPositionMm(SPRING_PLACEMENT_MM, 133);
         Serial.println(" Pronto!");
         
         delay(500);
@@ -814,53 +1063,180 @@ void TestMolaGrafset::executeStateReturnInitial() {
     currentState = STATE_SHOW_RESULTS;
 }
 
-// Regressão linear F = a + k*x, usando amostras coletadas
-float TestMolaGrafset::computeSpringRateRegression(float lowMm, float highMm, float* outR2) {
-    // Acumula apenas pontos no intervalo [lowMm, highMm]
-    float sumX = 0.0f, sumY = 0.0f, sumXX = 0.0f, sumXY = 0.0f;
-    int n = 0;
-    float minX = lowMm, maxX = highMm;
-    for (int i = 0; i < sampleCount; ++i) {
-        float x = sampleX_mm[i];
-        float y = sampleF_kg[i];
-        if (x >= minX && x <= maxX) {
-            sumX += x;
-            sumY += y;
-            sumXX += x * x;
-            sumXY += x * y;
-            n++;
-        }
+int TestMolaGrafset::loadSamplesForAnalysis() {
+    float stepsPerMm = stepperManager.getStepsPerMm();
+    s_analysisCount = samples.size();
+    for (int i = 0; i < s_analysisCount; ++i) {
+        // Compressão cresce no sentido BACKWARD (posição diminui)
+        s_xMm[i] = (float)(zeroReferenceSteps - samples[i].stepPos) / stepsPerMm;
+        s_fKg[i] = scaleManager.rawToKg(samples[i].rawCount);
     }
-    if (n < 2) {
-        if (outR2) *outR2 = 0.0f;
+    return s_analysisCount;
+}
+
+// K por estimador robusto sobre a região linear detectada nas amostras
+float TestMolaGrafset::computeSpringRate(float* outR2) {
+    if (outR2) *outR2 = 0.0f;
+    if (s_analysisCount < 2) {
         return 0.0f;
     }
-    float xMean = sumX / n;
-    float yMean = sumY / n;
-    float denom = (sumXX - n * xMean * xMean);
-    if (denom == 0.0f) {
-        if (outR2) *outR2 = 0.0f;
+
+    int first = 0;
+    int last = s_analysisCount - 1;
+    if (!detectLinearRegion(s_xMm, s_fKg, s_analysisCount,
+                            SPRING_LINEAR_REL_TOL, SPRING_LINEAR_MIN_POINTS,
+                            &first, &last)) {
+        Serial.println("[TESTE] AVISO: Regiao linear nao detectada, usando todas as amostras.");
+        first = 0;
+        last = s_analysisCount - 1;
+    }
+
+    SpringRateMethod method = (SpringRateMethod)SPRING_RATE_METHOD;
+    LineFit fit = fitSpringRate(s_xMm, s_fKg, first, last, method);
+
+    Serial.print("[TESTE] Regiao linear: ");
+    Serial.print(s_xMm[first], 1);
+    Serial.print(" a ");
+    Serial.print(s_xMm[last], 1);
+    Serial.print(" mm | Metodo: ");
+    Serial.print(springRateMethodName(method));
+    Serial.print(" | Inliers: ");
+    Serial.print(fit.inliers);
+    Serial.print("/");
+    Serial.println(last - first + 1);
+
+    if (!fit.valid) {
         return 0.0f;
     }
-    float k = (sumXY - n * xMean * yMean) / denom; // kgf/mm
-    // Intercept a = yMean - k * xMean (não usado)
-
-    // R^2
-    if (outR2) {
-        float ssTot = 0.0f;
-        float ssRes = 0.0f;
-        for (int i = 0; i < sampleCount; ++i) {
-            float x = sampleX_mm[i];
-            float y = sampleF_kg[i];
-            if (x >= minX && x <= maxX) {
-                float yHat = (yMean - k * xMean) + k * x;
-                ssTot += (y - yMean) * (y - yMean);
-                ssRes += (y - yHat) * (y - yHat);
+    if (outR2) *outR2 = fit.r2;
+    return fit.k;
+}
+
+void TestMolaGrafset::computeNonlinearFits() {
+    lastResult.courseMm = selectedCourseMm;
+    lastResult.kKgfMm = lastK_kgf_mm;
+    lastResult.kNmm = lastK_N_mm;
+    lastResult.r2 = lastR2;
+    lastResult.maxForceKg = lastForceKg;
+    lastResult.sampleCount = s_analysisCount;
+    lastResult.positionVerified = !stepperManager.stepLossDetected();
+    lastResult.lostStepUnits = stepperManager.lostStepUnits();
+    if (!lastResult.positionVerified) {
+        Serial.print("[ALARME] Perda de passos na compressao: ");
+        Serial.print(lastResult.lostStepUnits);
+        Serial.print(" passos, ");
+        Serial.print(stepperManager.stallEventCount());
+        Serial.println(" stall(s) - resultado INVALIDO.");
+    }
+    // Critérios da peça (perfil): K final com o estimador robusto
+    VerdictState vs = verdict.finish(lastK_kgf_mm, compressionSamplingDone && !stallAborted);
+    lastResult.hasLimits = (vs != VERDICT_NONE);
+    lastResult.passed = (vs != VERDICT_FAIL);
+    lastResult.verdictReason = verdict.reason();
+    lastResult.freeLengthMm = freeLengthMm;
+    lastResult.earlyRejected = earlyRejected;
+    lastResult.estimatedSavedMs = estimatedSavedMs;
+    lastResult.settleMeanMs = settlePoints ? settleTotalMs / settlePoints : 0;
+    lastResult.settleMaxMs = settleMaxMs;
+    lastResult.settleTimeouts = settleTimeouts;
+    if (lastResult.hasLimits) {
+        Serial.print("[TESTE] Peca ");
+        Serial.print(profile.settings().name);
+        if (lastResult.passed) {
+            Serial.println(": APROVADO");
+        } else {
+            Serial.print(": REPROVADO (");
+            Serial.print(verdictReasonName(lastResult.verdictReason));
+            Serial.println(")");
+        }
+    }
+    // CEP do lote: só K de medições completas e com posição verificada;
+    // troca de peça (perfil) inicia um novo lote
+    if (lastResult.positionVerified && compressionSamplingDone && !stallAborted && lastK_kgf_mm > 0.0f) {
+        const ProfileSettings& ps = profile.settings();
+        if (spcBatch.count() == 0 || strncmp(spcBatch.partName(), ps.name, SPC_PART_NAME_MAX) != 0) {
+            spcBatch.begin(ps.name, ps.kMinKgfMm, ps.kMaxKgfMm);
+        }
+        spcBatch.add(lastK_kgf_mm);
+        Serial.print("[CEP] ");
+        Serial.print(spcBatch.partName());
+        Serial.print(" n=");
+        Serial.print((unsigned long)spcBatch.count());
+        Serial.print(" media=");
+        Serial.print(spcBatch.mean(), 4);
+        Serial.print(" s=");
+        Serial.print(spcBatch.stdDev(), 4);
+        if (spcBatch.hasTolerance()) {
+            Serial.print(" Cpk=");
+            Serial.print(spcBatch.cpk(), 2);
+        }
+        Serial.println();
+    }
+    lastResult.piecewise = fitPiecewiseLinear(s_xMm, s_fKg, s_analysisCount);
+    lastResult.poly = fitQuadratic(s_xMm, s_fKg, s_analysisCount);
+
+    const PiecewiseFit& pw = lastResult.piecewise;
+    if (pw.valid) {
+        Serial.print("[TESTE] Ajuste por partes: ");
+        Serial.print(pw.segments);
+        Serial.print(" segmento(s) | RMS ");
+        Serial.print(pw.rmsKg, 3);
+        Serial.println(" kg");
+        for (int s = 0; s < pw.segments; ++s) {
+            Serial.print("[TESTE]   K");
+            Serial.print(s + 1);
+            Serial.print(": ");
+            Serial.print(pw.rateKgfMm[s], 3);
+            Serial.print(" kgf/mm");
+            if (s + 1 < pw.segments) {
+                Serial.print(" | quebra em ");
+                Serial.print(pw.breakMm[s], 2);
+                Serial.print(" mm");
             }
+            Serial.println();
         }
-        *outR2 = (ssTot > 0.0f) ? (1.0f - ssRes / ssTot) : 0.0f;
     }
-    return k;
+
+    const PolyFit& pf = lastResult.poly;
+    if (pf.valid) {
+        Serial.print("[TESTE] Polinomio: F = ");
+        Serial.print(pf.c0, 3);
+        Serial.print(" + ");
+        Serial.print(pf.c1, 4);
+        Serial.print("*x + ");
+        Serial.print(pf.c2, 5);
+        Serial.print("*x^2 | R^2 ");
+        Serial.println(pf.r2, 4);
+    }
+}
+
+void TestMolaGrafset::storeResult() {
+    CurveMeta meta = {};
+    meta.stepsPerMm = stepperManager.getStepsPerMm();
+    meta.calibFactor = scaleManager.getCalibFactor();
+    meta.tareOffset = (int32_t)scaleManager.getOffset();
+    meta.zeroSteps = (int32_t)zeroReferenceSteps;
+
+    ResultRecordHeader h = {};
+    h.uptimeMs = millis();
+    h.kKgfMm = lastResult.kKgfMm;
+    h.r2 = lastResult.r2;
+    h.maxForceKg = lastResult.maxForceKg;
+    if (!lastResult.positionVerified) {
+        h.verdict = STORED_VERDICT_INVALID;
+    } else if (lastResult.hasLimits) {
+        h.verdict = lastResult.passed ? STORED_VERDICT_PASS : STORED_VERDICT_FAIL;
+    } else {
+        h.verdict = STORED_VERDICT_NO_LIMITS;
+    }
+    h.reason = (uint8_t)lastResult.verdictReason;
+    h.flags = lastResult.earlyRejected ? RESULT_FLAG_EARLY_REJECT : 0;
+    strncpy(h.profile, profile.settings().name, RESULT_PROFILE_NAME_MAX);
+
+    if (resultStore.append(h, meta, samples.data(), samples.size())) {
+        Serial.print("[STORE] Teste gravado: registro ");
+        Serial.println((unsigned long)h.seq);
+    }
 }
 
 // ============== EXIBE RESULTADOS ==============
@@ -902,14 +1278,27 @@ void TestMolaGrafset::executeStateShowResults() {
         }
     }
 
-    if (encoderManager.wasButtonClicked()) {
-        Serial.println("[TESTE] Usuário confirmou.");
+    // Remoto: não aguarda clique (a retirada da mola fica com o PC de linha)
+    if (remoteMode || encoderManager.wasButtonClicked()) {
+        Serial.println(remoteMode ? "[TESTE] Modo remoto: resultado concluido." : "[TESTE] Usuário confirmou.");
         userConfirmedRemoval = true;
         
         // Exibe resumo final
         uiManager.clearScreen();
         uiManager.drawText("=== Teste Concluido ===", 20, 30, TFT_GREEN, 3);
         uiManager.drawText("", 10, 80, TFT_WHITE, 2);
+        if (!lastResult.positionVerified) {
+            uiManager.drawText("INVALIDO: passos perdidos", 20, 70, TFT_RED, 2);
+        } else if (lastResult.hasLimits) {
+            char verdictDisplay[48];
+            if (lastResult.passed) {
+                snprintf(verdictDisplay, sizeof(verdictDisplay), "APROVADO");
+            } else {
+                snprintf(verdictDisplay, sizeof(verdictDisplay), "REPROVADO: %s",
+                         verdictReasonName(lastResult.verdictReason));
+            }
+            uiManager.drawText(verdictDisplay, 20, 70, lastResult.passed ? TFT_GREEN : TFT_RED, 2);
+        }
         
         char kNewtons[64];
         snprintf(kNewtons, sizeof(kNewtons), "K: %.3f N/mm", lastK_N_mm);
@@ -928,7 +1317,24 @@ void TestMolaGrafset::executeStateShowResults() {
         snprintf(forceDisplay, sizeof(forceDisplay), "Forca max: %.2f kg", lastForceKg);
         uiManager.drawText(forceDisplay, 90, 200, TFT_WHITE, 2);
         
-        uiManager.drawText("", 10, 200, TFT_WHITE, 2);
+        // Mola progressiva/dupla taxa: mostra taxa de cada segmento e quebras
+        const PiecewiseFit& pw = lastResult.piecewise;
+        if (pw.valid && pw.segments > 1) {
+            char segDisplay[64];
+            int len = snprintf(segDisplay, sizeof(segDisplay), "Progressiva K:");
+            for (int s = 0; s < pw.segments && len < (int)sizeof(segDisplay); ++s) {
+                len += snprintf(segDisplay + len, sizeof(segDisplay) - len, " %.2f", pw.rateKgfMm[s]);
+            }
+            uiManager.drawText(segDisplay, 40, 225, TFT_ORANGE, 2);
+
+            char brkDisplay[64];
+            len = snprintf(brkDisplay, sizeof(brkDisplay), "Quebras (mm):");
+            for (int s = 0; s + 1 < pw.segments && len < (int)sizeof(brkDisplay); ++s) {
+                len += snprintf(brkDisplay + len, sizeof(brkDisplay) - len, " %.1f", pw.breakMm[s]);
+            }
+            uiManager.drawText(brkDisplay, 40, 250, TFT_ORANGE, 2);
+        }
+
         uiManager.drawText("Click no botao para menu", 100, 285, TFT_YELLOW, 2);
         
         Serial.println("[TESTE] Teste de mola concluido com sucesso!");
@@ -0,0 +1,226 @@
+#include "test_profile.h"
+#include <cstring>
+
+static uint16_t readU16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+int profileOperandSize(uint8_t op) {
+    switch (op) {
+        case PROFILE_OP_END:         return 0;
+        case PROFILE_OP_COURSE:      return 2;
+        case PROFILE_OP_CONTACT:     return 2;
+        case PROFILE_OP_APPROACH:    return 2;
+        case PROFILE_OP_LIMIT_FORCE: return 2;
+        case PROFILE_OP_LIMIT_K:     return 4;
+        case PROFILE_OP_K_NOMINAL:   return 4;
+        case PROFILE_OP_FORCE_AT:    return 6;
+        case PROFILE_OP_FREE_LENGTH: return 4;
+        case PROFILE_OP_SPEED:       return 2;
+        case PROFILE_OP_FILTER:      return 5;
+        case PROFILE_OP_SAMPLE:      return 2;
+        case PROFILE_OP_RANGE:       return 6;
+        case PROFILE_OP_DWELL:       return 2;
+        default:                     return -1;
+    }
+}
+
+// Valores do teste original (moveToPositionMm padrão, média de 5, 100 ms + 5x20 ms)
+void ProfileInterpreter::resetModal() {
+    _usDelay = 800;
+    _average = 5;
+    _settleMs = 100;
+    _readIntervalMs = 20;
+    _sampleIndex = 0;
+    _inRange = false;
+}
+
+bool ProfileInterpreter::load(const uint8_t* program, size_t size) {
+    _program = nullptr;
+    _error = nullptr;
+    memset(&_settings, 0, sizeof(_settings));
+
+    if (!program || size < 5) return fail("programa vazio");
+    if (program[0] != PROFILE_MAGIC0 || program[1] != PROFILE_MAGIC1) return fail("magic invalido");
+    if (program[2] != PROFILE_VERSION) return fail("versao nao suportada");
+
+    size_t nameLen = program[3];
+    if (nameLen > PROFILE_NAME_MAX || 4 + nameLen >= size) return fail("nome invalido");
+    memcpy(_settings.name, program + 4, nameLen);
+    _settings.name[nameLen] = '\0';
+
+    // Passe único: valida opcodes/tamanhos, extrai configuração e conta pontos
+    size_t pc = 4 + nameLen;
+    uint16_t maxCmm = 0;
+    uint16_t maxCheckCmm = 0;
+    uint32_t samples = 0;
+    bool ended = false;
+    while (pc < size) {
+        uint8_t op = program[pc++];
+        int len = profileOperandSize(op);
+        if (len < 0) return fail("opcode desconhecido");
+        if (pc + (size_t)len > size) return fail("operando truncado");
+        const uint8_t* a = program + pc;
+        pc += (size_t)len;
+
+        switch (op) {
+            case PROFILE_OP_END:
+                ended = true;
+                break;
+            case PROFILE_OP_COURSE:
+                _settings.courseMm = readU16(a) / 100.0f;
+                break;
+            case PROFILE_OP_CONTACT:
+                _settings.contactForceKg = readU16(a) / 1000.0f;
+                break;
+            case PROFILE_OP_APPROACH:
+                _settings.approachUsDelay = readU16(a);
+                break;
+            case PROFILE_OP_LIMIT_FORCE:
+                _settings.maxForceKg = readU16(a) / 1000.0f;
+                break;
+            case PROFILE_OP_LIMIT_K:
+                _settings.kMinKgfMm = readU16(a) / 1000.0f;
+                _settings.kMaxKgfMm = readU16(a + 2) / 1000.0f;
+                if (_settings.kMaxKgfMm < _settings.kMinKgfMm) return fail("limite de K invertido");
+                break;
+            case PROFILE_OP_K_NOMINAL: {
+                float nominal = readU16(a) / 1000.0f;
+                float tol = readU16(a + 2) / 1000.0f;
+                if (nominal <= 0.0f || tol >= 1.0f) return fail("K nominal invalido");
+                _settings.kNominalKgfMm = nominal;
+                _settings.kMinKgfMm = nominal * (1.0f - tol);
+                _settings.kMaxKgfMm = nominal * (1.0f + tol);
+                break;
+            }
+            case PROFILE_OP_FORCE_AT: {
+                if (_settings.forceCheckCount >= PROFILE_MAX_FORCE_CHECKS) return fail("checagens de forca demais");
+                uint16_t x = readU16(a);
+                if (_settings.forceCheckCount > 0 &&
+                    x <= (uint16_t)(_settings.forceChecks[_settings.forceCheckCount - 1].xMm * 100.0f + 0.5f)) {
+                    return fail("checagens de forca fora de ordem");
+                }
+                ForceCheck& fc = _settings.forceChecks[_settings.forceCheckCount++];
+                fc.xMm = x / 100.0f;
+                fc.minKg = readU16(a + 2) / 1000.0f;
+                fc.maxKg = readU16(a + 4) / 1000.0f;
+                if (fc.maxKg < fc.minKg) return fail("faixa de forca invertida");
+                if (x > maxCheckCmm) maxCheckCmm = x;
+                break;
+            }
+            case PROFILE_OP_FREE_LENGTH:
+                _settings.freeLengthMm = readU16(a) / 100.0f;
+                _settings.freeLengthTolMm = readU16(a + 2) / 100.0f;
+                break;
+            case PROFILE_OP_FILTER:
+                if (a[0] == 0) return fail("filtro sem leituras");
+                break;
+            case PROFILE_OP_SAMPLE: {
+                uint16_t p = readU16(a);
+                if (p > maxCmm) maxCmm = p;
+                ++samples;
+                break;
+            }
+            case PROFILE_OP_RANGE: {
+                uint16_t from = readU16(a);
+                uint16_t to = readU16(a + 2);
+                uint16_t step = readU16(a + 4);
+                if (step == 0 || to < from) return fail("faixa invalida");
+                if (to > maxCmm) maxCmm = to;
+                samples += (uint32_t)(to - from) / step + 1;
+                break;
+            }
+            default:
+                break;
+        }
+        if (ended) break;
+    }
+
+    if (!ended) return fail("sem END");
+    if (_settings.courseMm <= 0.0f) return fail("curso nao definido");
+    if (_settings.contactForceKg <= 0.0f) return fail("forca de contato nao definida");
+    if (_settings.approachUsDelay == 0) _settings.approachUsDelay = 100;  // busca original
+    if (maxCmm / 100.0f > _settings.courseMm) return fail("ponto alem do curso");
+    if (maxCheckCmm > maxCmm) return fail("checagem de forca alem do ultimo ponto");
+    if (samples == 0 || samples > 0xFFFF) return fail("numero de pontos invalido");
+    _settings.sampleCount = (uint16_t)samples;
+
+    _program = program;
+    _size = size;
+    _bodyStart = 4 + nameLen;
+    rewind();
+    return true;
+}
+
+void ProfileInterpreter::rewind() {
+    _pc = _bodyStart;
+    resetModal();
+}
+
+void ProfileInterpreter::emitSample(ProfileStep* out, uint16_t cmm) {
+    out->kind = PROFILE_STEP_SAMPLE;
+    out->index = _sampleIndex++;
+    out->positionMm = cmm / 100.0f;
+    out->usDelay = _usDelay;
+    out->average = _average;
+    out->settleMs = _settleMs;
+    out->readIntervalMs = _readIntervalMs;
+    out->dwellMs = 0;
+}
+
+bool ProfileInterpreter::next(ProfileStep* out) {
+    if (!_program) {
+        out->kind = PROFILE_STEP_END;
+        return false;
+    }
+
+    if (_inRange) {
+        uint16_t p = (uint16_t)_rangeNext;
+        _rangeNext += _rangeStep;
+        if (_rangeNext > _rangeEnd) _inRange = false;
+        emitSample(out, p);
+        return true;
+    }
+
+    // Programa já validado em load(): só decodifica
+    while (_pc < _size) {
+        uint8_t op = _program[_pc++];
+        const uint8_t* a = _program + _pc;
+        _pc += (size_t)profileOperandSize(op);
+
+        switch (op) {
+            case PROFILE_OP_SPEED:
+                _usDelay = readU16(a);
+                break;
+            case PROFILE_OP_FILTER:
+                _average = a[0];
+                _settleMs = readU16(a + 1);
+                _readIntervalMs = readU16(a + 3);
+                break;
+            case PROFILE_OP_SAMPLE:
+                emitSample(out, readU16(a));
+                return true;
+            case PROFILE_OP_RANGE: {
+                uint16_t from = readU16(a);
+                _rangeEnd = readU16(a + 2);
+                _rangeStep = readU16(a + 4);
+                _rangeNext = (uint32_t)from + _rangeStep;
+                _inRange = _rangeNext <= _rangeEnd;
+                emitSample(out, from);
+                return true;
+            }
+            case PROFILE_OP_DWELL:
+                out->kind = PROFILE_STEP_DWELL;
+                out->dwellMs = readU16(a);
+                return true;
+            case PROFILE_OP_END:
+                _pc = _size;
+                break;
+            default:
+                break;   // configuração: já extraída em load()
+        }
+    }
+
+    out->kind = PROFILE_STEP_END;
+    return false;
+}
@@ -1,8 +1,44 @@
 #include "tmc2209_manager.h"
 #include "config.h"
+#include "fast_io.h"
 
 TMC2209Manager tmc2209Manager;
 
+// Resistor de sense em ohms (config.h guarda em mOhm)
+static constexpr float TMC_R_SENSE_OHM = TMC_R_SENSE / 1000.0f;
+
+// MRES (CHOPCONF[27:24]): 0 = 256 microsteps ... 8 = passo inteiro
+static uint32_t microstepsToMres(uint16_t microsteps) {
+    switch (microsteps) {
+        case 256: return 0;
+        case 128: return 1;
+        case 64:  return 2;
+        case 32:  return 3;
+        case 16:  return 4;
+        case 8:   return 5;
+        case 4:   return 6;
+        case 2:   return 7;
+        default:  return 8;
+    }
+}
+
+static uint16_t mresToMicrosteps(uint32_t mres) {
+    return (mres <= 8) ? (uint16_t)(256u >> mres) : 1;
+}
+
+// Mesmo cálculo do TMCStepper::rms_current(): escala CS (0-31) e VSENSE
+static uint8_t currentScale(uint16_t mA, bool* outVsense) {
+    float cs = 32.0f * 1.41421f * mA / 1000.0f * (TMC_R_SENSE_OHM + 0.02f) / 0.325f - 1.0f;
+    *outVsense = false;
+    if (cs < 16.0f) {
+        *outVsense = true;
+        cs = 32.0f * 1.41421f * mA / 1000.0f * (TMC_R_SENSE_OHM + 0.02f) / 0.180f - 1.0f;
+    }
+    if (cs < 0.0f) cs = 0.0f;
+    if (cs > 31.0f) cs = 31.0f;
+    return (uint8_t)cs;
+}
+
 bool TMC2209Manager::begin() {
 #ifdef ARDUINO_ARCH_ESP32
     if (!TMC_UART_ENABLED) {
@@ -13,37 +49,46 @@ bool TMC2209Manager::begin() {
     serialTMC.begin(TMC_UART_BAUD, SERIAL_8N1, TMC_UART_RX_PIN, TMC_UART_TX_PIN);
     _serial = &serialTMC;
 
-    _driver = new TMC2209Stepper(_serial, TMC_R_SENSE, TMC_UART_ADDR);
+    if (!_uartMutex) {
+        _uartMutex = xSemaphoreCreateMutex();
+    }
+
+    _driver = new TMC2209Stepper(_serial, TMC_R_SENSE_OHM, TMC_UART_ADDR);
     _driver->begin();
     _driver->pdn_disable(true);       // PDN pin high -> habilita UART
     _driver->I_scale_analog(false);   // Usa VIO para current scale
     _driver->toff(4);                 // Driver ON (chopper)
 
-    // Corrente RMS e hold (holdMultiplier usa fração da RMS)
-    float holdMult = (float)TMC_CURRENT_HOLD / (float)TMC_CURRENT_RMS;
-    holdMult = constrain(holdMult, 0.0f, 1.0f);
-    _driver->rms_current(TMC_CURRENT_RMS, holdMult);
-
-    // Microsteps
-    _driver->microsteps(TMC_DEFAULT_MICROSTEPS);
+    int conn = _driver->test_connection();
+    if (conn != 0) {
+        delete _driver;
+        _driver = nullptr;
+        return false;
+    }
+    _commOk = true;
 
-    // StallGuard threshold
-    _driver->SGTHRS(TMC_STALLGUARD_THRESHOLD);
+    // GCONF/CHOPCONF são legíveis: partem do valor real do driver. Os
+    // registradores só de escrita partem de 0 e são enviados abaixo.
+    _regs.seed(TMC_REG_GCONF, _driver->GCONF());
+    _regs.seed(TMC_REG_CHOPCONF, _driver->CHOPCONF());
+    _regs.seed(TMC_REG_IHOLD_IRUN, 0);
+    _regs.seed(TMC_REG_TCOOLTHRS, 0);
+    _regs.seed(TMC_REG_SGTHRS, 0);
 
+    setCurrent(TMC_CURRENT_RMS, TMC_CURRENT_HOLD);
+    setMicrosteps(TMC_DEFAULT_MICROSTEPS);
+    setStallGuardThreshold(TMC_STALLGUARD_THRESHOLD);
+    // TCOOLTHRS máximo: StallGuard/DIAG ativos em qualquer velocidade de passo
+    writeReg(TMC_REG_TCOOLTHRS, 0xFFFFF);
     // Modo silencioso padrão
-    _driver->en_spreadCycle(false); // false -> stealthChop ON
+    enableStealthChop(true);
 
-    pinMode(TMC_DIAG_PIN, INPUT_PULLUP);
+    pinMode(TMC_DIAG_PIN, INPUT);
 
     _stallDetectedFlag = false;
     _stallUntreated = false;
     _lastStallTime = 0;
 
-    int conn = _driver->test_connection();
-    if (conn != 0) {
-        return false;
-    }
-
     Serial.println("[TMC2209] UART inicializada");
     return true;
 #else
@@ -51,27 +96,135 @@ bool TMC2209Manager::begin() {
 #endif
 }
 
+bool TMC2209Manager::isReady() const {
+    return _driver != nullptr;
+}
+
+bool TMC2209Manager::lockUart(TickType_t timeout) {
+    if (!_uartMutex) return true;
+    return xSemaphoreTake(_uartMutex, timeout) == pdTRUE;
+}
+
+void TMC2209Manager::unlockUart() {
+    if (_uartMutex) xSemaphoreGive(_uartMutex);
+}
+
+// ---- Registradores shadow ----
+
+void TMC2209Manager::writeReg(TmcReg reg, uint32_t value) {
+    portENTER_CRITICAL(&_regsMux);
+    _regs.write(reg, value);
+    portEXIT_CRITICAL(&_regsMux);
+
+    if (!_asyncService) {
+        service();
+    }
+}
+
+void TMC2209Manager::modifyReg(TmcReg reg, uint32_t clearMask, uint32_t setBits) {
+    portENTER_CRITICAL(&_regsMux);
+    uint32_t value = (_regs.shadow(reg) & ~clearMask) | setBits;
+    _regs.write(reg, value);
+    portEXIT_CRITICAL(&_regsMux);
+
+    if (!_asyncService) {
+        service();
+    }
+}
+
+void TMC2209Manager::sendReg(TmcReg reg, uint32_t value) {
+    switch (reg) {
+        case TMC_REG_GCONF:      _driver->GCONF(value); break;
+        case TMC_REG_IHOLD_IRUN: _driver->IHOLD_IRUN(value); break;
+        case TMC_REG_CHOPCONF:   _driver->CHOPCONF(value); break;
+        case TMC_REG_TCOOLTHRS:  _driver->TCOOLTHRS(value); break;
+        case TMC_REG_SGTHRS:     _driver->SGTHRS((uint8_t)value); break;
+        default: break;
+    }
+    ++_uartTransactions;
+}
+
+void TMC2209Manager::service() {
+    if (!_driver) return;
+
+    TmcReg reg;
+    uint32_t value;
+    for (;;) {
+        portENTER_CRITICAL(&_regsMux);
+        bool pending = _regs.takePending(&reg, &value);
+        portEXIT_CRITICAL(&_regsMux);
+        if (!pending) break;
+
+        lockUart();
+        sendReg(reg, value);
+        unlockUart();
+
+        portENTER_CRITICAL(&_regsMux);
+        _regs.commit(reg, value);
+        portEXIT_CRITICAL(&_regsMux);
+    }
+}
+
+void TMC2209Manager::setAsyncService(bool enable) {
+    _asyncService = enable;
+    if (!enable) {
+        service();
+    }
+}
+
+bool TMC2209Manager::waitFlushed(uint32_t timeoutMs) {
+    if (!_asyncService) {
+        service();
+        return true;
+    }
+    unsigned long t0 = millis();
+    for (;;) {
+        portENTER_CRITICAL(&_regsMux);
+        bool pending = _regs.hasPending();
+        portEXIT_CRITICAL(&_regsMux);
+        if (!pending) return true;
+        if ((millis() - t0) >= timeoutMs) return false;
+        vTaskDelay(1);
+    }
+}
+
+// ---- Configuração (só altera shadow; UART fica com service()) ----
+
 void TMC2209Manager::setCurrent(uint16_t currentRMS, uint16_t currentHold) {
     if (!_driver) return;
     float holdMult = (float)currentHold / (float)currentRMS;
     holdMult = constrain(holdMult, 0.0f, 1.0f);
-    _driver->rms_current(currentRMS, holdMult);
+
+    bool vsense = false;
+    uint8_t irun = currentScale(currentRMS, &vsense);
+    uint8_t ihold = (uint8_t)(irun * holdMult);
+
+    modifyReg(TMC_REG_CHOPCONF, TMC_CHOPCONF_VSENSE, vsense ? TMC_CHOPCONF_VSENSE : 0);
+    modifyReg(TMC_REG_IHOLD_IRUN, TMC_IHOLD_MASK | TMC_IRUN_MASK,
+              ((uint32_t)ihold & TMC_IHOLD_MASK) | ((uint32_t)irun << TMC_IRUN_SHIFT));
 }
 
 void TMC2209Manager::setMicrosteps(uint16_t microsteps) {
     if (!_driver) return;
-    _driver->microsteps(microsteps);
+    modifyReg(TMC_REG_CHOPCONF, TMC_CHOPCONF_MRES_MASK,
+              microstepsToMres(microsteps) << TMC_CHOPCONF_MRES_SHIFT);
 }
 
 void TMC2209Manager::setStallGuardThreshold(uint8_t threshold) {
     if (!_driver) return;
-    _driver->SGTHRS(threshold);
+    writeReg(TMC_REG_SGTHRS, threshold);
+}
+
+void TMC2209Manager::enableStealthChop(bool enable) {
+    if (!_driver) return;
+    modifyReg(TMC_REG_GCONF, TMC_GCONF_EN_SPREADCYCLE, enable ? 0 : TMC_GCONF_EN_SPREADCYCLE);
 }
 
 bool TMC2209Manager::isStallDetected() {
     if (!_driver) return false;
 
-    bool detected = (digitalRead(TMC_DIAG_PIN) == LOW);
+    // Lido a cada passo do homing sem sensor: acesso direto ao registrador
+    bool detected = (FastPin<TMC_DIAG_PIN>::read() == (TMC_DIAG_STALL_LEVEL != 0));
     if (detected) {
         _stallDetectedFlag = true;
         _stallUntreated = true;
@@ -94,33 +247,59 @@ void TMC2209Manager::markStallTreated() {
 
 int TMC2209Manager::getStallGuardValue() {
     if (!_driver) return -1;
-    return _driver->SG_RESULT();
+    if (_asyncService) {
+        return _lastSg;
+    }
+    uint16_t sg = 0;
+    return readStallGuard(&sg) ? (int)sg : -1;
 }
 
-bool TMC2209Manager::isCommunicationOK() {
+bool TMC2209Manager::readStallGuard(uint16_t* out) {
+    if (!_driver) return false;
+    // Não espera: se a UART estiver ocupada, pula esta leitura
+    if (!lockUart(0)) return false;
+    *out = _driver->SG_RESULT();
+    ++_uartTransactions;
+    unlockUart();
+    _lastSg = *out;
+    return true;
+}
+
+bool TMC2209Manager::readMicrostepCounter(uint16_t* out) {
     if (!_driver) return false;
-    return (_driver->test_connection() == 0);
+    if (!lockUart(pdMS_TO_TICKS(5))) return false;
+    *out = _driver->MSCNT();
+    ++_uartTransactions;
+    unlockUart();
+    return true;
 }
 
-void TMC2209Manager::enableStealthChop(bool enable) {
-    if (!_driver) return;
-    _driver->en_spreadCycle(!enable);
+bool TMC2209Manager::isCommunicationOK() {
+    return _driver && _commOk;
 }
 
-String TMC2209Manager::getDiagnostics() {
+int TMC2209Manager::getDiagnostics(char* buf, size_t len) {
     if (!_driver) {
-        return String("[TMC2209] UART desabilitada (TMC_UART_ENABLED=false)");
+        return snprintf(buf, len, "[TMC2209] UART desabilitada (TMC_UART_ENABLED=false)");
     }
 
-    String diag;
-    diag.reserve(128);
-    diag += "[TMC2209] ";
-    diag += isCommunicationOK() ? "OK" : "FAIL";
-    diag += " | RMS="; diag += TMC_CURRENT_RMS;
-    diag += "mA | HOLD="; diag += TMC_CURRENT_HOLD; diag += "mA";
-    diag += " | uSteps="; diag += TMC_DEFAULT_MICROSTEPS;
-    diag += " | SGTHRS="; diag += TMC_STALLGUARD_THRESHOLD;
-    diag += " | SG_RESULT="; diag += getStallGuardValue();
-    return diag;
-}
+    // Apenas valores em cache: nenhuma transação UART
+    portENTER_CRITICAL(&_regsMux);
+    uint32_t chopconf = _regs.shadow(TMC_REG_CHOPCONF);
+    uint32_t iholdIrun = _regs.shadow(TMC_REG_IHOLD_IRUN);
+    uint32_t sgthrs = _regs.shadow(TMC_REG_SGTHRS);
+    uint32_t requested = _regs.requested();
+    uint32_t flushed = _regs.flushed();
+    portEXIT_CRITICAL(&_regsMux);
 
+    return snprintf(buf, len,
+                    "[TMC2209] %s | IRUN=%u | IHOLD=%u | uSteps=%u | SGTHRS=%u | SG_RESULT=%d | wr %lu/%lu",
+                    isCommunicationOK() ? "OK" : "FAIL",
+                    (unsigned)((iholdIrun & TMC_IRUN_MASK) >> TMC_IRUN_SHIFT),
+                    (unsigned)(iholdIrun & TMC_IHOLD_MASK),
+                    (unsigned)mresToMicrosteps((chopconf & TMC_CHOPCONF_MRES_MASK) >> TMC_CHOPCONF_MRES_SHIFT),
+                    (unsigned)sgthrs,
+                    (int)_lastSg,
+                    (unsigned long)flushed,
+                    (unsigned long)requested);
+}
@@ -0,0 +1,115 @@
+#include "trace_probe.h"
+#include <cstdio>
+
+#if PROBES_ENABLED
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+static ProbeStats s_stats[PROBE_COUNT];
+
+static const char* const PROBE_NAMES[PROBE_COUNT] = {
+    "loop",
+    "scale.update",
+    "ui.drawTestStatus",
+    "ui.plotGraphPoint",
+    "grafset.tick",
+    "mola.compressionStep",
+    "stepper.move",
+    "spc.add",
+    "ui.spcUpdate",
+    "export.frame"
+};
+
+uint32_t probeNowTicks() {
+#ifdef ARDUINO
+    return ESP.getCycleCount();
+#else
+    // Nativo: 1 tick = 1 ns (wrap a cada ~4 s, suficiente para escopos curtos)
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+static uint32_t ticksPerUs() {
+#ifdef ARDUINO
+    return ESP.getCpuFreqMHz();
+#else
+    return 1000;
+#endif
+}
+
+static int bucketForUs(uint32_t us) {
+    int b = 0;
+    while (us != 0 && b < PROBE_HIST_BUCKETS - 1) {
+        us >>= 1;
+        b++;
+    }
+    return b;
+}
+
+void probeRecord(ProbeId id, uint32_t ticks) {
+    ProbeStats& s = s_stats[id];
+    if (s.count == 0 || ticks < s.minTicks) s.minTicks = ticks;
+    if (ticks > s.maxTicks) s.maxTicks = ticks;
+    s.sumTicks += ticks;
+    s.count++;
+    s.hist[bucketForUs(ticks / ticksPerUs())]++;
+}
+
+void probeReset() {
+    for (int i = 0; i < PROBE_COUNT; ++i) {
+        s_stats[i] = ProbeStats();
+    }
+}
+
+const ProbeStats& probeStats(ProbeId id) {
+    return s_stats[id];
+}
+
+const char* probeName(ProbeId id) {
+    return (id < PROBE_COUNT) ? PROBE_NAMES[id] : "?";
+}
+
+void probeDump(void (*writeLine)(const char* line)) {
+    char line[160];
+    uint32_t tpu = ticksPerUs();
+
+    for (int i = 0; i < PROBE_COUNT; ++i) {
+        const ProbeStats& s = s_stats[i];
+        if (s.count == 0) continue;
+
+        snprintf(line, sizeof(line), "PROBE %s n=%lu min=%luus max=%luus mean=%luus",
+                 PROBE_NAMES[i],
+                 (unsigned long)s.count,
+                 (unsigned long)(s.minTicks / tpu),
+                 (unsigned long)(s.maxTicks / tpu),
+                 (unsigned long)(s.sumTicks / s.count / tpu));
+        writeLine(line);
+
+        // Histograma: apenas baldes não vazios, "<limite_superior_us:contagem";
+        // o último balde não tem limite superior (">=limite_inferior_us:contagem")
+        int len = snprintf(line, sizeof(line), "HIST %s", PROBE_NAMES[i]);
+        for (int b = 0; b < PROBE_HIST_BUCKETS && len < (int)sizeof(line); ++b) {
+            if (s.hist[b] == 0) continue;
+            bool last = (b == PROBE_HIST_BUCKETS - 1);
+            len += snprintf(line + len, sizeof(line) - len, last ? " >=%lu:%lu" : " <%lu:%lu",
+                            (unsigned long)(1UL << (last ? b - 1 : b)), (unsigned long)s.hist[b]);
+        }
+        writeLine(line);
+    }
+}
+
+#else
+
+void probeDump(void (*writeLine)(const char* line)) {
+    writeLine("PROBE desabilitado (compile com -DPROBES_ENABLED=1)");
+}
+
+void probeReset() {
+}
+
+#endif // PROBES_ENABLED
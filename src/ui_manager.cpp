@@ -1,5 +1,9 @@
 #include "ui_manager.h"
 #include "config.h"
+#include "trace_probe.h"
+#include "event_trace.h"
+#include "spc_stats.h"
+#include "spc_chart.h"
 
 #include <TFT_eSPI.h>
 #include <SPI.h>
@@ -50,6 +54,7 @@ UiMode UiManager::getMode() const {
 // ---- MENU ----
 
 void UiManager::drawMenu(const char* const* items, int itemCount, int selectedIndex) {
+    TRACE_EVENT(EVT_UI_BEGIN, TRACE_UI_MENU, selectedIndex);
     _mode = UI_MODE_MENU;
 
     tft.fillScreen(TFT_BLACK);
@@ -81,6 +86,7 @@ void UiManager::drawMenu(const char* const* items, int itemCount, int selectedIn
     tft.fillRect(0, 290, 480, 30, TFT_BLACK);
     tft.setCursor(10, 295);
     tft.print("Encoder: navegar | Click: selecionar");
+    TRACE_EVENT(EVT_UI_END, TRACE_UI_MENU, selectedIndex);
 }
 
 // ---- TESTE DA MOLA ----
@@ -92,6 +98,8 @@ void UiManager::drawTestStatus(float forceKg,
                                bool running,
                                bool done)
 {
+    PROBE_SCOPE(PROBE_UI_DRAW_TEST_STATUS);
+    TRACE_EVENT(EVT_UI_BEGIN, TRACE_UI_TEST_STATUS, 0);
     _mode = UI_MODE_TEST;
 
     // Cabeçalho em linha única
@@ -139,6 +147,7 @@ void UiManager::drawTestStatus(float forceKg,
     tft.setTextColor(TFT_DARKGREY, TFT_BLACK);
     tft.setCursor(200, 295);
     tft.print("Click:menu");
+    TRACE_EVENT(EVT_UI_END, TRACE_UI_TEST_STATUS, 0);
 }
 
 // Limpa área de gráfico maximizada ao limite
@@ -180,9 +189,9 @@ void UiManager::clearGraphArea() {
     lastPointValidYellow = false;
 }
 
-void UiManager::drawKValueAtStep(int step, float k_kgf_mm, float k_N_mm) {
-    // Desenha o valor de K para o passo atual na lista lateral
-    int yPos = K_VALUES_Y0 + (step * 18);  // 18 pixels de espaçamento vertical
+void UiManager::drawKValueAtStep(int row, float xMm, float k_kgf_mm, float k_N_mm) {
+    // Desenha o valor de K para o ponto atual na lista lateral
+    int yPos = K_VALUES_Y0 + (row * 18);  // 18 pixels de espaçamento vertical
     
     // Limita para não sair da tela (máximo ~12 linhas)
     if (yPos > (K_VALUES_Y0 + 200)) return;
@@ -191,7 +200,7 @@ void UiManager::drawKValueAtStep(int step, float k_kgf_mm, float k_N_mm) {
     int x = K_VALUES_X;
 
     char bufN[26];
-    snprintf(bufN, sizeof(bufN), "%dmm: %.2fN/mm", step, k_N_mm);
+    snprintf(bufN, sizeof(bufN), "%gmm: %.2fN/mm", xMm, k_N_mm);
     tft.setTextColor(TFT_YELLOW, TFT_BLACK);  // N/mm em amarelo
     tft.setCursor(x, yPos);
     tft.print(bufN);
@@ -206,6 +215,8 @@ void UiManager::drawKValueAtStep(int step, float k_kgf_mm, float k_N_mm) {
 
 // Adiciona ponto no gráfico (desloc x força, normalizado)
 void UiManager::plotGraphPoint(float xNorm, float yNorm, bool firstPoint) {
+    PROBE_SCOPE(PROBE_UI_PLOT_POINT);
+    TRACE_EVENT(EVT_UI_BEGIN, TRACE_UI_GRAPH_POINT, 0);
     if (xNorm < 0.0f) xNorm = 0.0f;
     if (xNorm > 1.0f) xNorm = 1.0f;
     if (yNorm < 0.0f) yNorm = 0.0f;
@@ -224,6 +235,7 @@ void UiManager::plotGraphPoint(float xNorm, float yNorm, bool firstPoint) {
         lastPx = px;
         lastPy = py;
     }
+    TRACE_EVENT(EVT_UI_END, TRACE_UI_GRAPH_POINT, 0);
 }
 
 // ---- TELA DE CALIBRAÇÃO ----
@@ -416,3 +428,64 @@ void UiManager::clearStallAlert() {
 
 
 
+
+// ---- TELA DE CEP (SPC) DO LOTE ----
+// Desenho em SpcChartView (spc_chart.h); aqui só as primitivas da TFT
+static void spcFillScreen(uint16_t color, void*) {
+    tft.fillScreen(color);
+}
+
+static void spcFillRect(int x, int y, int w, int h, uint16_t color, void*) {
+    tft.fillRect(x, y, w, h, color);
+}
+
+static void spcDrawRect(int x, int y, int w, int h, uint16_t color, void*) {
+    tft.drawRect(x, y, w, h, color);
+}
+
+static void spcHLine(int x, int y, int w, uint16_t color, void*) {
+    tft.drawFastHLine(x, y, w, color);
+}
+
+static void spcLine(int x0, int y0, int x1, int y1, uint16_t color, void*) {
+    tft.drawLine(x0, y0, x1, y1, color);
+}
+
+static void spcFillCircle(int x, int y, int r, uint16_t color, void*) {
+    tft.fillCircle(x, y, r, color);
+}
+
+static void spcText(int x, int y, uint8_t size, uint16_t color, const char* str, void*) {
+    tft.setTextSize(size);
+    tft.setTextColor(color, TFT_BLACK);
+    tft.setCursor(x, y);
+    tft.print(str);
+}
+
+static const SpcCanvas s_spcCanvas = {
+    spcFillScreen, spcFillRect, spcDrawRect, spcHLine, spcLine, spcFillCircle, spcText, nullptr
+};
+static SpcChartView s_spcView;
+
+void UiManager::drawSpcScreen(const SpcBatch& batch) {
+    PROBE_SCOPE(PROBE_UI_SPC_UPDATE);
+    TRACE_EVENT(EVT_UI_BEGIN, TRACE_UI_SPC, 1);
+    _mode = UI_MODE_TEST;
+    s_spcView.draw(batch, s_spcCanvas);
+    TRACE_EVENT(EVT_UI_END, TRACE_UI_SPC, 1);
+}
+
+void UiManager::updateSpcScreen(const SpcBatch& batch) {
+    if (s_spcView.needsRedraw(batch)) {
+        drawSpcScreen(batch);
+        return;
+    }
+    PROBE_SCOPE(PROBE_UI_SPC_UPDATE);
+    TRACE_EVENT(EVT_UI_BEGIN, TRACE_UI_SPC, 0);
+    s_spcView.drawNew(batch, s_spcCanvas);
+    TRACE_EVENT(EVT_UI_END, TRACE_UI_SPC, 0);
+}
+
+void UiManager::invalidateSpcScreen() {
+    s_spcView.invalidate();
+}
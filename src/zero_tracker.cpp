@@ -0,0 +1,147 @@
+#include "zero_tracker.h"
+#include <cmath>
+
+// Incerteza inicial (contagens², (contagens/h)², (contagens/°C)²); também é o
+// teto da diagonal de P, que sem excitação cresceria 1/λ a cada atualização
+static const float P_INIT[3] = {1.0e6f, 1.0e4f, 1.0e4f};
+
+// Fração do viés da tara mantida a cada observação aceita
+static const float BIAS_DECAY = 0.5f;
+
+void ZeroTracker::begin(const ZeroTrackerConfig& cfg) {
+    _cfg = cfg;
+    _anchored = false;
+    _hasTemp = false;
+    for (int i = 0; i < 3; ++i) {
+        _theta[i] = 0.0f;
+        for (int j = 0; j < 3; ++j) _P[i][j] = (i == j) ? P_INIT[i] : 0.0f;
+    }
+    _windowCount = 0;
+    _windowHead = 0;
+    _observedOnce = false;
+    _bias = 0.0f;
+    _accepted = 0;
+    _rejected = 0;
+}
+
+void ZeroTracker::tare(float offsetCounts, uint32_t nowMs, float tempC) {
+    _windowCount = 0;
+    if (!_anchored) {
+        // Primeira tara: origem de tempo e temperatura do modelo
+        _anchored = true;
+        _originMs = nowMs;
+        _hasTemp = !std::isnan(tempC);
+        _originTempC = _hasTemp ? tempC : 0.0f;
+        _theta[0] = offsetCounts;
+        _P[0][0] = _cfg.stableCounts * _cfg.stableCounts;
+        _bias = 0.0f;
+        return;
+    }
+
+    float phi[3];
+    regressors(nowMs, tempC, phi);
+    float model = _theta[0] + _theta[1] * phi[1] + _theta[2] * phi[2];
+    if (fabsf(offsetCounts - model) > _cfg.maxJumpCounts) {
+        // Degrau (fixação trocada, célula remontada): desloca a e reabre sua
+        // incerteza; b e c continuam
+        _theta[0] += offsetCounts - model;
+        for (int i = 0; i < 3; ++i) {
+            _P[0][i] = 0.0f;
+            _P[i][0] = 0.0f;
+        }
+        _P[0][0] = P_INIT[0];
+        _bias = 0.0f;
+        return;
+    }
+    rlsUpdate(phi, offsetCounts);
+    _bias = offsetCounts - (_theta[0] + _theta[1] * phi[1] + _theta[2] * phi[2]);
+}
+
+void ZeroTracker::regressors(uint32_t nowMs, float tempC, float phi[3]) const {
+    phi[0] = 1.0f;
+    phi[1] = (float)(nowMs - _originMs) / 3600000.0f;
+    phi[2] = (_hasTemp && !std::isnan(tempC)) ? (tempC - _originTempC) : 0.0f;
+}
+
+float ZeroTracker::offsetAt(uint32_t nowMs, float tempC) const {
+    float phi[3];
+    regressors(nowMs, tempC, phi);
+    return _theta[0] + _theta[1] * phi[1] + _theta[2] * phi[2] + _bias;
+}
+
+bool ZeroTracker::observe(int32_t raw, uint32_t nowMs, float tempC) {
+    if (!_anchored) return false;
+
+    _window[_windowHead] = raw;
+    _windowHead = (_windowHead + 1) % ZERO_TRACK_WINDOW;
+    if (_windowCount < ZERO_TRACK_WINDOW) ++_windowCount;
+    if (_windowCount < ZERO_TRACK_WINDOW) return false;
+    if (_observedOnce && (nowMs - _lastObserveMs) < _cfg.observeIntervalMs) return false;
+    _observedOnce = true;
+    _lastObserveMs = nowMs;
+
+    // Média e desvio da janela relativos à primeira leitura (evita cancelamento)
+    float ref = (float)_window[0];
+    float sum = 0.0f;
+    float sumSq = 0.0f;
+    for (int i = 0; i < ZERO_TRACK_WINDOW; ++i) {
+        float d = (float)_window[i] - ref;
+        sum += d;
+        sumSq += d * d;
+    }
+    float meanD = sum / ZERO_TRACK_WINDOW;
+    float var = (sumSq - sum * meanD) / (ZERO_TRACK_WINDOW - 1);
+    float mean = ref + meanD;
+
+    if (var > _cfg.stableCounts * _cfg.stableCounts ||
+        fabsf(mean - offsetAt(nowMs, tempC)) > _cfg.maxJumpCounts) {
+        ++_rejected;
+        return false;
+    }
+
+    float phi[3];
+    regressors(nowMs, tempC, phi);
+    rlsUpdate(phi, mean);
+    _bias *= BIAS_DECAY;   // a célula livre confirma (ou corrige) a tara
+    ++_accepted;
+    _windowCount = 0;
+    return true;
+}
+
+void ZeroTracker::rlsUpdate(const float phi[3], float y) {
+    float Pphi[3];
+    for (int i = 0; i < 3; ++i) {
+        Pphi[i] = _P[i][0] * phi[0] + _P[i][1] * phi[1] + _P[i][2] * phi[2];
+    }
+    float denom = _cfg.forgetting + phi[0] * Pphi[0] + phi[1] * Pphi[1] + phi[2] * Pphi[2];
+    float err = y - (_theta[0] * phi[0] + _theta[1] * phi[1] + _theta[2] * phi[2]);
+
+    float gain[3];
+    for (int i = 0; i < 3; ++i) {
+        gain[i] = Pphi[i] / denom;
+        _theta[i] += gain[i] * err;
+    }
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            _P[i][j] = (_P[i][j] - gain[i] * Pphi[j]) / _cfg.forgetting;
+        }
+    }
+
+    // Simetria e teto da diagonal (anti-windup de direções sem excitação)
+    for (int i = 0; i < 3; ++i) {
+        for (int j = i + 1; j < 3; ++j) {
+            float m = 0.5f * (_P[i][j] + _P[j][i]);
+            _P[i][j] = m;
+            _P[j][i] = m;
+        }
+    }
+    for (int i = 0; i < 3; ++i) {
+        if (_P[i][i] > P_INIT[i]) {
+            float s = sqrtf(P_INIT[i] / _P[i][i]);
+            for (int j = 0; j < 3; ++j) {
+                _P[i][j] *= s;
+                _P[j][i] *= s;
+            }
+        }
+    }
+}
@@ -0,0 +1,123 @@
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+#include "boot_profile.h"
+#include "tare_estimator.h"
+#include "config.h"
+
+static BootProfile prof;
+
+void setUp() {
+    prof.begin(0);
+}
+void tearDown() {}
+
+static void test_phases_are_differences_between_marks() {
+    prof.begin(1000);
+    prof.mark("core", 3000);
+    prof.mark("serial", 3500);
+    prof.mark("menu", 10000);
+    TEST_ASSERT_EQUAL_INT(3, prof.count());
+    TEST_ASSERT_EQUAL_STRING("serial", prof.name(1));
+    TEST_ASSERT_EQUAL_UINT32(2000, prof.durationUs(0));
+    TEST_ASSERT_EQUAL_UINT32(500, prof.durationUs(1));
+    TEST_ASSERT_EQUAL_UINT32(6500, prof.durationUs(2));
+    TEST_ASSERT_EQUAL_UINT32(9000, prof.totalUs());
+}
+
+// Fases além do limite não são guardadas, mas o total continua certo
+static void test_overflow_keeps_total() {
+    for (int i = 1; i <= BootProfile::BOOT_PHASE_MAX + 3; ++i) prof.mark("x", i * 100u);
+    TEST_ASSERT_EQUAL_INT(BootProfile::BOOT_PHASE_MAX, prof.count());
+    TEST_ASSERT_EQUAL_UINT32((BootProfile::BOOT_PHASE_MAX + 3) * 100u, prof.totalUs());
+}
+
+static void test_micros_wraparound() {
+    prof.begin(0xFFFFFF00u);
+    prof.mark("core", 0x00000100u);
+    TEST_ASSERT_EQUAL_UINT32(0x200u, prof.durationUs(0));
+}
+
+// ---- Levantamento: boot em relógio virtual ----
+// Custos assumidos (não medidos aqui): TFT 180 ms, sonda do TMC 40 ms,
+// LittleFS 120 ms; HX711 a 10 SPS com ruído de 0,3 a 1,5 g.
+
+struct Rng {
+    uint32_t s = 99u;
+    float uniform() {
+        s ^= s << 13;
+        s ^= s >> 17;
+        s ^= s << 5;
+        return (float)(s >> 8) * (1.0f / 16777216.0f);
+    }
+    float gaussian() {
+        float sum = 0.0f;
+        for (int i = 0; i < 12; ++i) sum += uniform();
+        return sum - 6.0f;
+    }
+};
+
+static const uint32_t TFT_US = 180000, TMC_US = 40000, FS_US = 120000, CONV_US = 100000;
+
+// Conversões até a tara decidir (mesma configuração do ScaleManager)
+static uint32_t tareUs(Rng& rng) {
+    const float countsPerKg = 5000.0f;
+    TareConfig cfg;
+    cfg.targetSeCounts = TARE_TARGET_SE_KG * countsPerKg;
+    cfg.minSamples = TARE_MIN_SAMPLES;
+    cfg.maxSamples = TARE_MAX_SAMPLES;
+    cfg.trendT = TARE_TREND_T;
+    TareEstimator est;
+    est.begin(cfg);
+    float noise = (0.3f + 1.2f * rng.uniform()) * countsPerKg / 1000.0f;
+    while (!est.push(100000 + (int32_t)lroundf(noise * rng.gaussian()))) {}
+    return est.result().samples * CONV_US;
+}
+
+static void test_boot_timeline_benchmark() {
+    const int RUNS = 1000;
+    static uint32_t oldMs[RUNS], newMs[RUNS];
+    Rng rng;
+    for (int r = 0; r < RUNS; ++r) {
+        // Antes: delay(1000), tara síncrona de 10 leituras, delay(100), splash fixo de 5 s
+        uint32_t t = 1000000 + TFT_US + 10 * CONV_US + 100000 + TMC_US + FS_US + 5000000;
+        oldMs[r] = t / 1000;
+
+        // Agora: splash logo após o Serial, tara em paralelo no core 0
+        prof.begin(0);
+        uint32_t now = TFT_US;
+        prof.mark("display", now);
+        uint32_t splashStart = now;
+        uint32_t tareDone = now + tareUs(rng);
+        prof.mark("hx711", now);
+        now += TMC_US;
+        prof.mark("motor", now);
+        now += FS_US;
+        prof.mark("store", now);
+        uint32_t splashEnd = std::max(tareDone, splashStart + BOOT_SPLASH_MIN_MS * 1000);
+        splashEnd = std::min(splashEnd, splashStart + BOOT_SPLASH_MAX_MS * 1000);
+        now = std::max(now, splashEnd);
+        prof.mark("splash", now);
+        prof.mark("menu", now);
+        newMs[r] = prof.totalUs() / 1000;
+    }
+    std::sort(oldMs, oldMs + RUNS);
+    std::sort(newMs, newMs + RUNS);
+    char msg[160];
+    snprintf(msg, sizeof(msg), "boot ate o menu: antes %u ms | agora p50 %u ms p90 %u ms max %u ms",
+             (unsigned)oldMs[RUNS / 2], (unsigned)newMs[RUNS / 2], (unsigned)newMs[RUNS * 9 / 10],
+             (unsigned)newMs[RUNS - 1]);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE(newMs[RUNS - 1] <= (TFT_US / 1000) + BOOT_SPLASH_MAX_MS);
+    TEST_ASSERT_TRUE(newMs[RUNS / 2] * 4 < oldMs[RUNS / 2]);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_phases_are_differences_between_marks);
+    RUN_TEST(test_overflow_keeps_total);
+    RUN_TEST(test_micros_wraparound);
+    RUN_TEST(test_boot_timeline_benchmark);
+    return UNITY_END();
+}
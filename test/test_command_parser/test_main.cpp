@@ -0,0 +1,146 @@
+#include <unity.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include "command_parser.h"
+#include "config.h"
+
+static CommandParser parser;
+
+void setUp() {
+    parser = CommandParser();
+}
+void tearDown() {}
+
+// Alimenta a linha inteira; retorna quantos comandos foram entregues
+static int feedString(const char* s) {
+    int delivered = 0;
+    for (; *s; ++s) delivered += parser.feed((uint8_t)*s) ? 1 : 0;
+    return delivered;
+}
+
+static void test_verb_and_args() {
+    TEST_ASSERT_EQUAL_INT(1, feedString("start 2\r\n"));
+    const Command& c = parser.command();
+    TEST_ASSERT_EQUAL_INT(CMD_START, c.id);
+    TEST_ASSERT_EQUAL_INT(CMD_ERR_NONE, c.error);
+    TEST_ASSERT_EQUAL_STRING("START", c.verb);
+    TEST_ASSERT_EQUAL_UINT8(1, c.argc);
+    long v = -1;
+    TEST_ASSERT_TRUE(c.argInt(0, &v));
+    TEST_ASSERT_EQUAL_INT32(2, v);
+}
+
+static void test_numeric_args_and_keywords() {
+    TEST_ASSERT_EQUAL_INT(1, feedString("  JOG\t-1.25  \n"));
+    float mm = 0.0f;
+    TEST_ASSERT_TRUE(parser.command().argFloat(0, &mm));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, -1.25f, mm);
+    long bad;
+    TEST_ASSERT_FALSE(parser.command().argInt(0, &bad));
+    TEST_ASSERT_FALSE(parser.command().argFloat(1, &mm));
+
+    TEST_ASSERT_EQUAL_INT(1, feedString("probes Reset\n"));
+    TEST_ASSERT_EQUAL_INT(CMD_PROBES, parser.command().id);
+    TEST_ASSERT_TRUE(parser.command().argIs(0, "RESET"));
+}
+
+static void test_empty_lines_are_ignored() {
+    TEST_ASSERT_EQUAL_INT(0, feedString("\n\r\n   \n"));
+    TEST_ASSERT_EQUAL_INT(1, feedString("STATUS\n"));
+    TEST_ASSERT_EQUAL_INT(CMD_STATUS, parser.command().id);
+}
+
+static void test_unknown_verb() {
+    TEST_ASSERT_EQUAL_INT(1, feedString("FOO 1\n"));
+    TEST_ASSERT_EQUAL_INT(CMD_UNKNOWN, parser.command().id);
+    TEST_ASSERT_EQUAL_STRING("FOO", parser.command().verb);
+}
+
+// Fluxo remoto: HOME leva à posição de colocação, a mola entra e só então
+// START (que não refaz o home sobre a mola carregada)
+static void test_home_then_start_gate() {
+    TEST_ASSERT_EQUAL_INT(1, feedString("home\n"));
+    TEST_ASSERT_EQUAL_INT(CMD_HOME, parser.command().id);
+    TEST_ASSERT_EQUAL_UINT8(0, parser.command().argc);
+
+    TEST_ASSERT_EQUAL_INT(REMOTE_START_NOT_HOMED, remoteStartGate(false, SPRING_PLACEMENT_MM));
+    TEST_ASSERT_EQUAL_INT(REMOTE_START_OK, remoteStartGate(true, SPRING_PLACEMENT_MM));
+    TEST_ASSERT_EQUAL_INT(REMOTE_START_OK,
+                          remoteStartGate(true, SPRING_PLACEMENT_MM - REMOTE_START_PARK_TOL_MM / 2));
+    TEST_ASSERT_EQUAL_INT(REMOTE_START_NOT_PARKED,
+                          remoteStartGate(true, SPRING_PLACEMENT_MM + 2 * REMOTE_START_PARK_TOL_MM));
+    TEST_ASSERT_EQUAL_INT(REMOTE_START_NOT_PARKED, remoteStartGate(true, 12.0f));
+    TEST_ASSERT_EQUAL_STRING("not_homed", remoteStartGateName(REMOTE_START_NOT_HOMED));
+    TEST_ASSERT_EQUAL_STRING("not_parked", remoteStartGateName(REMOTE_START_NOT_PARKED));
+}
+
+static void test_errors_discard_until_newline() {
+    TEST_ASSERT_EQUAL_INT(1, feedString("CAL 1234567890123456 x\n"));
+    TEST_ASSERT_EQUAL_INT(CMD_NONE, parser.command().id);
+    TEST_ASSERT_EQUAL_INT(CMD_ERR_TOO_LONG, parser.command().error);
+    TEST_ASSERT_EQUAL_STRING("CAL", parser.command().verb);
+
+    TEST_ASSERT_EQUAL_INT(1, feedString("JOG 1 2 3 4 5\n"));
+    TEST_ASSERT_EQUAL_INT(CMD_ERR_TOO_MANY_ARGS, parser.command().error);
+
+    TEST_ASSERT_EQUAL_INT(1, feedString("TA\x01RE\n"));
+    TEST_ASSERT_EQUAL_INT(CMD_ERR_BAD_CHAR, parser.command().error);
+
+    // Sincronismo mantido: a linha seguinte é normal
+    TEST_ASSERT_EQUAL_INT(1, feedString("ABORT\n"));
+    TEST_ASSERT_EQUAL_INT(CMD_ABORT, parser.command().id);
+    TEST_ASSERT_EQUAL_INT(CMD_ERR_NONE, parser.command().error);
+}
+
+// Fuzz: bytes aleatórios nunca produzem tokens sem terminador nem argc
+// fora do limite, e o parser volta a entender a próxima linha válida
+static void test_fuzz_random_bytes() {
+    uint32_t rng = 12345;
+    for (int round = 0; round < 2000; ++round) {
+        int len = 1 + (int)(rng % 200);
+        for (int i = 0; i < len; ++i) {
+            rng = rng * 1664525u + 1013904223u;
+            uint8_t b = (uint8_t)(rng >> 24);
+            if (parser.feed(b)) {
+                const Command& c = parser.command();
+                TEST_ASSERT_TRUE(c.argc <= CMD_MAX_ARGS);
+                TEST_ASSERT_TRUE(strlen(c.verb) <= CMD_TOKEN_MAX);
+                for (int a = 0; a < c.argc; ++a) TEST_ASSERT_TRUE(strlen(c.args[a]) <= CMD_TOKEN_MAX);
+            }
+        }
+        feedString("\n");   // fecha a linha de lixo (pode entregar um comando)
+        TEST_ASSERT_EQUAL_INT(1, feedString("STATUS\n"));
+        TEST_ASSERT_EQUAL_INT(CMD_STATUS, parser.command().id);
+    }
+}
+
+// Vazão do parser no host (referência; a UART entrega ~11,5 kB/s a 115200)
+static void test_throughput() {
+    const char* line = "JOG -1.25\nSTATUS\nSTART 3\nEXPORT 4096\n";
+    const size_t lineLen = strlen(line);
+    const int reps = 200000;
+    int delivered = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) delivered += feedString(line);
+    auto t1 = std::chrono::steady_clock::now();
+    TEST_ASSERT_EQUAL_INT(reps * 4, delivered);
+
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / (double)(reps * lineLen);
+    char msg[64];
+    snprintf(msg, sizeof(msg), "parser: %.1f ns/byte", ns);
+    TEST_MESSAGE(msg);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_verb_and_args);
+    RUN_TEST(test_numeric_args_and_keywords);
+    RUN_TEST(test_empty_lines_are_ignored);
+    RUN_TEST(test_unknown_verb);
+    RUN_TEST(test_home_then_start_gate);
+    RUN_TEST(test_errors_discard_until_newline);
+    RUN_TEST(test_fuzz_random_bytes);
+    RUN_TEST(test_throughput);
+    return UNITY_END();
+}
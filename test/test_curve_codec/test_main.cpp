@@ -0,0 +1,140 @@
+#include <unity.h>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include "curve_codec.h"
+
+void setUp() {}
+void tearDown() {}
+
+static const int MAX_SAMPLES = 2000;
+static CurveSample samples[MAX_SAMPLES];
+static uint8_t blob[curveMaxBytes(MAX_SAMPLES, 1)];
+static const CurveMeta META = {1600.0f, -21000.0f, 84000, 48000, 0, 0};
+
+static uint32_t s_rng = 11;
+static int32_t noise(int amp) {
+    s_rng = s_rng * 1664525u + 1013904223u;
+    return (int32_t)((s_rng >> 16) % (uint32_t)(2 * amp + 1)) - amp;
+}
+
+// Movimento contínuo (uma amostra a cada conversão) ou pontos parados do perfil
+static void makeCurve(int n, int32_t stepsPerSample, uint32_t usPerSample, uint32_t t0) {
+    for (int i = 0; i < n; ++i) {
+        samples[i].stepPos = 48000 - i * stepsPerSample;
+        samples[i].rawCount = 84000 - i * stepsPerSample * 13 / 10 + noise(40);
+        samples[i].timestampUs = t0 + (uint32_t)i * usPerSample + (uint32_t)(noise(300) + 300);
+    }
+}
+
+// Codifica e confere next() e sampleAt() contra todas as amostras
+static size_t roundTrip(int n, int interval) {
+    size_t len = curveEncode(META, samples, n, blob, sizeof(blob), interval);
+    TEST_ASSERT_TRUE(len >= sizeof(CurveBlobHeader));
+
+    CurveReader r;
+    TEST_ASSERT_TRUE(r.open(blob, len));
+    TEST_ASSERT_EQUAL_INT(n, r.count());
+    TEST_ASSERT_EQUAL_INT(interval, r.checkpointInterval());
+    TEST_ASSERT_EQUAL_INT32(META.tareOffset, r.meta().tareOffset);
+
+    CurveSample s;
+    for (int i = 0; i < n; ++i) {
+        TEST_ASSERT_TRUE(r.next(&s));
+        TEST_ASSERT_EQUAL_MEMORY(&samples[i], &s, sizeof(s));
+    }
+    TEST_ASSERT_FALSE(r.next(&s));
+    // Acesso aleatório, em ordem inversa
+    for (int i = n - 1; i >= 0; --i) {
+        TEST_ASSERT_TRUE(r.sampleAt(i, &s));
+        TEST_ASSERT_EQUAL_MEMORY(&samples[i], &s, sizeof(s));
+    }
+    TEST_ASSERT_FALSE(r.sampleAt(n, &s));
+    TEST_ASSERT_FALSE(r.sampleAt(-1, &s));
+    return len;
+}
+
+static void test_round_trip_sizes_and_intervals() {
+    const int sizes[] = {0, 1, 11, 256, 2000};
+    const int intervals[] = {1, 8, 32, 128};
+    for (int n : sizes) {
+        makeCurve(n, 25, 12500, 1000000u);
+        for (int interval : intervals) roundTrip(n, interval);
+    }
+}
+
+// micros() dá a volta no meio da curva: delta de tempo módulo 2^32
+static void test_round_trip_micros_wraparound() {
+    makeCurve(256, 25, 12500, 0xFFFFFFFFu - 1000000u);
+    TEST_ASSERT_TRUE(samples[255].timestampUs < samples[0].timestampUs);
+    roundTrip(256, 32);
+}
+
+static void test_encode_rejects_bad_arguments() {
+    makeCurve(11, 1600, 600000, 0);
+    TEST_ASSERT_EQUAL_UINT(0, curveEncode(META, samples, 11, blob, 16));
+    TEST_ASSERT_EQUAL_UINT(0, curveEncode(META, samples, -1, blob, sizeof(blob)));
+    TEST_ASSERT_EQUAL_UINT(0, curveEncode(META, samples, 11, blob, sizeof(blob), 0));
+    TEST_ASSERT_EQUAL_UINT(0, curveEncode(META, samples, 11, blob, sizeof(blob), 256));
+}
+
+static void test_reader_rejects_truncated_and_corrupt_headers() {
+    makeCurve(256, 25, 12500, 0);
+    size_t len = curveEncode(META, samples, 256, blob, sizeof(blob), 32);
+    CurveReader r;
+    // Qualquer blob cortado antes do fim dos deltas é recusado
+    for (size_t cut = 0; cut < len; cut += 7) TEST_ASSERT_FALSE(r.open(blob, cut));
+    TEST_ASSERT_FALSE(r.open(blob, len - 1));
+
+    CurveBlobHeader hdr;
+    memcpy(&hdr, blob, sizeof(hdr));
+    const size_t fields[] = {offsetof(CurveBlobHeader, magic), offsetof(CurveBlobHeader, version),
+                             offsetof(CurveBlobHeader, checkpointInterval),
+                             offsetof(CurveBlobHeader, checkpointCount),
+                             offsetof(CurveBlobHeader, dataBytes) + 1};
+    for (size_t f : fields) {
+        blob[f] ^= 0x5A;
+        TEST_ASSERT_FALSE(r.open(blob, len));
+        blob[f] ^= 0x5A;
+    }
+    TEST_ASSERT_TRUE(r.open(blob, len));
+
+    // Âncora apontando além dos deltas: leitura falha sem sair do buffer
+    CurveCheckpoint cp;
+    uint8_t* table = blob + sizeof(CurveBlobHeader);
+    memcpy(&cp, table + sizeof(cp), sizeof(cp));
+    cp.dataOffset = 0xFFFFFF;
+    memcpy(table + sizeof(cp), &cp, sizeof(cp));
+    TEST_ASSERT_TRUE(r.open(blob, len));
+    CurveSample s;
+    TEST_ASSERT_FALSE(r.sampleAt(40, &s));
+}
+
+// Bytes por amostra (CurveSample bruta = 12): referência do tamanho na flash
+static void test_benchmark_bytes_per_sample() {
+    char msg[96];
+    makeCurve(256, 25, 12500, 0);
+    size_t b256 = roundTrip(256, CURVE_DEFAULT_CHECKPOINT_INTERVAL);
+    makeCurve(2000, 25, 12500, 0);
+    size_t b2000 = roundTrip(2000, CURVE_DEFAULT_CHECKPOINT_INTERVAL);
+    makeCurve(11, 1600, 600000, 0);
+    size_t b11 = roundTrip(11, CURVE_DEFAULT_CHECKPOINT_INTERVAL);
+    TEST_ASSERT_TRUE(b256 < 256 * sizeof(CurveSample) / 2);
+
+    snprintf(msg, sizeof(msg), "contínuo 256: %.1f B/amostra (%u bytes)", (double)b256 / 256, (unsigned)b256);
+    TEST_MESSAGE(msg);
+    snprintf(msg, sizeof(msg), "contínuo 2000: %.1f B/amostra", (double)b2000 / 2000);
+    TEST_MESSAGE(msg);
+    snprintf(msg, sizeof(msg), "perfil 11 pontos: %.1f B/amostra", (double)b11 / 11);
+    TEST_MESSAGE(msg);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_round_trip_sizes_and_intervals);
+    RUN_TEST(test_round_trip_micros_wraparound);
+    RUN_TEST(test_encode_rejects_bad_arguments);
+    RUN_TEST(test_reader_rejects_truncated_and_corrupt_headers);
+    RUN_TEST(test_benchmark_bytes_per_sample);
+    return UNITY_END();
+}
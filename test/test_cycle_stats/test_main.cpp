@@ -0,0 +1,267 @@
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include "cycle_stats.h"
+#include "fatigue_stroke.h"
+#include "rig_sim.h"
+#include "config.h"
+
+// Conta alocações no heap: a ciclagem não pode alocar nada
+static unsigned long g_allocs = 0;
+void* operator new(std::size_t n) {
+    ++g_allocs;
+    void* p = std::malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+void setUp() {}
+void tearDown() {}
+
+// Mola ideal F = f0 + k*x amostrada como no curso do ensaio de fadiga
+static void feedLinearCycle(CycleAccumulator& c, float f0, float k, float courseMm, int points) {
+    c.begin();
+    for (int i = 0; i <= points; ++i) {
+        float x = courseMm * (float)i / (float)points;
+        c.addSample(x, f0 + k * x);
+    }
+}
+
+static void test_cycle_linear_spring() {
+    CycleAccumulator c;
+    feedLinearCycle(c, 0.2f, 1.5f, 5.0f, 20);
+    TEST_ASSERT_EQUAL_INT(21, c.count());
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.5f, c.springRateKgfMm());
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.2f, c.minForceKg());
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 7.7f, c.maxForceKg());
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 5.0f, c.maxCompressionMm());
+    // Área exata do trapézio: (0.2*5 + 1.5*25/2) kgf·mm
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, (1.0f + 18.75f) * 9.80665f, c.energyMj());
+}
+
+static void test_cycle_degenerate() {
+    CycleAccumulator c;
+    c.begin();
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, c.springRateKgfMm());
+    c.addSample(1.0f, 2.0f);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, c.springRateKgfMm());
+    c.addSample(1.0f, 3.0f);   // mesma posição: sem inclinação definida
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, c.springRateKgfMm());
+}
+
+static void test_summary_drift_and_stddev() {
+    CycleAccumulator c;
+    FatigueSummary s;
+    s.begin();
+    feedLinearCycle(c, 0.0f, 2.0f, 5.0f, 20);
+    s.addCycle(c);
+    feedLinearCycle(c, 0.0f, 1.8f, 5.0f, 20);
+    s.addCycle(c);
+    TEST_ASSERT_EQUAL_UINT32(2, s.cycles());
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, -10.0f, s.driftPercent());
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.9f, s.meanK());
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.1414f, s.stdDevK());
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.8f, s.minK());
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 2.0f, s.maxK());
+}
+
+// 100k ciclos com K alternando em torno de 1.5 sem perder precisão na
+// média/desvio (Welford)
+static void test_summary_welford_100k_cycles() {
+    static_assert(sizeof(FatigueSummary) <= 64, "resumo deve ter tamanho fixo e pequeno");
+    CycleAccumulator c;
+    FatigueSummary s;
+    s.begin();
+    const uint32_t cycles = 100000;
+    for (uint32_t n = 0; n < cycles; ++n) {
+        float k = (n & 1) ? 1.51f : 1.49f;
+        feedLinearCycle(c, 0.1f, k, 5.0f, 20);
+        s.addCycle(c);
+    }
+    TEST_ASSERT_EQUAL_UINT32(cycles, s.cycles());
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.5f, s.meanK());
+    TEST_ASSERT_FLOAT_WITHIN(2e-4f, 0.01f, s.stdDevK());
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 1.49f, s.firstK());
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 1.51f, s.lastK());
+}
+
+static void test_curve_log_powers_of_two() {
+    static CurveLog<4, 8> log;
+    log.begin(21);   // passo de decimação 3
+    for (uint32_t cycle = 1; cycle <= 20; ++cycle) {
+        log.beginCycle(cycle);
+        for (int i = 0; i < 21; ++i) log.addSample((float)i, (float)cycle);
+    }
+    TEST_ASSERT_EQUAL_INT(4, log.size());
+    const uint32_t expected[] = {1, 2, 4, 8};   // 16 não cabe: slots cheios
+    for (int i = 0; i < 4; ++i) {
+        TEST_ASSERT_EQUAL_UINT32(expected[i], log.at(i).cycle);
+        TEST_ASSERT_EQUAL_INT(7, log.at(i).count);
+        TEST_ASSERT_EQUAL_FLOAT(18.0f, log.at(i).xMm[6]);
+        TEST_ASSERT_EQUAL_FLOAT((float)expected[i], log.at(i).forceKg[0]);
+    }
+}
+
+// ---- Fila de um ciclo e rejeição ----
+
+static void test_stroke_queue_samples_without_stopping() {
+    static MotionQueue q;
+    const float unitsPerMm = 3200.0f;
+    int points = buildFatigueStroke(q, 1000, unitsPerMm, FATIGUE_STEP_DELAY_US);
+    TEST_ASSERT_EQUAL_INT(21, points);
+    TEST_ASSERT_EQUAL_INT(22, q.size());
+    for (int i = 0; i < points; ++i) {
+        TEST_ASSERT_EQUAL(SEG_ACTION_SAMPLE, q[i].action);
+        TEST_ASSERT_EQUAL_UINT16(i, q[i].tag);
+    }
+    TEST_ASSERT_EQUAL_INT32(1000 - 16000, q[points - 1].target);
+    TEST_ASSERT_EQUAL(SEG_ACTION_NONE, q[points].action);
+    TEST_ASSERT_EQUAL_INT32(1000, q[points].target);
+    // Sem DWELL: a descida inteira é um trapézio só (junções na velocidade de cruzeiro)
+    q.plan(1000, 1, STEPPER_ACCEL_MM_S2 * unitsPerMm, STEPPER_START_MM_S * unitsPerMm,
+           [](uint16_t, void*) { return 28571.0f; }, nullptr);
+    for (int i = 2; i < points - 1; ++i) TEST_ASSERT_EQUAL_FLOAT(q[i].cruisePps, q[i].entryPps);
+}
+
+static void test_gate_skips_points_without_conversion() {
+    FatigueCycleGate gate;
+    CycleAccumulator c;
+    gate.begin(4, 10);
+    c.begin();
+    TEST_ASSERT_TRUE(gate.onPoint(c, 0, true, 9.0f, 50.0f));     // conversão do retorno
+    TEST_ASSERT_FALSE(gate.sampled());
+    TEST_ASSERT_TRUE(gate.onPoint(c, 2, true, 1.0f, 50.0f));
+    TEST_ASSERT_TRUE(gate.sampled());
+    TEST_ASSERT_TRUE(gate.onPoint(c, 3, false, 99.0f, 50.0f));   // sem conversão: ignora até a força
+    TEST_ASSERT_FALSE(gate.sampled());
+    TEST_ASSERT_TRUE(gate.onPoint(c, 4, true, 2.0f, 50.0f));
+    TEST_ASSERT_EQUAL_INT(2, c.count());
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 2.0f, c.springRateKgfMm());
+    TEST_ASSERT_EQUAL_UINT32(1, gate.missedPoints());
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, c.maxCompressionMm());
+    TEST_ASSERT_FALSE(gate.onPoint(c, 5, true, 51.0f, 50.0f));  // acima do limite: aborta
+}
+
+// Só rejeições seguidas param a ciclagem; esparsas apenas somam
+static void test_gate_counts_consecutive_rejects() {
+    FatigueCycleGate gate;
+    FatigueSummary s;
+    CycleAccumulator good, bad;
+    s.begin();
+    gate.begin(4, 3);
+    feedLinearCycle(good, 0.0f, 1.5f, 5.0f, 5);
+    bad.begin();
+    for (int round = 0; round < 50; ++round) {
+        TEST_ASSERT_EQUAL(FATIGUE_CYCLE_REJECTED, gate.endCycle(bad, s));
+        TEST_ASSERT_EQUAL(FATIGUE_CYCLE_ACCEPTED, gate.endCycle(good, s));
+    }
+    TEST_ASSERT_EQUAL_UINT32(50, gate.rejected());
+    TEST_ASSERT_EQUAL_UINT32(50, s.cycles());
+    for (int i = 0; i < 3; ++i) TEST_ASSERT_EQUAL(FATIGUE_CYCLE_REJECTED, gate.endCycle(bad, s));
+    TEST_ASSERT_EQUAL(FATIGUE_CYCLE_HX711_LOST, gate.endCycle(bad, s));
+    TEST_ASSERT_EQUAL_UINT32(4, gate.consecutiveRejects());
+}
+
+// ---- Ciclagem no simulador da bancada ----
+
+static RigSimFatigueConfig soakConfig(float sps) {
+    RigSimFatigueConfig cfg = {1.5f, -2.0f, 0.005f, sps, 0, 0, false, 4242u};
+    return cfg;
+}
+
+// Modelo contínuo do simulador contra a soma pulso a pulso de segmentRateAt
+static void test_sim_segment_time_matches_pulse_engine() {
+    static MotionQueue q;
+    const float unitsPerMm = 3200.0f, accel = STEPPER_ACCEL_MM_S2 * unitsPerMm;
+    buildFatigueStroke(q, 0, unitsPerMm, FATIGUE_STEP_DELAY_US);
+    q.plan(0, 1, accel, STEPPER_START_MM_S * unitsPerMm,
+           [](uint16_t us, void*) { return 1e6f / ((us + STEP_PULSE_US) * 0.5f); }, nullptr);
+    double model = 0.0, engine = 0.0;
+    for (int i = 0; i < q.size(); ++i) {
+        model += rigSimSegmentUs(q[i], accel);
+        for (long k = 0; k < q[i].pulses; ++k) engine += 1e6 / segmentRateAt(q[i], k, accel);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.01 * engine, engine, model);
+}
+
+// 100k ciclos (~30 h de bancada) pela fila de movimento: sem heap, K e deriva
+// conferem, rejeições esparsas (1 a cada 1000) não interrompem
+static void test_soak_100k_cycles_on_sim() {
+    RigSimFatigueConfig cfg = soakConfig(10.0f);
+    cfg.missEvery = 1000;
+    unsigned long before = g_allocs;
+    FatigueSoakReport r = rigSimFatigueSoak(cfg, 100000);
+    TEST_ASSERT_EQUAL_UINT32(0, g_allocs - before);
+
+    char msg[200];
+    snprintf(msg, sizeof(msg),
+             "soak 10 SPS: %lu ciclos, %lu rejeitados, %.0f ms/ciclo (%.1f h), %.1f amostras/ciclo, "
+             "K %.4f +/- %.4f deriva %+.2f%%, %d curvas",
+             (unsigned long)r.cycles, (unsigned long)r.rejected, r.cycleMs,
+             r.cycleMs * (r.cycles + r.rejected) / 3.6e6, r.samplesPerCycle, r.meanK, r.stdK,
+             r.driftPct, r.storedCurves);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_FALSE(r.hx711Lost);
+    TEST_ASSERT_EQUAL_UINT32(100000, r.cycles);
+    TEST_ASSERT_EQUAL_UINT32(100, r.rejected);
+    TEST_ASSERT_EQUAL_INT(FATIGUE_STORED_CURVES, r.storedCurves);
+    TEST_ASSERT_TRUE(r.samplesPerCycle >= FATIGUE_MIN_CYCLE_SAMPLES);
+    // K de 1.5 caindo 2% a cada 10k ciclos: -20% no fim. Primeiro e último
+    // são ciclos isolados (~2% de dispersão a 10 SPS); a média é a da rampa
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 1.5f, r.firstK);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 1.2f, r.lastK);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.35f, r.meanK);
+    TEST_ASSERT_FLOAT_WITHIN(6.0f, -20.0f, r.driftPct);
+}
+
+static void test_hx711_stop_aborts_after_consecutive_rejects() {
+    RigSimFatigueConfig cfg = soakConfig(80.0f);
+    cfg.hx711StopCycle = 500;
+    FatigueSoakReport r = rigSimFatigueSoak(cfg, 1000);
+    TEST_ASSERT_TRUE(r.hx711Lost);
+    TEST_ASSERT_EQUAL_UINT32(499, r.cycles);
+    TEST_ASSERT_EQUAL_UINT32(FATIGUE_MAX_REJECTED_CYCLES + 1, r.rejected);
+}
+
+// Levantamento: pontos sem parar x parada com leitura bloqueante em cada ponto
+static void test_cycle_time_benchmark() {
+    const float rates[] = {10.0f, 80.0f};
+    for (float sps : rates) {
+        RigSimFatigueConfig cfg = soakConfig(sps);
+        cfg.kDriftPct = 0.0f;
+        FatigueSoakReport sampled = rigSimFatigueSoak(cfg, 500);
+        cfg.blockingPoints = true;
+        FatigueSoakReport blocking = rigSimFatigueSoak(cfg, 500);
+        char msg[200];
+        snprintf(msg, sizeof(msg),
+                 "%2.0f SPS: amostrado %4.0f ms/ciclo %4.1f pontos K %.4f+/-%.4f | "
+                 "bloqueante %4.0f ms/ciclo %4.1f pontos K %.4f+/-%.4f",
+                 sps, sampled.cycleMs, sampled.samplesPerCycle, sampled.meanK, sampled.stdK,
+                 blocking.cycleMs, blocking.samplesPerCycle, blocking.meanK, blocking.stdK);
+        TEST_MESSAGE(msg);
+        TEST_ASSERT_TRUE(sampled.cycleMs < blocking.cycleMs);
+        TEST_ASSERT_FLOAT_WITHIN(0.03f, 1.5f, sampled.meanK);
+        TEST_ASSERT_EQUAL_UINT32(0, sampled.rejected);
+    }
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_cycle_linear_spring);
+    RUN_TEST(test_cycle_degenerate);
+    RUN_TEST(test_summary_drift_and_stddev);
+    RUN_TEST(test_summary_welford_100k_cycles);
+    RUN_TEST(test_curve_log_powers_of_two);
+    RUN_TEST(test_stroke_queue_samples_without_stopping);
+    RUN_TEST(test_gate_skips_points_without_conversion);
+    RUN_TEST(test_gate_counts_consecutive_rejects);
+    RUN_TEST(test_sim_segment_time_matches_pulse_engine);
+    RUN_TEST(test_soak_100k_cycles_on_sim);
+    RUN_TEST(test_hx711_stop_aborts_after_consecutive_rejects);
+    RUN_TEST(test_cycle_time_benchmark);
+    return UNITY_END();
+}
@@ -0,0 +1,188 @@
+#include <unity.h>
+#include "endstop_homing.h"
+
+// Eixo falso: posição em pulsos, switch acionado a partir de tripAt (indo
+// para o home a posição diminui). Com latch, a "ISR" e o temporizador de
+// debounce rodam dentro do passo e da espera, como no simulador.
+struct FakeAxis {
+    int32_t position = 0;
+    int32_t tripAt = -100;
+    int32_t glitchAt = 1;        // pulso de ruído nesta posição (1 = nenhum)
+    bool    glitchActive = false;
+    uint32_t glitchLeftUs = 0;
+    bool    abortAfter = false;
+    long    abortSteps = 0;
+    long    steps = 0;
+    EndstopLatch* latch = nullptr;
+    uint32_t timerLeftUs = 0;    // 0 = temporizador parado
+
+    bool pressed() const { return position <= tripAt || glitchActive; }
+};
+
+static const uint32_t DEBOUNCE_US = 2000;
+static const uint32_t GLITCH_US = 500;   // mais que um passo, menos que o debounce
+
+static void fakeStep(void* ctx) {
+    FakeAxis& a = *static_cast<FakeAxis*>(ctx);
+    bool before = a.pressed();
+    a.position -= 1;
+    ++a.steps;
+    if (a.position == a.glitchAt) {
+        a.glitchActive = true;
+        a.glitchLeftUs = GLITCH_US;
+    }
+    bool after = a.pressed();
+    if (a.latch && after != before && a.latch->onEdge(after, a.position)) a.timerLeftUs = DEBOUNCE_US;
+}
+
+static void fakeDelayUs(uint32_t us, void* ctx) {
+    FakeAxis& a = *static_cast<FakeAxis*>(ctx);
+    if (a.glitchActive) {
+        if (us < a.glitchLeftUs) {
+            a.glitchLeftUs -= us;
+        } else {
+            // Ruído solta antes do debounce terminar: reinicia o temporizador
+            a.glitchActive = false;
+            if (a.latch && a.latch->onEdge(false, a.position)) a.timerLeftUs = DEBOUNCE_US;
+            return;
+        }
+    }
+    if (a.timerLeftUs == 0) return;
+    if (us >= a.timerLeftUs) {
+        a.timerLeftUs = 0;
+        if (a.latch) a.latch->onDebounceTimer(a.pressed());
+    } else {
+        a.timerLeftUs -= us;
+    }
+}
+
+static bool fakePressed(void* ctx) {
+    return static_cast<FakeAxis*>(ctx)->pressed();
+}
+
+static int32_t fakePosition(void* ctx) {
+    return static_cast<FakeAxis*>(ctx)->position;
+}
+
+static bool fakeAbort(void* ctx) {
+    FakeAxis& a = *static_cast<FakeAxis*>(ctx);
+    return a.abortAfter && a.steps >= a.abortSteps;
+}
+
+static FakeAxis axis;
+static EndstopHomingHal hal;
+static const EndstopHomingParams params = {1000, 133, 20000};
+
+void setUp() {
+    axis = FakeAxis();
+    hal = {fakeStep, fakeDelayUs, fakePressed, fakePosition, fakeAbort, &axis};
+}
+void tearDown() {}
+
+// ---- EndstopLatch ----
+
+static void test_latch_captures_first_edge() {
+    EndstopLatch latch;
+    latch.arm(false, 0);
+    TEST_ASSERT_EQUAL(LATCH_ARMED, latch.state());
+    TEST_ASSERT_FALSE(latch.onEdge(false, -3));   // soltura com a latch armada: ignora
+    TEST_ASSERT_TRUE(latch.onEdge(true, -5));
+    TEST_ASSERT_TRUE(latch.pending());
+    TEST_ASSERT_TRUE(latch.stopRequested());
+    // Bounce: reinicia o debounce mas não move a posição capturada
+    TEST_ASSERT_TRUE(latch.onEdge(false, -6));
+    TEST_ASSERT_TRUE(latch.onEdge(true, -6));
+    latch.onDebounceTimer(true);
+    TEST_ASSERT_TRUE(latch.confirmed());
+    TEST_ASSERT_EQUAL_INT32(-5, latch.position());
+    TEST_ASSERT_EQUAL_UINT16(3, latch.edges());
+    TEST_ASSERT_FALSE(latch.onEdge(false, -7));   // confirmada: ISR não mexe mais
+}
+
+static void test_latch_rejects_noise_and_rearms() {
+    EndstopLatch latch;
+    latch.arm(false, 0);
+    latch.onEdge(true, -2);
+    latch.onDebounceTimer(false);
+    TEST_ASSERT_EQUAL(LATCH_ARMED, latch.state());
+    TEST_ASSERT_EQUAL_UINT16(1, latch.rejected());
+    TEST_ASSERT_FALSE(latch.stopRequested());
+    latch.onDebounceTimer(true);                  // temporizador atrasado: sem efeito
+    TEST_ASSERT_EQUAL(LATCH_ARMED, latch.state());
+}
+
+static void test_latch_armed_while_pressed_confirms() {
+    EndstopLatch latch;
+    latch.arm(true, 42);
+    TEST_ASSERT_TRUE(latch.confirmed());
+    TEST_ASSERT_EQUAL_INT32(42, latch.position());
+    latch.disarm();
+    TEST_ASSERT_EQUAL(LATCH_DISARMED, latch.state());
+    TEST_ASSERT_FALSE(latch.onEdge(true, 0));
+}
+
+// ---- runEndstopHoming ----
+
+static void test_polled_home_at_switch() {
+    EndstopHomingReport rep = runEndstopHoming(params, hal, nullptr);
+    TEST_ASSERT_EQUAL(ENDSTOP_HOME_OK, rep.result);
+    TEST_ASSERT_EQUAL_INT32(axis.tripAt, rep.homePosition);
+    TEST_ASSERT_EQUAL_INT32(100, rep.steps);
+    TEST_ASSERT_EQUAL_UINT16(0, rep.edges);
+}
+
+static void test_not_found_after_max_steps() {
+    axis.tripAt = -5000;
+    EndstopHomingReport rep = runEndstopHoming(params, hal, nullptr);
+    TEST_ASSERT_EQUAL(ENDSTOP_HOME_NOT_FOUND, rep.result);
+    TEST_ASSERT_EQUAL_INT32(params.maxSteps, rep.steps);
+    TEST_ASSERT_EQUAL_STRING("sem fim de curso", endstopHomingResultName(rep.result));
+}
+
+static void test_abort_stops_loop() {
+    axis.abortAfter = true;
+    axis.abortSteps = 10;
+    EndstopHomingReport rep = runEndstopHoming(params, hal, nullptr);
+    TEST_ASSERT_EQUAL(ENDSTOP_HOME_ABORTED, rep.result);
+    TEST_ASSERT_EQUAL_INT32(10, rep.steps);
+}
+
+static void test_latched_home_at_edge() {
+    EndstopLatch latch;
+    axis.latch = &latch;
+    EndstopHomingReport rep = runEndstopHoming(params, hal, &latch);
+    TEST_ASSERT_EQUAL(ENDSTOP_HOME_OK, rep.result);
+    TEST_ASSERT_EQUAL_INT32(axis.tripAt, rep.homePosition);
+    TEST_ASSERT_EQUAL_UINT16(1, rep.edges);
+    TEST_ASSERT_EQUAL(LATCH_DISARMED, latch.state());   // desarma no fim
+}
+
+// Ruído antes do switch: o polled para nele, a latch descarta e segue
+static void test_glitch_false_home_only_when_polled() {
+    axis.glitchAt = -40;
+    EndstopHomingReport polled = runEndstopHoming(params, hal, nullptr);
+    TEST_ASSERT_EQUAL(ENDSTOP_HOME_OK, polled.result);
+    TEST_ASSERT_EQUAL_INT32(-40, polled.homePosition);
+
+    setUp();
+    axis.glitchAt = -40;
+    EndstopLatch latch;
+    axis.latch = &latch;
+    EndstopHomingReport latched = runEndstopHoming(params, hal, &latch);
+    TEST_ASSERT_EQUAL(ENDSTOP_HOME_OK, latched.result);
+    TEST_ASSERT_EQUAL_INT32(axis.tripAt, latched.homePosition);
+    TEST_ASSERT_EQUAL_UINT16(1, latched.rejected);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_latch_captures_first_edge);
+    RUN_TEST(test_latch_rejects_noise_and_rearms);
+    RUN_TEST(test_latch_armed_while_pressed_confirms);
+    RUN_TEST(test_polled_home_at_switch);
+    RUN_TEST(test_not_found_after_max_steps);
+    RUN_TEST(test_abort_stops_loop);
+    RUN_TEST(test_latched_home_at_edge);
+    RUN_TEST(test_glitch_false_home_only_when_polled);
+    return UNITY_END();
+}
@@ -0,0 +1,124 @@
+#include <unity.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "event_trace.h"
+
+struct Parsed {
+    unsigned long ts;
+    unsigned type, source, seq;
+    long arg;
+};
+
+static const int MAX_LINES = TRACE_EVENT_CAPACITY + 4;
+static char lines[MAX_LINES][64];
+static int lineCount = 0;
+
+static void captureLine(const char* line) {
+    if (lineCount < MAX_LINES) {
+        strncpy(lines[lineCount], line, sizeof(lines[0]) - 1);
+        lines[lineCount][sizeof(lines[0]) - 1] = '\0';
+    }
+    ++lineCount;
+}
+
+static Parsed parseEvt(int i) {
+    Parsed p = {};
+    int n = sscanf(lines[i], "EVT %lu %u %u %u %ld", &p.ts, &p.type, &p.source, &p.seq, &p.arg);
+    TEST_ASSERT_EQUAL_INT(5, n);
+    return p;
+}
+
+void setUp() {
+    traceClear();
+    lineCount = 0;
+}
+void tearDown() {}
+
+static void test_empty_dump() {
+    traceDump(captureLine);
+    TEST_ASSERT_EQUAL_INT(2, lineCount);
+    TEST_ASSERT_EQUAL_STRING("TRACE begin 0 0", lines[0]);
+    TEST_ASSERT_EQUAL_STRING("TRACE end", lines[1]);
+}
+
+static void test_events_in_order_with_fields() {
+    TRACE_EVENT(EVT_STATE_ENTER, TRACE_GRAFSET_FADIGA, 50);
+    TRACE_EVENT(EVT_MOTION_START, TRACE_MOTION_QUEUE, 22);
+    TRACE_EVENT(EVT_SAMPLE, TRACE_SAMPLE_HX711, -8388608);
+    traceDump(captureLine);
+    TEST_ASSERT_EQUAL_INT(5, lineCount);
+    TEST_ASSERT_EQUAL_STRING("TRACE begin 3 0", lines[0]);
+    Parsed a = parseEvt(1), b = parseEvt(2), c = parseEvt(3);
+    TEST_ASSERT_EQUAL_UINT(EVT_STATE_ENTER, a.type);
+    TEST_ASSERT_EQUAL_UINT(TRACE_GRAFSET_FADIGA, a.source);
+    TEST_ASSERT_EQUAL_INT32(50, a.arg);
+    TEST_ASSERT_EQUAL_UINT(EVT_MOTION_START, b.type);
+    TEST_ASSERT_EQUAL_INT32(-8388608, c.arg);   // mínimo de 24 bits do HX711
+    TEST_ASSERT_EQUAL_UINT(0, a.seq);
+    TEST_ASSERT_EQUAL_UINT(2, c.seq);
+    TEST_ASSERT_TRUE(a.ts <= b.ts && b.ts <= c.ts);   // relógio std::chrono no PC
+    TEST_ASSERT_EQUAL_STRING("TRACE end", lines[4]);
+}
+
+// Buffer cheio: ficam os TRACE_EVENT_CAPACITY mais novos e o cabeçalho conta os perdidos
+static void test_wraparound_counts_overrun() {
+    const int total = TRACE_EVENT_CAPACITY * 2 + 37;
+    for (int i = 0; i < total; ++i) traceRecord(EVT_ENCODER, TRACE_ENC_ROTATE, i);
+    traceDump(captureLine);
+    TEST_ASSERT_EQUAL_INT(TRACE_EVENT_CAPACITY + 2, lineCount);
+    char expected[48];
+    snprintf(expected, sizeof(expected), "TRACE begin %d %d", TRACE_EVENT_CAPACITY,
+             total - TRACE_EVENT_CAPACITY);
+    TEST_ASSERT_EQUAL_STRING(expected, lines[0]);
+    for (int i = 0; i < TRACE_EVENT_CAPACITY; ++i) {
+        Parsed p = parseEvt(i + 1);
+        long want = total - TRACE_EVENT_CAPACITY + i;
+        TEST_ASSERT_EQUAL_INT32(want, p.arg);
+        TEST_ASSERT_EQUAL_UINT((unsigned)want & 0xFFFFu, p.seq);
+    }
+}
+
+// seq tem 16 bits: dá a volta sem afetar a ordem do despejo
+static void test_seq_wraps_at_16_bits() {
+    const long total = 65536L + 10;
+    for (long i = 0; i < total; ++i) traceRecord(EVT_SAMPLE, TRACE_SAMPLE_STALLGUARD, (int32_t)i);
+    traceDump(captureLine);
+    Parsed last = parseEvt(TRACE_EVENT_CAPACITY);
+    Parsed first = parseEvt(1);
+    TEST_ASSERT_EQUAL_UINT(9, last.seq);
+    TEST_ASSERT_EQUAL_UINT((65536u + 10u - TRACE_EVENT_CAPACITY) & 0xFFFFu, first.seq);
+    TEST_ASSERT_EQUAL_INT32(total - 1, last.arg);
+}
+
+static void test_clear_resets_head_and_seq() {
+    for (int i = 0; i < 5; ++i) TRACE_EVENT(EVT_UI_BEGIN, TRACE_UI_MENU, i);
+    traceClear();
+    TRACE_EVENT(EVT_UI_END, TRACE_UI_MENU, 7);
+    traceDump(captureLine);
+    TEST_ASSERT_EQUAL_STRING("TRACE begin 1 0", lines[0]);
+    Parsed p = parseEvt(1);
+    TEST_ASSERT_EQUAL_UINT(0, p.seq);
+    TEST_ASSERT_EQUAL_INT32(7, p.arg);
+}
+
+// Linha mais longa possível cabe no buffer de 64 bytes do despejo
+static void test_longest_line_fits() {
+    traceRecord((TraceEventType)255, 255, -2147483647 - 1);
+    traceDump(captureLine);
+    Parsed p = parseEvt(1);
+    TEST_ASSERT_EQUAL_UINT(255, p.type);
+    TEST_ASSERT_EQUAL_INT32(-2147483647 - 1, p.arg);
+    TEST_ASSERT_TRUE(strlen(lines[1]) < 63);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_dump);
+    RUN_TEST(test_events_in_order_with_fields);
+    RUN_TEST(test_wraparound_counts_overrun);
+    RUN_TEST(test_seq_wraps_at_16_bits);
+    RUN_TEST(test_clear_resets_head_and_seq);
+    RUN_TEST(test_longest_line_fits);
+    return UNITY_END();
+}
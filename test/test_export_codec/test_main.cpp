@@ -0,0 +1,181 @@
+#include <unity.h>
+#include <cstdio>
+#include <cstring>
+#include "export_codec.h"
+#include "varint.h"
+#include "crc32.h"
+
+void setUp() {}
+void tearDown() {}
+
+static LzWorkspace ws;
+static uint8_t stream[64 * 1024];
+static uint8_t rebuilt[64 * 1024];
+static uint8_t frame[EXPORT_FRAME_MAX_BYTES];
+static CurveSample samples[256];
+
+static uint32_t s_rng = 7;
+static int32_t noise(int amp) {
+    s_rng = s_rng * 1664525u + 1013904223u;
+    return (int32_t)((s_rng >> 16) % (uint32_t)(2 * amp + 1)) - amp;
+}
+
+// Curva simulada: passos a cada mmPerPoint, mola de k kgf/mm, HX711 com ruído
+static void makeCurve(int n, float mmPerPoint, uint32_t usPerPoint) {
+    const float stepsPerMm = 1600.0f, calib = 21000.0f, k = 0.8f;
+    for (int i = 0; i < n; ++i) {
+        float x = mmPerPoint * (float)i;
+        samples[i].stepPos = 48000 - (int32_t)(x * stepsPerMm);
+        samples[i].rawCount = 84000 + (int32_t)(k * x * calib) + noise(40);
+        samples[i].timestampUs = 1000000u + (uint32_t)i * usPerPoint + (uint32_t)(noise(200) + 200);
+    }
+}
+
+static void makeHeader(ResultRecordHeader& h, CurveMeta& m, int n, uint32_t seq) {
+    memset(&h, 0, sizeof(h));
+    h.seq = seq;
+    h.uptimeMs = 60000u * seq;
+    h.sampleCount = (uint16_t)n;
+    h.kKgfMm = 0.8f;
+    h.r2 = 0.999f;
+    h.maxForceKg = 8.0f;
+    h.verdict = STORED_VERDICT_PASS;
+    strcpy(h.profile, "PN 4471-A");
+    m = CurveMeta{1600.0f, 21000.0f, 84000, 48000, samples[0].timestampUs, samples[n - 1].timestampUs};
+}
+
+// Decodifica um registro do fluxo como tools/export_client.py
+static size_t decodeRecord(const uint8_t* in, size_t len, const CurveMeta& meta, CurveSample* out,
+                           int* count) {
+    size_t n = 0;
+    uint32_t v;
+    if (in[n++] != EXPORT_RECORD_TAG) return 0;
+    n += varintGet(in + n, len - n, &v);   // seq
+    n += varintGet(in + n, len - n, &v);   // uptime
+    n += varintGet(in + n, len - n, &v);
+    *count = (int)v;
+    n += 3;
+    n += 1 + in[n];                        // nome
+    n += 5 * 4;                            // floats
+    n += varintGet(in + n, len - n, &v);
+    n += varintGet(in + n, len - n, &v);
+    int32_t step = meta.zeroSteps, raw = meta.tareOffset;
+    uint32_t t = 0;
+    for (int i = 0; i < *count; ++i) {
+        n += varintGet(in + n, len - n, &v); step += zigzagDecode(v);
+        n += varintGet(in + n, len - n, &v); raw += zigzagDecode(v);
+        n += varintGet(in + n, len - n, &v); t += v;
+        out[i] = CurveSample{step, raw, t};
+    }
+    return n;
+}
+
+// Envia o fluxo em quadros e remonta do lado do cliente; retorna bytes no fio
+static size_t sendAndRebuild(const uint8_t* data, size_t len) {
+    size_t wire = 0;
+    for (size_t off = 0; off < len; off += EXPORT_CHUNK_BYTES) {
+        size_t chunk = (len - off < EXPORT_CHUNK_BYTES) ? len - off : EXPORT_CHUNK_BYTES;
+        size_t fl = exportBuildFrame((uint32_t)off, data + off, chunk, frame, ws);
+        wire += fl;
+
+        TEST_ASSERT_EQUAL_HEX8(EXPORT_FRAME_MAGIC0, frame[0]);
+        TEST_ASSERT_EQUAL_HEX8(EXPORT_FRAME_MAGIC1, frame[1]);
+        uint32_t fOff = frame[3] | frame[4] << 8 | frame[5] << 16 | (uint32_t)frame[6] << 24;
+        size_t rawLen = frame[7] | frame[8] << 8;
+        size_t payLen = frame[9] | frame[10] << 8;
+        TEST_ASSERT_EQUAL_UINT32(off, fOff);
+        TEST_ASSERT_EQUAL_size_t(chunk, rawLen);
+        TEST_ASSERT_EQUAL_size_t(fl, payLen + EXPORT_FRAME_OVERHEAD);
+        uint32_t crc = frame[11 + payLen] | frame[12 + payLen] << 8 | frame[13 + payLen] << 16 |
+                       (uint32_t)frame[14 + payLen] << 24;
+        TEST_ASSERT_EQUAL_HEX32(crc32Update(0, frame + 2, 9 + payLen), crc);
+
+        if (frame[2] == EXPORT_FRAME_LZ) {
+            TEST_ASSERT_EQUAL_size_t(rawLen, lzDecompress(frame + 11, payLen, rebuilt + off, rawLen));
+        } else {
+            TEST_ASSERT_EQUAL_UINT8(EXPORT_FRAME_STORED, frame[2]);
+            memcpy(rebuilt + off, frame + 11, payLen);
+        }
+    }
+    wire += exportBuildEndFrame((uint32_t)len, frame);
+    TEST_ASSERT_EQUAL_UINT8(EXPORT_FRAME_END, frame[2]);
+    TEST_ASSERT_EQUAL_MEMORY(data, rebuilt, len);
+    return wire;
+}
+
+static void test_lz_round_trip_and_incompressible() {
+    static uint8_t in[EXPORT_CHUNK_BYTES], out[EXPORT_CHUNK_BYTES * 2], back[EXPORT_CHUNK_BYTES];
+    for (size_t i = 0; i < sizeof(in); ++i) in[i] = (uint8_t)("abcabcabd"[i % 9]);
+    size_t c = lzCompress(in, sizeof(in), out, sizeof(out), ws);
+    TEST_ASSERT_TRUE(c > 0 && c < sizeof(in) / 4);
+    TEST_ASSERT_EQUAL_size_t(sizeof(in), lzDecompress(out, c, back, sizeof(back)));
+    TEST_ASSERT_EQUAL_MEMORY(in, back, sizeof(in));
+
+    for (size_t i = 0; i < sizeof(in); ++i) in[i] = (uint8_t)noise(127);
+    TEST_ASSERT_EQUAL_size_t(0, lzCompress(in, sizeof(in), out, sizeof(out), ws));
+}
+
+static void test_lz_rejects_corrupt_input() {
+    static uint8_t back[EXPORT_CHUNK_BYTES];
+    const uint8_t badRef[] = {0x01, 0xFF, 0x0F};   // referência antes do início
+    TEST_ASSERT_EQUAL_size_t(0, lzDecompress(badRef, sizeof(badRef), back, sizeof(back)));
+    const uint8_t truncated[] = {0x01, 0x00};
+    TEST_ASSERT_EQUAL_size_t(0, lzDecompress(truncated, sizeof(truncated), back, sizeof(back)));
+}
+
+static void test_record_round_trip() {
+    makeCurve(256, 0.04f, 120000);
+    ResultRecordHeader h;
+    CurveMeta m;
+    makeHeader(h, m, 256, 1);
+    size_t n = exportEncodeRecord(h, m, samples, stream, sizeof(stream));
+    TEST_ASSERT_TRUE(n > 0);
+
+    static CurveSample back[256];
+    int count = 0;
+    TEST_ASSERT_EQUAL_size_t(n, decodeRecord(stream, n, m, back, &count));
+    TEST_ASSERT_EQUAL_INT(256, count);
+    TEST_ASSERT_EQUAL_MEMORY(samples, back, sizeof(back));
+
+    TEST_ASSERT_EQUAL_size_t(0, exportEncodeRecord(h, m, samples, stream, 64));
+}
+
+// Fluxo de N registros em quadros: taxa no fio contra o CSV equivalente
+static void benchmarkStream(int records, int points, float mmPerPoint, uint32_t usPerPoint,
+                            float* bytesPerSample, float* ratio) {
+    size_t len = 0, csv = 0;
+    for (int r = 0; r < records; ++r) {
+        makeCurve(points, mmPerPoint, usPerPoint);
+        ResultRecordHeader h;
+        CurveMeta m;
+        makeHeader(h, m, points, (uint32_t)r + 1);
+        len += exportEncodeRecord(h, m, samples, stream + len, sizeof(stream) - len);
+        csv += exportCsvBytes(h, samples);
+    }
+    size_t wire = sendAndRebuild(stream, len);
+    *bytesPerSample = (float)wire / (float)(records * points);
+    *ratio = (float)csv / (float)wire;
+}
+
+static void test_benchmark_wire_size_vs_csv() {
+    float bps11, ratio11, bps256, ratio256;
+    benchmarkStream(40, 11, 1.0f, 600000, &bps11, &ratio11);
+    benchmarkStream(40, 256, 0.04f, 120000, &bps256, &ratio256);
+    TEST_ASSERT_TRUE(ratio11 > 1.5f);
+    TEST_ASSERT_TRUE(ratio256 > 2.5f);
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "11 pontos: %.1f B/amostra, %.1fx menor que CSV", bps11, ratio11);
+    TEST_MESSAGE(msg);
+    snprintf(msg, sizeof(msg), "256 pontos: %.1f B/amostra, %.1fx menor que CSV", bps256, ratio256);
+    TEST_MESSAGE(msg);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_lz_round_trip_and_incompressible);
+    RUN_TEST(test_lz_rejects_corrupt_input);
+    RUN_TEST(test_record_round_trip);
+    RUN_TEST(test_benchmark_wire_size_vs_csv);
+    return UNITY_END();
+}
@@ -0,0 +1,81 @@
+#include <unity.h>
+#include "fast_io.h"
+#include "config.h"
+
+// Fora do Arduino todo FastPin usa a porta simulada
+static_assert(FAST_IO_SIMULATED, "host sempre na porta simulada");
+
+using StepPin    = FastPin<STEP_PIN>;
+using EndstopPin = FastPin<ENDSTOP_PIN>;
+using HighPin    = FastPin<40>;   // porta simulada tem 64 bits
+
+struct WriteLog {
+    int count;
+    int lastPin;
+    bool lastLevel;
+    uint64_t outAtCall;
+};
+
+static WriteLog wlog;
+
+static void recordWrite(int pin, bool level, void* ctx) {
+    WriteLog& l = *static_cast<WriteLog*>(ctx);
+    ++l.count;
+    l.lastPin = pin;
+    l.lastLevel = level;
+    l.outAtCall = simGpioPort.out;
+}
+
+void setUp() {
+    simGpioPort.out = 0;
+    simGpioPort.in = ~0ULL;
+    simGpioPort.onWrite = nullptr;
+    simGpioPort.ctx = nullptr;
+    wlog = {};
+}
+void tearDown() {
+    simGpioPort.onWrite = nullptr;
+}
+
+static void test_high_low_touch_only_own_bit() {
+    simGpioPort.out = 1ULL << DIR_PIN;
+    StepPin::high();
+    TEST_ASSERT_TRUE(simGpioPort.out == ((1ULL << DIR_PIN) | (1ULL << STEP_PIN)));
+    StepPin::low();
+    TEST_ASSERT_TRUE(simGpioPort.out == (1ULL << DIR_PIN));
+    HighPin::write(true);
+    TEST_ASSERT_TRUE((simGpioPort.out >> 40) & 1ULL);
+    HighPin::write(false);
+    TEST_ASSERT_TRUE(simGpioPort.out == (1ULL << DIR_PIN));
+}
+
+// O gancho vê o nível já aplicado na porta (o simulador lê DIR dali)
+static void test_write_hook_sees_new_level() {
+    simGpioPort.onWrite = recordWrite;
+    simGpioPort.ctx = &wlog;
+    StepPin::high();
+    TEST_ASSERT_EQUAL_INT(1, wlog.count);
+    TEST_ASSERT_EQUAL_INT(STEP_PIN, wlog.lastPin);
+    TEST_ASSERT_TRUE(wlog.lastLevel);
+    TEST_ASSERT_TRUE((wlog.outAtCall >> STEP_PIN) & 1ULL);
+    StepPin::write(false);
+    TEST_ASSERT_EQUAL_INT(2, wlog.count);
+    TEST_ASSERT_FALSE(wlog.lastLevel);
+    TEST_ASSERT_FALSE((wlog.outAtCall >> STEP_PIN) & 1ULL);
+}
+
+// Entradas com pull-up: repouso alto; endstop acionado puxa para GND
+static void test_read_follows_input_port() {
+    TEST_ASSERT_TRUE(EndstopPin::read());
+    simGpioPort.in = simGpioPort.in & ~(1ULL << ENDSTOP_PIN);
+    TEST_ASSERT_FALSE(EndstopPin::read());
+    TEST_ASSERT_TRUE(StepPin::read());   // outros bits não mudam
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_high_low_touch_only_own_bit);
+    RUN_TEST(test_write_hook_sees_new_level);
+    RUN_TEST(test_read_follows_input_port);
+    return UNITY_END();
+}
@@ -0,0 +1,234 @@
+#include <unity.h>
+#include <cstdio>
+#include "motion_phase.h"
+#include "tmc_register_cache.h"
+#include "rig_sim.h"
+
+// Driver falso no nível de registrador: as chamadas alteram a cópia local
+// como TMC2209Manager::modifyReg() e só waitFlushed() fala com a "UART"
+enum MockCall : uint8_t { CALL_MRES, CALL_CURRENT, CALL_CHOPPER, CALL_FLUSH };
+
+struct MockDriver {
+    TmcRegisterCache cache;
+    uint32_t regs[TMC_REG_COUNT];
+    MockCall calls[8];
+    int      callCount;
+    TmcReg   uart[8];          // transações na ordem de envio
+    int      uartCount;
+    int      uartBeforeFlush;  // transações antes do waitFlushed()
+    bool     flushOk;
+    const MotionPhaseAxis* axis;
+    long     incrementAtFlush; // eixo visto pelo driver durante o flush
+};
+
+static MockDriver mock;
+
+static void record(MockCall c) {
+    if (mock.callCount < 8) mock.calls[mock.callCount] = c;
+    ++mock.callCount;
+}
+
+static void modifyReg(TmcReg reg, uint32_t mask, uint32_t bits) {
+    mock.cache.write(reg, (mock.cache.shadow(reg) & ~mask) | (bits & mask));
+}
+
+static uint32_t mresFor(uint16_t microsteps) {
+    uint32_t mres = 0;
+    while ((256u >> mres) > microsteps) ++mres;
+    return mres;
+}
+
+static void mockSetMicrosteps(uint16_t microsteps, void*) {
+    record(CALL_MRES);
+    modifyReg(TMC_REG_CHOPCONF, TMC_CHOPCONF_MRES_MASK, mresFor(microsteps) << TMC_CHOPCONF_MRES_SHIFT);
+}
+
+// 50 mA por passo de CS basta para distinguir as fases
+static void mockSetCurrent(uint16_t runMa, uint16_t holdMa, void*) {
+    record(CALL_CURRENT);
+    uint32_t irun = runMa / 50, ihold = holdMa / 50;
+    modifyReg(TMC_REG_IHOLD_IRUN, TMC_IHOLD_MASK | TMC_IRUN_MASK, ihold | (irun << TMC_IRUN_SHIFT));
+}
+
+static void mockEnableStealthChop(bool enable, void*) {
+    record(CALL_CHOPPER);
+    modifyReg(TMC_REG_GCONF, TMC_GCONF_EN_SPREADCYCLE, enable ? 0 : TMC_GCONF_EN_SPREADCYCLE);
+}
+
+static bool mockWaitFlushed(uint32_t timeoutMs, void*) {
+    record(CALL_FLUSH);
+    TEST_ASSERT_EQUAL_UINT32(TMC_FLUSH_TIMEOUT_MS, timeoutMs);
+    mock.uartBeforeFlush = mock.uartCount;
+    mock.incrementAtFlush = mock.axis->pulseIncrement;
+    if (!mock.flushOk) return false;
+    TmcReg reg;
+    uint32_t value;
+    while (mock.cache.takePending(&reg, &value)) {
+        mock.regs[reg] = value;
+        if (mock.uartCount < 8) mock.uart[mock.uartCount] = reg;
+        ++mock.uartCount;
+        mock.cache.commit(reg, value);
+    }
+    return true;
+}
+
+static const MotionPhaseDriverHal hal = {
+    mockSetMicrosteps, mockSetCurrent, mockEnableStealthChop, mockWaitFlushed, nullptr
+};
+
+static MotionPhaseAxis axis;
+
+// Driver como o begin() deixa: 1/TMC_DEFAULT_MICROSTEPS, corrente de boot, StealthChop
+void setUp() {
+    mock = MockDriver{};
+    mock.flushOk = true;
+    mock.axis = &axis;
+    axis = MotionPhaseAxis();
+    uint32_t boot[TMC_REG_COUNT] = {};
+    boot[TMC_REG_CHOPCONF] = mresFor(TMC_DEFAULT_MICROSTEPS) << TMC_CHOPCONF_MRES_SHIFT;
+    boot[TMC_REG_IHOLD_IRUN] = (TMC_CURRENT_HOLD / 50) | ((uint32_t)(TMC_CURRENT_RMS / 50) << TMC_IRUN_SHIFT);
+    for (uint8_t r = 0; r < TMC_REG_COUNT; ++r) {
+        mock.cache.seed((TmcReg)r, boot[r]);
+        mock.regs[r] = boot[r];
+    }
+}
+void tearDown() {}
+
+static uint32_t mresOf(uint32_t chopconf) {
+    return (chopconf & TMC_CHOPCONF_MRES_MASK) >> TMC_CHOPCONF_MRES_SHIFT;
+}
+
+static uint32_t irunOf(uint32_t iholdIrun) {
+    return (iholdIrun & TMC_IRUN_MASK) >> TMC_IRUN_SHIFT;
+}
+
+// MRES, corrente e chopper só na cópia local; o flush envia tudo antes do eixo mudar
+static void test_switch_sequence_and_uart_order() {
+    TEST_ASSERT_TRUE(applyMotionPhase(hal, MOTION_PHASE_TRAVEL_CFG, axis));
+    TEST_ASSERT_EQUAL_INT(4, mock.callCount);
+    TEST_ASSERT_EQUAL_INT(CALL_MRES, mock.calls[0]);
+    TEST_ASSERT_EQUAL_INT(CALL_CURRENT, mock.calls[1]);
+    TEST_ASSERT_EQUAL_INT(CALL_CHOPPER, mock.calls[2]);
+    TEST_ASSERT_EQUAL_INT(CALL_FLUSH, mock.calls[3]);
+    TEST_ASSERT_EQUAL_INT(0, mock.uartBeforeFlush);
+    TEST_ASSERT_EQUAL_INT(1, mock.incrementAtFlush);   // eixo ainda na fase antiga
+
+    // Uma transação por registrador alterado, na ordem da tarefa da UART
+    TEST_ASSERT_EQUAL_INT(3, mock.uartCount);
+    TEST_ASSERT_EQUAL_INT(TMC_REG_GCONF, mock.uart[0]);
+    TEST_ASSERT_EQUAL_INT(TMC_REG_IHOLD_IRUN, mock.uart[1]);
+    TEST_ASSERT_EQUAL_INT(TMC_REG_CHOPCONF, mock.uart[2]);
+    TEST_ASSERT_EQUAL_UINT32(mresFor(MOTION_PHASE_TRAVEL_CFG.microsteps), mresOf(mock.regs[TMC_REG_CHOPCONF]));
+    TEST_ASSERT_EQUAL_UINT32(MOTION_PHASE_TRAVEL_CFG.currentMa / 50, irunOf(mock.regs[TMC_REG_IHOLD_IRUN]));
+    TEST_ASSERT_EQUAL_UINT32(TMC_GCONF_EN_SPREADCYCLE, mock.regs[TMC_REG_GCONF]);
+    TEST_ASSERT_FALSE(mock.cache.hasPending());
+
+    TEST_ASSERT_EQUAL_INT(TMC_FINE_MICROSTEPS / MOTION_PHASE_TRAVEL_CFG.microsteps, axis.pulseIncrement);
+    TEST_ASSERT_EQUAL_UINT16(MOTION_PHASE_TRAVEL_CFG.microsteps, axis.microsteps);
+    TEST_ASSERT_EQUAL_UINT8(MOTION_PHASE_TRAVEL_CFG.speedPct, axis.speedPct);
+    TEST_ASSERT_FALSE(axis.stealthChop);
+}
+
+// TRAVEL -> HOMING muda só corrente e chopper: MRES igual não vai para a UART
+static void test_unchanged_registers_are_not_sent() {
+    applyMotionPhase(hal, MOTION_PHASE_TRAVEL_CFG, axis);
+    mock.uartCount = 0;
+    applyMotionPhase(hal, MOTION_PHASE_HOMING_CFG, axis);
+    TEST_ASSERT_EQUAL_INT(2, mock.uartCount);
+    TEST_ASSERT_EQUAL_INT(TMC_REG_GCONF, mock.uart[0]);
+    TEST_ASSERT_EQUAL_INT(TMC_REG_IHOLD_IRUN, mock.uart[1]);
+    TEST_ASSERT_EQUAL_UINT32(0, mock.regs[TMC_REG_GCONF]);
+
+    mock.uartCount = 0;
+    applyMotionPhase(hal, MOTION_PHASE_HOMING_CFG, axis);
+    TEST_ASSERT_EQUAL_INT(0, mock.uartCount);
+}
+
+// Sem confirmação o eixo segue a fase pedida e o chamador avisa
+static void test_flush_timeout_is_reported() {
+    mock.flushOk = false;
+    TEST_ASSERT_FALSE(applyMotionPhase(hal, MOTION_PHASE_MEASURE_CFG, axis));
+    TEST_ASSERT_TRUE(mock.cache.hasPending());
+    TEST_ASSERT_EQUAL_INT(0, mock.uartCount);
+    TEST_ASSERT_EQUAL_INT(1, axis.pulseIncrement);
+    TEST_ASSERT_EQUAL_UINT16(MOTION_PHASE_MEASURE_CFG.microsteps, axis.microsteps);
+}
+
+// Posição em 1/16 atravessando as fases: a mesma distância em mm dá a mesma
+// contagem, com 4 unidades por pulso no deslocamento e 1 na medição
+static void test_position_rescale_across_phases() {
+    using Coarse = AxisScale<ActiveRig, TMC_DEFAULT_MICROSTEPS>;
+    using Fine   = AxisScale<ActiveRig, TMC_FINE_MICROSTEPS>;
+    long pos = Coarse::mmToUnits(12.5f);
+    pos = motionPhaseFineUnits(pos);
+    TEST_ASSERT_EQUAL_INT32(Fine::mmToUnits(12.5f), pos);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 12.5f, Fine::unitsToMm(pos));
+
+    applyMotionPhase(hal, MOTION_PHASE_TRAVEL_CFG, axis);
+    long pulses = Fine::mmToUnits(7.5f) / axis.pulseIncrement;
+    pos += pulses * axis.pulseIncrement;
+    applyMotionPhase(hal, MOTION_PHASE_MEASURE_CFG, axis);
+    pulses = Fine::mmToUnits(0.025f) / axis.pulseIncrement;
+    pos -= pulses * axis.pulseIncrement;
+    TEST_ASSERT_EQUAL_INT32(Fine::mmToUnits(19.975f), pos);
+    TEST_ASSERT_EQUAL_INT32(19975, Fine::unitsToUm(pos));
+    TEST_ASSERT_EQUAL_UINT32(mresFor(TMC_FINE_MICROSTEPS), mresOf(mock.regs[TMC_REG_CHOPCONF]));
+    TEST_ASSERT_EQUAL_INT(TMC_FINE_MICROSTEPS, 256u >> mresOf(mock.regs[TMC_REG_CHOPCONF]));
+}
+
+// usDelay mantém a velocidade em mm/s em qualquer microstep; speedPct escala
+static void test_pulse_delay_keeps_mm_per_s() {
+    const uint16_t usDelay = 800;
+    float defaultMmS = 1e6f / (usDelay + STEP_PULSE_US) / ActiveRig::STEPS_PER_MM;
+    float fineUnitsPerMm = (float)AxisScale<ActiveRig, TMC_FINE_MICROSTEPS>::UNITS_PER_MM;
+    const MotionPhaseConfig* cfgs[] = {&MOTION_PHASE_TRAVEL_CFG, &MOTION_PHASE_HOMING_CFG,
+                                       &MOTION_PHASE_MEASURE_CFG};
+    for (const MotionPhaseConfig* cfg : cfgs) {
+        applyMotionPhase(hal, *cfg, axis);
+        float pulsesPerMm = fineUnitsPerMm / axis.pulseIncrement;
+        float mmS = 1e6f / (motionPhasePulseDelayUs(usDelay, axis) + STEP_PULSE_US) / pulsesPerMm;
+        TEST_ASSERT_FLOAT_WITHIN(0.01f * defaultMmS, defaultMmS * cfg->speedPct / 100.0f, mmS);
+    }
+}
+
+// Simulador: deslocamento de aproximação (30 mm) e curso de medição (2 mm)
+// em cada fase. Deslocamento ganha tempo, medição ganha resolução
+static void test_sim_travel_time_and_resolution_per_phase() {
+    struct Move { const char* name; float mm; };
+    const Move moves[] = {{"aproximacao", 30.0f}, {"compressao", 2.0f}};
+    const uint16_t usDelay = 150;   // ~3,9 mm/s: acima de STEPPER_START_MM_S nas duas fases
+    for (const Move& m : moves) {
+        PhaseMoveReport travel  = rigSimPhaseMove(MOTION_PHASE_TRAVEL_CFG, m.mm, usDelay);
+        PhaseMoveReport measure = rigSimPhaseMove(MOTION_PHASE_MEASURE_CFG, m.mm, usDelay);
+        char msg[200];
+        snprintf(msg, sizeof(msg),
+                 "%s %.0f mm: TRAVEL %6.1f ms %5.2f mm/s %.3f um/pulso | "
+                 "MEASURE %6.1f ms %5.2f mm/s %.4f um/pulso",
+                 m.name, m.mm, travel.travelMs, travel.cruiseMmS, travel.resolutionUm,
+                 measure.travelMs, measure.cruiseMmS, measure.resolutionUm);
+        TEST_MESSAGE(msg);
+        TEST_ASSERT_TRUE(travel.travelMs < measure.travelMs);
+        TEST_ASSERT_FLOAT_WITHIN(0.01f * measure.cruiseMmS,
+                                 measure.cruiseMmS * MOTION_PHASE_TRAVEL_CFG.speedPct / 100.0f,
+                                 travel.cruiseMmS);
+        TEST_ASSERT_FLOAT_WITHIN(1e-3f, measure.resolutionUm * 4.0f, travel.resolutionUm);
+        TEST_ASSERT_EQUAL_UINT32(travel.pulses * 4, measure.pulses);
+    }
+    // Alvo fora da grade de 1/4: erro de até meio pulso grosso, zero em 1/16
+    PhaseMoveReport travel  = rigSimPhaseMove(MOTION_PHASE_TRAVEL_CFG, 1.0003f, usDelay);
+    PhaseMoveReport measure = rigSimPhaseMove(MOTION_PHASE_MEASURE_CFG, 1.0003f, usDelay);
+    TEST_ASSERT_TRUE(travel.targetErrorUm > 0.0f);
+    TEST_ASSERT_TRUE(travel.targetErrorUm <= travel.resolutionUm / 2.0f + 1e-3f);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, measure.targetErrorUm);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_switch_sequence_and_uart_order);
+    RUN_TEST(test_unchanged_registers_are_not_sent);
+    RUN_TEST(test_flush_timeout_is_reported);
+    RUN_TEST(test_position_rescale_across_phases);
+    RUN_TEST(test_pulse_delay_keeps_mm_per_s);
+    RUN_TEST(test_sim_travel_time_and_resolution_per_phase);
+    return UNITY_END();
+}
@@ -0,0 +1,120 @@
+#include <unity.h>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include "motion_queue.h"
+#include "config.h"
+
+void setUp() {}
+void tearDown() {}
+
+// Fase de medição: 1/16, uma unidade por pulso, 60 µs da ciclagem ~ 35 µs/pulso
+static const float UNITS_PER_MM = (float)ActiveRig::STEPS_PER_MM *
+                                  (float)(TMC_FINE_MICROSTEPS / TMC_DEFAULT_MICROSTEPS);
+static const float ACCEL = STEPPER_ACCEL_MM_S2 * UNITS_PER_MM;
+static const float MIN_PPS = STEPPER_START_MM_S * UNITS_PER_MM;
+
+static float cruiseOf(uint16_t usDelay, void*) {
+    return 1e6f / ((float)usDelay * 0.5f + (float)STEP_PULSE_US * 0.5f);
+}
+
+// Tempo de execução do plano: soma dos períodos de cada pulso (em ms)
+static double planMs(const MotionQueue& q) {
+    double us = 0.0;
+    for (int i = 0; i < q.size(); ++i) {
+        for (long k = 0; k < q[i].pulses; ++k) us += 1e6 / segmentRateAt(q[i], k, ACCEL);
+    }
+    return us / 1000.0;
+}
+
+// Curso da ciclagem: 20 pontos de 0.25 mm para baixo e o retorno
+static void buildStroke(MotionQueue& q, SegmentAction pointAction) {
+    q.clear();
+    const int points = 20;
+    for (int i = 1; i <= points; ++i) {
+        long target = -lroundf((float)i * 0.25f * UNITS_PER_MM);
+        q.push(target, FATIGUE_STEP_DELAY_US, (i == points) ? SEG_ACTION_DWELL : pointAction, 0,
+               (uint16_t)i);
+    }
+    q.push(0, FATIGUE_STEP_DELAY_US);
+}
+
+static void test_pulses_and_directions() {
+    MotionQueue q;
+    q.push(100, 60);
+    q.push(100, 60);   // parado
+    q.push(-50, 60);
+    q.plan(0, 1, ACCEL, MIN_PPS, cruiseOf, nullptr);
+    TEST_ASSERT_EQUAL_INT32(100, q[0].pulses);
+    TEST_ASSERT_EQUAL_INT8(1, q[0].dir);
+    TEST_ASSERT_EQUAL_INT32(0, q[1].pulses);
+    TEST_ASSERT_EQUAL_INT8(0, q[1].dir);
+    TEST_ASSERT_EQUAL_INT32(150, q[2].pulses);
+    TEST_ASSERT_EQUAL_INT8(-1, q[2].dir);
+}
+
+static void test_units_per_pulse_rounding_carries() {
+    MotionQueue q;
+    for (int i = 1; i <= 10; ++i) q.push(i * 3, 60);
+    q.plan(0, 2, ACCEL, MIN_PPS, cruiseOf, nullptr);
+    // 3 unidades = 1.5 pulso: o resto passa adiante e o erro não acumula
+    long pos = 0;
+    for (int i = 0; i < q.size(); ++i) {
+        pos += q[i].dir * q[i].pulses * 2;
+        TEST_ASSERT_TRUE(labs(pos - q[i].target) <= 1);
+    }
+}
+
+static void test_junctions_blend_and_stop() {
+    MotionQueue q;
+    buildStroke(q, SEG_ACTION_SAMPLE);
+    q.plan(0, 1, ACCEL, MIN_PPS, cruiseOf, nullptr);
+    TEST_ASSERT_EQUAL_FLOAT(MIN_PPS, q[0].entryPps);
+    TEST_ASSERT_TRUE(q[5].entryPps > MIN_PPS);           // atravessa a junção
+    TEST_ASSERT_EQUAL_FLOAT(MIN_PPS, q[19].exitPps);      // dwell no fundo
+    TEST_ASSERT_EQUAL_FLOAT(MIN_PPS, q[20].entryPps);     // reversão
+    TEST_ASSERT_EQUAL_FLOAT(MIN_PPS, q[20].exitPps);      // fim da fila
+    // Nenhum segmento pede mais do que a aceleração entrega
+    for (int i = 0; i < q.size(); ++i) {
+        float maxExit = sqrtf(q[i].entryPps * q[i].entryPps + 2.0f * ACCEL * (float)q[i].pulses);
+        TEST_ASSERT_TRUE(q[i].exitPps <= maxExit + 1.0f);
+        TEST_ASSERT_TRUE(q[i].entryPps <= q[i].cruisePps + 1.0f);
+    }
+}
+
+static void test_rate_profile_is_trapezoid() {
+    MotionQueue q;
+    q.push(20000, 60);
+    q.plan(0, 1, ACCEL, MIN_PPS, cruiseOf, nullptr);
+    const MotionSegment& s = q[0];
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, MIN_PPS, segmentRateAt(s, 0, ACCEL));
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, s.cruisePps, segmentRateAt(s, 10000, ACCEL));
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, MIN_PPS, segmentRateAt(s, s.pulses - 1, ACCEL));
+}
+
+// Referência do commit original: curso com junções combinadas x paradas em todo ponto
+static void test_benchmark_blended_vs_stop_at_every_point() {
+    MotionQueue blended, stopping;
+    buildStroke(blended, SEG_ACTION_SAMPLE);
+    buildStroke(stopping, SEG_ACTION_DWELL);
+    blended.plan(0, 1, ACCEL, MIN_PPS, cruiseOf, nullptr);
+    stopping.plan(0, 1, ACCEL, MIN_PPS, cruiseOf, nullptr);
+    double tBlend = planMs(blended);
+    double tStop = planMs(stopping);
+    TEST_ASSERT_TRUE(tBlend < tStop);
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "curso 20 x 0.25 mm + retorno: combinado %.0f ms, parando %.0f ms",
+             tBlend, tStop);
+    TEST_MESSAGE(msg);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_pulses_and_directions);
+    RUN_TEST(test_units_per_pulse_rounding_carries);
+    RUN_TEST(test_junctions_blend_and_stop);
+    RUN_TEST(test_rate_profile_is_trapezoid);
+    RUN_TEST(test_benchmark_blended_vs_stop_at_every_point);
+    return UNITY_END();
+}
@@ -0,0 +1,91 @@
+#include <unity.h>
+#include <type_traits>
+#include "config.h"
+
+// env:native compila com -DRIG_SIM: o perfil ativo é a simulação
+static_assert(std::is_same<ActiveRig, SimRig>::value, "env:native deve usar SimRig");
+static_assert(ActiveRig::SIMULATED, "SimRig não usa GPIO real");
+static_assert(!RigRevA::SIMULATED && !RigRevB::SIMULATED, "revisões de hardware");
+
+// Mecânica da rev A na simulação: os números do host valem para a bancada
+static_assert(SimRig::STEPS_PER_MM == RigRevA::STEPS_PER_MM, "SimRig segue a rev A");
+static_assert(SimRig::STEP_PIN == RigRevA::STEP_PIN && SimRig::ENDSTOP_PIN == RigRevA::ENDSTOP_PIN,
+              "mesmo mapa de pinos");
+
+using Coarse = AxisScale<ActiveRig, TMC_DEFAULT_MICROSTEPS>;
+using Fine   = AxisScale<ActiveRig, TMC_FINE_MICROSTEPS>;
+
+void setUp() {}
+void tearDown() {}
+
+static void test_steps_per_mm() {
+    TEST_ASSERT_EQUAL_UINT32(1600, RigRevA::STEPS_PER_REV);
+    TEST_ASSERT_EQUAL_INT32(1600, RigRevA::STEPS_PER_MM);
+    TEST_ASSERT_EQUAL_INT32(1600, RigRevB::STEPS_PER_MM);   // 3200 passos/volta, fuso 2 mm
+    TEST_ASSERT_EQUAL_FLOAT((float)SimRig::STEPS_PER_MM, STEPPER_STEPS_PER_MM);
+    TEST_ASSERT_EQUAL_FLOAT((float)SimRig::LOADCELL_CAPACITY_KG, GRAPH_MAX_FORCE_KG);
+}
+
+static void test_config_exposes_active_pins() {
+    TEST_ASSERT_EQUAL_INT(ActiveRig::STEP_PIN, STEP_PIN);
+    TEST_ASSERT_EQUAL_INT(ActiveRig::DIR_PIN, DIR_PIN);
+    TEST_ASSERT_EQUAL_INT(ActiveRig::ENDSTOP_PIN, ENDSTOP_PIN);
+    TEST_ASSERT_EQUAL_INT(ActiveRig::TMC_DIAG_PIN, TMC_DIAG_PIN);
+    TEST_ASSERT_EQUAL_UINT16(ActiveRig::MICROSTEPS, TMC_DEFAULT_MICROSTEPS);
+}
+
+static void test_fine_units_scale_with_microsteps() {
+    TEST_ASSERT_EQUAL_INT32(ActiveRig::STEPS_PER_MM, Coarse::UNITS_PER_MM);
+    TEST_ASSERT_EQUAL_INT32(ActiveRig::STEPS_PER_MM * (TMC_FINE_MICROSTEPS / TMC_DEFAULT_MICROSTEPS),
+                            Fine::UNITS_PER_MM);
+}
+
+// Arredondamento ao mais próximo, simétrico em torno de zero
+static void test_um_units_rounding() {
+    TEST_ASSERT_EQUAL_INT32(1600, Coarse::umToUnits(1000));
+    TEST_ASSERT_EQUAL_INT32(-1600, Coarse::umToUnits(-1000));
+    TEST_ASSERT_EQUAL_INT32(2, Coarse::umToUnits(1));      // 1,6 -> 2
+    TEST_ASSERT_EQUAL_INT32(-2, Coarse::umToUnits(-1));
+    TEST_ASSERT_EQUAL_INT32(1, Coarse::unitsToUm(2));      // 1,25 µm -> 1
+    TEST_ASSERT_EQUAL_INT32(-1, Coarse::unitsToUm(-2));
+    for (int32_t um = -5000; um <= 5000; um += 7) {
+        TEST_ASSERT_EQUAL_INT32(um, Coarse::unitsToUm(Coarse::umToUnits(um)));
+        TEST_ASSERT_EQUAL_INT32(um, Fine::unitsToUm(Fine::umToUnits(um)));
+    }
+}
+
+static void test_mm_units() {
+    TEST_ASSERT_EQUAL_INT32(16000, Coarse::mmToUnits(10.0f));
+    TEST_ASSERT_EQUAL_INT32(-800, Coarse::mmToUnits(-0.5f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 10.0f, Coarse::unitsToMm(16000));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, -0.5f, Fine::unitsToMm(Fine::mmToUnits(-0.5f)));
+}
+
+// mm do firmware passa pela conversão inteira: mesmo resultado de umToUnits
+// para os valores de config/comando (µm inteiros), sem erro de float em
+// cursos longos
+static void test_mm_units_use_integer_path() {
+    const float mms[] = {0.25f, 0.5f, 2.0f, 10.0f, 30.0f, 133.333f, 250.0f, -0.25f, -19.975f};
+    for (float mm : mms) {
+        int32_t um = Coarse::mmToUm(mm);
+        TEST_ASSERT_EQUAL_INT32(Coarse::umToUnits(um), Coarse::mmToUnits(mm));
+        TEST_ASSERT_EQUAL_INT32(Fine::umToUnits(um), Fine::mmToUnits(mm));
+    }
+    TEST_ASSERT_EQUAL_INT32(133333, Coarse::mmToUm(133.333f));
+    TEST_ASSERT_EQUAL_INT32(400000, Coarse::mmToUnits(250.0f));
+    TEST_ASSERT_EQUAL_INT32(Fine::umToUnits(1), Fine::mmToUnits(0.0012f));   // abaixo de 1 µm: arredonda
+}
+
+// Tudo constexpr: conversões usáveis em static_assert
+static_assert(Coarse::umToUnits(2500) == 4000, "conversão em tempo de compilação");
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_steps_per_mm);
+    RUN_TEST(test_config_exposes_active_pins);
+    RUN_TEST(test_fine_units_scale_with_microsteps);
+    RUN_TEST(test_um_units_rounding);
+    RUN_TEST(test_mm_units);
+    RUN_TEST(test_mm_units_use_integer_path);
+    return UNITY_END();
+}
@@ -0,0 +1,108 @@
+#include <unity.h>
+#include <cstdio>
+#include "rig_sim.h"
+#include "fast_io.h"
+#include "config.h"
+
+static const uint16_t RUNS = 200;
+
+static RigSimConfig makeConfig(float jitterUm, uint32_t bounceUs, float glitchPerS) {
+    RigSimConfig cfg = {jitterUm, bounceUs, RIG_SIM_BOUNCE_EDGE_US, glitchPerS, RIG_SIM_GLITCH_US,
+                        RIG_SIM_STEP_DELAY_US, RIG_SIM_START_MM, 12345u};
+    return cfg;
+}
+
+static void report(const char* name, const HomeRepeatability& polled, const HomeRepeatability& latched) {
+    char msg[200];
+    snprintf(msg, sizeof(msg),
+             "%-22s polled std %.3f um span %.2f falsos %u | latch std %.3f um span %.2f falsos %u bordas %.1f",
+             name, polled.stdUm, polled.spanUm, (unsigned)polled.falseHomes, latched.stdUm,
+             latched.spanUm, (unsigned)latched.falseHomes, latched.meanEdges);
+    TEST_MESSAGE(msg);
+}
+
+void setUp() {}
+void tearDown() {}
+
+// Switch ideal: os dois modos zeram no mesmo passo, sempre
+static void test_ideal_switch_is_exact() {
+    RigSimConfig cfg = makeConfig(0.0f, 0, 0.0f);
+    HomeRepeatability polled = rigSimHomeRepeatability(cfg, 20, false);
+    HomeRepeatability latched = rigSimHomeRepeatability(cfg, 20, true);
+    TEST_ASSERT_EQUAL_UINT16(20, polled.runs);
+    TEST_ASSERT_EQUAL_UINT16(0, polled.notFound + polled.falseHomes);
+    TEST_ASSERT_EQUAL_UINT16(0, latched.notFound + latched.falseHomes);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, polled.stdUm);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, latched.stdUm);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f, latched.meanEdges);
+}
+
+// O simulador devolve o gancho da porta simulada como estava
+static void test_restores_port_hook() {
+    int marker = 0;
+    auto hook = [](int, bool, void*) {};
+    simGpioPort.onWrite = hook;
+    simGpioPort.ctx = &marker;
+    rigSimHomeRepeatability(makeConfig(0.0f, 0, 0.0f), 2, true);
+    TEST_ASSERT_TRUE(simGpioPort.onWrite == hook);
+    TEST_ASSERT_TRUE(simGpioPort.ctx == &marker);
+    simGpioPort.onWrite = nullptr;
+    simGpioPort.ctx = nullptr;
+}
+
+// Mesma semente, mesmo resultado (HOMESIM usa millis() como semente)
+static void test_seed_is_reproducible() {
+    RigSimConfig cfg = makeConfig(1.0f, 2000, 10.0f);
+    HomeRepeatability a = rigSimHomeRepeatability(cfg, 30, false);
+    HomeRepeatability b = rigSimHomeRepeatability(cfg, 30, false);
+    TEST_ASSERT_EQUAL_FLOAT(a.stdUm, b.stdUm);
+    TEST_ASSERT_EQUAL_UINT16(a.falseHomes, b.falseHomes);
+}
+
+// ---- Levantamento HOMESIM: 200 homings a 133 µs/passo (0,625 µm/passo) ----
+
+static void test_bounce_benchmark() {
+    const uint32_t bounces[] = {0, 500, 2000};
+    for (uint32_t bounceUs : bounces) {
+        RigSimConfig cfg = makeConfig(0.0f, bounceUs, 0.0f);
+        HomeRepeatability polled = rigSimHomeRepeatability(cfg, RUNS, false);
+        HomeRepeatability latched = rigSimHomeRepeatability(cfg, RUNS, true);
+        char name[32];
+        snprintf(name, sizeof(name), "bounce %lu us", (unsigned long)bounceUs);
+        report(name, polled, latched);
+        // Com latch o zero é a primeira borda: bounce não espalha o home
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, latched.stdUm);
+        TEST_ASSERT_EQUAL_UINT16(0, latched.falseHomes + latched.notFound);
+        if (bounceUs >= 2000) TEST_ASSERT_TRUE(polled.stdUm > 0.3f);
+    }
+}
+
+static void test_glitch_benchmark() {
+    RigSimConfig cfg = makeConfig(0.0f, RIG_SIM_BOUNCE_US, 50.0f);
+    HomeRepeatability polled = rigSimHomeRepeatability(cfg, RUNS, false);
+    HomeRepeatability latched = rigSimHomeRepeatability(cfg, RUNS, true);
+    report("ruido 50/s", polled, latched);
+    TEST_ASSERT_TRUE(polled.falseHomes > RUNS / 4);
+    TEST_ASSERT_EQUAL_UINT16(0, latched.falseHomes);
+}
+
+static void test_jitter_benchmark() {
+    RigSimConfig cfg = makeConfig(RIG_SIM_TRIP_JITTER_UM, RIG_SIM_BOUNCE_US, 0.0f);
+    HomeRepeatability polled = rigSimHomeRepeatability(cfg, RUNS, false);
+    HomeRepeatability latched = rigSimHomeRepeatability(cfg, RUNS, true);
+    report("espalhamento 1 um", polled, latched);
+    // Sobra só o espalhamento mecânico (~1 µm) mais a quantização do passo
+    TEST_ASSERT_TRUE(latched.stdUm < polled.stdUm);
+    TEST_ASSERT_TRUE(latched.stdUm < 1.5f * RIG_SIM_TRIP_JITTER_UM);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_ideal_switch_is_exact);
+    RUN_TEST(test_restores_port_hook);
+    RUN_TEST(test_seed_is_reproducible);
+    RUN_TEST(test_bounce_benchmark);
+    RUN_TEST(test_glitch_benchmark);
+    RUN_TEST(test_jitter_benchmark);
+    return UNITY_END();
+}
@@ -0,0 +1,87 @@
+#include <unity.h>
+#include <cstdlib>
+#include <new>
+#include "sample_arena.h"
+
+// Conta alocações do programa inteiro: a arena não pode usar heap
+static volatile unsigned s_allocs = 0;
+
+void* operator new(std::size_t n) {
+    ++s_allocs;
+    void* p = std::malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](std::size_t n) { return operator new(n); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+void setUp() {}
+void tearDown() {}
+
+static CurveSample sampleAt(int i) {
+    CurveSample s;
+    s.stepPos = i;
+    s.rawCount = 1000 + i;
+    s.timestampUs = (uint32_t)i * 100u;
+    return s;
+}
+
+static void test_fills_without_decimation() {
+    static SampleArena<16> arena;
+    arena.clear();
+    for (int i = 0; i < 16; ++i) TEST_ASSERT_TRUE(arena.push(sampleAt(i)));
+    TEST_ASSERT_EQUAL_INT(16, arena.size());
+    TEST_ASSERT_EQUAL_UINT32(1, arena.stride());
+    TEST_ASSERT_EQUAL_INT32(15, arena.back().stepPos);
+}
+
+// Curso longo: tamanho limitado, grade uniforme, primeira amostra mantida
+static void test_long_run_keeps_uniform_grid() {
+    static SampleArena<256> arena;
+    arena.clear();
+    const int offered = 100000;
+    for (int i = 0; i < offered; ++i) arena.push(sampleAt(i));
+
+    TEST_ASSERT_TRUE(arena.size() <= arena.capacity());
+    TEST_ASSERT_TRUE(arena.size() > arena.capacity() / 2);
+    uint32_t stride = arena.stride();
+    TEST_ASSERT_EQUAL_INT32(0, arena[0].stepPos);
+    for (int i = 1; i < arena.size(); ++i) {
+        TEST_ASSERT_EQUAL_INT32((int32_t)stride, arena[i].stepPos - arena[i - 1].stepPos);
+        TEST_ASSERT_EQUAL_INT32(1000 + arena[i].stepPos, arena[i].rawCount);
+    }
+    // Cobre o curso inteiro: a última amostra está a menos de um passo do fim
+    TEST_ASSERT_TRUE(offered - 1 - arena.back().stepPos < (int)stride);
+}
+
+static void test_clear_restarts() {
+    static SampleArena<8> arena;
+    for (int i = 0; i < 100; ++i) arena.push(sampleAt(i));
+    arena.clear();
+    TEST_ASSERT_TRUE(arena.empty());
+    TEST_ASSERT_EQUAL_UINT32(1, arena.stride());
+    TEST_ASSERT_TRUE(arena.push(sampleAt(7)));
+    TEST_ASSERT_EQUAL_INT32(7, arena[0].stepPos);
+}
+
+static void test_no_heap_allocation() {
+    static SampleArena<256> arena;
+    unsigned before = s_allocs;
+    arena.clear();
+    for (int i = 0; i < 50000; ++i) arena.push(sampleAt(i));
+    TEST_ASSERT_EQUAL_UINT32(before, s_allocs);
+    static_assert(sizeof(SampleArena<256>) <= 256 * sizeof(CurveSample) + 16,
+                  "arena = amostras + contadores");
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_fills_without_decimation);
+    RUN_TEST(test_long_run_keeps_uniform_grid);
+    RUN_TEST(test_clear_restarts);
+    RUN_TEST(test_no_heap_allocation);
+    return UNITY_END();
+}
@@ -0,0 +1,105 @@
+#include <unity.h>
+#include "sensorless_homing.h"
+
+// Modelo do eixo: batente mecânico em 0, micro switch aciona em switchAt
+struct FakeAxis {
+    long pos;
+    bool towardHome;
+    long switchAt;         // fim de curso acionado com pos <= switchAt
+    long stallAt;          // StallGuard dispara com pos <= stallAt
+    long falseStallAt;     // stall espúrio (travamento) nesta posição, -1 = nunca
+    long abortAfter;       // pede abort após N passos, -1 = nunca
+    long steps;
+    uint32_t elapsedUs;
+};
+
+static void fakeSetDirection(bool towardHome, void* ctx) {
+    static_cast<FakeAxis*>(ctx)->towardHome = towardHome;
+}
+static void fakeStep(void* ctx) {
+    FakeAxis* a = static_cast<FakeAxis*>(ctx);
+    // Encostado no batente o motor perde passos: a posição não passa de 0
+    if (a->towardHome) { if (a->pos > 0) a->pos--; }
+    else a->pos++;
+    a->steps++;
+}
+static void fakeDelay(uint32_t us, void* ctx) {
+    static_cast<FakeAxis*>(ctx)->elapsedUs += us;
+}
+static bool fakeStall(void* ctx) {
+    FakeAxis* a = static_cast<FakeAxis*>(ctx);
+    return a->towardHome && (a->pos <= a->stallAt || a->pos == a->falseStallAt);
+}
+static bool fakeEndstop(void* ctx) {
+    FakeAxis* a = static_cast<FakeAxis*>(ctx);
+    return a->pos <= a->switchAt;
+}
+static bool fakeAbort(void* ctx) {
+    FakeAxis* a = static_cast<FakeAxis*>(ctx);
+    return a->abortAfter >= 0 && a->steps >= a->abortAfter;
+}
+
+static FakeAxis axis;
+static HomingHal hal = {fakeSetDirection, fakeStep, fakeDelay, fakeStall, fakeEndstop, fakeAbort, &axis};
+static const SensorlessHomingParams params = {20000, 400, 50, 60, 250};
+
+void setUp() {
+    axis = FakeAxis{5000, true, 2, 0, -1, -1, 0, 0};
+}
+void tearDown() {}
+
+static void test_stall_at_home_with_endstop_is_ok() {
+    HomingReport rep = runSensorlessHoming(params, hal);
+    TEST_ASSERT_EQUAL_INT(HOMING_OK, rep.result);
+    // A aproximação rápida para no micro switch, antes do batente
+    TEST_ASSERT_EQUAL_INT32(5000 - 2, rep.fastSteps);
+    TEST_ASSERT_TRUE(axis.pos <= axis.switchAt);
+    TEST_ASSERT_TRUE(rep.slowSteps >= 400 && rep.slowSteps <= 2 * 400 + 50);
+}
+
+static void test_stall_before_switch_is_rejected() {
+    axis.switchAt = -1;   // switch desconectado: só o stall no batente
+    HomingReport rep = runSensorlessHoming(params, hal);
+    TEST_ASSERT_EQUAL_INT(HOMING_STALL_WITHOUT_ENDSTOP, rep.result);
+}
+
+static void test_false_stall_far_from_home() {
+    axis.falseStallAt = 3000;
+    axis.switchAt = -1;
+    HomingReport rep = runSensorlessHoming(params, hal);
+    TEST_ASSERT_EQUAL_INT(HOMING_STALL_WITHOUT_ENDSTOP, rep.result);
+    TEST_ASSERT_EQUAL_INT32(2000, rep.fastSteps);
+}
+
+static void test_stall_ignored_during_blank_steps() {
+    // Já encostado: DIAG ativo desde o primeiro passo, mas ignorado nos 50 iniciais
+    axis.pos = 0;
+    axis.switchAt = -1;
+    HomingReport rep = runSensorlessHoming(params, hal);
+    TEST_ASSERT_EQUAL_INT32(50, rep.fastSteps);
+}
+
+static void test_no_contact_within_max_steps() {
+    axis.pos = 1000000;
+    HomingReport rep = runSensorlessHoming(params, hal);
+    TEST_ASSERT_EQUAL_INT(HOMING_NO_CONTACT, rep.result);
+    TEST_ASSERT_EQUAL_INT32(params.maxSteps, rep.fastSteps);
+}
+
+static void test_abort_request() {
+    axis.abortAfter = 100;
+    HomingReport rep = runSensorlessHoming(params, hal);
+    TEST_ASSERT_EQUAL_INT(HOMING_ABORTED, rep.result);
+    TEST_ASSERT_EQUAL_INT32(100, rep.fastSteps);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_stall_at_home_with_endstop_is_ok);
+    RUN_TEST(test_stall_before_switch_is_rejected);
+    RUN_TEST(test_false_stall_far_from_home);
+    RUN_TEST(test_stall_ignored_during_blank_steps);
+    RUN_TEST(test_no_contact_within_max_steps);
+    RUN_TEST(test_abort_request);
+    return UNITY_END();
+}
@@ -0,0 +1,222 @@
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include "settling_detector.h"
+#include "config.h"
+
+static const float COUNTS_PER_KG = 5000.0f;
+static const int32_t ZERO = 80000;
+
+static SettlingDetector det;
+
+static SettlingConfig makeConfig() {
+    SettlingConfig cfg;
+    cfg.window         = SETTLE_WINDOW;
+    cfg.minSpanMs      = SETTLE_MIN_SPAN_MS;
+    cfg.maxDriftCounts = SETTLE_MAX_DRIFT_KG * COUNTS_PER_KG;
+    cfg.maxStdCounts   = SETTLE_MAX_STD_KG * COUNTS_PER_KG;
+    cfg.relTol         = SETTLE_REL_TOL;
+    cfg.zeroCounts     = ZERO;
+    cfg.timeoutMs      = SETTLE_TIMEOUT_MS;
+    return cfg;
+}
+
+void setUp() {
+    det.begin(makeConfig());
+    det.start(0);
+}
+void tearDown() {}
+
+// Sinal constante: decide assim que a janela cobre window e minSpanMs
+static void test_constant_settles_when_window_covered() {
+    SettleStatus st = SETTLE_WAITING;
+    uint32_t t = 0;
+    while (st == SETTLE_WAITING) {
+        t += 100;   // 10 SPS
+        st = det.push(ZERO + 5000, t);
+    }
+    TEST_ASSERT_EQUAL(SETTLE_DONE, st);
+    TEST_ASSERT_EQUAL_UINT16(SETTLE_WINDOW, det.conversions());   // 6 x 100 ms cobre 300 ms
+    TEST_ASSERT_EQUAL_UINT32(t, det.settlingMs());
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, ZERO + 5000, det.windowMean());
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.0f, det.windowStd());
+}
+
+// A 80 SPS a janela mínima de conversões é curta: minSpanMs manda
+static void test_min_span_extends_fast_window() {
+    SettleStatus st = SETTLE_WAITING;
+    uint32_t t = 0;
+    while (st == SETTLE_WAITING) {
+        t += 12;
+        st = det.push(ZERO + 5000, t);
+    }
+    TEST_ASSERT_EQUAL(SETTLE_DONE, st);
+    TEST_ASSERT_TRUE(det.conversions() > SETTLE_WINDOW);
+    TEST_ASSERT_TRUE(det.conversions() <= SettlingDetector::SETTLE_WINDOW_MAX);
+}
+
+// Rampa lenta (fluência) passa no desvio pequeno mas não na inclinação
+static void test_drift_blocks_settling() {
+    uint32_t t = 0;
+    for (int i = 0; i < 10; ++i) {
+        t += 100;
+        TEST_ASSERT_EQUAL(SETTLE_WAITING, det.push(ZERO + 5000 + 20 * i, t));
+    }
+    TEST_ASSERT_TRUE(det.windowDrift() > SETTLE_MAX_DRIFT_KG * COUNTS_PER_KG);
+}
+
+// Oscilação simétrica: inclinação nula, desvio alto
+static void test_ringing_blocks_settling() {
+    uint32_t t = 0;
+    for (int i = 0; i < 10; ++i) {
+        t += 100;
+        TEST_ASSERT_EQUAL(SETTLE_WAITING, det.push(ZERO + 5000 + ((i & 1) ? 60 : -60), t));
+    }
+    TEST_ASSERT_TRUE(det.windowStd() > SETTLE_MAX_STD_KG * COUNTS_PER_KG);
+}
+
+// Limite relativo: a 50 kg (0,2% = 100 g) a mesma oscilação é aceita
+static void test_relative_limit_scales_with_force() {
+    uint32_t t = 0;
+    SettleStatus st = SETTLE_WAITING;
+    const int32_t big = (int32_t)(50.0f * COUNTS_PER_KG);   // limite 0,1 kg = 500 contagens
+    for (int i = 0; i < 10 && st == SETTLE_WAITING; ++i) {
+        t += 100;
+        st = det.push(ZERO + big + ((i & 1) ? 60 : -60), t);
+    }
+    TEST_ASSERT_EQUAL(SETTLE_DONE, st);
+}
+
+static void test_timeout_uses_last_window() {
+    uint32_t t = 0;
+    SettleStatus st = SETTLE_WAITING;
+    int i = 0;
+    while (st == SETTLE_WAITING) {
+        t += 100;
+        st = det.push(ZERO + 5000 + ((i++ & 1) ? 100 : -100), t);
+    }
+    TEST_ASSERT_EQUAL(SETTLE_TIMEOUT, st);
+    TEST_ASSERT_EQUAL_UINT32(SETTLE_TIMEOUT_MS, det.settlingMs());
+    TEST_ASSERT_FLOAT_WITHIN(20.0f, ZERO + 5000, det.windowMean());
+    // Decisão tomada: novas conversões não mudam o estado
+    TEST_ASSERT_EQUAL(SETTLE_TIMEOUT, det.push(ZERO, t + 100));
+    TEST_ASSERT_EQUAL_UINT32(SETTLE_TIMEOUT_MS, det.settlingMs());
+}
+
+// ---- Levantamento: mola/quadro amortecidos (zeta 0,1..0,3) após degraus de 1 mm ----
+
+struct Rng {
+    uint32_t s = 77u;
+    float uniform() {
+        s ^= s << 13;
+        s ^= s >> 17;
+        s ^= s << 5;
+        return (float)(s >> 8) * (1.0f / 16777216.0f);
+    }
+    float gaussian() {
+        float sum = 0.0f;
+        for (int i = 0; i < 12; ++i) sum += uniform();
+        return sum - 6.0f;
+    }
+};
+
+struct Spring {
+    const char* name;
+    double kgPerMm, fn, zeta;
+};
+
+struct PointStats {
+    double detMs, detErrPct, fixedMs, fixedErrPct;
+    int timeouts;
+};
+
+// F(t) = Fss - dF e^{-zwt}(cos wd t + z/sqrt(1-z²) sin wd t) + fluência de 1% (tau 300 ms)
+static PointStats runSpring(const Spring& s, double sps, double noiseKg, Rng& rng) {
+    const int RUNS = 200, POINTS = 10;
+    const double w = 2.0 * M_PI * s.fn, z = s.zeta, wd = w * sqrt(1.0 - z * z);
+    const double dt = 1.0 / sps;
+    PointStats out = {};
+    for (int rep = 0; rep < RUNS; ++rep) {
+        for (int p = 1; p <= POINTS; ++p) {
+            double fss = s.kgPerMm * p, dF = s.kgPerMm;
+            auto force = [&](double t) {
+                return fss - dF * exp(-z * w * t) * (cos(wd * t) + z / sqrt(1.0 - z * z) * sin(wd * t)) +
+                       0.01 * dF * exp(-t / 0.3);
+            };
+            double phase = rng.uniform() * dt;
+            auto sample = [&](double tc) { return force(tc) + noiseKg * rng.gaussian(); };
+
+            // Antes: espera fixa de 100 ms e 5 x (read_average(5) + 20 ms)
+            double t = 0.100, sum = 0.0;
+            for (int j = 0; j < 5; ++j) {
+                for (int c = 0; c < 5; ++c) {
+                    double tc = ceil((t - phase) / dt) * dt + phase;
+                    sum += sample(tc);
+                    t = tc + 1e-6;
+                }
+                t += 0.020;
+            }
+            out.fixedMs += t * 1000.0;
+            out.fixedErrPct += fabs(sum / 25.0 - fss) / fss * 100.0;
+
+            SettlingConfig cfg = makeConfig();
+            det.begin(cfg);
+            det.start(0);
+            double tc = phase;
+            SettleStatus st;
+            do {
+                int32_t raw = ZERO + (int32_t)lround(sample(tc) * COUNTS_PER_KG);
+                st = det.push(raw, (uint32_t)lround(tc * 1000.0));
+                tc += dt;
+            } while (st == SETTLE_WAITING);
+            if (st == SETTLE_TIMEOUT) ++out.timeouts;
+            out.detMs += det.settlingMs();
+            out.detErrPct += fabs((det.windowMean() - ZERO) / COUNTS_PER_KG - fss) / fss * 100.0;
+        }
+    }
+    const int n = RUNS * POINTS;
+    out.detMs /= n;
+    out.detErrPct /= n;
+    out.fixedMs /= n;
+    out.fixedErrPct /= n;
+    return out;
+}
+
+static void test_settling_benchmark() {
+    const Spring springs[] = {
+        {"mole 0,2 kgf/mm 3 Hz", 0.2, 3.0, 0.15},
+        {"media 1 kgf/mm 8 Hz", 1.0, 8.0, 0.1},
+        {"dura 5 kgf/mm 20 Hz", 5.0, 20.0, 0.2},
+        {"10 kgf/mm 30 Hz", 10.0, 30.0, 0.3},
+    };
+    const struct { double sps, noiseKg; } rates[] = {{10.0, 0.001}, {80.0, 0.0025}};
+    Rng rng;
+    int timeouts = 0;
+    for (const auto& r : rates) {
+        for (const Spring& s : springs) {
+            PointStats st = runSpring(s, r.sps, r.noiseKg, rng);
+            char msg[200];
+            snprintf(msg, sizeof(msg),
+                     "%2.0f SPS %-22s detector %5.0f ms/pt erro %.2f%% | fixo %5.0f ms/pt erro %.2f%% | timeouts %d",
+                     r.sps, s.name, st.detMs, st.detErrPct, st.fixedMs, st.fixedErrPct, st.timeouts);
+            TEST_MESSAGE(msg);
+            timeouts += st.timeouts;
+            // Mais rápido que a espera fixa a 10 SPS, sem perder exatidão além de 0,2%
+            if (r.sps == 10.0) TEST_ASSERT_TRUE(st.detMs < st.fixedMs);
+            TEST_ASSERT_TRUE(st.detErrPct < 0.2);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(0, timeouts);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_constant_settles_when_window_covered);
+    RUN_TEST(test_min_span_extends_fast_window);
+    RUN_TEST(test_drift_blocks_settling);
+    RUN_TEST(test_ringing_blocks_settling);
+    RUN_TEST(test_relative_limit_scales_with_force);
+    RUN_TEST(test_timeout_uses_last_window);
+    RUN_TEST(test_settling_benchmark);
+    return UNITY_END();
+}
@@ -0,0 +1,119 @@
+#include <unity.h>
+#include "sg_poll_scheduler.h"
+
+// UART falsa: devolve value ou falha, contando transações
+struct FakeUart {
+    uint16_t value;
+    bool     fail;
+    int      calls;
+};
+
+static bool fakeRead(uint16_t* out, void* ctx) {
+    FakeUart* u = static_cast<FakeUart*>(ctx);
+    u->calls++;
+    if (u->fail) return false;
+    *out = u->value;
+    return true;
+}
+
+static FakeUart uartState;
+static SgUart uart = {fakeRead, &uartState};
+static SgPollScheduler sched;
+
+void setUp() {
+    uartState = FakeUart{300, false, 0};
+    sched = SgPollScheduler();
+    sched.configure(10, 3, 50, 3);
+}
+void tearDown() {}
+
+static void test_idle_does_not_touch_uart() {
+    for (uint32_t t = 0; t < 100; ++t) TEST_ASSERT_FALSE(sched.poll(t, uart));
+    TEST_ASSERT_EQUAL_INT(0, uartState.calls);
+}
+
+static void test_respects_period_during_motion() {
+    sched.setMotion(true, false);
+    int reads = 0;
+    for (uint32_t t = 0; t < 100; ++t) reads += sched.poll(t, uart) ? 1 : 0;
+    TEST_ASSERT_EQUAL_INT(10, reads);
+    TEST_ASSERT_EQUAL_INT(10, uartState.calls);
+    TEST_ASSERT_EQUAL_UINT16(300, sched.lastValue());
+    TEST_ASSERT_EQUAL_UINT32(90, sched.lastReadMs());
+}
+
+static void test_backoff_after_failures_and_recovery() {
+    sched.setMotion(true, false);
+    uartState.fail = true;
+    for (uint32_t t = 0; t < 1000; ++t) sched.poll(t, uart);
+    // 10, 20, 40, 80 ms: satura em maxBackoff = 3
+    TEST_ASSERT_EQUAL_UINT32(80, sched.currentPeriodMs());
+    TEST_ASSERT_TRUE(uartState.calls < 20);
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)uartState.calls, sched.failCount());
+
+    uartState.fail = false;
+    uint32_t t = 1000;
+    while (!sched.poll(t, uart)) ++t;
+    TEST_ASSERT_EQUAL_UINT32(10, sched.currentPeriodMs());
+}
+
+static void test_abort_needs_consecutive_low_reads() {
+    sched.setMotion(true, true);
+    uartState.value = 40;
+    sched.poll(0, uart);
+    sched.poll(10, uart);
+    uartState.value = 200;          // uma leitura alta zera a contagem
+    sched.poll(20, uart);
+    uartState.value = 40;
+    sched.poll(30, uart);
+    sched.poll(40, uart);
+    TEST_ASSERT_FALSE(sched.abortLatched());
+    sched.poll(50, uart);
+    TEST_ASSERT_TRUE(sched.abortLatched());
+    sched.clearAbort();
+    TEST_ASSERT_FALSE(sched.abortLatched());
+}
+
+static void test_abort_not_armed_on_travel() {
+    sched.setMotion(true, false);
+    uartState.value = 0;
+    for (uint32_t t = 0; t < 100; t += 10) sched.poll(t, uart);
+    TEST_ASSERT_FALSE(sched.abortLatched());
+}
+
+// Abort travado sobrevive ao fim do movimento (o chamador lê depois), mas o
+// próximo movimento começa destravado; chamadas repetidas não destravam
+static void test_new_motion_clears_latched_abort() {
+    sched.setMotion(true, true);
+    uartState.value = 0;
+    for (uint32_t t = 0; t < 30; t += 10) sched.poll(t, uart);
+    TEST_ASSERT_TRUE(sched.abortLatched());
+    sched.setMotion(true, false);             // troca de sentido dentro da fila
+    TEST_ASSERT_TRUE(sched.abortLatched());
+    sched.setMotion(false, false);
+    TEST_ASSERT_TRUE(sched.abortLatched());
+    sched.setMotion(true, false);             // retorno após o stall
+    TEST_ASSERT_FALSE(sched.abortLatched());
+    for (uint32_t t = 100; t < 200; t += 10) sched.poll(t, uart);
+    TEST_ASSERT_FALSE(sched.abortLatched());   // não armado: leituras baixas não travam
+}
+
+static void test_new_motion_reads_immediately() {
+    sched.setMotion(true, false);
+    TEST_ASSERT_TRUE(sched.poll(0, uart));
+    sched.setMotion(false, false);
+    sched.setMotion(true, false);
+    TEST_ASSERT_TRUE(sched.poll(1, uart));
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_idle_does_not_touch_uart);
+    RUN_TEST(test_respects_period_during_motion);
+    RUN_TEST(test_backoff_after_failures_and_recovery);
+    RUN_TEST(test_abort_needs_consecutive_low_reads);
+    RUN_TEST(test_abort_not_armed_on_travel);
+    RUN_TEST(test_new_motion_clears_latched_abort);
+    RUN_TEST(test_new_motion_reads_immediately);
+    return UNITY_END();
+}
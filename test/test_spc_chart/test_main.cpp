@@ -0,0 +1,195 @@
+#include <unity.h>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include "spc_chart.h"
+#include "trace_probe.h"
+
+// Tela falsa: conta chamadas e pixels escritos (custo no SPI da TFT)
+struct CountingCanvas {
+    uint32_t pixels;
+    int      calls;
+    int      clears;
+};
+
+static CountingCanvas counter;
+
+static void cntFillScreen(uint16_t, void*) {
+    counter.pixels += 480u * 320u;
+    counter.calls++;
+    counter.clears++;
+}
+
+static void cntFillRect(int, int, int w, int h, uint16_t, void*) {
+    counter.pixels += (uint32_t)(w * h);
+    counter.calls++;
+}
+
+static void cntDrawRect(int, int, int w, int h, uint16_t, void*) {
+    counter.pixels += (uint32_t)(2 * w + 2 * h - 4);
+    counter.calls++;
+}
+
+static void cntHLine(int, int, int w, uint16_t, void*) {
+    counter.pixels += (uint32_t)w;
+    counter.calls++;
+}
+
+static void cntLine(int x0, int y0, int x1, int y1, uint16_t, void*) {
+    int dx = abs(x1 - x0), dy = abs(y1 - y0);
+    counter.pixels += (uint32_t)((dx > dy ? dx : dy) + 1);
+    counter.calls++;
+}
+
+static void cntFillCircle(int, int, int r, uint16_t, void*) {
+    counter.pixels += (uint32_t)((2 * r + 1) * (2 * r + 1));
+    counter.calls++;
+}
+
+// Fonte 1 da TFT_eSPI: célula 6x8 por tamanho, com fundo
+static void cntText(int, int, uint8_t size, uint16_t, const char* s, void*) {
+    counter.pixels += (uint32_t)(strlen(s) * 6 * size * 8 * size);
+    counter.calls++;
+}
+
+static const SpcCanvas canvas = {
+    cntFillScreen, cntFillRect, cntDrawRect, cntHLine, cntLine, cntFillCircle, cntText, nullptr
+};
+
+static SpcBatch batch;
+static SpcChartView view;
+static uint32_t rng;
+
+// K de processo estável: 0,65 +/- 0,01 (uniforme)
+static float nextK() {
+    rng = rng * 1664525u + 1013904223u;
+    return 0.65f + 0.02f * ((float)(rng >> 8) / 16777216.0f - 0.5f);
+}
+
+static void addSubgroups(int n) {
+    for (int i = 0; i < n * SPC_SUBGROUP_SIZE; ++i) batch.add(nextK());
+}
+
+void setUp() {
+    batch.begin("PN 4471-A", 0.585f, 0.715f);
+    view = SpcChartView();
+    counter = CountingCanvas{};
+    rng = 12345u;
+}
+void tearDown() {}
+
+static void test_full_draw_clears_and_plots_page() {
+    addSubgroups(6);
+    TEST_ASSERT_TRUE(view.needsRedraw(batch));
+    view.draw(batch, canvas);
+    TEST_ASSERT_EQUAL_INT(1, counter.clears);
+    TEST_ASSERT_TRUE(counter.pixels > 480u * 320u);
+    TEST_ASSERT_FALSE(view.needsRedraw(batch));
+}
+
+// Subgrupo com a média e a amplitude do lote: limites e escala não mudam.
+// Mola no meio do subgrupo: só as linhas do painel que mudaram (n, m, s,
+// Cpk); subgrupo fechado: + 2 segmentos e 2 pontos nas cartas
+static void test_incremental_update_draws_only_new_point() {
+    addSubgroups(20);
+    view.draw(batch, canvas);
+    float gm = batch.grandMean(), r = batch.meanRange();
+    const float group[] = {gm - r / 2, gm + r / 2, gm, gm, gm};
+    for (int i = 0; i < SPC_SUBGROUP_SIZE - 1; ++i) batch.add(group[i]);
+    TEST_ASSERT_FALSE(view.needsRedraw(batch));
+    counter = CountingCanvas{};
+    view.drawNew(batch, canvas);
+    TEST_ASSERT_EQUAL_INT(0, counter.clears);
+    TEST_ASSERT_TRUE(counter.calls <= 4);
+
+    // Nada mudou: nada a desenhar
+    counter = CountingCanvas{};
+    view.drawNew(batch, canvas);
+    TEST_ASSERT_EQUAL_INT(0, counter.calls);
+
+    batch.add(group[SPC_SUBGROUP_SIZE - 1]);
+    TEST_ASSERT_FALSE(view.needsRedraw(batch));
+    counter = CountingCanvas{};
+    view.drawNew(batch, canvas);
+    TEST_ASSERT_EQUAL_INT(0, counter.clears);
+    TEST_ASSERT_TRUE(counter.calls >= 4 + 2);   // pontos + n e subgrupos
+    TEST_ASSERT_TRUE(counter.calls <= 4 + 8);
+}
+
+static void test_point_out_of_scale_forces_redraw() {
+    addSubgroups(10);
+    view.draw(batch, canvas);
+    for (int i = 0; i < SPC_SUBGROUP_SIZE; ++i) batch.add(0.80f);
+    TEST_ASSERT_TRUE(view.needsRedraw(batch));
+}
+
+static void test_full_page_forces_redraw() {
+    addSubgroups(SPC_CHART_POINTS);
+    view.draw(batch, canvas);
+    TEST_ASSERT_FALSE(view.needsRedraw(batch));
+    addSubgroups(1);
+    TEST_ASSERT_TRUE(view.needsRedraw(batch));
+    view.draw(batch, canvas);   // página nova a partir do último subgrupo
+    TEST_ASSERT_FALSE(view.needsRedraw(batch));
+    view.invalidate();
+    TEST_ASSERT_TRUE(view.needsRedraw(batch));
+}
+
+// Lote de 500 molas com a tela aberta (como o laço de main.cpp): custo de
+// SpcBatch::add() pela sonda e da tela em pixels/CPU, incremental x sempre
+// redesenhar tudo
+static void test_render_cost_benchmark() {
+    const int springs = 500;
+    probeReset();
+    uint64_t incPixels = 0, fullPixels = 0, incTicks = 0, fullTicks = 0;
+    int redraws = 0;
+    SpcChartView always;
+    view.draw(batch, canvas);
+    for (int i = 0; i < springs; ++i) {
+        batch.add(nextK());
+
+        counter = CountingCanvas{};
+        uint32_t t0 = probeNowTicks();
+        if (view.needsRedraw(batch)) {
+            view.draw(batch, canvas);
+            ++redraws;
+        } else {
+            view.drawNew(batch, canvas);
+        }
+        incTicks += probeNowTicks() - t0;
+        incPixels += counter.pixels;
+
+        counter = CountingCanvas{};
+        t0 = probeNowTicks();
+        always.draw(batch, canvas);
+        fullTicks += probeNowTicks() - t0;
+        fullPixels += counter.pixels;
+    }
+    const ProbeStats& add = probeStats(PROBE_SPC_ADD);
+    TEST_ASSERT_EQUAL_UINT32(springs, add.count);
+
+    // ILI9488 em SPI a 40 MHz: 3 bytes por pixel
+    const double usPerPixel = 24.0 / 40.0;
+    char msg[220];
+    snprintf(msg, sizeof(msg),
+             "%d molas: add %.0f ns (max %lu ns) | incremental %lu px/mola (~%.1f ms SPI) "
+             "%.1f us CPU, %d redesenhos | completo %lu px/mola (~%.1f ms SPI) %.1f us CPU",
+             springs, (double)add.sumTicks / add.count, (unsigned long)add.maxTicks,
+             (unsigned long)(incPixels / springs), incPixels / springs * usPerPixel / 1000.0,
+             incTicks / 1000.0 / springs, redraws,
+             (unsigned long)(fullPixels / springs), fullPixels / springs * usPerPixel / 1000.0,
+             fullTicks / 1000.0 / springs);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE(redraws < springs / SPC_SUBGROUP_SIZE / 4);
+    TEST_ASSERT_TRUE(incPixels * 10 < fullPixels);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_full_draw_clears_and_plots_page);
+    RUN_TEST(test_incremental_update_draws_only_new_point);
+    RUN_TEST(test_point_out_of_scale_forces_redraw);
+    RUN_TEST(test_full_page_forces_redraw);
+    RUN_TEST(test_render_cost_benchmark);
+    return UNITY_END();
+}
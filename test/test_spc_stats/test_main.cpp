@@ -0,0 +1,93 @@
+#include <unity.h>
+#include <cmath>
+#include "spc_stats.h"
+
+static SpcBatch batch;
+
+void setUp() {
+    batch.begin("PN 4471-A", 0.585f, 0.715f);
+}
+void tearDown() {}
+
+static void test_empty_batch() {
+    TEST_ASSERT_EQUAL_STRING("PN 4471-A", batch.partName());
+    TEST_ASSERT_TRUE(batch.hasTolerance());
+    TEST_ASSERT_EQUAL_UINT32(0, batch.count());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, batch.cpk());
+    SpcPoint p;
+    TEST_ASSERT_FALSE(batch.chartPoint(0, &p));
+}
+
+// Dois subgrupos com média/amplitude conhecidas (n = 5: A2 0,577, D4 2,114, d2 2,326)
+static void test_xbar_r_limits() {
+    const float g1[] = {0.64f, 0.65f, 0.66f, 0.65f, 0.65f};   // média 0,65 R 0,02
+    const float g2[] = {0.63f, 0.67f, 0.65f, 0.66f, 0.64f};   // média 0,65 R 0,04
+    for (float v : g1) batch.add(v);
+    TEST_ASSERT_EQUAL_UINT32(1, batch.subgroups());
+    for (float v : g2) batch.add(v);
+    TEST_ASSERT_EQUAL_UINT32(2, batch.subgroups());
+
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.65f, batch.grandMean());
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.03f, batch.meanRange());
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.65f + 0.577f * 0.03f, batch.xbarUcl());
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.65f - 0.577f * 0.03f, batch.xbarLcl());
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 2.114f * 0.03f, batch.rUcl());
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, batch.rLcl());
+
+    float sigma = 0.03f / 2.326f;
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, sigma, batch.sigmaWithin());
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.065f / (3.0f * sigma), batch.cpk());
+
+    SpcPoint p;
+    TEST_ASSERT_TRUE(batch.chartPoint(1, &p));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.65f, p.xbar);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.04f, p.range);
+    TEST_ASSERT_FALSE(batch.chartPoint(2, &p));
+}
+
+static void test_welford_matches_two_pass() {
+    float values[37];
+    double sum = 0.0;
+    for (int i = 0; i < 37; ++i) {
+        values[i] = 0.65f + 0.01f * sinf((float)i);
+        batch.add(values[i]);
+        sum += values[i];
+    }
+    double mean = sum / 37.0, ss = 0.0;
+    for (float v : values) ss += (v - mean) * (v - mean);
+    TEST_ASSERT_EQUAL_UINT32(37, batch.count());
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, (float)mean, batch.mean());
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, (float)sqrt(ss / 36.0), batch.stdDev());
+    TEST_ASSERT_EQUAL_UINT32(7, batch.subgroups());   // 2 molas no subgrupo em formação
+}
+
+// Buffer circular: só os últimos SPC_CHART_POINTS subgrupos ficam no gráfico
+static void test_chart_ring_keeps_recent_subgroups() {
+    const uint32_t groups = SPC_CHART_POINTS + 10;
+    for (uint32_t g = 0; g < groups; ++g) {
+        for (int i = 0; i < SPC_SUBGROUP_SIZE; ++i) batch.add(0.6f + 0.001f * (float)g);
+    }
+    SpcPoint p;
+    TEST_ASSERT_FALSE(batch.chartPoint(9, &p));
+    TEST_ASSERT_TRUE(batch.chartPoint(10, &p));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.61f, p.xbar);
+    TEST_ASSERT_TRUE(batch.chartPoint(groups - 1, &p));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.6f + 0.001f * (float)(groups - 1), p.xbar);
+}
+
+static void test_no_tolerance_no_cpk() {
+    batch.begin("Curso 10 mm", 0.0f, 0.0f);
+    for (int i = 0; i < 20; ++i) batch.add(0.5f + 0.01f * (float)(i % 3));
+    TEST_ASSERT_FALSE(batch.hasTolerance());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, batch.cpk());
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_batch);
+    RUN_TEST(test_xbar_r_limits);
+    RUN_TEST(test_welford_matches_two_pass);
+    RUN_TEST(test_chart_ring_keeps_recent_subgroups);
+    RUN_TEST(test_no_tolerance_no_cpk);
+    return UNITY_END();
+}
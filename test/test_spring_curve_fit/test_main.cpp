@@ -0,0 +1,101 @@
+#include <unity.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include "spring_curve_fit.h"
+
+void setUp() {}
+void tearDown() {}
+
+static float xs[SPRING_CURVE_MAX_POINTS];
+static float ys[SPRING_CURVE_MAX_POINTS];
+
+// Ruído determinístico pequeno (±amp) para o BIC não ver resíduo zero
+static float jitter(int i, float amp) {
+    return amp * (float)(((i * 37) % 11) - 5) / 5.0f;
+}
+
+static void test_linear_spring_single_segment() {
+    const int n = 80;
+    for (int i = 0; i < n; ++i) {
+        xs[i] = 0.1f * (float)i;
+        ys[i] = 0.2f + 1.5f * xs[i] + jitter(i, 0.005f);
+    }
+    PiecewiseFit pw = fitPiecewiseLinear(xs, ys, n);
+    TEST_ASSERT_TRUE(pw.valid);
+    TEST_ASSERT_EQUAL_INT(1, pw.segments);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.5f, pw.rateKgfMm[0]);
+}
+
+static void test_dual_rate_spring_two_segments() {
+    const int n = 100;
+    for (int i = 0; i < n; ++i) {
+        float x = 0.1f * (float)i;
+        xs[i] = x;
+        ys[i] = (x < 4.0f) ? 1.0f * x : 4.0f + 3.0f * (x - 4.0f);
+        ys[i] += jitter(i, 0.005f);
+    }
+    PiecewiseFit pw = fitPiecewiseLinear(xs, ys, n);
+    TEST_ASSERT_TRUE(pw.valid);
+    TEST_ASSERT_EQUAL_INT(2, pw.segments);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 1.0f, pw.rateKgfMm[0]);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 3.0f, pw.rateKgfMm[1]);
+    TEST_ASSERT_FLOAT_WITHIN(0.15f, 4.0f, pw.breakMm[0]);
+}
+
+static void test_quadratic_exact() {
+    const int n = 60;
+    for (int i = 0; i < n; ++i) {
+        xs[i] = 0.1f * (float)i;
+        ys[i] = 0.5f + 1.2f * xs[i] + 0.3f * xs[i] * xs[i];
+    }
+    PolyFit q = fitQuadratic(xs, ys, n);
+    TEST_ASSERT_TRUE(q.valid);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.5f, q.c0);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 1.2f, q.c1);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.3f, q.c2);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.0f, q.r2);
+}
+
+static void test_too_few_points() {
+    xs[0] = 0.0f; ys[0] = 0.0f;
+    xs[1] = 1.0f; ys[1] = 1.0f;
+    TEST_ASSERT_FALSE(fitQuadratic(xs, ys, 2).valid);
+    TEST_ASSERT_FALSE(fitPiecewiseLinear(xs, ys, 1).valid);
+    // Dois pontos ainda definem um segmento
+    PiecewiseFit pw = fitPiecewiseLinear(xs, ys, 2);
+    TEST_ASSERT_TRUE(pw.valid);
+    TEST_ASSERT_EQUAL_INT(1, pw.segments);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, pw.rateKgfMm[0]);
+}
+
+// Pior caso (3 segmentos, 256 pontos): tempo no host só como referência
+static void test_benchmark_worst_case() {
+    const int n = SPRING_CURVE_MAX_POINTS;
+    for (int i = 0; i < n; ++i) {
+        float x = 0.05f * (float)i;
+        xs[i] = x;
+        ys[i] = x + 2.0f * fmaxf(0.0f, x - 4.0f) + 4.0f * fmaxf(0.0f, x - 9.0f) + jitter(i, 0.01f);
+    }
+    const int reps = 50;
+    PiecewiseFit pw;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) pw = fitPiecewiseLinear(xs, ys, n);
+    auto t1 = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(t1 - t0).count() / reps;
+
+    TEST_ASSERT_EQUAL_INT(3, pw.segments);
+    char msg[64];
+    snprintf(msg, sizeof(msg), "fitPiecewiseLinear n=%d: %.3f ms", n, ms);
+    TEST_MESSAGE(msg);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_linear_spring_single_segment);
+    RUN_TEST(test_dual_rate_spring_two_segments);
+    RUN_TEST(test_quadratic_exact);
+    RUN_TEST(test_too_few_points);
+    RUN_TEST(test_benchmark_worst_case);
+    return UNITY_END();
+}
@@ -0,0 +1,97 @@
+#include <unity.h>
+#include <cmath>
+#include "spring_rate_estimator.h"
+#include "config.h"
+
+void setUp() {}
+void tearDown() {}
+
+static float xs[SPRING_RATE_MAX_POINTS];
+static float ys[SPRING_RATE_MAX_POINTS];
+
+static void fillLine(int n, float k, float a) {
+    for (int i = 0; i < n; ++i) {
+        xs[i] = 0.1f * (float)i;
+        ys[i] = a + k * xs[i];
+    }
+}
+
+static void test_least_squares_exact_line() {
+    fillLine(50, 1.25f, 0.3f);
+    LineFit fit = fitSpringRate(xs, ys, 0, 49, RATE_LEAST_SQUARES);
+    TEST_ASSERT_TRUE(fit.valid);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.25f, fit.k);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.3f, fit.a);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.0f, fit.r2);
+    TEST_ASSERT_EQUAL_INT(50, fit.inliers);
+}
+
+// Dois pontos espúrios grandes: os estimadores robustos ficam na reta
+static void test_robust_methods_reject_outliers() {
+    fillLine(60, 2.0f, 0.0f);
+    ys[10] += 5.0f;
+    ys[40] -= 4.0f;
+    const SpringRateMethod robust[] = {RATE_THEIL_SEN, RATE_RANSAC, RATE_HUBER};
+    for (SpringRateMethod m : robust) {
+        LineFit fit = fitSpringRate(xs, ys, 0, 59, m);
+        TEST_ASSERT_TRUE(fit.valid);
+        TEST_ASSERT_FLOAT_WITHIN(0.02f, 2.0f, fit.k);
+    }
+    LineFit ls = fitSpringRate(xs, ys, 0, 59, RATE_LEAST_SQUARES);
+    TEST_ASSERT_TRUE(fabsf(ls.k - 2.0f) > 0.02f);
+}
+
+static void test_fit_needs_two_points() {
+    fillLine(4, 1.0f, 0.0f);
+    LineFit fit = fitSpringRate(xs, ys, 2, 2, RATE_LEAST_SQUARES);
+    TEST_ASSERT_FALSE(fit.valid);
+}
+
+// Assentamento no início e encosto no fim ficam fora da região linear
+static void test_linear_region_skips_seating_and_saturation() {
+    const int n = 100;
+    for (int i = 0; i < n; ++i) {
+        float x = 0.1f * (float)i;
+        xs[i] = x;
+        if (i < 15)      ys[i] = 0.05f * x;                            // assentamento
+        else if (i < 85) ys[i] = 0.075f + 1.0f * (x - 1.5f);           // linear
+        else             ys[i] = 7.075f + 8.0f * (x - 8.5f);           // encosto
+    }
+    int first = -1, last = -1;
+    TEST_ASSERT_TRUE(detectLinearRegion(xs, ys, n, 0.25f, 10, &first, &last));
+    TEST_ASSERT_TRUE(first >= 12 && first <= 20);
+    TEST_ASSERT_TRUE(last >= 80 && last <= 88);
+}
+
+static void test_linear_region_rejects_flat_curve() {
+    for (int i = 0; i < 30; ++i) {
+        xs[i] = 0.1f * (float)i;
+        ys[i] = 1.0f;
+    }
+    int first, last;
+    TEST_ASSERT_FALSE(detectLinearRegion(xs, ys, 30, 0.25f, 5, &first, &last));
+}
+
+// Todos os tamanhos que o arena do teste de mola pode produzir (sob ASan
+// um trecho a mais que LINEAR_REGION_SEGMENTS estoura a pilha)
+static void test_linear_region_sweep_sample_counts() {
+    for (int n = 2; n <= SPRING_SAMPLE_CAPACITY; ++n) {
+        fillLine(n, 1.5f, 0.1f);
+        int first = -1, last = -1;
+        bool ok = detectLinearRegion(xs, ys, n, 0.25f, 2, &first, &last);
+        TEST_ASSERT_TRUE_MESSAGE(ok, "reta perfeita deve ter região linear");
+        TEST_ASSERT_EQUAL_INT(0, first);
+        TEST_ASSERT_EQUAL_INT(n - 1, last);
+    }
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_least_squares_exact_line);
+    RUN_TEST(test_robust_methods_reject_outliers);
+    RUN_TEST(test_fit_needs_two_points);
+    RUN_TEST(test_linear_region_skips_seating_and_saturation);
+    RUN_TEST(test_linear_region_rejects_flat_curve);
+    RUN_TEST(test_linear_region_sweep_sample_counts);
+    return UNITY_END();
+}
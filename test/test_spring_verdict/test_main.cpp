@@ -0,0 +1,117 @@
+#include <unity.h>
+#include <cstring>
+#include "spring_verdict.h"
+#include "test_profiles_data.h"
+#include "config.h"
+
+static ProfileInterpreter interp;
+static SpringVerdict verdict;
+
+// Perfil de produção gerado: K 0,65 ±10 %, F(4) 2,2-3,0, F(8) 4,7-5,8, livre 20 ±0,5
+static const ProfileSettings& production() {
+    for (int i = 0; i < TEST_PROFILES_COUNT; ++i) {
+        interp.load(TEST_PROFILES[i].data, TEST_PROFILES[i].size);
+        if (strcmp(interp.settings().name, "PN 4471-A") == 0) break;
+    }
+    return interp.settings();
+}
+
+void setUp() {
+    verdict.begin(production(), VERDICT_EARLY_K_MARGIN, VERDICT_EARLY_MIN_POINTS, VERDICT_MIN_X_MM);
+}
+void tearDown() {}
+
+// Curso de 0 a 8 mm em passos de 1 mm; retorna o índice que reprovou ou -1
+static int runSpring(float k, float preload) {
+    for (int i = 0; i <= 8; ++i) {
+        float x = (float)i;
+        if (verdict.addSample(x, preload + k * x)) return i;
+    }
+    return -1;
+}
+
+static void test_good_spring_passes() {
+    TEST_ASSERT_EQUAL_INT(VERDICT_PENDING, verdict.state());
+    TEST_ASSERT_FALSE(verdict.checkFreeLength(20.2f));
+    TEST_ASSERT_EQUAL_INT(-1, runSpring(0.65f, 0.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.65f, verdict.runningK());
+    TEST_ASSERT_EQUAL_INT(VERDICT_PASS, verdict.finish(0.66f, true));
+}
+
+static void test_free_length_fails_before_compression() {
+    TEST_ASSERT_TRUE(verdict.checkFreeLength(19.2f));
+    TEST_ASSERT_EQUAL_INT(VERDICT_REASON_FREE_LENGTH, verdict.reason());
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 19.2f, verdict.failValue());
+    // Já reprovado: amostras seguintes só repetem o resultado
+    TEST_ASSERT_TRUE(verdict.addSample(1.0f, 0.65f));
+}
+
+// Mola fraca: a checagem F(4) reprova no ponto 4, antes do fim do curso
+static void test_force_at_rejects_early() {
+    int at = runSpring(0.45f, 0.0f);
+    TEST_ASSERT_EQUAL_INT(4, at);
+    TEST_ASSERT_EQUAL_INT(VERDICT_REASON_FORCE_AT, verdict.reason());
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 1.8f, verdict.failValue());
+}
+
+// Checagem entre amostras: força interpolada na posição da checagem
+static void test_force_at_interpolates() {
+    TEST_ASSERT_FALSE(verdict.addSample(3.5f, 1.0f));
+    TEST_ASSERT_TRUE(verdict.addSample(4.5f, 1.6f));
+    TEST_ASSERT_EQUAL_INT(VERDICT_REASON_FORCE_AT, verdict.reason());
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.3f, verdict.failValue());
+}
+
+static void test_overforce_rejects() {
+    TEST_ASSERT_TRUE(verdict.addSample(1.0f, 8.5f));
+    TEST_ASSERT_EQUAL_INT(VERDICT_REASON_OVERFORCE, verdict.reason());
+}
+
+// K muito alto, mas com F(4) dentro da faixa: reprovado pelo K corrente
+static void test_running_k_rejects_with_margin() {
+    const float k = 0.65f * 1.1f * (1.0f + VERDICT_EARLY_K_MARGIN) * 1.2f;
+    const float preload = 2.6f - 4.0f * k;
+    int at = -1;
+    for (int i = 0; i <= 8 && at < 0; ++i) {
+        if (verdict.addSample((float)i, preload + k * (float)i)) at = i;
+    }
+    // x = 0 fica abaixo de VERDICT_MIN_X_MM: o 4º ponto contado é x = 4
+    TEST_ASSERT_EQUAL_INT(VERDICT_EARLY_MIN_POINTS, at);
+    TEST_ASSERT_EQUAL_INT(VERDICT_REASON_K_HIGH, verdict.reason());
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, k, verdict.failValue());
+}
+
+// Dentro da margem antecipada, mas fora da faixa no K final
+static void test_final_k_without_margin() {
+    TEST_ASSERT_EQUAL_INT(-1, runSpring(0.65f, 0.0f));
+    TEST_ASSERT_EQUAL_INT(VERDICT_FAIL, verdict.finish(0.72f, true));
+    TEST_ASSERT_EQUAL_INT(VERDICT_REASON_K_HIGH, verdict.reason());
+}
+
+static void test_incomplete_course_fails() {
+    verdict.addSample(1.0f, 0.65f);
+    TEST_ASSERT_EQUAL_INT(VERDICT_FAIL, verdict.finish(0.65f, false));
+    TEST_ASSERT_EQUAL_INT(VERDICT_REASON_INCOMPLETE, verdict.reason());
+}
+
+static void test_profile_without_limits_has_no_verdict() {
+    interp.load(TEST_PROFILES[0].data, TEST_PROFILES[0].size);
+    verdict.begin(interp.settings(), VERDICT_EARLY_K_MARGIN, VERDICT_EARLY_MIN_POINTS, VERDICT_MIN_X_MM);
+    TEST_ASSERT_EQUAL_INT(VERDICT_NONE, verdict.state());
+    TEST_ASSERT_FALSE(verdict.addSample(1.0f, 100.0f));
+    TEST_ASSERT_EQUAL_INT(VERDICT_NONE, verdict.finish(10.0f, true));
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_good_spring_passes);
+    RUN_TEST(test_free_length_fails_before_compression);
+    RUN_TEST(test_force_at_rejects_early);
+    RUN_TEST(test_force_at_interpolates);
+    RUN_TEST(test_overforce_rejects);
+    RUN_TEST(test_running_k_rejects_with_margin);
+    RUN_TEST(test_final_k_without_margin);
+    RUN_TEST(test_incomplete_course_fails);
+    RUN_TEST(test_profile_without_limits_has_no_verdict);
+    return UNITY_END();
+}
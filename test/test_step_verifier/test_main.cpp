@@ -0,0 +1,88 @@
+#include <unity.h>
+#include "step_verifier.h"
+
+// Driver simulado: MSCNT anda 256/microsteps por pulso recebido; dropEvery
+// faz o driver perder um a cada N pulsos (ruído no STEP)
+struct FakeDriver {
+    int32_t mscnt;
+    int     microsteps;
+    int     dropEvery;
+    long    received;
+    long    dropped;
+
+    void pulse(int dir) {
+        ++received;
+        if (dropEvery > 0 && received % dropEvery == 0) {
+            ++dropped;
+            return;
+        }
+        mscnt = (mscnt + dir * (256 / microsteps) + 1024) % 1024;
+    }
+};
+
+static FakeDriver drv;
+static StepVerifier ver;
+
+void setUp() {
+    drv = FakeDriver{300, 16, 0, 0, 0};
+    ver = StepVerifier();
+    ver.begin((uint16_t)drv.mscnt);
+}
+void tearDown() {}
+
+// Move em blocos curtos e verifica ao fim de cada um, como o StepperManager
+static void move(long pulses, int dir) {
+    for (long i = 0; i < pulses; ++i) drv.pulse(dir);
+    ver.addPulses(pulses * dir, 256 / drv.microsteps);
+    ver.check((uint16_t)drv.mscnt);
+}
+
+static void test_clean_moves_report_no_loss() {
+    for (int i = 0; i < 50; ++i) move(37, (i & 1) ? 1 : -1);
+    TEST_ASSERT_FALSE(ver.lossDetected());
+    TEST_ASSERT_EQUAL_INT32(0, ver.lastError());
+    TEST_ASSERT_EQUAL_UINT32(50, ver.checks());
+}
+
+static void test_dropped_pulses_are_counted() {
+    drv.dropEvery = 10;
+    for (int i = 0; i < 20; ++i) move(20, 1);   // 2 perdas por bloco
+    TEST_ASSERT_TRUE(ver.lossDetected());
+    TEST_ASSERT_EQUAL_INT32(-2 * 16, ver.lastError());
+    // Perda em unidades de 1/16: igual aos pulsos perdidos
+    TEST_ASSERT_EQUAL_INT32(drv.dropped, ver.lostUnits(16));
+    TEST_ASSERT_EQUAL_INT32(drv.dropped / 2, ver.lostUnits(8));
+}
+
+static void test_microstep_change_with_rebase() {
+    move(100, 1);
+    drv.microsteps = 4;
+    ver.rebase((uint16_t)drv.mscnt);
+    move(25, -1);
+    TEST_ASSERT_FALSE(ver.lossDetected());
+}
+
+static void test_stall_marks_loss() {
+    ver.noteStall();
+    TEST_ASSERT_TRUE(ver.lossDetected());
+    TEST_ASSERT_EQUAL_UINT32(1, ver.stallEvents());
+}
+
+static void test_inactive_ignores_everything() {
+    ver.stop();
+    drv.dropEvery = 2;
+    move(100, 1);
+    ver.noteStall();
+    TEST_ASSERT_FALSE(ver.lossDetected());
+    TEST_ASSERT_EQUAL_UINT32(0, ver.checks());
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_clean_moves_report_no_loss);
+    RUN_TEST(test_dropped_pulses_are_counted);
+    RUN_TEST(test_microstep_change_with_rebase);
+    RUN_TEST(test_stall_marks_loss);
+    RUN_TEST(test_inactive_ignores_everything);
+    return UNITY_END();
+}
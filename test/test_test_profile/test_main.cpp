@@ -0,0 +1,132 @@
+#include <unity.h>
+#include <cstring>
+#include "test_profile.h"
+#include "test_profiles_data.h"
+
+void setUp() {}
+void tearDown() {}
+
+static ProfileInterpreter interp;
+
+// Carrega o perfil gerado pelo nome (tools/test_profiles.txt)
+static bool loadByName(const char* name) {
+    for (int i = 0; i < TEST_PROFILES_COUNT; ++i) {
+        if (!interp.load(TEST_PROFILES[i].data, TEST_PROFILES[i].size)) continue;
+        if (strcmp(interp.settings().name, name) == 0) return true;
+    }
+    return false;
+}
+
+static void test_all_generated_profiles_load() {
+    for (int i = 0; i < TEST_PROFILES_COUNT; ++i) {
+        TEST_ASSERT_TRUE_MESSAGE(interp.load(TEST_PROFILES[i].data, TEST_PROFILES[i].size),
+                                 interp.error());
+        // sampleCount de load() bate com os passos que next() entrega
+        ProfileStep step;
+        int samples = 0;
+        while (interp.next(&step)) {
+            if (step.kind == PROFILE_STEP_SAMPLE) samples++;
+        }
+        TEST_ASSERT_EQUAL_INT(interp.settings().sampleCount, samples);
+    }
+}
+
+// Os cursos embutidos reproduzem o comportamento anterior: 1 mm, média 5, 100 ms, 800 µs
+static void test_builtin_course_matches_legacy() {
+    TEST_ASSERT_TRUE(loadByName("Curso 10 mm"));
+    const ProfileSettings& s = interp.settings();
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 10.0f, s.courseMm);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.30f, s.contactForceKg);
+    TEST_ASSERT_EQUAL_UINT16(100, s.approachUsDelay);
+    TEST_ASSERT_FALSE(s.hasLimits());
+    TEST_ASSERT_EQUAL_UINT16(11, s.sampleCount);
+
+    ProfileStep step;
+    for (int i = 0; i <= 10; ++i) {
+        TEST_ASSERT_TRUE(interp.next(&step));
+        TEST_ASSERT_EQUAL_INT(PROFILE_STEP_SAMPLE, step.kind);
+        TEST_ASSERT_EQUAL_UINT16(i, step.index);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, (float)i, step.positionMm);
+        TEST_ASSERT_EQUAL_UINT16(800, step.usDelay);
+        TEST_ASSERT_EQUAL_UINT8(5, step.average);
+        TEST_ASSERT_EQUAL_UINT16(100, step.settleMs);
+        TEST_ASSERT_EQUAL_UINT16(20, step.readIntervalMs);
+    }
+    TEST_ASSERT_FALSE(interp.next(&step));
+}
+
+static void test_fine_profile_ranges_filter_and_dwell() {
+    TEST_ASSERT_TRUE(loadByName("Fino 6 mm"));
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 9.5f, interp.settings().maxForceKg);
+
+    const float expected[] = {0.0f, 0.5f, 1.0f, 1.5f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+    ProfileStep step;
+    for (float mm : expected) {
+        TEST_ASSERT_TRUE(interp.next(&step));
+        TEST_ASSERT_EQUAL_INT(PROFILE_STEP_SAMPLE, step.kind);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, mm, step.positionMm);
+    }
+    TEST_ASSERT_TRUE(interp.next(&step));
+    TEST_ASSERT_EQUAL_INT(PROFILE_STEP_DWELL, step.kind);
+    TEST_ASSERT_EQUAL_UINT16(2000, step.dwellMs);
+    // Filtro modal trocado antes do dwell vale para o último ponto
+    TEST_ASSERT_TRUE(interp.next(&step));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 6.0f, step.positionMm);
+    TEST_ASSERT_EQUAL_UINT8(8, step.average);
+    TEST_ASSERT_EQUAL_UINT16(300, step.settleMs);
+    TEST_ASSERT_FALSE(interp.next(&step));
+
+    interp.rewind();
+    TEST_ASSERT_TRUE(interp.next(&step));
+    TEST_ASSERT_EQUAL_UINT16(0, step.index);
+    TEST_ASSERT_EQUAL_UINT8(5, step.average);
+}
+
+static void test_production_profile_limits() {
+    TEST_ASSERT_TRUE(loadByName("PN 4471-A"));
+    const ProfileSettings& s = interp.settings();
+    TEST_ASSERT_TRUE(s.hasLimits());
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.65f, s.kNominalKgfMm);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.585f, s.kMinKgfMm);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.715f, s.kMaxKgfMm);
+    TEST_ASSERT_EQUAL_UINT8(2, s.forceCheckCount);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 4.0f, s.forceChecks[0].xMm);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 2.2f, s.forceChecks[0].minKg);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 5.8f, s.forceChecks[1].maxKg);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 20.0f, s.freeLengthMm);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.5f, s.freeLengthTolMm);
+}
+
+static void test_rejects_bad_header_and_truncation() {
+    const TestProfileEntry& e = TEST_PROFILES[0];
+    static uint8_t buf[128];
+    memcpy(buf, e.data, e.size);
+
+    buf[0] = 'X';
+    TEST_ASSERT_FALSE(interp.load(buf, e.size));
+    TEST_ASSERT_NOT_NULL(interp.error());
+    TEST_ASSERT_FALSE(interp.loaded());
+
+    memcpy(buf, e.data, e.size);
+    buf[2] = PROFILE_VERSION + 1;
+    TEST_ASSERT_FALSE(interp.load(buf, e.size));
+
+    // Qualquer corte antes do END é recusado (sem ler além do buffer)
+    for (size_t n = 0; n < e.size; ++n) {
+        TEST_ASSERT_FALSE(interp.load(e.data, n));
+    }
+
+    memcpy(buf, e.data, e.size);
+    buf[e.size - 1] = 0x7F;   // opcode desconhecido no lugar do END
+    TEST_ASSERT_FALSE(interp.load(buf, e.size));
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_all_generated_profiles_load);
+    RUN_TEST(test_builtin_course_matches_legacy);
+    RUN_TEST(test_fine_profile_ranges_filter_and_dwell);
+    RUN_TEST(test_production_profile_limits);
+    RUN_TEST(test_rejects_bad_header_and_truncation);
+    return UNITY_END();
+}
@@ -0,0 +1,126 @@
+#include <unity.h>
+#include "tmc_register_cache.h"
+
+// UART falsa: registradores do driver e número de transações
+struct FakeDriver {
+    uint32_t regs[TMC_REG_COUNT];
+    int transactions;
+};
+
+static TmcRegisterCache cache;
+static FakeDriver driver;
+
+// Mesmo laço da tarefa da UART: envia tudo o que estiver pendente
+static void flush() {
+    TmcReg reg;
+    uint32_t value;
+    while (cache.takePending(&reg, &value)) {
+        driver.regs[reg] = value;
+        driver.transactions++;
+        cache.commit(reg, value);
+    }
+}
+
+void setUp() {
+    cache = TmcRegisterCache();
+    driver = FakeDriver{};
+    for (uint8_t r = 0; r < TMC_REG_COUNT; ++r) cache.seed((TmcReg)r, 0);
+}
+void tearDown() {}
+
+static void test_writes_coalesce_into_one_transaction() {
+    for (uint32_t v = 1; v <= 5; ++v) cache.write(TMC_REG_SGTHRS, v);
+    TEST_ASSERT_TRUE(cache.hasPending());
+    flush();
+    TEST_ASSERT_EQUAL_INT(1, driver.transactions);
+    TEST_ASSERT_EQUAL_UINT32(5, driver.regs[TMC_REG_SGTHRS]);
+    TEST_ASSERT_EQUAL_UINT32(5, cache.requested());
+    TEST_ASSERT_EQUAL_UINT32(4, cache.coalesced());
+    TEST_ASSERT_EQUAL_UINT32(1, cache.flushed());
+}
+
+static void test_write_equal_to_driver_is_skipped() {
+    cache.write(TMC_REG_TCOOLTHRS, 0);
+    TEST_ASSERT_FALSE(cache.hasPending());
+    cache.write(TMC_REG_TCOOLTHRS, 7);
+    cache.write(TMC_REG_TCOOLTHRS, 0);   // volta ao valor do driver antes do envio
+    TEST_ASSERT_FALSE(cache.hasPending());
+    flush();
+    TEST_ASSERT_EQUAL_INT(0, driver.transactions);
+    TEST_ASSERT_EQUAL_UINT32(2, cache.skipped());
+}
+
+// Troca de fase: MRES e corrente alternando; só muda o que difere do driver
+static void test_phase_switch_round_trip() {
+    const uint32_t chopFine = (4UL << TMC_CHOPCONF_MRES_SHIFT) | TMC_CHOPCONF_VSENSE;
+    const uint32_t chopCoarse = (5UL << TMC_CHOPCONF_MRES_SHIFT) | TMC_CHOPCONF_VSENSE;
+    const uint32_t current = (16UL << TMC_IRUN_SHIFT) | 8;
+    cache.seed(TMC_REG_CHOPCONF, chopCoarse);
+    cache.seed(TMC_REG_IHOLD_IRUN, current);
+    driver.regs[TMC_REG_CHOPCONF] = chopCoarse;
+    driver.regs[TMC_REG_IHOLD_IRUN] = current;
+
+    for (int i = 0; i < 10; ++i) {
+        cache.write(TMC_REG_CHOPCONF, (i & 1) ? chopCoarse : chopFine);
+        cache.write(TMC_REG_IHOLD_IRUN, current);
+        flush();
+    }
+    TEST_ASSERT_EQUAL_INT(10, driver.transactions);   // só CHOPCONF
+    TEST_ASSERT_EQUAL_UINT32(chopCoarse, driver.regs[TMC_REG_CHOPCONF]);
+    TEST_ASSERT_EQUAL_UINT32(current, driver.regs[TMC_REG_IHOLD_IRUN]);
+}
+
+// Escrita nova enquanto a anterior está em trânsito continua pendente
+static void test_write_during_flight_stays_pending() {
+    cache.write(TMC_REG_GCONF, 1);
+    TmcReg reg;
+    uint32_t value;
+    TEST_ASSERT_TRUE(cache.takePending(&reg, &value));
+    cache.write(TMC_REG_GCONF, 2);
+    cache.commit(reg, value);
+    TEST_ASSERT_TRUE(cache.hasPending());
+    flush();
+    TEST_ASSERT_EQUAL_UINT32(2, driver.regs[TMC_REG_GCONF]);
+    TEST_ASSERT_FALSE(cache.hasPending());
+}
+
+// Volta ao valor antigo enquanto o novo está em trânsito: write() vê o
+// valor antigo do driver e descarta, mas o driver recebe o novo no envio
+static void test_revert_during_flight_is_resent() {
+    cache.write(TMC_REG_SGTHRS, 9);
+    TmcReg reg;
+    uint32_t value;
+    TEST_ASSERT_TRUE(cache.takePending(&reg, &value));
+    cache.write(TMC_REG_SGTHRS, 0);
+    TEST_ASSERT_FALSE(cache.hasPending());
+    driver.regs[reg] = value;
+    driver.transactions++;
+    cache.commit(reg, value);
+    TEST_ASSERT_TRUE(cache.hasPending());
+    flush();
+    TEST_ASSERT_EQUAL_INT(2, driver.transactions);
+    TEST_ASSERT_EQUAL_UINT32(0, driver.regs[TMC_REG_SGTHRS]);
+    TEST_ASSERT_EQUAL_UINT32(cache.shadow(TMC_REG_SGTHRS), driver.regs[TMC_REG_SGTHRS]);
+    TEST_ASSERT_FALSE(cache.hasPending());
+}
+
+static void test_pending_in_register_order() {
+    cache.write(TMC_REG_SGTHRS, 3);
+    cache.write(TMC_REG_GCONF, TMC_GCONF_EN_SPREADCYCLE);
+    TmcReg reg;
+    uint32_t value;
+    TEST_ASSERT_TRUE(cache.takePending(&reg, &value));
+    TEST_ASSERT_EQUAL_INT(TMC_REG_GCONF, reg);
+    TEST_ASSERT_EQUAL_UINT32(TMC_GCONF_EN_SPREADCYCLE, value);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_writes_coalesce_into_one_transaction);
+    RUN_TEST(test_write_equal_to_driver_is_skipped);
+    RUN_TEST(test_phase_switch_round_trip);
+    RUN_TEST(test_write_during_flight_stays_pending);
+    RUN_TEST(test_revert_during_flight_is_resent);
+    RUN_TEST(test_pending_in_register_order);
+    return UNITY_END();
+}
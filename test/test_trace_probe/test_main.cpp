@@ -0,0 +1,117 @@
+#include <unity.h>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include "trace_probe.h"
+
+static_assert(PROBES_ENABLED, "env:native compila com -DPROBES_ENABLED=1");
+
+// No PC 1 tick = 1 ns
+static const uint32_t US = 1000;
+
+static char lines[8][160];
+static int lineCount = 0;
+
+static void captureLine(const char* line) {
+    if (lineCount < 8) {
+        strncpy(lines[lineCount], line, sizeof(lines[0]) - 1);
+        lines[lineCount][sizeof(lines[0]) - 1] = '\0';
+    }
+    ++lineCount;
+}
+
+void setUp() {
+    probeReset();
+    lineCount = 0;
+}
+void tearDown() {}
+
+static void busyWaitUs(uint32_t us) {
+    using namespace std::chrono;
+    auto end = steady_clock::now() + microseconds(us);
+    while (steady_clock::now() < end) {
+    }
+}
+
+static void test_min_max_mean() {
+    probeRecord(PROBE_SPC_ADD, 3 * US);
+    probeRecord(PROBE_SPC_ADD, 1 * US);
+    probeRecord(PROBE_SPC_ADD, 8 * US);
+    const ProbeStats& s = probeStats(PROBE_SPC_ADD);
+    TEST_ASSERT_EQUAL_UINT32(3, s.count);
+    TEST_ASSERT_EQUAL_UINT32(1 * US, s.minTicks);
+    TEST_ASSERT_EQUAL_UINT32(8 * US, s.maxTicks);
+    TEST_ASSERT_TRUE(s.sumTicks == 12 * US);
+    TEST_ASSERT_EQUAL_UINT32(0, probeStats(PROBE_LOOP).count);
+}
+
+// Baldes log2: [0,1) µs, [1,2), [2,4), [4,8) ... último aberto
+static void test_histogram_buckets() {
+    const uint32_t us[] = {0, 1, 2, 3, 4, 7, 8, 1023, 1024};
+    for (uint32_t v : us) probeRecord(PROBE_LOOP, v * US + US / 2);
+    probeRecord(PROBE_LOOP, 999);                       // 0,999 µs: ainda balde 0
+    probeRecord(PROBE_LOOP, 0xFFFFFFFFu);               // ~4,3 s: último balde
+    const ProbeStats& s = probeStats(PROBE_LOOP);
+    TEST_ASSERT_EQUAL_UINT32(2, s.hist[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, s.hist[1]);
+    TEST_ASSERT_EQUAL_UINT32(2, s.hist[2]);
+    TEST_ASSERT_EQUAL_UINT32(2, s.hist[3]);
+    TEST_ASSERT_EQUAL_UINT32(1, s.hist[4]);
+    TEST_ASSERT_EQUAL_UINT32(1, s.hist[10]);
+    TEST_ASSERT_EQUAL_UINT32(1, s.hist[11]);
+    TEST_ASSERT_EQUAL_UINT32(1, s.hist[PROBE_HIST_BUCKETS - 1]);
+}
+
+// Backend std::chrono: o escopo mede a espera real (com folga para o agendador)
+static void test_scope_measures_chrono_time() {
+    for (int i = 0; i < 5; ++i) {
+        PROBE_SCOPE(PROBE_EXPORT_FRAME);
+        busyWaitUs(2000);
+    }
+    const ProbeStats& s = probeStats(PROBE_EXPORT_FRAME);
+    TEST_ASSERT_EQUAL_UINT32(5, s.count);
+    TEST_ASSERT_TRUE(s.minTicks >= 2000 * US);
+    TEST_ASSERT_TRUE(s.minTicks < 50000 * US);
+    TEST_ASSERT_EQUAL_UINT32(5, s.hist[11] + s.hist[12] + s.hist[13] + s.hist[14] + s.hist[15] + s.hist[16]);
+}
+
+static void test_now_ticks_is_monotonic_ns() {
+    uint32_t t0 = probeNowTicks();
+    busyWaitUs(100);
+    uint32_t dt = probeNowTicks() - t0;   // aritmética modular: vale através do wrap
+    TEST_ASSERT_TRUE(dt >= 100 * US);
+    TEST_ASSERT_TRUE(dt < 100000 * US);
+}
+
+static void test_dump_format() {
+    probeRecord(PROBE_SPC_ADD, 1 * US + 1);
+    probeRecord(PROBE_SPC_ADD, 5 * US);
+    probeRecord(PROBE_SPC_ADD, 0xFFFFFFFFu);
+    probeDump(captureLine);
+    TEST_ASSERT_EQUAL_INT(2, lineCount);   // só a sonda com dados
+    TEST_ASSERT_EQUAL_STRING("PROBE spc.add n=3 min=1us max=4294967us mean=1431657us", lines[0]);
+    TEST_ASSERT_EQUAL_STRING("HIST spc.add <2:1 <8:1 >=4194304:1", lines[1]);
+}
+
+static void test_names_and_reset() {
+    TEST_ASSERT_EQUAL_STRING("loop", probeName(PROBE_LOOP));
+    TEST_ASSERT_EQUAL_STRING("export.frame", probeName(PROBE_EXPORT_FRAME));
+    TEST_ASSERT_EQUAL_STRING("?", probeName(PROBE_COUNT));
+    probeRecord(PROBE_LOOP, US);
+    probeReset();
+    TEST_ASSERT_EQUAL_UINT32(0, probeStats(PROBE_LOOP).count);
+    TEST_ASSERT_EQUAL_UINT32(0, probeStats(PROBE_LOOP).hist[1]);
+    probeDump(captureLine);
+    TEST_ASSERT_EQUAL_INT(0, lineCount);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_min_max_mean);
+    RUN_TEST(test_histogram_buckets);
+    RUN_TEST(test_scope_measures_chrono_time);
+    RUN_TEST(test_now_ticks_is_monotonic_ns);
+    RUN_TEST(test_dump_format);
+    RUN_TEST(test_names_and_reset);
+    return UNITY_END();
+}
@@ -0,0 +1,217 @@
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include "zero_tracker.h"
+#include "config.h"
+
+// Fator típico de célula de 20 kg no HX711 (contagens por kg)
+static const float COUNTS_PER_KG = 10000.0f;
+static const float BASE = 84000.0f;
+static const int W = ZeroTracker::ZERO_TRACK_WINDOW;
+
+static ZeroTracker zt;
+
+static ZeroTrackerConfig makeConfig() {
+    ZeroTrackerConfig cfg;
+    cfg.observeIntervalMs = ZERO_TRACK_OBSERVE_MS;
+    cfg.stableCounts      = ZERO_TRACK_STABLE_KG * COUNTS_PER_KG;
+    cfg.maxJumpCounts     = ZERO_TRACK_MAX_JUMP_KG * COUNTS_PER_KG;
+    cfg.forgetting        = ZERO_TRACK_FORGET;
+    return cfg;
+}
+
+// Janela inteira de leituras iguais a partir de t; resultado da última
+static bool feedWindow(int32_t raw, uint32_t t, float tempC) {
+    bool accepted = false;
+    for (int i = 0; i < W; ++i) accepted = zt.observe(raw, t + i * 100, tempC);
+    return accepted;
+}
+
+void setUp() {
+    zt.begin(makeConfig());
+}
+void tearDown() {}
+
+static void test_no_observation_before_tare() {
+    TEST_ASSERT_FALSE(feedWindow((int32_t)BASE, 0, NAN));
+    TEST_ASSERT_EQUAL_UINT32(0, zt.accepted());
+}
+
+static void test_tare_is_exact_zero() {
+    zt.tare(BASE, 0, 25.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, BASE, zt.offsetAt(0, 25.0f));
+    // Segunda tara perto da previsão: o viés faz offsetAt() devolver o medido
+    zt.tare(BASE + 30.0f, 60000, 25.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, BASE + 30.0f, zt.offsetAt(60000, 25.0f));
+}
+
+static void test_stable_free_window_is_accepted() {
+    zt.tare(BASE, 0, NAN);
+    TEST_ASSERT_TRUE(feedWindow((int32_t)BASE + 10, 1000, NAN));
+    TEST_ASSERT_EQUAL_UINT32(1, zt.accepted());
+}
+
+// A medida decide: carga (longe da previsão) e vibração reprovam a janela
+static void test_loaded_or_unstable_window_is_rejected() {
+    zt.tare(BASE, 0, NAN);
+    int32_t loaded = (int32_t)(BASE + 0.2f * COUNTS_PER_KG);
+    TEST_ASSERT_FALSE(feedWindow(loaded, 1000, NAN));
+    TEST_ASSERT_EQUAL_UINT32(1, zt.rejected());
+
+    bool accepted = false;
+    for (int i = 0; i < W; ++i) {
+        int32_t shake = (int32_t)BASE + ((i & 1) ? 200 : -200);
+        accepted = zt.observe(shake, 40000 + i * 100, NAN);
+    }
+    TEST_ASSERT_FALSE(accepted);
+    TEST_ASSERT_EQUAL_UINT32(2, zt.rejected());
+    TEST_ASSERT_EQUAL_UINT32(0, zt.accepted());
+}
+
+static void test_interrupt_discards_partial_window() {
+    zt.tare(BASE, 0, NAN);
+    for (int i = 0; i < W - 1; ++i) TEST_ASSERT_FALSE(zt.observe((int32_t)BASE, 1000 + i, NAN));
+    zt.interrupt();
+    TEST_ASSERT_FALSE(zt.observe((int32_t)BASE, 2000, NAN));
+    TEST_ASSERT_EQUAL_UINT32(0, zt.accepted() + zt.rejected());
+}
+
+static void test_one_observation_per_interval() {
+    zt.tare(BASE, 0, NAN);
+    TEST_ASSERT_TRUE(feedWindow((int32_t)BASE, 1000, NAN));
+    TEST_ASSERT_FALSE(feedWindow((int32_t)BASE, 2000, NAN));
+    TEST_ASSERT_TRUE(feedWindow((int32_t)BASE, 1000 + ZERO_TRACK_OBSERVE_MS, NAN));
+    TEST_ASSERT_EQUAL_UINT32(2, zt.accepted());
+}
+
+// Degrau na tara (fixação trocada): desloca a sem perder a deriva aprendida
+static void test_far_tare_is_a_step() {
+    zt.tare(BASE, 0, NAN);
+    for (uint32_t k = 1; k <= 240; ++k) {
+        uint32_t t = k * ZERO_TRACK_OBSERVE_MS;
+        feedWindow((int32_t)lroundf(BASE + 30.0f * t / 3600000.0f), t, NAN);
+    }
+    float drift = zt.driftCountsPerHour();
+    TEST_ASSERT_FLOAT_WITHIN(3.0f, 30.0f, drift);
+
+    uint32_t t = 241 * ZERO_TRACK_OBSERVE_MS;
+    float jumped = BASE + 2000.0f;
+    zt.tare(jumped, t, NAN);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, jumped, zt.offsetAt(t, NAN));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, drift, zt.driftCountsPerHour());
+}
+
+// ---- Turno sintético com a política do ScaleManager ----
+
+struct Rng {
+    uint32_t s = 12345u;
+    float uniform() {
+        s ^= s << 13;
+        s ^= s >> 17;
+        s ^= s << 5;
+        return (float)(s >> 8) * (1.0f / 16777216.0f);
+    }
+    float gaussian() {
+        float sum = 0.0f;
+        for (int i = 0; i < 12; ++i) sum += uniform();
+        return sum - 6.0f;
+    }
+};
+
+// Deriva 30 contagens/h, 40 contagens/°C, ciclo térmico de 4 °C e aquecimento
+static float trueOffset(float hours, float tempC) {
+    float warmUp = 60.0f * (1.0f - expf(-hours * 3.0f));
+    return BASE + 30.0f * hours + 40.0f * (tempC - 25.0f) + warmUp;
+}
+
+static float temperatureAt(float hours) {
+    return 25.0f + 2.0f * sinf(2.0f * (float)M_PI * hours / 4.0f) + 1.5f * (1.0f - expf(-hours * 2.0f));
+}
+
+// 8 h a 2 leituras/s: 3 min ocioso / 2 min de teste (tara com a fixação de
+// 0,2 kg), uma fadiga de 1 h a partir de 4 h, toques de 1 kg no menu e a
+// fixação esquecida na plataforma depois de alguns testes. Como em
+// ScaleManager::trackZero(): offset muda só em janela aceita, congelado no teste.
+static void test_shift_benchmark() {
+    Rng rng;
+    const uint32_t periodMs = 500;
+    const uint32_t shiftMs = 8u * 3600000u;
+    const float fixture = 0.2f * COUNTS_PER_KG;
+    const float noise = 0.002f * COUNTS_PER_KG;
+
+    float t0 = temperatureAt(0.0f);
+    float offsetTracked = trueOffset(0.0f, t0);
+    float offsetBoot = offsetTracked;
+    zt.tare(offsetTracked, 0, t0);
+
+    double errTracked = 0.0, errBoot = 0.0, errTestTare = 0.0, errBootLoaded = 0.0;
+    uint32_t idleN = 0, loadedN = 0;
+    bool inTest = false;
+    bool fixtureLeft = false;
+    uint32_t bumpUntil = 0;
+    float testTare = 0.0f;
+
+    for (uint32_t t = periodMs; t < shiftMs; t += periodMs) {
+        float h = t / 3600000.0f;
+        float temp = temperatureAt(h);
+        float zero = trueOffset(h, temp);
+
+        bool fatigue = (t >= 4u * 3600000u && t < 5u * 3600000u);
+        bool test = fatigue || (t % 300000u) >= 180000u;
+        if (test && !inTest) {
+            testTare = zero + fixture;   // tara do teste: não alimenta o modelo
+            fixtureLeft = rng.uniform() < 0.2f;
+        }
+        inTest = test;
+
+        if (test) {
+            zt.interrupt();   // congelado: vale a tara do teste
+            errTestTare += fabsf(testTare - (zero + fixture));
+            errBootLoaded += fabsf(offsetBoot - zero);
+            ++loadedN;
+            continue;
+        }
+
+        if (bumpUntil <= t && rng.uniform() < 0.001f) bumpUntil = t + 5000;
+        float load = (bumpUntil > t) ? COUNTS_PER_KG : 0.0f;
+        if (fixtureLeft && (t % 300000u) < 60000u) load += fixture;
+        int32_t raw = (int32_t)lroundf(zero + load + noise * rng.gaussian());
+        if (zt.observe(raw, t, temp)) offsetTracked = zt.offsetAt(t, temp);
+
+        if (load == 0.0f) {
+            errTracked += fabsf(offsetTracked - zero);
+            errBoot += fabsf(offsetBoot - zero);
+            ++idleN;
+        }
+    }
+
+    float gTracked = (float)(errTracked / idleN) / COUNTS_PER_KG * 1000.0f;
+    float gBoot = (float)(errBoot / idleN) / COUNTS_PER_KG * 1000.0f;
+    float gTestTare = (float)(errTestTare / loadedN) / COUNTS_PER_KG * 1000.0f;
+    float gBootLoaded = (float)(errBootLoaded / loadedN) / COUNTS_PER_KG * 1000.0f;
+    char msg[200];
+    snprintf(msg, sizeof(msg),
+             "zero ocioso: rastreado %.2f g, so tara de boot %.2f g | em teste: tara do teste %.2f g, "
+             "tara de boot %.2f g | b=%.1f cont/h c=%.1f cont/C aceitas=%u rejeitadas=%u",
+             gTracked, gBoot, gTestTare, gBootLoaded, zt.driftCountsPerHour(),
+             zt.tempCoefCountsPerC(), (unsigned)zt.accepted(), (unsigned)zt.rejected());
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_TRUE(zt.rejected() > 0);   // toques e fixação esquecida
+    TEST_ASSERT_TRUE(gTracked < 0.5f * gBoot);
+    TEST_ASSERT_FLOAT_WITHIN(10.0f, 30.0f, zt.driftCountsPerHour());
+    TEST_ASSERT_FLOAT_WITHIN(10.0f, 40.0f, zt.tempCoefCountsPerC());
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_no_observation_before_tare);
+    RUN_TEST(test_tare_is_exact_zero);
+    RUN_TEST(test_stable_free_window_is_accepted);
+    RUN_TEST(test_loaded_or_unstable_window_is_rejected);
+    RUN_TEST(test_interrupt_discards_partial_window);
+    RUN_TEST(test_one_observation_per_interval);
+    RUN_TEST(test_far_tare_is_a_step);
+    RUN_TEST(test_shift_benchmark);
+    return UNITY_END();
+}
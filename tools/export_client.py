@@ -0,0 +1,308 @@
+#!/usr/bin/env python3
+"""Baixa o registro de resultados pelo comando serial EXPORT e gera CSV.
+
+Uso:
+    python tools/export_client.py --port /dev/ttyUSB0 -o resultados.csv
+    python tools/export_client.py --input captura.bin -o resultados.csv
+
+Com --port envia "EXPORT <offset>" e recebe os quadros binários (formato em
+include/export_codec.h). O fluxo recebido é salvo em <saida>.part a cada
+quadro válido: se a transferência cair, rode de novo e ela continua do
+offset já recebido. Quadro com CRC inválido ou fora de ordem provoca novo
+pedido a partir do último offset contíguo.
+
+Com --input decodifica uma captura bruta da serial (offline).
+
+Ao final imprime registros, amostras, bytes no fio, bytes do CSV gerado,
+taxa de compressão e vazão efetiva, e quanto o mesmo CSV levaria no fio.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import time
+import zlib
+
+MAGIC = b"\xa5\x5a"
+FRAME_STORED = 0
+FRAME_LZ = 1
+FRAME_END = 2
+HEADER_LEN = 11          # magic(2) tipo(1) offset(4) bruto(2) carga(2)
+MAX_PAYLOAD = 512
+RECORD_TAG = ord("R")
+
+VERDICTS = {0: "sem_limites", 1: "aprovado", 2: "reprovado", 3: "invalido"}
+
+
+def lz_decompress(data, raw_len):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        ctrl = data[i]
+        i += 1
+        for bit in range(8):
+            if i >= len(data):
+                break
+            if ctrl & (1 << bit):
+                length = (data[i] & 0x0F) + 3
+                dist = (((data[i] >> 4) << 8) | data[i + 1]) + 1
+                i += 2
+                if dist > len(out):
+                    raise ValueError("referencia LZ invalida")
+                for _ in range(length):
+                    out.append(out[-dist])
+            else:
+                out.append(data[i])
+                i += 1
+    if len(out) != raw_len:
+        raise ValueError("tamanho LZ divergente")
+    return bytes(out)
+
+
+class FrameReader:
+    """Extrai quadros válidos de um fluxo de bytes misturado com texto."""
+
+    def __init__(self):
+        self.buf = bytearray()
+        self.text = bytearray()
+        self.crc_errors = 0
+
+    def feed(self, data):
+        self.buf += data
+
+    def frames(self):
+        while True:
+            start = self.buf.find(MAGIC)
+            if start < 0:
+                # Guarda o último byte: pode ser a metade de um magic
+                keep = 1 if self.buf[-1:] == MAGIC[:1] else 0
+                self.text += self.buf[:len(self.buf) - keep]
+                del self.buf[:len(self.buf) - keep]
+                return
+            self.text += self.buf[:start]
+            del self.buf[:start]
+            if len(self.buf) < HEADER_LEN:
+                return
+            typ, offset, raw_len, pay_len = struct.unpack_from("<BIHH", self.buf, 2)
+            if typ > FRAME_END or pay_len > MAX_PAYLOAD or raw_len > MAX_PAYLOAD:
+                del self.buf[:1]          # falso magic (texto ou ruído)
+                continue
+            total = HEADER_LEN + pay_len + 4
+            if len(self.buf) < total:
+                return
+            crc = struct.unpack_from("<I", self.buf, HEADER_LEN + pay_len)[0]
+            if zlib.crc32(bytes(self.buf[2:HEADER_LEN + pay_len])) != crc:
+                self.crc_errors += 1
+                del self.buf[:1]
+                continue
+            payload = bytes(self.buf[HEADER_LEN:HEADER_LEN + pay_len])
+            del self.buf[:total]
+            yield typ, offset, raw_len, payload
+
+    def text_lines(self):
+        lines = self.text.decode("ascii", errors="replace").splitlines()
+        self.text.clear()
+        return lines
+
+
+def read_varint(data, pos):
+    result = 0
+    shift = 0
+    while True:
+        b = data[pos]
+        pos += 1
+        result |= (b & 0x7F) << shift
+        if not b & 0x80:
+            return result, pos
+        shift += 7
+
+
+def unzigzag(v):
+    return (v >> 1) ^ -(v & 1)
+
+
+def decode_records(stream):
+    """Decodifica o fluxo de registros (ver exportEncodeRecord)."""
+    records = []
+    pos = 0
+    while pos < len(stream):
+        if stream[pos] != RECORD_TAG:
+            raise ValueError("registro invalido no offset %d" % pos)
+        pos += 1
+        seq, pos = read_varint(stream, pos)
+        uptime_ms, pos = read_varint(stream, pos)
+        count, pos = read_varint(stream, pos)
+        verdict, reason, flags, name_len = stream[pos:pos + 4]
+        pos += 4
+        name = stream[pos:pos + name_len].decode("latin-1")
+        pos += name_len
+        steps_mm, calib, k, r2, fmax = struct.unpack_from("<5f", stream, pos)
+        pos += 20
+        v, pos = read_varint(stream, pos)
+        tare = unzigzag(v)
+        v, pos = read_varint(stream, pos)
+        zero = unzigzag(v)
+
+        step, raw, t = zero, tare, 0
+        samples = []
+        for _ in range(count):
+            v, pos = read_varint(stream, pos)
+            step += unzigzag(v)
+            v, pos = read_varint(stream, pos)
+            raw += unzigzag(v)
+            v, pos = read_varint(stream, pos)
+            t = (t + v) & 0xFFFFFFFF
+            samples.append((step, raw, t))
+        records.append({
+            "seq": seq, "uptime_ms": uptime_ms, "profile": name, "verdict": verdict,
+            "reason": reason, "early": flags & 1, "steps_mm": steps_mm, "calib": calib,
+            "k": k, "r2": r2, "fmax": fmax, "tare": tare, "zero": zero, "samples": samples,
+        })
+    return records
+
+
+def write_csv(records, path):
+    with open(path, "w", encoding="utf-8") as f:
+        f.write("seq,perfil,k_kgf_mm,r2,veredito,i,step_pos,raw_count,t_us,x_mm,f_kg\n")
+        for r in records:
+            for i, (step, raw, t) in enumerate(r["samples"]):
+                x = (r["zero"] - step) / r["steps_mm"] if r["steps_mm"] else 0.0
+                kg = (raw - r["tare"]) / r["calib"] if r["calib"] else 0.0
+                f.write("%d,%s,%.4f,%.4f,%s,%d,%d,%d,%d,%.3f,%.4f\n" % (
+                    r["seq"], r["profile"], r["k"], r["r2"], VERDICTS.get(r["verdict"], "?"),
+                    i, step, raw, t, x, kg))
+    return os.path.getsize(path)
+
+
+class Transfer:
+    def __init__(self, part_path):
+        self.part_path = part_path
+        self.stream = bytearray()
+        if part_path and os.path.exists(part_path):
+            with open(part_path, "rb") as f:
+                self.stream = bytearray(f.read())
+        self.total = None
+        self.wire = 0
+        self.device_report = None
+
+    def accept(self, typ, offset, raw_len, payload):
+        """Retorna False se houve lacuna (precisa pedir de novo)."""
+        if typ == FRAME_END:
+            if offset == len(self.stream):
+                self.total = offset
+            return offset == len(self.stream)
+        if offset + raw_len <= len(self.stream):
+            return True                   # duplicado (retransmissão)
+        if offset != len(self.stream):
+            return False
+        data = lz_decompress(payload, raw_len) if typ == FRAME_LZ else payload
+        self.stream += data
+        if self.part_path:
+            with open(self.part_path, "ab") as f:
+                f.write(data)
+        return True
+
+
+def run_serial(args, transfer):
+    import serial  # pyserial
+
+    reader = FrameReader()
+    with serial.Serial(args.port, args.baud, timeout=0.2) as port:
+        time.sleep(0.2)
+        port.reset_input_buffer()
+        retries = 0
+        while transfer.total is None and retries <= args.retries:
+            port.write(b"EXPORT %d\n" % len(transfer.stream))
+            last_rx = time.time()
+            gap = False
+            while transfer.total is None and not gap:
+                chunk = port.read(4096)
+                if chunk:
+                    last_rx = time.time()
+                    transfer.wire += len(chunk)
+                    reader.feed(chunk)
+                    for frame in reader.frames():
+                        if not transfer.accept(*frame):
+                            gap = True
+                            break
+                    for line in reader.text_lines():
+                        if line.startswith("OK EXPORT done"):
+                            transfer.device_report = line
+                        elif line.startswith("ERR EXPORT"):
+                            sys.exit("dispositivo recusou: " + line)
+                elif time.time() - last_rx > args.timeout:
+                    gap = True
+            if gap:
+                retries += 1
+                port.write(b"ABORT\n")
+                time.sleep(0.5)
+                port.reset_input_buffer()
+                reader = FrameReader()
+                print("retomando do offset %d" % len(transfer.stream), file=sys.stderr)
+        # Relatório final do dispositivo vem logo após o quadro de fim
+        deadline = time.time() + 1.0
+        while transfer.device_report is None and time.time() < deadline:
+            reader.feed(port.read(256))
+            list(reader.frames())
+            for line in reader.text_lines():
+                if line.startswith("OK EXPORT done"):
+                    transfer.device_report = line
+    return reader.crc_errors
+
+
+def run_capture(args, transfer):
+    reader = FrameReader()
+    with open(args.input, "rb") as f:
+        data = f.read()
+    transfer.wire = len(data)
+    reader.feed(data)
+    for frame in reader.frames():
+        if not transfer.accept(*frame):
+            sys.exit("captura com lacuna no offset %d" % len(transfer.stream))
+    for line in reader.text_lines():
+        if line.startswith("OK EXPORT done"):
+            transfer.device_report = line
+    return reader.crc_errors
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    src = ap.add_mutually_exclusive_group(required=True)
+    src.add_argument("--port", help="porta serial (ex.: /dev/ttyUSB0)")
+    src.add_argument("--input", help="captura bruta da serial")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--timeout", type=float, default=3.0, help="s sem dados antes de retomar")
+    ap.add_argument("--retries", type=int, default=5)
+    ap.add_argument("-o", "--output", default="resultados.csv")
+    args = ap.parse_args()
+
+    part = args.output + ".part" if args.port else None
+    transfer = Transfer(part)
+    t0 = time.time()
+    crc_errors = run_serial(args, transfer) if args.port else run_capture(args, transfer)
+    elapsed = time.time() - t0
+    if transfer.total is None:
+        sys.exit("exportação incompleta: %d bytes (rode de novo para retomar)" % len(transfer.stream))
+
+    records = decode_records(bytes(transfer.stream))
+    csv_bytes = write_csv(records, args.output)
+    if part and os.path.exists(part):
+        os.remove(part)
+
+    samples = sum(len(r["samples"]) for r in records)
+    print("%d registros, %d amostras -> %s" % (len(records), samples, args.output))
+    print("fluxo %d B, fio %d B, CSV %d B, CRC inválidos %d" % (
+        len(transfer.stream), transfer.wire, csv_bytes, crc_errors))
+    if transfer.wire:
+        print("compressão vs CSV: %.2fx" % (csv_bytes / transfer.wire))
+    if args.port and elapsed > 0:
+        csv_wire_s = csv_bytes * 10.0 / args.baud   # 8N1: 10 bits por byte
+        print("%.1f s (%.0f amostras/s, %.0f B/s de CSV efetivo); CSV puro levaria %.1f s" % (
+            elapsed, samples / elapsed, csv_bytes / elapsed, csv_wire_s))
+    if transfer.device_report:
+        print("dispositivo: " + transfer.device_report)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,241 @@
+#!/usr/bin/env python3
+"""Compila perfis de teste de mola (texto) para o bytecode lido pelo firmware.
+
+Uso:
+    python tools/profile_compiler.py tools/test_profiles.txt -o include/test_profiles_data.h
+
+O formato binário está documentado em include/test_profile.h; este script
+é a única parte que interpreta texto, o firmware só decodifica opcodes.
+"""
+
+import argparse
+import shlex
+import struct
+import sys
+
+PROFILE_VERSION = 1
+PROFILE_NAME_MAX = 15
+
+OP_END = 0x00
+OP_COURSE = 0x01
+OP_CONTACT = 0x02
+OP_APPROACH = 0x03
+OP_LIMIT_FORCE = 0x04
+OP_LIMIT_K = 0x05
+OP_K_NOMINAL = 0x06
+OP_FORCE_AT = 0x07
+OP_FREE_LENGTH = 0x08
+OP_SPEED = 0x10
+OP_FILTER = 0x11
+OP_SAMPLE = 0x20
+OP_RANGE = 0x21
+OP_DWELL = 0x22
+
+U16_MAX = 0xFFFF
+MAX_FORCE_CHECKS = 4
+
+
+class ProfileError(Exception):
+    pass
+
+
+def u16(value, what):
+    v = int(round(value))
+    if not 0 <= v <= U16_MAX:
+        raise ProfileError(f"{what} fora da faixa: {value}")
+    return struct.pack("<H", v)
+
+
+def cmm(mm, what):
+    return u16(float(mm) * 100.0, what)
+
+
+def grams(kg, what):
+    return u16(float(kg) * 1000.0, what)
+
+
+def expect(args, n, keyword):
+    if len(args) != n:
+        raise ProfileError(f"'{keyword}' espera {n} argumento(s)")
+
+
+class Profile:
+    def __init__(self, name):
+        if not name or len(name.encode("ascii")) > PROFILE_NAME_MAX:
+            raise ProfileError(f"nome deve ter 1..{PROFILE_NAME_MAX} caracteres: '{name}'")
+        self.name = name
+        self.config = bytearray()
+        self.body = bytearray()
+        self.course = None
+        self.contact = None
+        self.max_point = 0.0
+        self.points = 0
+        self.force_checks = []
+
+    def statement(self, keyword, args):
+        if keyword == "course":
+            expect(args, 1, keyword)
+            self.course = float(args[0])
+            self.config += bytes([OP_COURSE]) + cmm(args[0], "curso")
+        elif keyword == "contact_kg":
+            expect(args, 1, keyword)
+            self.contact = float(args[0])
+            self.config += bytes([OP_CONTACT]) + grams(args[0], "forca de contato")
+        elif keyword == "approach_us":
+            expect(args, 1, keyword)
+            self.config += bytes([OP_APPROACH]) + u16(float(args[0]), "approach_us")
+        elif keyword == "limit_force_kg":
+            expect(args, 1, keyword)
+            self.config += bytes([OP_LIMIT_FORCE]) + grams(args[0], "limite de forca")
+        elif keyword == "limit_k":
+            expect(args, 2, keyword)
+            lo, hi = float(args[0]), float(args[1])
+            if hi < lo:
+                raise ProfileError("limit_k: minimo maior que maximo")
+            self.config += bytes([OP_LIMIT_K]) + grams(lo, "K minimo") + grams(hi, "K maximo")
+        elif keyword == "k_nominal":
+            expect(args, 2, keyword)
+            nominal, tol_pct = float(args[0]), float(args[1])
+            if nominal <= 0 or not 0 <= tol_pct < 100:
+                raise ProfileError("k_nominal: K > 0 e tolerancia entre 0 e 100 %")
+            self.config += bytes([OP_K_NOMINAL]) + grams(nominal, "K nominal") + u16(tol_pct * 10.0, "tolerancia")
+        elif keyword == "force_at":
+            expect(args, 3, keyword)
+            x, lo, hi = (float(a) for a in args)
+            if hi < lo:
+                raise ProfileError("force_at: minimo maior que maximo")
+            if self.force_checks and x <= self.force_checks[-1]:
+                raise ProfileError("force_at: posicoes devem ser crescentes")
+            if len(self.force_checks) >= MAX_FORCE_CHECKS:
+                raise ProfileError(f"no maximo {MAX_FORCE_CHECKS} force_at por perfil")
+            self.force_checks.append(x)
+            self.config += bytes([OP_FORCE_AT]) + cmm(x, "posicao") + grams(lo, "forca minima") + grams(hi, "forca maxima")
+        elif keyword == "free_length":
+            expect(args, 2, keyword)
+            self.config += bytes([OP_FREE_LENGTH]) + cmm(args[0], "comprimento livre") + cmm(args[1], "tolerancia")
+        elif keyword == "speed_us":
+            expect(args, 1, keyword)
+            self.body += bytes([OP_SPEED]) + u16(float(args[0]), "speed_us")
+        elif keyword == "filter":
+            expect(args, 3, keyword)
+            n = int(args[0])
+            if not 1 <= n <= 255:
+                raise ProfileError("filter: N deve estar entre 1 e 255")
+            self.body += bytes([OP_FILTER, n]) + u16(float(args[1]), "acomodacao") + u16(float(args[2]), "intervalo")
+        elif keyword == "sample":
+            expect(args, 1, keyword)
+            self.body += bytes([OP_SAMPLE]) + cmm(args[0], "posicao")
+            self.max_point = max(self.max_point, float(args[0]))
+            self.points += 1
+        elif keyword == "range":
+            expect(args, 3, keyword)
+            start, end, step = (int(round(float(a) * 100.0)) for a in args)
+            if step <= 0 or end < start:
+                raise ProfileError("range: passo deve ser > 0 e fim >= inicio")
+            self.body += bytes([OP_RANGE]) + u16(start, "inicio") + u16(end, "fim") + u16(step, "passo")
+            self.max_point = max(self.max_point, end / 100.0)
+            self.points += (end - start) // step + 1
+        elif keyword == "dwell":
+            expect(args, 1, keyword)
+            self.body += bytes([OP_DWELL]) + u16(float(args[0]), "dwell")
+        else:
+            raise ProfileError(f"comando desconhecido: '{keyword}'")
+
+    def compile(self):
+        if self.course is None:
+            raise ProfileError("'course' obrigatorio")
+        if self.contact is None:
+            raise ProfileError("'contact_kg' obrigatorio")
+        if self.points == 0:
+            raise ProfileError("nenhum ponto de amostragem")
+        if self.max_point > self.course + 1e-9:
+            raise ProfileError(f"ponto {self.max_point} mm alem do curso {self.course} mm")
+        if self.force_checks and self.force_checks[-1] > self.max_point + 1e-9:
+            raise ProfileError(f"force_at {self.force_checks[-1]} mm alem do ultimo ponto")
+        name = self.name.encode("ascii")
+        header = bytes([ord("S"), ord("P"), PROFILE_VERSION, len(name)]) + name
+        return header + bytes(self.config) + bytes(self.body) + bytes([OP_END])
+
+
+def parse(lines):
+    profiles = []
+    current = None
+    for lineno, raw in enumerate(lines, 1):
+        line = raw.split("#", 1)[0].strip()
+        if not line:
+            continue
+        try:
+            tokens = shlex.split(line)
+            keyword, args = tokens[0], tokens[1:]
+            if keyword == "profile":
+                if current is not None:
+                    raise ProfileError("'profile' sem 'end' anterior")
+                expect(args, 1, keyword)
+                current = Profile(args[0])
+            elif keyword == "end":
+                if current is None:
+                    raise ProfileError("'end' sem 'profile'")
+                profiles.append((current.name, current.compile()))
+                current = None
+            elif current is None:
+                raise ProfileError(f"'{keyword}' fora de um perfil")
+            else:
+                current.statement(keyword, args)
+        except (ProfileError, ValueError) as exc:
+            raise ProfileError(f"linha {lineno}: {exc}") from None
+    if current is not None:
+        raise ProfileError(f"perfil '{current.name}' sem 'end'")
+    if not profiles:
+        raise ProfileError("nenhum perfil definido")
+    return profiles
+
+
+def render_header(profiles, source):
+    out = []
+    out.append("// Gerado por tools/profile_compiler.py a partir de " + source + " - NAO EDITAR")
+    out.append("#ifndef TEST_PROFILES_DATA_H")
+    out.append("#define TEST_PROFILES_DATA_H")
+    out.append("")
+    out.append('#include "test_profile.h"')
+    out.append("")
+    for i, (name, code) in enumerate(profiles):
+        out.append(f"// {name} ({len(code)} bytes)")
+        out.append(f"constexpr uint8_t TEST_PROFILE_{i}[] = {{")
+        for off in range(0, len(code), 12):
+            chunk = ", ".join(f"0x{b:02X}" for b in code[off:off + 12])
+            out.append(f"    {chunk},")
+        out.append("};")
+        out.append("")
+    out.append("constexpr TestProfileEntry TEST_PROFILES[] = {")
+    for i, _ in enumerate(profiles):
+        out.append(f"    {{TEST_PROFILE_{i}, sizeof(TEST_PROFILE_{i})}},")
+    out.append("};")
+    out.append("constexpr int TEST_PROFILES_COUNT = sizeof(TEST_PROFILES) / sizeof(TEST_PROFILES[0]);")
+    out.append("")
+    out.append("#endif // TEST_PROFILES_DATA_H")
+    return "\n".join(out) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("source", help="arquivo de perfis (texto)")
+    parser.add_argument("-o", "--output", default="include/test_profiles_data.h")
+    args = parser.parse_args()
+
+    with open(args.source, encoding="utf-8") as f:
+        try:
+            profiles = parse(f)
+        except ProfileError as exc:
+            print(f"{args.source}: {exc}", file=sys.stderr)
+            return 1
+
+    source = args.source.replace("\\", "/")
+    with open(args.output, "w", encoding="utf-8", newline="\n") as f:
+        f.write(render_header(profiles, source))
+    for name, code in profiles:
+        print(f"{name}: {len(code)} bytes")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
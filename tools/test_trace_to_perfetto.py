@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+"""Testes do conversor trace_to_perfetto.py sobre um despejo fixo.
+
+Uso:
+    python3 -m unittest discover -s tools -p "test_*.py"
+"""
+
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import unittest
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import trace_to_perfetto as t2p  # noqa: E402
+
+# Despejo como o do comando "trace": ruído do log, micros() dando a volta
+# entre seq 3 e 4, e um evento gravado durante o despejo (seq 8) que
+# sobrescreveu a vaga mais antiga (seq 0 não chegou a ser impresso)
+FIXED_TRACE = """\
+[SETUP] Pronto.
+TRACE begin 8 1
+EVT 4294967000 5 0 8 -120
+EVT 4294966000 1 1 1 50
+EVT 4294966100 3 2 2 22
+EVT 4294967200 5 0 3 81234
+EVT 150 4 2 4 -16000
+EVT 300 6 1 5 12
+EVT 400 7 3 6 0
+EVT 900 8 3 7 0
+TRACE end
+EVT lixo 1 2 3 4
+"""
+
+WRAP = 1 << 32
+
+
+class TraceToPerfettoTest(unittest.TestCase):
+    def setUp(self):
+        self.events = t2p.parse_events(FIXED_TRACE.splitlines())
+        self.trace = t2p.to_chrome_trace(self.events)
+
+    def test_drops_event_written_during_dump(self):
+        self.assertEqual([ev[3] for ev in self.events], [1, 2, 3, 4, 5, 6, 7])
+
+    def test_unwraps_micros(self):
+        ts = [ev[0] for ev in self.events]
+        self.assertEqual(ts, [4294966000, 4294966100, 4294967200,
+                              WRAP + 150, WRAP + 300, WRAP + 400, WRAP + 900])
+        self.assertEqual(ts, sorted(ts))
+
+    def test_chrome_trace_format(self):
+        evs = self.trace["traceEvents"]
+        self.assertEqual(self.trace["displayTimeUnit"], "ms")
+        meta = [e for e in evs if e["ph"] == "M"]
+        self.assertEqual({e["args"]["name"] for e in meta}, set(t2p.THREAD_NAMES.values()))
+        data = [e for e in evs if e["ph"] != "M"]
+        self.assertEqual(data[0], {"ph": "B", "pid": 1, "tid": t2p.TID_GRAFSET, "ts": 4294966000,
+                                   "name": "TestFadiga:50", "args": {"state": 50}})
+        self.assertEqual(data[1]["name"], "queue")
+        self.assertEqual(data[1]["args"], {"steps": 22})
+        self.assertEqual(data[2], {"ph": "C", "pid": 1, "tid": t2p.TID_SAMPLE, "ts": 4294967200,
+                                   "name": "hx711_raw", "args": {"value": 81234}})
+        self.assertEqual(data[3]["ph"], "E")
+        self.assertEqual(data[3]["args"], {"position": -16000})
+        self.assertEqual(data[4], {"ph": "i", "s": "t", "pid": 1, "tid": t2p.TID_ENCODER,
+                                   "ts": WRAP + 300, "name": "click", "args": {"position": 12}})
+        self.assertEqual([(e["ph"], e["name"]) for e in data[5:]], [("B", "spcChart"), ("E", "spcChart")])
+
+    # Ida e volta: cada evento do despejo sai do JSON com o mesmo tipo, origem e arg
+    def test_round_trip(self):
+        names = {
+            t2p.TID_MOTION: {v: k for k, v in t2p.MOTION_NAMES.items()},
+            t2p.TID_SAMPLE: {v: k for k, v in t2p.SAMPLE_NAMES.items()},
+            t2p.TID_ENCODER: {v: k for k, v in t2p.ENCODER_NAMES.items()},
+            t2p.TID_UI: {v: k for k, v in t2p.UI_NAMES.items()},
+        }
+        grafsets = {v: k for k, v in t2p.GRAFSET_NAMES.items()}
+        back = []
+        for e in self.trace["traceEvents"]:
+            if e["ph"] == "M":
+                continue
+            tid, ph, args = e["tid"], e["ph"], e["args"]
+            if tid == t2p.TID_GRAFSET:
+                name, state = e["name"].split(":")
+                typ = t2p.EVT_STATE_ENTER if ph == "B" else t2p.EVT_STATE_EXIT
+                back.append((e["ts"], typ, grafsets[name], int(state)))
+            elif tid == t2p.TID_MOTION:
+                typ = t2p.EVT_MOTION_START if ph == "B" else t2p.EVT_MOTION_END
+                back.append((e["ts"], typ, names[tid][e["name"]], next(iter(args.values()))))
+            elif tid == t2p.TID_SAMPLE:
+                back.append((e["ts"], t2p.EVT_SAMPLE, names[tid][e["name"]], args["value"]))
+            elif tid == t2p.TID_ENCODER:
+                back.append((e["ts"], t2p.EVT_ENCODER, names[tid][e["name"]], args["position"]))
+            else:
+                typ = t2p.EVT_UI_BEGIN if ph == "B" else t2p.EVT_UI_END
+                back.append((e["ts"], typ, names[tid][e["name"]], args["arg"]))
+        self.assertEqual(back, [(ts, typ, src, arg) for ts, typ, src, _, arg in self.events])
+
+    def test_command_line(self):
+        script = os.path.join(os.path.dirname(os.path.abspath(__file__)), "trace_to_perfetto.py")
+        with tempfile.TemporaryDirectory() as tmp:
+            out = os.path.join(tmp, "trace.json")
+            res = subprocess.run([sys.executable, script, "-", "-o", out], input=FIXED_TRACE,
+                                 capture_output=True, text=True, check=True)
+            self.assertIn("7 eventos", res.stdout)
+            with open(out, encoding="utf-8") as f:
+                self.assertEqual(json.load(f), self.trace)
+
+    def test_seq_chain_across_16_bit_wrap(self):
+        block = [(10, 5, 0, 65534, 1), (20, 5, 0, 65535, 2), (30, 5, 0, 0, 3), (40, 5, 0, 1, 4)]
+        self.assertEqual(t2p.drop_overwritten(block), block)
+
+
+if __name__ == "__main__":
+    unittest.main()
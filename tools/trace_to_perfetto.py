@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+"""Converte o despejo do comando serial "trace" para JSON do Chrome trace.
+
+Uso:
+    python tools/trace_to_perfetto.py log_serial.txt -o trace.json
+
+Abra o resultado em https://ui.perfetto.dev ou chrome://tracing.
+
+Linhas aceitas (demais linhas do log são ignoradas):
+    TRACE begin <eventos> <perdidos>
+    EVT <ts_us> <tipo> <origem> <seq> <arg>
+
+Testes: python3 -m unittest discover -s tools -p "test_*.py"
+"""
+
+import argparse
+import json
+import sys
+
+EVT_STATE_ENTER = 1
+EVT_STATE_EXIT = 2
+EVT_MOTION_START = 3
+EVT_MOTION_END = 4
+EVT_SAMPLE = 5
+EVT_ENCODER = 6
+EVT_UI_BEGIN = 7
+EVT_UI_END = 8
+
+GRAFSET_NAMES = {0: "TestMola", 1: "TestFadiga"}
+MOTION_NAMES = {0: "move", 1: "homing", 2: "queue"}
+ENCODER_NAMES = {0: "rotate", 1: "click", 2: "long_press"}
+UI_NAMES = {0: "drawTestStatus", 1: "plotGraphPoint", 2: "drawMenu", 3: "spcChart"}
+SAMPLE_NAMES = {0: "hx711_raw", 1: "sg_result"}
+
+# Uma "thread" por categoria para separar as trilhas na visualização
+TID_GRAFSET = 1
+TID_MOTION = 2
+TID_SAMPLE = 3
+TID_ENCODER = 4
+TID_UI = 5
+THREAD_NAMES = {
+    TID_GRAFSET: "grafset",
+    TID_MOTION: "motor",
+    TID_SAMPLE: "amostras",
+    TID_ENCODER: "encoder",
+    TID_UI: "ui",
+}
+
+PID = 1
+U32 = 1 << 32
+SEQ_MOD = 1 << 16
+
+
+def drop_overwritten(block):
+    """Descarta eventos sobrescritos durante o despejo.
+
+    O firmware grava enquanto despeja: um evento novo pode ocupar a vaga de um
+    antigo ainda não impresso. seq sobe de 1 em 1 (16 bits), então a cadeia é
+    seguida de trás para frente a partir do último evento (sempre válido) e
+    quem não se encaixa sai.
+    """
+    kept = []
+    expected = None
+    for ev in reversed(block):
+        if expected is None or ev[3] == expected:
+            kept.append(ev)
+            expected = (ev[3] - 1) % SEQ_MOD
+    kept.reverse()
+    return kept
+
+
+def parse_events(lines):
+    """Retorna lista de (ts_us, tipo, origem, seq, arg) com micros() desdobrado."""
+    blocks = [[]]
+    for line in lines:
+        parts = line.strip().split()
+        if parts[:2] == ["TRACE", "begin"]:
+            blocks.append([])
+            continue
+        if len(parts) != 6 or parts[0] != "EVT":
+            continue
+        try:
+            raw, typ, src, seq, arg = (int(p) for p in parts[1:])
+        except ValueError:
+            continue
+        blocks[-1].append((raw, typ, src, seq, arg))
+
+    events = []
+    wraps = 0
+    last_raw = None
+    for block in blocks:
+        for raw, typ, src, seq, arg in drop_overwritten(block):
+            # micros() estoura a cada ~71 min; o despejo sai em ordem cronológica
+            if last_raw is not None and raw < last_raw and (last_raw - raw) > U32 // 2:
+                wraps += 1
+            last_raw = raw
+            events.append((raw + wraps * U32, typ, src, seq, arg))
+    return events
+
+
+def to_chrome_trace(events):
+    out = []
+    for tid, name in THREAD_NAMES.items():
+        out.append({"ph": "M", "pid": PID, "tid": tid, "name": "thread_name",
+                    "args": {"name": name}})
+
+    for ts, typ, src, seq, arg in events:
+        if typ in (EVT_STATE_ENTER, EVT_STATE_EXIT):
+            name = "%s:%d" % (GRAFSET_NAMES.get(src, "grafset%d" % src), arg)
+            ph = "B" if typ == EVT_STATE_ENTER else "E"
+            out.append({"ph": ph, "pid": PID, "tid": TID_GRAFSET, "ts": ts,
+                        "name": name, "args": {"state": arg}})
+        elif typ in (EVT_MOTION_START, EVT_MOTION_END):
+            name = MOTION_NAMES.get(src, "motion%d" % src)
+            ph = "B" if typ == EVT_MOTION_START else "E"
+            key = "steps" if typ == EVT_MOTION_START else "position"
+            out.append({"ph": ph, "pid": PID, "tid": TID_MOTION, "ts": ts,
+                        "name": name, "args": {key: arg}})
+        elif typ == EVT_SAMPLE:
+            out.append({"ph": "C", "pid": PID, "tid": TID_SAMPLE, "ts": ts,
+                        "name": SAMPLE_NAMES.get(src, "sample%d" % src),
+                        "args": {"value": arg}})
+        elif typ == EVT_ENCODER:
+            out.append({"ph": "i", "s": "t", "pid": PID, "tid": TID_ENCODER,
+                        "ts": ts, "name": ENCODER_NAMES.get(src, "enc%d" % src),
+                        "args": {"position": arg}})
+        elif typ in (EVT_UI_BEGIN, EVT_UI_END):
+            ph = "B" if typ == EVT_UI_BEGIN else "E"
+            out.append({"ph": ph, "pid": PID, "tid": TID_UI, "ts": ts,
+                        "name": UI_NAMES.get(src, "ui%d" % src), "args": {"arg": arg}})
+    return {"traceEvents": out, "displayTimeUnit": "ms"}
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("log", help="arquivo com a saída serial (use - para stdin)")
+    ap.add_argument("-o", "--output", default="trace.json", help="arquivo JSON de saída")
+    args = ap.parse_args()
+
+    if args.log == "-":
+        events = parse_events(sys.stdin)
+    else:
+        with open(args.log, "r", encoding="utf-8", errors="replace") as f:
+            events = parse_events(f)
+
+    with open(args.output, "w", encoding="utf-8") as f:
+        json.dump(to_chrome_trace(events), f)
+    print("%d eventos -> %s" % (len(events), args.output))
+
+
+if __name__ == "__main__":
+    main()